@@ -0,0 +1,474 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../core/allocation_tracker.h"
+#include "../core/instrumentation.h"
+#include "../core/matrix_batch.h"
+#include "../core/parallel.h"
+#include "../core/type_traits.h"
+
+// Kernels over a MatrixBatch. Each one runs group by group (a group is
+// MatrixBatch::lanes matrices stored entry-interleaved) and finishes every
+// loop with a fixed-length loop over the lanes of the group, which is what
+// gets vectorized. Groups are independent and are spread over threads with
+// Parallel::parallel_for. Pivot search and row swaps differ per matrix and
+// stay scalar; everything O(n^3) runs across the lanes.
+
+namespace Algebra {
+	namespace Batched {
+
+		using Core::MatrixBatch;
+		using Core::Traits::EpsilonType;
+		using Core::Traits::NormType;
+		using Core::Traits::default_epsilon;
+
+		// Work (about lanes * n^3 flops) one thread should get before the
+		// groups are split up.
+		inline constexpr std::size_t parallel_grain = std::size_t{ 1 } << 16;
+
+		namespace Detail {
+
+			inline constexpr std::size_t lanes = MatrixBatch<double>::lanes;
+
+			template<typename Function>
+			void for_each_group(std::size_t groups, std::size_t work_per_group, Function&& function) {
+				const std::size_t min_groups = std::max<std::size_t>(1, parallel_grain / std::max<std::size_t>(work_per_group, 1));
+				Core::Parallel::parallel_for(0, groups, min_groups, [&](std::size_t first, std::size_t last) {
+					for (std::size_t g = first; g < last; ++g) {
+						function(g);
+					}
+				});
+			}
+
+			// |re| + |im|, the pivot measure LAPACK uses for complex entries.
+			template<typename T>
+			NormType<T> magnitude(const T& value) {
+				if constexpr (Core::Traits::is_complex<T>::value) {
+					return std::abs(value.real()) + std::abs(value.imag());
+				}
+				else {
+					return std::abs(value);
+				}
+			}
+
+			// Padding members of the last group become identities, so that the
+			// factorizations run on them without producing infinities.
+			template<typename T, typename Allocator>
+			void pad_with_identity(MatrixBatch<T, Allocator>& batch) {
+				const std::size_t used = batch.size() % lanes;
+				if (used == 0 || batch.groups() == 0) {
+					return;
+				}
+				T* base = batch.group(batch.groups() - 1);
+				for (std::size_t i = 0; i < batch.get_rows(); ++i) {
+					for (std::size_t j = 0; j < batch.get_columns(); ++j) {
+						T* entry = base + (i * batch.get_columns() + j) * lanes;
+						std::fill(entry + used, entry + lanes, i == j ? T{ 1 } : T{});
+					}
+				}
+			}
+
+			inline std::string failure_message(const char* what, const std::vector<std::size_t>& members) {
+				return std::string(what) + " (first at batch index " + std::to_string(members.front()) + ", "
+					+ std::to_string(members.size()) + " in total)";
+			}
+
+		}
+
+		// C = alpha * A * B + beta * C for every member; with beta == 0 the
+		// previous contents of C are ignored.
+		template<typename T, typename Allocator>
+		void gemm(const T& alpha, const MatrixBatch<T, Allocator>& a, const MatrixBatch<T, Allocator>& b,
+			const T& beta, MatrixBatch<T, Allocator>& c) {
+			const std::size_t m = a.get_rows();
+			const std::size_t k = a.get_columns();
+			const std::size_t n = b.get_columns();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Batched::gemm", 2 * a.size() * m * n * k, a.size() * (m * k + k * n + 2 * m * n) * sizeof(T));
+			if (a.size() != b.size() || a.size() != c.size()) {
+				throw std::invalid_argument("Batches must hold the same number of matrices");
+			}
+			if (b.get_rows() != k) {
+				throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
+			}
+			if (c.get_rows() != m || c.get_columns() != n) {
+				throw std::invalid_argument("Output matrix has wrong dimensions for multiplication");
+			}
+
+			constexpr std::size_t L = Detail::lanes;
+			Detail::for_each_group(a.groups(), L * m * n * k, [&](std::size_t g) {
+				const T* ga = a.group(g);
+				const T* gb = b.group(g);
+				T* gc = c.group(g);
+				for (std::size_t i = 0; i < m; ++i) {
+					T* c_row = gc + i * n * L;
+					if (beta == T{ 0 }) {
+						std::fill(c_row, c_row + n * L, T{});
+					}
+					else if (beta != T{ 1 }) {
+						for (std::size_t e = 0; e < n * L; ++e) {
+							c_row[e] *= beta;
+						}
+					}
+					for (std::size_t p = 0; p < k; ++p) {
+						T scaled[L];
+						for (std::size_t l = 0; l < L; ++l) {
+							scaled[l] = alpha * ga[(i * k + p) * L + l];
+						}
+						const T* b_row = gb + p * n * L;
+						for (std::size_t j = 0; j < n; ++j) {
+							for (std::size_t l = 0; l < L; ++l) {
+								c_row[j * L + l] += scaled[l] * b_row[j * L + l];
+							}
+						}
+					}
+				}
+			});
+		}
+
+		template<typename T, typename Allocator>
+		[[nodiscard]] MatrixBatch<T, Allocator> multiply(const MatrixBatch<T, Allocator>& a, const MatrixBatch<T, Allocator>& b) {
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Batched::multiply");
+			MatrixBatch<T, Allocator> c(a.size(), a.get_rows(), b.get_columns());
+			gemm(T{ 1 }, a, b, T{ 0 }, c);
+			return c;
+		}
+
+		// PA = LU of every member, with partial pivoting as in
+		// LUP_Decomposition. A member with a pivot below epsilon, which
+		// LUP_Decomposition would reject, does not stop the others: singular()
+		// reports it, and its elimination only skips exactly zero pivots.
+		template<typename T>
+		class LupBatch {
+		public:
+			explicit LupBatch(const MatrixBatch<T>& matrices, EpsilonType<T> epsilon = default_epsilon<T>())
+				: factors_(matrices) {
+				if (matrices.get_rows() != matrices.get_columns()) {
+					throw std::invalid_argument("LUP decomposition requires square matrix");
+				}
+				compute_decomposition(epsilon);
+			}
+
+			[[nodiscard]] std::size_t size() const noexcept { return factors_.size(); }
+			// L below the diagonal (unit diagonal implied) and U on and above it.
+			[[nodiscard]] const MatrixBatch<T>& get_factors() const noexcept { return factors_; }
+			// Indices of the members with a pivot below epsilon.
+			[[nodiscard]] std::vector<std::size_t> singular() const {
+				std::vector<std::size_t> result;
+				for (std::size_t b = 0; b < size(); ++b) {
+					if (singular_[b]) {
+						result.push_back(b);
+					}
+				}
+				return result;
+			}
+			[[nodiscard]] bool is_singular(std::size_t b) const { return singular_.at(b) != 0; }
+
+			[[nodiscard]] std::vector<T> determinants() const {
+				const std::size_t n = factors_.get_rows();
+				std::vector<T> result(size());
+				for (std::size_t b = 0; b < size(); ++b) {
+					T product = sign_[b] < 0 ? T{ -1 } : T{ 1 };
+					for (std::size_t i = 0; i < n; ++i) {
+						product *= factors_(b, i, i);
+					}
+					result[b] = product;
+				}
+				return result;
+			}
+
+			// X with A X = B for every member; B is a batch of n x k matrices.
+			// Throws if a member is singular.
+			[[nodiscard]] MatrixBatch<T> solve(const MatrixBatch<T>& b) const {
+				const std::size_t n = factors_.get_rows();
+				const std::size_t k = b.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Algebra::Batched::LupBatch::solve", 2 * size() * n * n * k, size() * (n * n + 2 * n * k) * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Algebra::Batched::LupBatch::solve");
+				if (b.size() != size() || b.get_rows() != n) {
+					throw std::invalid_argument("Right-hand side batch must match the factored batch");
+				}
+				const std::vector<std::size_t> failed = singular();
+				if (!failed.empty()) {
+					throw std::runtime_error(Detail::failure_message("Matrix is singular or nearly singular", failed));
+				}
+
+				constexpr std::size_t L = Detail::lanes;
+				MatrixBatch<T> x(b);
+				Detail::for_each_group(factors_.groups(), L * n * n * k, [&](std::size_t g) {
+					const T* lu = factors_.group(g);
+					T* gx = x.group(g);
+					for (std::size_t i = 0; i < n; ++i) {
+						for (std::size_t l = 0; l < L; ++l) {
+							const std::size_t p = pivots_[(g * n + i) * L + l];
+							if (p != i) {
+								for (std::size_t j = 0; j < k; ++j) {
+									std::swap(gx[(i * k + j) * L + l], gx[(p * k + j) * L + l]);
+								}
+							}
+						}
+					}
+					for (std::size_t i = 0; i < n; ++i) {
+						T* row = gx + i * k * L;
+						for (std::size_t p = 0; p < i; ++p) {
+							const T* coefficient = lu + (i * n + p) * L;
+							const T* solved = gx + p * k * L;
+							for (std::size_t j = 0; j < k; ++j) {
+								for (std::size_t l = 0; l < L; ++l) {
+									row[j * L + l] -= coefficient[l] * solved[j * L + l];
+								}
+							}
+						}
+					}
+					for (std::size_t i = n; i-- > 0;) {
+						T* row = gx + i * k * L;
+						for (std::size_t p = i + 1; p < n; ++p) {
+							const T* coefficient = lu + (i * n + p) * L;
+							const T* solved = gx + p * k * L;
+							for (std::size_t j = 0; j < k; ++j) {
+								for (std::size_t l = 0; l < L; ++l) {
+									row[j * L + l] -= coefficient[l] * solved[j * L + l];
+								}
+							}
+						}
+						const T* diagonal = lu + (i * n + i) * L;
+						for (std::size_t j = 0; j < k; ++j) {
+							for (std::size_t l = 0; l < L; ++l) {
+								row[j * L + l] /= diagonal[l];
+							}
+						}
+					}
+				});
+				return x;
+			}
+
+			[[nodiscard]] MatrixBatch<T> inverse() const {
+				MatrixBatch<T> identity(size(), factors_.get_rows(), factors_.get_columns());
+				identity.identity_matrix(T{ 1 });
+				return solve(identity);
+			}
+
+		private:
+			static constexpr std::size_t L = Detail::lanes;
+
+			MatrixBatch<T> factors_;
+			// Row swapped with row i at step i of member (g, l), at (g * n + i) * L + l.
+			std::vector<std::size_t> pivots_;
+			std::vector<signed char> sign_;
+			std::vector<unsigned char> singular_;
+
+			void compute_decomposition(EpsilonType<T> epsilon) {
+				const std::size_t n = factors_.get_rows();
+				MATRIXLIB_PROFILE_ZONE("Algebra::Batched::LupBatch::compute_decomposition", 2 * size() * n * n * n / 3, 2 * size() * n * n * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Algebra::Batched::LupBatch::compute_decomposition");
+				Detail::pad_with_identity(factors_);
+				const std::size_t padded = factors_.groups() * L;
+				pivots_.assign(padded * n, 0);
+				sign_.assign(padded, 1);
+				singular_.assign(padded, 0);
+
+				Detail::for_each_group(factors_.groups(), L * n * n * n, [&](std::size_t g) {
+					T* a = factors_.group(g);
+					for (std::size_t k = 0; k < n; ++k) {
+						for (std::size_t l = 0; l < L; ++l) {
+							std::size_t pivot = k;
+							NormType<T> largest = Detail::magnitude(a[(k * n + k) * L + l]);
+							for (std::size_t i = k + 1; i < n; ++i) {
+								const NormType<T> candidate = Detail::magnitude(a[(i * n + k) * L + l]);
+								if (candidate > largest) {
+									largest = candidate;
+									pivot = i;
+								}
+							}
+							pivots_[(g * n + k) * L + l] = pivot;
+							if (std::abs(a[(pivot * n + k) * L + l]) < epsilon) {
+								singular_[g * L + l] = 1;
+							}
+							if (pivot != k) {
+								for (std::size_t j = 0; j < n; ++j) {
+									std::swap(a[(k * n + j) * L + l], a[(pivot * n + j) * L + l]);
+								}
+								sign_[g * L + l] = static_cast<signed char>(-sign_[g * L + l]);
+							}
+						}
+
+						T inverse[L];
+						const T* pivot_row = a + k * n * L;
+						for (std::size_t l = 0; l < L; ++l) {
+							const T pivot = pivot_row[k * L + l];
+							inverse[l] = pivot == T{ 0 } ? T{ 0 } : T{ 1 } / pivot;
+						}
+						for (std::size_t i = k + 1; i < n; ++i) {
+							T* row = a + i * n * L;
+							for (std::size_t l = 0; l < L; ++l) {
+								row[k * L + l] *= inverse[l];
+							}
+							for (std::size_t j = k + 1; j < n; ++j) {
+								for (std::size_t l = 0; l < L; ++l) {
+									row[j * L + l] -= row[k * L + l] * pivot_row[j * L + l];
+								}
+							}
+						}
+					}
+				});
+			}
+		};
+
+		// A = R^H R of every member (upper R, positive real diagonal), as in
+		// CHOLESKY_Decomposition. Members that are not positive definite are
+		// reported by failed() instead of stopping the batch.
+		template<typename T>
+		class CholeskyBatch {
+		public:
+			explicit CholeskyBatch(const MatrixBatch<T>& matrices) : factors_(matrices) {
+				if (matrices.get_rows() != matrices.get_columns()) {
+					throw std::invalid_argument("Cholesky decomposition requires square matrix");
+				}
+				compute_decomposition();
+			}
+
+			[[nodiscard]] std::size_t size() const noexcept { return factors_.size(); }
+			[[nodiscard]] const MatrixBatch<T>& get_R() const noexcept { return factors_; }
+			[[nodiscard]] std::vector<std::size_t> failed() const {
+				std::vector<std::size_t> result;
+				for (std::size_t b = 0; b < size(); ++b) {
+					if (failed_[b]) {
+						result.push_back(b);
+					}
+				}
+				return result;
+			}
+
+			// X with A X = B for every member. Throws if a member failed.
+			[[nodiscard]] MatrixBatch<T> solve(const MatrixBatch<T>& b) const {
+				const std::size_t n = factors_.get_rows();
+				const std::size_t k = b.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Algebra::Batched::CholeskyBatch::solve", 2 * size() * n * n * k, size() * (n * n + 2 * n * k) * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Algebra::Batched::CholeskyBatch::solve");
+				if (b.size() != size() || b.get_rows() != n) {
+					throw std::invalid_argument("Right-hand side batch must match the factored batch");
+				}
+				const std::vector<std::size_t> bad = failed();
+				if (!bad.empty()) {
+					throw std::runtime_error(Detail::failure_message("Matrix is not positive definite", bad));
+				}
+
+				MatrixBatch<T> x(b);
+				Detail::for_each_group(factors_.groups(), L * n * n * k, [&](std::size_t g) {
+					const T* r = factors_.group(g);
+					T* gx = x.group(g);
+					// R^H Y = B, pushing each solved row into the rows below it.
+					for (std::size_t i = 0; i < n; ++i) {
+						T* row = gx + i * k * L;
+						const T* diagonal = r + (i * n + i) * L;
+						for (std::size_t j = 0; j < k; ++j) {
+							for (std::size_t l = 0; l < L; ++l) {
+								row[j * L + l] /= diagonal[l];
+							}
+						}
+						for (std::size_t q = i + 1; q < n; ++q) {
+							T coefficient[L];
+							for (std::size_t l = 0; l < L; ++l) {
+								coefficient[l] = Core::Traits::conjugate(r[(i * n + q) * L + l]);
+							}
+							T* target = gx + q * k * L;
+							for (std::size_t j = 0; j < k; ++j) {
+								for (std::size_t l = 0; l < L; ++l) {
+									target[j * L + l] -= coefficient[l] * row[j * L + l];
+								}
+							}
+						}
+					}
+					for (std::size_t i = n; i-- > 0;) {
+						T* row = gx + i * k * L;
+						for (std::size_t q = i + 1; q < n; ++q) {
+							const T* coefficient = r + (i * n + q) * L;
+							const T* solved = gx + q * k * L;
+							for (std::size_t j = 0; j < k; ++j) {
+								for (std::size_t l = 0; l < L; ++l) {
+									row[j * L + l] -= coefficient[l] * solved[j * L + l];
+								}
+							}
+						}
+						const T* diagonal = r + (i * n + i) * L;
+						for (std::size_t j = 0; j < k; ++j) {
+							for (std::size_t l = 0; l < L; ++l) {
+								row[j * L + l] /= diagonal[l];
+							}
+						}
+					}
+				});
+				return x;
+			}
+
+		private:
+			static constexpr std::size_t L = Detail::lanes;
+
+			MatrixBatch<T> factors_;
+			std::vector<unsigned char> failed_;
+
+			void compute_decomposition() {
+				const std::size_t n = factors_.get_rows();
+				MATRIXLIB_PROFILE_ZONE("Algebra::Batched::CholeskyBatch::compute_decomposition", size() * n * n * n / 3, 2 * size() * n * n * sizeof(T));
+				Detail::pad_with_identity(factors_);
+				failed_.assign(factors_.groups() * L, 0);
+
+				Detail::for_each_group(factors_.groups(), L * n * n * n / 2, [&](std::size_t g) {
+					T* a = factors_.group(g);
+					for (std::size_t i = 0; i < n; ++i) {
+						T* pivot_row = a + i * n * L;
+						T inverse[L];
+						for (std::size_t l = 0; l < L; ++l) {
+							NormType<T> pivot = std::real(pivot_row[i * L + l]);
+							// A failed member keeps going on a unit pivot so its
+							// lanes stay finite; its result is discarded.
+							if (!(pivot > NormType<T>{ 0 })) {
+								failed_[g * L + l] = 1;
+								pivot = NormType<T>{ 1 };
+							}
+							const NormType<T> diagonal = std::sqrt(pivot);
+							pivot_row[i * L + l] = T(diagonal);
+							inverse[l] = T(NormType<T>{ 1 } / diagonal);
+						}
+						for (std::size_t j = i + 1; j < n; ++j) {
+							for (std::size_t l = 0; l < L; ++l) {
+								pivot_row[j * L + l] *= inverse[l];
+							}
+						}
+						for (std::size_t p = i + 1; p < n; ++p) {
+							T* row = a + p * n * L;
+							T coefficient[L];
+							for (std::size_t l = 0; l < L; ++l) {
+								coefficient[l] = Core::Traits::conjugate(pivot_row[p * L + l]);
+								row[i * L + l] = T{};
+							}
+							for (std::size_t j = p; j < n; ++j) {
+								for (std::size_t l = 0; l < L; ++l) {
+									row[j * L + l] -= coefficient[l] * pivot_row[j * L + l];
+								}
+							}
+						}
+					}
+				});
+			}
+		};
+
+		template<typename T>
+		[[nodiscard]] std::vector<T> determinants(const MatrixBatch<T>& matrices) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Batched::determinants", 0, 0);
+			return LupBatch<T>(matrices).determinants();
+		}
+
+		// Inverse of every member; throws if any member is singular.
+		template<typename T>
+		[[nodiscard]] MatrixBatch<T> inverse(const MatrixBatch<T>& matrices) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Batched::inverse", 0, 0);
+			return LupBatch<T>(matrices).inverse();
+		}
+
+	}
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/gemm_kernel.h"
+#include "../core/allocation_tracker.h"
+#include "../core/instrumentation.h"
+#include "../core/matrix.h"
+#include "../core/matrix_view.h"
+#include "../core/parallel.h"
+#include "../core/syrk_kernel.h"
+#include "../core/type_traits.h"
+#include "../core/vector.h"
+#include "../core/vector_kernel.h"
+#include "norms.h"
+
+namespace Algebra {
+	namespace Blas {
+
+		using Core::MatrixView;
+		using Core::Op;
+		using Core::OpView;
+		using Core::Triangle;
+		using Core::Vector;
+		using Core::VectorView;
+		using Core::Traits::NormType;
+		using Core::Traits::type_identity_t;
+
+		// C = alpha * op(A) * op(B) + beta * C, written into the caller's C.
+		// With beta == 0 the previous contents of C are ignored (NaNs included);
+		// with beta == 1 the product accumulates into C. After the first call of a
+		// given shape no memory is allocated. C must not overlap A or B.
+		template<typename T>
+		void gemm(const type_identity_t<T>& alpha, const MatrixView<const T>& a, Op op_a,
+			const MatrixView<const T>& b, Op op_b, const type_identity_t<T>& beta, const MatrixView<T>& c) {
+			const size_t m = Core::is_transposed(op_a) ? a.get_columns() : a.get_rows();
+			const size_t k = Core::is_transposed(op_a) ? a.get_rows() : a.get_columns();
+			const size_t k_b = Core::is_transposed(op_b) ? b.get_columns() : b.get_rows();
+			const size_t n = Core::is_transposed(op_b) ? b.get_rows() : b.get_columns();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Blas::gemm", 2 * m * n * k, (m * k + k * n + 2 * m * n) * sizeof(T));
+
+			if (k != k_b) {
+				throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
+			}
+			if (c.get_rows() != m || c.get_columns() != n) {
+				throw std::invalid_argument("Output matrix has wrong dimensions for multiplication");
+			}
+			if (c.overlaps(a) || c.overlaps(b)) {
+				throw std::invalid_argument("Output matrix must not overlap an operand of gemm");
+			}
+
+			Core::Kernels::gemm<T>(alpha, a, op_a, b, op_b, beta, c);
+		}
+
+		template<typename T, typename AllocatorA, typename AllocatorB, typename AllocatorC>
+		void gemm(const type_identity_t<T>& alpha, const Core::Matrix<T, AllocatorA>& a, Op op_a,
+			const Core::Matrix<T, AllocatorB>& b, Op op_b, const type_identity_t<T>& beta, Core::Matrix<T, AllocatorC>& c) {
+			gemm<T>(alpha, Core::view(a), op_a, Core::view(b), op_b, beta, Core::view(c));
+		}
+		template<typename T, typename AllocatorA, typename AllocatorB, typename AllocatorC>
+		void gemm(const type_identity_t<T>& alpha, const Core::Matrix<T, AllocatorA>& a,
+			const Core::Matrix<T, AllocatorB>& b, const type_identity_t<T>& beta, Core::Matrix<T, AllocatorC>& c) {
+			gemm<T>(alpha, Core::view(a), Op::no_transpose, Core::view(b), Op::no_transpose, beta, Core::view(c));
+		}
+
+		// Operands built with transposed(), conjugated() or adjoint(); plain
+		// matrices and views convert to an OpView with Op::no_transpose.
+		template<typename T>
+		void gemm(const type_identity_t<T>& alpha, const OpView<type_identity_t<T>>& a, const OpView<type_identity_t<T>>& b,
+			const type_identity_t<T>& beta, const MatrixView<T>& c) {
+			gemm<T>(alpha, a.operand(), a.op(), b.operand(), b.op(), beta, c);
+		}
+		template<typename T, typename AllocatorC>
+		void gemm(const type_identity_t<T>& alpha, const OpView<type_identity_t<T>>& a, const OpView<type_identity_t<T>>& b,
+			const type_identity_t<T>& beta, Core::Matrix<T, AllocatorC>& c) {
+			gemm<T>(alpha, a.operand(), a.op(), b.operand(), b.op(), beta, Core::view(c));
+		}
+
+
+		// y = alpha * op(A) * x + beta * y, written into the caller's y (see
+		// core/vector_kernel.h). beta == 0 ignores the previous contents of y.
+		// Transposed products stream A by rows like the plain one, so
+		// gemv(Op::transpose) never reads a column. y must not overlap A or x.
+		template<typename T>
+		void gemv(const type_identity_t<T>& alpha, const MatrixView<const T>& a, Op op,
+			const VectorView<const T>& x, const type_identity_t<T>& beta, const VectorView<T>& y) {
+			const size_t rows = Core::is_transposed(op) ? a.get_columns() : a.get_rows();
+			const size_t columns = Core::is_transposed(op) ? a.get_rows() : a.get_columns();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Blas::gemv", 2 * rows * columns, (rows * columns + columns + 2 * rows) * sizeof(T));
+
+			if (x.size() != columns || y.size() != rows) {
+				throw std::invalid_argument("Vector lengths must match the matrix dimensions");
+			}
+			if (y.overlaps(x)) {
+				throw std::invalid_argument("Output vector must not overlap an operand of gemv");
+			}
+			for (size_t i = 0; i < a.get_rows(); ++i) {
+				if (y.overlaps(VectorView<const T>(a.row(i), a.get_columns()))) {
+					throw std::invalid_argument("Output vector must not overlap an operand of gemv");
+				}
+			}
+
+			Core::Kernels::gemv<T>(alpha, a, op, x.data(), beta, y.data());
+		}
+
+		template<typename T, typename AllocatorA, typename AllocatorX, typename AllocatorY>
+		void gemv(const type_identity_t<T>& alpha, const Core::Matrix<T, AllocatorA>& a, Op op,
+			const Vector<T, AllocatorX>& x, const type_identity_t<T>& beta, Vector<T, AllocatorY>& y) {
+			gemv<T>(alpha, Core::view(a), op, VectorView<const T>(x), beta, VectorView<T>(y));
+		}
+		template<typename T, typename AllocatorA, typename AllocatorX, typename AllocatorY>
+		void gemv(const type_identity_t<T>& alpha, const Core::Matrix<T, AllocatorA>& a,
+			const Vector<T, AllocatorX>& x, const type_identity_t<T>& beta, Vector<T, AllocatorY>& y) {
+			gemv<T>(alpha, Core::view(a), Op::no_transpose, VectorView<const T>(x), beta, VectorView<T>(y));
+		}
+		template<typename T, typename AllocatorX, typename AllocatorY>
+		void gemv(const type_identity_t<T>& alpha, const OpView<type_identity_t<T>>& a,
+			const Vector<T, AllocatorX>& x, const type_identity_t<T>& beta, Vector<T, AllocatorY>& y) {
+			gemv<T>(alpha, a.operand(), a.op(), VectorView<const T>(x), beta, VectorView<T>(y));
+		}
+
+		// y = alpha * A^T * x + beta * y; gemv with Op::conjugate_transpose
+		// gives A^H.
+		template<typename T, typename AllocatorA, typename AllocatorX, typename AllocatorY>
+		void gemv_transposed(const type_identity_t<T>& alpha, const Core::Matrix<T, AllocatorA>& a,
+			const Vector<T, AllocatorX>& x, const type_identity_t<T>& beta, Vector<T, AllocatorY>& y) {
+			gemv<T>(alpha, Core::view(a), Op::transpose, VectorView<const T>(x), beta, VectorView<T>(y));
+		}
+
+
+		// y += alpha * x.
+		template<typename T>
+		void axpy(const type_identity_t<T>& alpha, const VectorView<const T>& x, const VectorView<T>& y) {
+			const size_t n = x.size();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Blas::axpy", 2 * n, 3 * n * sizeof(T));
+			if (y.size() != n) {
+				throw std::invalid_argument("Vector sizes must agree");
+			}
+			Core::Parallel::parallel_for(0, n, Core::Kernels::vector_block_elements, [&](size_t first, size_t last) {
+				Core::Kernels::axpy<false>(alpha, x.data() + first, y.data() + first, last - first);
+			});
+		}
+		template<typename T, typename AllocatorX, typename AllocatorY>
+		void axpy(const type_identity_t<T>& alpha, const Vector<T, AllocatorX>& x, Vector<T, AllocatorY>& y) {
+			axpy<T>(alpha, VectorView<const T>(x), VectorView<T>(y));
+		}
+
+
+		// x^H y: the first operand is conjugated, as in BLAS dotc.
+		template<typename T>
+		T dot(const VectorView<const T>& x, const VectorView<const T>& y) {
+			const size_t n = x.size();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Blas::dot", 2 * n, 2 * n * sizeof(T));
+			if (y.size() != n) {
+				throw std::invalid_argument("Vector sizes must agree");
+			}
+			const size_t blocks = Core::Kernels::vector_blocks(n);
+			const size_t per_block = (n + blocks - 1) / std::max<size_t>(blocks, 1);
+			std::array<T, Core::Kernels::max_vector_blocks> partials{};
+			Core::Parallel::parallel_for(0, blocks, 1, [&](size_t first, size_t last) {
+				for (size_t block = first; block < last; ++block) {
+					const size_t begin = std::min(n, block * per_block);
+					const size_t end = std::min(n, begin + per_block);
+					partials[block] = Core::Kernels::dot<true>(x.data() + begin, y.data() + begin, end - begin);
+				}
+			});
+			T result{};
+			for (size_t block = 0; block < blocks; ++block) {
+				result += partials[block];
+			}
+			return result;
+		}
+		template<typename T, typename AllocatorX, typename AllocatorY>
+		T dot(const Vector<T, AllocatorX>& x, const Vector<T, AllocatorY>& y) {
+			return dot<T>(VectorView<const T>(x), VectorView<const T>(y));
+		}
+
+
+		// ||x||_2 without overflow or underflow: every block sums its squares
+		// scaled by its largest component with the Algebra::Norms helper, and
+		// the block results are merged in block order.
+		template<typename T>
+		NormType<T> nrm2(const VectorView<const T>& x) {
+			using R = NormType<T>;
+			const size_t n = x.size();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Blas::nrm2", 2 * n, n * sizeof(T));
+			const size_t blocks = Core::Kernels::vector_blocks(n);
+			const size_t per_block = (n + blocks - 1) / std::max<size_t>(blocks, 1);
+			std::array<Algebra::Norms::Detail::NormPartial<R>, Core::Kernels::max_vector_blocks> partials{};
+			Core::Parallel::parallel_for(0, blocks, 1, [&](size_t first, size_t last) {
+				for (size_t block = first; block < last; ++block) {
+					const size_t begin = std::min(n, block * per_block);
+					const size_t end = std::min(n, begin + per_block);
+					const R* values = reinterpret_cast<const R*>(x.data() + begin);
+					const size_t count = (end - begin) * (sizeof(T) / sizeof(R));
+					Algebra::Norms::Detail::accumulate_squares(values, count, partials[block]);
+				}
+			});
+			Algebra::Norms::Detail::NormPartial<R> total;
+			for (size_t block = 0; block < blocks; ++block) {
+				total.add_squares(partials[block].scale, partials[block].sum_of_squares);
+			}
+			return total.scale * std::sqrt(total.sum_of_squares);
+		}
+		template<typename T, typename Allocator>
+		NormType<T> nrm2(const Vector<T, Allocator>& x) {
+			return nrm2<T>(VectorView<const T>(x));
+		}
+
+
+		namespace Detail {
+
+			template<typename T>
+			void check_rank_k(const MatrixView<const T>& a, Op op, const MatrixView<T>& c, bool conjugate) {
+				// For real T, Op::transpose and Op::conjugate_transpose are the same.
+				const Op adjoint = conjugate ? Op::conjugate_transpose : Op::transpose;
+				const bool real_transpose = !Core::Traits::is_complex<T>::value && Core::is_transposed(op);
+				if (op != Op::no_transpose && op != adjoint && !real_transpose) {
+					throw std::invalid_argument(conjugate
+						? "herk takes Op::no_transpose or Op::conjugate_transpose"
+						: "syrk takes Op::no_transpose or Op::transpose");
+				}
+				const size_t n = op == Op::no_transpose ? a.get_rows() : a.get_columns();
+				if (c.get_rows() != n || c.get_columns() != n) {
+					throw std::invalid_argument("Output matrix has wrong dimensions for rank-k update");
+				}
+				if (c.overlaps(a)) {
+					throw std::invalid_argument("Output matrix must not overlap the operand of a rank-k update");
+				}
+			}
+
+			template<typename T>
+			void real_diagonal(const MatrixView<T>& c) {
+				if constexpr (Core::Traits::is_complex<T>::value) {
+					for (size_t i = 0; i < c.get_rows(); ++i) {
+						c(i, i) = T(c(i, i).real());
+					}
+				}
+			}
+
+		}
+
+		// C = alpha * op(A) * op(A)^T + beta * C on one triangle of C, with op
+		// Op::no_transpose (C = A A^T) or Op::transpose (C = A^T A). Half the
+		// multiply-adds of the gemm for the same product, and A^T is read in
+		// place (see core/syrk_kernel.h). The other triangle is neither read nor
+		// written; Core::Kernels::mirror_triangle fills it. C must not overlap A.
+		template<typename T>
+		void syrk(const type_identity_t<T>& alpha, const MatrixView<const T>& a, Op op, const type_identity_t<T>& beta,
+			const MatrixView<T>& c, Triangle triangle = Triangle::upper) {
+			// n (n + 1) k flops, C of order n and A of n k entries.
+			MATRIXLIB_PROFILE_ZONE("Algebra::Blas::syrk", (c.get_rows() + 1) * a.get_rows() * a.get_columns(),
+				(a.get_rows() * a.get_columns() + c.get_rows() * (c.get_rows() + 1)) * sizeof(T));
+			Detail::check_rank_k(a, op, c, false);
+			Core::Kernels::rank_k_update<T>(alpha, a, op != Op::no_transpose, false, beta, c, triangle);
+		}
+		template<typename T, typename AllocatorA, typename AllocatorC>
+		void syrk(const type_identity_t<T>& alpha, const Core::Matrix<T, AllocatorA>& a, Op op, const type_identity_t<T>& beta,
+			Core::Matrix<T, AllocatorC>& c, Triangle triangle = Triangle::upper) {
+			syrk<T>(alpha, Core::view(a), op, beta, Core::view(c), triangle);
+		}
+
+		// C = alpha * op(A) * op(A)^H + beta * C on one triangle of C, with op
+		// Op::no_transpose (C = A A^H) or Op::conjugate_transpose (C = A^H A);
+		// alpha and beta are real so C stays hermitian, and the imaginary parts
+		// of its diagonal are set to zero as in BLAS.
+		template<typename T>
+		void herk(const type_identity_t<NormType<T>>& alpha, const MatrixView<const T>& a, Op op,
+			const type_identity_t<NormType<T>>& beta, const MatrixView<T>& c, Triangle triangle = Triangle::upper) {
+			// n (n + 1) k flops, C of order n and A of n k entries.
+			MATRIXLIB_PROFILE_ZONE("Algebra::Blas::herk", (c.get_rows() + 1) * a.get_rows() * a.get_columns(),
+				(a.get_rows() * a.get_columns() + c.get_rows() * (c.get_rows() + 1)) * sizeof(T));
+			Detail::check_rank_k(a, op, c, true);
+			Core::Kernels::rank_k_update<T>(T(alpha), a, op != Op::no_transpose, true, T(beta), c, triangle);
+			Detail::real_diagonal(c);
+		}
+		template<typename T, typename AllocatorA, typename AllocatorC>
+		void herk(const type_identity_t<NormType<T>>& alpha, const Core::Matrix<T, AllocatorA>& a, Op op,
+			const type_identity_t<NormType<T>>& beta, Core::Matrix<T, AllocatorC>& c, Triangle triangle = Triangle::upper) {
+			herk<T>(alpha, Core::view(a), op, beta, Core::view(c), triangle);
+		}
+
+		// X^H X (X^T X for real X) for the n columns of X: the upper triangle by
+		// herk, then mirrored and tagged symmetric or hermitian.
+		template<typename T, typename Allocator>
+		Core::Matrix<T> gram(const Core::Matrix<T, Allocator>& x) {
+			const size_t n = x.get_columns();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Blas::gram", n * (n + 1) * x.get_rows(), (x.get_rows() * n + n * n) * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Blas::gram");
+			Core::Matrix<T> result(n, n);
+			herk<T>(NormType<T>{ 1 }, Core::view(x), Op::conjugate_transpose, NormType<T>{ 0 }, Core::view(result));
+			Core::Kernels::mirror_triangle(Core::view(result), Triangle::upper, true);
+			result.set_structure(Core::StructureTag(Core::Traits::is_complex<T>::value ? Core::Structure::hermitian : Core::Structure::symmetric));
+			return result;
+		}
+
+		// X^H X for an X whose rows arrive in blocks, e.g. a covariance over a
+		// stream of samples: every add() is a herk with beta = 1 into the upper
+		// triangle of the running sum, so only the n x n result is ever held.
+		template<typename T>
+		class GramAccumulator {
+		public:
+			explicit GramAccumulator(size_t columns) : upper_(columns, columns) {}
+
+			void add(const MatrixView<const T>& rows) {
+				if (rows.get_columns() != upper_.get_columns()) {
+					throw std::invalid_argument("Row block must have as many columns as the accumulator");
+				}
+				MATRIXLIB_ALLOCATION_SCOPE("Algebra::Blas::GramAccumulator::add");
+				herk<T>(NormType<T>{ 1 }, rows, Op::conjugate_transpose, NormType<T>{ 1 }, Core::view(upper_));
+				rows_ += rows.get_rows();
+			}
+			template<typename Allocator>
+			void add(const Core::Matrix<T, Allocator>& rows) {
+				add(Core::view(rows));
+			}
+
+			[[nodiscard]] size_t columns() const noexcept { return upper_.get_columns(); }
+			// Rows added since construction or the last reset().
+			[[nodiscard]] size_t rows() const noexcept { return rows_; }
+
+			// The sum so far, both triangles filled.
+			[[nodiscard]] Core::Matrix<T> result() const {
+				Core::Matrix<T> full = upper_;
+				Core::Kernels::mirror_triangle(Core::view(full), Triangle::upper, true);
+				full.set_structure(Core::StructureTag(Core::Traits::is_complex<T>::value ? Core::Structure::hermitian : Core::Structure::symmetric));
+				return full;
+			}
+
+			void reset() {
+				upper_.fill(T{ 0 });
+				rows_ = 0;
+			}
+
+		private:
+			static_assert(
+				Core::Traits::is_valid_matrix_type<T>::value,
+				"GramAccumulator<T> requires T to be either float, double, long double or ComplexNumber<float/double/long double>");
+
+			Core::Matrix<T> upper_;
+			size_t rows_ = 0;
+		};
+
+	}
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <complex>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../core/allocation_tracker.h"
+#include "../core/gemm_kernel.h"
+#include "../core/instrumentation.h"
+#include "../core/matrix.h"
+#include "../core/matrix_view.h"
+#include "../core/structure.h"
+
+// Products of several matrices in the cheapest association.
+//
+// A * B * C * v goes through operator* left to right, so a chain ending in a
+// vector still forms every n x n intermediate product. multiply_chain picks
+// the parenthesization with the classic O(p^3) dynamic program over the p
+// operands and then evaluates it. The cost of one product is the number of
+// multiply-adds the kernel Matrix::operator* would pick actually performs:
+// m k n for gemm, fewer when an operand is tagged banded (triangular and
+// diagonal included) and only its band is visited, m n for an identity
+// factor, which is just copied. Tags of intermediate products follow
+// Core::product_structure, so a diagonal scaling stays cheap wherever it
+// lands in the order.
+
+namespace Algebra {
+	namespace Operations {
+
+		using Core::Matrix;
+
+		struct ChainOperand {
+			size_t rows = 0;
+			size_t columns = 0;
+			Core::StructureTag structure;
+		};
+
+		// Optimal association of a chain of operands; operand i is written
+		// A<i> by to_string.
+		class ChainPlan {
+		public:
+			explicit ChainPlan(std::vector<ChainOperand> operands) : operands_(std::move(operands)) {
+				const size_t p = operands_.size();
+				if (p == 0) {
+					throw std::invalid_argument("Matrix chain must not be empty");
+				}
+				for (size_t i = 0; i + 1 < p; ++i) {
+					if (operands_[i].columns != operands_[i + 1].rows) {
+						throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
+					}
+				}
+
+				cost_.assign(p * p, 0.0);
+				split_.assign(p * p, 0);
+				structure_.assign(p * p, Core::StructureTag());
+				for (size_t i = 0; i < p; ++i) {
+					structure_[i * p + i] = operands_[i].structure;
+					for (size_t j = i + 1; j < p; ++j) {
+						structure_[i * p + j] = Core::product_structure(structure_[i * p + j - 1], operands_[i].rows,
+							operands_[j].structure, operands_[j].rows, operands_[j].columns);
+					}
+				}
+				for (size_t length = 2; length <= p; ++length) {
+					for (size_t i = 0; i + length <= p; ++i) {
+						const size_t j = i + length - 1;
+						double best = std::numeric_limits<double>::infinity();
+						for (size_t k = i; k < j; ++k) {
+							const double candidate = cost_[i * p + k] + cost_[(k + 1) * p + j]
+								+ product_cost(operands_[i].rows, operands_[k].columns, operands_[j].columns,
+									structure_[i * p + k], structure_[(k + 1) * p + j]);
+							if (candidate < best) {
+								best = candidate;
+								split_[i * p + j] = k;
+							}
+						}
+						cost_[i * p + j] = best;
+					}
+				}
+			}
+
+			[[nodiscard]] size_t size() const noexcept { return operands_.size(); }
+			[[nodiscard]] const ChainOperand& operand(size_t i) const { return operands_.at(i); }
+			// Multiply-adds of the whole chain in the chosen order.
+			[[nodiscard]] double cost() const noexcept { return cost_[size() - 1]; }
+			// Last product of operands first..last is (first..k) * (k + 1..last).
+			[[nodiscard]] size_t split(size_t first, size_t last) const {
+				if (first >= last || last >= size()) {
+					throw std::out_of_range("Chain range must hold at least two operands");
+				}
+				return split_[first * size() + last];
+			}
+			[[nodiscard]] const Core::StructureTag& structure(size_t first, size_t last) const {
+				return structure_.at(first * size() + last);
+			}
+			[[nodiscard]] std::string to_string() const { return to_string(0, size() - 1); }
+
+			// Multiply-adds of an m x k by k x n product as Matrix::operator*
+			// performs it.
+			[[nodiscard]] static double product_cost(size_t m, size_t k, size_t n,
+				const Core::StructureTag& lhs, const Core::StructureTag& rhs) noexcept {
+				if (lhs.kind() == Core::Structure::identity || rhs.kind() == Core::Structure::identity) {
+					return static_cast<double>(m) * static_cast<double>(n);
+				}
+				const size_t lhs_width = std::min(k, lhs.lower_bandwidth(m) + lhs.upper_bandwidth(k) + 1);
+				const size_t rhs_width = std::min(n, rhs.lower_bandwidth(k) + rhs.upper_bandwidth(n) + 1);
+				return static_cast<double>(m) * static_cast<double>(lhs_width) * static_cast<double>(rhs_width);
+			}
+
+		private:
+			std::vector<ChainOperand> operands_;
+			std::vector<double> cost_;
+			std::vector<size_t> split_;
+			std::vector<Core::StructureTag> structure_;
+
+			[[nodiscard]] std::string to_string(size_t first, size_t last) const {
+				if (first == last) {
+					return "A" + std::to_string(first);
+				}
+				const size_t k = split(first, last);
+				return "(" + to_string(first, k) + " " + to_string(k + 1, last) + ")";
+			}
+		};
+
+		namespace Detail {
+
+			// Evaluates a ChainPlan. Intermediate products live in a pool and go
+			// back to it once consumed, so a later product of the same shape
+			// writes into an existing buffer instead of allocating.
+			template<typename T>
+			class ChainEvaluator {
+			public:
+				ChainEvaluator(const ChainPlan& plan, const std::vector<const Matrix<T>*>& operands)
+					: plan_(plan), operands_(operands) {
+				}
+
+				Matrix<T> run() {
+					if (plan_.size() == 1) {
+						return *operands_[0];
+					}
+					const size_t slot = evaluate(0, plan_.size() - 1);
+					return std::move(pool_[slot]);
+				}
+
+			private:
+				static constexpr size_t operand_slot = std::numeric_limits<size_t>::max();
+
+				const ChainPlan& plan_;
+				const std::vector<const Matrix<T>*>& operands_;
+				std::deque<Matrix<T>> pool_;
+				std::vector<bool> busy_;
+
+				// Slot of the pool holding the product of first..last;
+				// operand_slot for a single operand.
+				size_t evaluate(size_t first, size_t last) {
+					if (first == last) {
+						return operand_slot;
+					}
+					const size_t k = plan_.split(first, last);
+					const size_t left = evaluate(first, k);
+					const size_t right = evaluate(k + 1, last);
+					const Matrix<T>& lhs = left == operand_slot ? *operands_[first] : pool_[left];
+					const Matrix<T>& rhs = right == operand_slot ? *operands_[last] : pool_[right];
+
+					const size_t slot = acquire(lhs.get_rows(), rhs.get_columns());
+					multiply_into(lhs, rhs, plan_.structure(first, last), pool_[slot]);
+					release(left);
+					release(right);
+					return slot;
+				}
+
+				size_t acquire(size_t rows, size_t columns) {
+					for (size_t slot = 0; slot < pool_.size(); ++slot) {
+						if (!busy_[slot] && pool_[slot].get_rows() == rows && pool_[slot].get_columns() == columns) {
+							busy_[slot] = true;
+							return slot;
+						}
+					}
+					pool_.emplace_back(rows, columns);
+					busy_.push_back(true);
+					return pool_.size() - 1;
+				}
+				void release(size_t slot) {
+					if (slot != operand_slot) {
+						busy_[slot] = false;
+					}
+				}
+
+				// The kernel choice of Matrix::operator*, into a reused buffer.
+				static void multiply_into(const Matrix<T>& lhs, const Matrix<T>& rhs,
+					const Core::StructureTag& structure, Matrix<T>& result) {
+					const Core::StructureTag& lhs_tag = lhs.structure();
+					const Core::StructureTag& rhs_tag = rhs.structure();
+					if (lhs_tag.kind() == Core::Structure::identity) {
+						result.assign(rhs);
+						return;
+					}
+					if (rhs_tag.kind() == Core::Structure::identity) {
+						result.assign(lhs);
+						return;
+					}
+					if (lhs_tag.has_band(lhs.get_rows(), lhs.get_columns()) || rhs_tag.has_band(rhs.get_rows(), rhs.get_columns())) {
+						result.fill(T{ 0 });
+						Core::Kernels::banded_multiply(Core::MatrixView<const T>(lhs),
+							lhs_tag.lower_bandwidth(lhs.get_rows()), lhs_tag.upper_bandwidth(lhs.get_columns()),
+							Core::MatrixView<const T>(rhs),
+							rhs_tag.lower_bandwidth(rhs.get_rows()), rhs_tag.upper_bandwidth(rhs.get_columns()),
+							Core::view(result));
+						result.set_structure(structure);
+						return;
+					}
+					Core::Kernels::gemm(T{ 1 }, Core::MatrixView<const T>(lhs), Core::Op::no_transpose,
+						Core::MatrixView<const T>(rhs), Core::Op::no_transpose, T{ 0 }, Core::view(result));
+					result.set_structure(Core::StructureTag());
+				}
+			};
+
+		}
+
+		template<typename T>
+		[[nodiscard]] ChainPlan plan_chain(const std::vector<const Matrix<T>*>& operands) {
+			std::vector<ChainOperand> shapes;
+			shapes.reserve(operands.size());
+			for (const Matrix<T>* operand : operands) {
+				shapes.push_back({ operand->get_rows(), operand->get_columns(), operand->structure() });
+			}
+			return ChainPlan(std::move(shapes));
+		}
+
+		// operands[0] * operands[1] * ... in the association of plan_chain.
+		template<typename T>
+		[[nodiscard]] Matrix<T> multiply_chain(const std::vector<const Matrix<T>*>& operands) {
+			const ChainPlan plan = plan_chain(operands);
+			MATRIXLIB_PROFILE_ZONE("Algebra::Operations::multiply_chain", 2 * static_cast<size_t>(plan.cost()),
+				plan.operand(0).rows * plan.operand(plan.size() - 1).columns * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Operations::multiply_chain");
+			return Detail::ChainEvaluator<T>(plan, operands).run();
+		}
+
+		template<typename T>
+		using ChainList = std::initializer_list<std::reference_wrapper<const Matrix<T>>>;
+
+		namespace Detail {
+
+			template<typename T>
+			[[nodiscard]] Matrix<T> multiply_chain_list(ChainList<T> operands) {
+				std::vector<const Matrix<T>*> pointers;
+				pointers.reserve(operands.size());
+				for (const Matrix<T>& operand : operands) {
+					pointers.push_back(&operand);
+				}
+				return multiply_chain(pointers);
+			}
+
+		}
+
+		// multiply_chain({ a, b, c }). T cannot be deduced through a list of
+		// reference_wrappers, so there is one overload per element type.
+		[[nodiscard]] inline Matrix<float> multiply_chain(ChainList<float> operands) {
+			return Detail::multiply_chain_list<float>(operands);
+		}
+		[[nodiscard]] inline Matrix<double> multiply_chain(ChainList<double> operands) {
+			return Detail::multiply_chain_list<double>(operands);
+		}
+		[[nodiscard]] inline Matrix<long double> multiply_chain(ChainList<long double> operands) {
+			return Detail::multiply_chain_list<long double>(operands);
+		}
+		[[nodiscard]] inline Matrix<std::complex<float>> multiply_chain(ChainList<std::complex<float>> operands) {
+			return Detail::multiply_chain_list<std::complex<float>>(operands);
+		}
+		[[nodiscard]] inline Matrix<std::complex<double>> multiply_chain(ChainList<std::complex<double>> operands) {
+			return Detail::multiply_chain_list<std::complex<double>>(operands);
+		}
+		[[nodiscard]] inline Matrix<std::complex<long double>> multiply_chain(ChainList<std::complex<long double>> operands) {
+			return Detail::multiply_chain_list<std::complex<long double>>(operands);
+		}
+
+		template<typename T, typename... Rest>
+		[[nodiscard]] Matrix<T> multiply_chain(const Matrix<T>& first, const Matrix<T>& second, const Rest&... rest) {
+			return multiply_chain(std::vector<const Matrix<T>*>{ &first, &second, &rest... });
+		}
+
+	}
+}
@@ -0,0 +1,590 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/allocation_tracker.h"
+#include "../core/instrumentation.h"
+#include "../core/matrix.h"
+#include "../core/type_traits.h"
+#include "../decompositions/lup_decomposition.h"
+#include "../decompositions/schur_decomposition.h"
+#include "norms.h"
+
+// Matrix exponential, logarithm and square root.
+//
+// expm is the scaling-and-squaring Pade method of Higham (2005) with the
+// degree and scaling chosen from ||A^k||_1^(1/k) as in Al-Mohy and Higham
+// (2009): the powers A^2, A^4 and A^6 are needed by the approximant anyway,
+// so their exact 1-norms bound the series more tightly than ||A||_1 at no
+// extra product, and degrees 3..9 are tried before any power they do not use
+// is formed. The theta_m bounds are the double precision ones; float gets
+// at least that accuracy, long double does not get its full precision.
+//
+// expm_multiply forms exp(tA) B by a truncated Taylor series with scaling
+// (Al-Mohy and Higham, 2011), using only products A X with the n x k block.
+//
+// sqrtm and logm work on the complex Schur form A = Q T Q^H: sqrtm by the
+// Bjorck-Hammarling recurrence on T, logm by inverse scaling and squaring
+// (square roots of T until ||T - I||_1 <= theta_7, then the [7/7] Pade
+// approximant of log(I + X) as a 7-point Gauss-Legendre sum). Real input
+// gives a real result; one without a real principal root or logarithm (an
+// eigenvalue on the closed negative real axis) throws std::runtime_error.
+//
+// matrix_power and polyval evaluate A^k and p(A) with as few products as
+// the exponent or degree allows, writing each into reused buffers.
+
+namespace Algebra {
+	namespace Functions {
+
+		using Core::Matrix;
+		using Core::Traits::is_complex;
+		using Core::Traits::NormType;
+
+		namespace Detail {
+
+			template<typename T>
+			Matrix<T> identity(size_t n) {
+				Matrix<T> result(n, n);
+				result.identity_matrix(T{ 1 });
+				return result;
+			}
+
+			// target += alpha * x
+			template<typename T>
+			void add_scaled(Matrix<T>& target, const T& alpha, const Matrix<T>& x) {
+				for (size_t i = 0; i < target.get_rows(); ++i) {
+					T* row = target(i).data();
+					const T* source = x(i).data();
+					for (size_t j = 0; j < target.get_columns(); ++j) {
+						row[j] += alpha * source[j];
+					}
+				}
+			}
+
+			// target = alpha * I + sum_k coefficients[k] * powers[k]
+			template<typename T>
+			Matrix<T> combination(size_t n, double alpha, const std::vector<const Matrix<T>*>& powers, const std::vector<double>& coefficients) {
+				Matrix<T> result(n, n);
+				for (size_t i = 0; i < n; ++i) {
+					result(i)[i] = T(alpha);
+				}
+				for (size_t k = 0; k < powers.size(); ++k) {
+					add_scaled(result, T(coefficients[k]), *powers[k]);
+				}
+				return result;
+			}
+
+			template<typename T>
+			NormType<T> one_norm(const Matrix<T>& matrix) {
+				return Norms::inductive_l_one_norm_columns(matrix);
+			}
+
+			// Pade coefficients b_0..b_m of exp, Higham (2005).
+			inline const std::vector<double>& pade_coefficients(size_t m) {
+				static const std::vector<double> b3{ 120., 60., 12., 1. };
+				static const std::vector<double> b5{ 30240., 15120., 3360., 420., 30., 1. };
+				static const std::vector<double> b7{ 17297280., 8648640., 1995840., 277200., 25200., 1512., 56., 1. };
+				static const std::vector<double> b9{ 17643225600., 8821612800., 2075673600., 302702400., 30270240.,
+					2162160., 110880., 3960., 90., 1. };
+				static const std::vector<double> b13{ 64764752532480000., 32382376266240000., 7771770303897600.,
+					1187353796428800., 129060195264000., 10559470521600., 670442572800., 33522128640.,
+					1323241920., 40840800., 960960., 16380., 182., 1. };
+				switch (m) {
+				case 3: return b3;
+				case 5: return b5;
+				case 7: return b7;
+				case 9: return b9;
+				default: return b13;
+				}
+			}
+
+			// Largest ||A||-type bound for which the [m/m] approximant is exact to
+			// double precision.
+			inline constexpr double theta_3 = 1.495585217958292e-2;
+			inline constexpr double theta_5 = 2.539398330063230e-1;
+			inline constexpr double theta_7 = 9.504178996162932e-1;
+			inline constexpr double theta_9 = 2.097847961257068e0;
+			inline constexpr double theta_13 = 4.25;
+
+			template<typename T>
+			Matrix<T> solve_pade(const Matrix<T>& u, const Matrix<T>& v) {
+				Matrix<T> numerator(v);
+				Matrix<T> denominator(v);
+				add_scaled(numerator, T{ 1 }, u);
+				add_scaled(denominator, T{ -1 }, u);
+				return Decompositions::LUP_Decomposition::Lup_Decomposition<T>(denominator).solve(numerator);
+			}
+
+			// r_m(A) = (V - U)^-1 (V + U) for m <= 9 from the even powers
+			// A^2, A^4, ... (powers[i] = A^(2i + 2)).
+			template<typename T>
+			Matrix<T> pade_low(const Matrix<T>& a, const std::vector<const Matrix<T>*>& powers, size_t m) {
+				const size_t n = a.get_rows();
+				const std::vector<double>& b = pade_coefficients(m);
+				std::vector<double> odd;
+				std::vector<double> even;
+				for (size_t k = 1; 2 * k <= m; ++k) {
+					even.push_back(b[2 * k]);
+					odd.push_back(b[2 * k + 1]);
+				}
+				const Matrix<T> inner = combination(n, b[1], powers, odd);
+				const Matrix<T> u = a * inner;
+				const Matrix<T> v = combination(n, b[0], powers, even);
+				return solve_pade(u, v);
+			}
+
+			// U = A [A6 (b13 A6 + b11 A4 + b9 A2) + b7 A6 + b5 A4 + b3 A2 + b1 I],
+			// V = A6 (b12 A6 + b10 A4 + b8 A2) + b6 A6 + b4 A4 + b2 A2 + b0 I.
+			template<typename T>
+			Matrix<T> pade_13(const Matrix<T>& a, const Matrix<T>& a2, const Matrix<T>& a4, const Matrix<T>& a6) {
+				const size_t n = a.get_rows();
+				const std::vector<double>& b = pade_coefficients(13);
+				const std::vector<const Matrix<T>*> powers{ &a2, &a4, &a6 };
+				const Matrix<T> inner_u = combination(n, 0.0, powers, { b[9], b[11], b[13] });
+				Matrix<T> outer_u = combination(n, b[1], powers, { b[3], b[5], b[7] });
+				Core::Kernels::gemm(T{ 1 }, Core::view(a6), Core::Op::no_transpose, Core::view(inner_u), Core::Op::no_transpose,
+					T{ 1 }, Core::view(outer_u));
+				const Matrix<T> u = a * outer_u;
+				const Matrix<T> inner_v = combination(n, 0.0, powers, { b[8], b[10], b[12] });
+				Matrix<T> v = combination(n, b[0], powers, { b[2], b[4], b[6] });
+				Core::Kernels::gemm(T{ 1 }, Core::view(a6), Core::Op::no_transpose, Core::view(inner_v), Core::Op::no_transpose,
+					T{ 1 }, Core::view(v));
+				return solve_pade(u, v);
+			}
+
+			template<typename T>
+			Matrix<T> scaled(const Matrix<T>& matrix, NormType<T> factor) {
+				Matrix<T> result(matrix);
+				for (size_t i = 0; i < result.get_rows(); ++i) {
+					for (T& value : result(i)) {
+						value *= factor;
+					}
+				}
+				return result;
+			}
+
+			// Upper triangular R with R^2 = T (Bjorck-Hammarling), column by
+			// column; uses the principal branch on the diagonal.
+			template<typename C>
+			Matrix<C> triangular_sqrt(const Matrix<C>& t) {
+				const size_t n = t.get_rows();
+				Matrix<C> r(n, n);
+				const Matrix<C>& solved = r;
+				for (size_t j = 0; j < n; ++j) {
+					r(j)[j] = std::sqrt(t(j, j));
+					for (size_t i = j; i-- > 0;) {
+						const C* row = solved(i).data();
+						C sum = t(i, j);
+						for (size_t k = i + 1; k < j; ++k) {
+							sum -= row[k] * solved(k, j);
+						}
+						const C denominator = solved(i, i) + solved(j, j);
+						if (denominator == C{}) {
+							if (sum != C{}) {
+								throw std::runtime_error("Matrix has no square root");
+							}
+							r(i)[j] = C{};
+						}
+						else {
+							r(i)[j] = sum / denominator;
+						}
+					}
+				}
+				return r;
+			}
+
+			// log T for upper triangular T by inverse scaling and squaring.
+			template<typename C>
+			Matrix<C> triangular_log(Matrix<C> t) {
+				using R = typename C::value_type;
+				const size_t n = t.get_rows();
+				constexpr double theta = 2.64e-1;
+				constexpr size_t max_square_roots = 64;
+				const Matrix<C> identity_matrix = identity<C>(n);
+
+				size_t roots = 0;
+				Matrix<C> x = t;
+				add_scaled(x, C(-1), identity_matrix);
+				while (one_norm(x) > R(theta)) {
+					if (++roots > max_square_roots) {
+						throw std::runtime_error("Matrix logarithm did not converge");
+					}
+					t = triangular_sqrt(t);
+					x = t;
+					add_scaled(x, C(-1), identity_matrix);
+				}
+
+				// log(I + X) = sum_j w_j X (I + x_j X)^-1 with Gauss-Legendre
+				// nodes x_j and weights w_j on [0, 1].
+				static const double nodes[] = { 0.0, 0.4058451513773972, -0.4058451513773972, 0.7415311855993945,
+					-0.7415311855993945, 0.9491079123427585, -0.9491079123427585 };
+				static const double weights[] = { 0.4179591836734694, 0.3818300505051189, 0.3818300505051189,
+					0.2797053914892766, 0.2797053914892766, 0.1294849661688697, 0.1294849661688697 };
+				Matrix<C> result(n, n);
+				Matrix<C> y(n, n);
+				const Matrix<C>& solved = y;
+				for (size_t q = 0; q < 7; ++q) {
+					const R node = R((nodes[q] + 1.0) / 2.0);
+					const C weight = C(R(weights[q] / 2.0));
+					// (I + node X) Y = X; both are upper triangular, and so is Y.
+					for (size_t j = 0; j < n; ++j) {
+						for (size_t i = j + 1; i-- > 0;) {
+							const C* row = x(i).data();
+							C sum = row[j];
+							for (size_t k = i + 1; k <= j; ++k) {
+								sum -= node * row[k] * solved(k, j);
+							}
+							y(i)[j] = sum / (C(1) + node * row[i]);
+						}
+					}
+					add_scaled(result, weight, y);
+				}
+				return scaled(result, std::ldexp(R(1), static_cast<int>(roots)));
+			}
+
+			// Back from the Schur basis, Q F Q^H; real T keeps the real part,
+			// the imaginary one being rounding for a real primary function.
+			template<typename T, typename C>
+			Matrix<T> from_schur(const Matrix<C>& q, const Matrix<C>& f) {
+				const Matrix<C> product = (q * f) * Core::adjoint(q);
+				if constexpr (is_complex<T>::value) {
+					return product;
+				}
+				else {
+					Matrix<T> result(product.get_rows(), product.get_columns());
+					for (size_t i = 0; i < result.get_rows(); ++i) {
+						for (size_t j = 0; j < result.get_columns(); ++j) {
+							result(i)[j] = product(i, j).real();
+						}
+					}
+					return result;
+				}
+			}
+
+			// A real principal square root or logarithm needs no eigenvalue on
+			// the negative real axis.
+			template<typename T, typename C>
+			void check_real_principal(const std::vector<C>& eigenvalues, const char* message) {
+				if constexpr (!is_complex<T>::value) {
+					using R = typename C::value_type;
+					const R tolerance = std::sqrt(std::numeric_limits<R>::epsilon());
+					for (const C& value : eigenvalues) {
+						if (value.real() < R{ 0 } && std::abs(value.imag()) <= tolerance * std::abs(value)) {
+							throw std::runtime_error(message);
+						}
+					}
+				}
+			}
+
+		}
+
+		template<typename T>
+		Matrix<T> expm(const Matrix<T>& a) {
+			using R = NormType<T>;
+			const size_t n = a.get_rows();
+			if (!a.is_square()) {
+				throw std::invalid_argument("Matrix exponential requires square matrix");
+			}
+			MATRIXLIB_PROFILE_ZONE("Algebra::Functions::expm", 2 * 10 * n * n * n, 8 * n * n * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Functions::expm");
+			if (n == 0) {
+				return Matrix<T>();
+			}
+			if (a.structure().kind() == Core::Structure::diagonal) {
+				Matrix<T> result(n, n);
+				for (size_t i = 0; i < n; ++i) {
+					result(i)[i] = std::exp(a(i, i));
+				}
+				result.set_structure(Core::StructureTag(Core::Structure::diagonal));
+				return result;
+			}
+
+			const R norm = Detail::one_norm(a);
+			const Matrix<T> a2 = a * a;
+			if (norm <= R(Detail::theta_3)) {
+				return Detail::pade_low(a, { &a2 }, 3);
+			}
+			const Matrix<T> a4 = a2 * a2;
+			if (norm <= R(Detail::theta_5)) {
+				return Detail::pade_low(a, { &a2, &a4 }, 5);
+			}
+			const Matrix<T> a6 = a4 * a2;
+			const R norm4 = Detail::one_norm(a4);
+			const R norm6 = Detail::one_norm(a6);
+			// eta_1 = max(||A^4||^(1/4), ||A^6||^(1/6)) also bounds
+			// ||A^8||^(1/8) <= ||A^4||^(1/4), so it serves every degree up to 9.
+			const R eta = std::max(std::pow(norm4, R(0.25)), std::pow(norm6, R(1) / R(6)));
+			if (eta <= R(Detail::theta_3)) {
+				return Detail::pade_low(a, { &a2 }, 3);
+			}
+			if (eta <= R(Detail::theta_5)) {
+				return Detail::pade_low(a, { &a2, &a4 }, 5);
+			}
+			if (eta <= R(Detail::theta_7)) {
+				return Detail::pade_low(a, { &a2, &a4, &a6 }, 7);
+			}
+			if (eta <= R(Detail::theta_9)) {
+				const Matrix<T> a8 = a4 * a4;
+				return Detail::pade_low(a, { &a2, &a4, &a6, &a8 }, 9);
+			}
+
+			// ||A^10||^(1/10) <= (||A^4|| ||A^6||)^(1/10).
+			const R eta_13 = std::min(eta, std::max(std::pow(norm4, R(0.25)), std::pow(norm4 * norm6, R(0.1))));
+			const int squarings = std::max(0, static_cast<int>(std::ceil(std::log2(eta_13 / R(Detail::theta_13)))));
+			const R scale = std::ldexp(R(1), -squarings);
+			Matrix<T> result = Detail::pade_13(Detail::scaled(a, scale), Detail::scaled(a2, scale * scale),
+				Detail::scaled(a4, std::pow(scale, 4)), Detail::scaled(a6, std::pow(scale, 6)));
+			for (int k = 0; k < squarings; ++k) {
+				result = result * result;
+			}
+			return result;
+		}
+
+		// exp(tA) B without forming exp(tA): B is n x k. A is shifted by
+		// mu = trace(A) / n, the series length m and step count s minimise m s
+		// subject to ||t (A - mu I)||_1 / s <= theta_m, and each step stops
+		// early once two consecutive terms are below the unit roundoff
+		// relative to the partial sum.
+		template<typename T>
+		Matrix<T> expm_multiply(const Matrix<T>& a, const Matrix<T>& b, const T& t = T{ 1 }) {
+			using R = NormType<T>;
+			const size_t n = a.get_rows();
+			if (!a.is_square()) {
+				throw std::invalid_argument("Matrix exponential requires square matrix");
+			}
+			if (b.get_rows() != n) {
+				throw std::invalid_argument("Block of vectors must have as many rows as the matrix");
+			}
+			MATRIXLIB_PROFILE_ZONE("Algebra::Functions::expm_multiply", 0, 0);
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Functions::expm_multiply");
+			if (n == 0 || b.get_columns() == 0) {
+				return b;
+			}
+
+			// theta_m of the degree-m Taylor series, m = 1..30, double precision.
+			static const double theta[] = { 2.22e-16, 2.58e-8, 1.38e-5, 3.39e-4, 2.40e-3, 9.06e-3, 2.38e-2, 4.99e-2,
+				8.95e-2, 1.44e-1, 2.14e-1, 2.99e-1, 3.99e-1, 5.13e-1, 6.41e-1, 7.80e-1, 9.30e-1, 1.09, 1.26, 1.43,
+				1.62, 1.81, 2.01, 2.21, 2.42, 2.64, 2.85, 3.07, 3.30, 3.52 };
+
+			T mu{};
+			for (size_t i = 0; i < n; ++i) {
+				mu += a(i, i);
+			}
+			mu /= static_cast<R>(n);
+			Matrix<T> shifted(a);
+			for (size_t i = 0; i < n; ++i) {
+				shifted(i)[i] -= mu;
+			}
+
+			const R norm = std::abs(t) * Detail::one_norm(shifted);
+			size_t degree = 0;
+			size_t steps = 1;
+			if (norm > R{ 0 }) {
+				double best = std::numeric_limits<double>::infinity();
+				for (size_t m = 1; m <= std::size(theta); ++m) {
+					const double s = std::max(1.0, std::ceil(static_cast<double>(norm) / theta[m - 1]));
+					if (static_cast<double>(m) * s < best) {
+						best = static_cast<double>(m) * s;
+						degree = m;
+						steps = static_cast<size_t>(s);
+					}
+				}
+			}
+
+			const R tolerance = std::numeric_limits<R>::epsilon() / R(2);
+			const T step_factor = std::exp(t * mu / static_cast<R>(steps));
+			Matrix<T> f(b);
+			Matrix<T> term(b);
+			for (size_t step = 0; step < steps; ++step) {
+				R previous = Norms::inductive_l_one_norm_rows(term);
+				for (size_t j = 1; j <= degree; ++j) {
+					term = shifted * term;
+					const T coefficient = t / static_cast<R>(steps * j);
+					for (size_t i = 0; i < n; ++i) {
+						for (T& value : term(i)) {
+							value *= coefficient;
+						}
+					}
+					Detail::add_scaled(f, T{ 1 }, term);
+					const R current = Norms::inductive_l_one_norm_rows(term);
+					if (previous + current <= tolerance * Norms::inductive_l_one_norm_rows(f)) {
+						break;
+					}
+					previous = current;
+				}
+				for (size_t i = 0; i < n; ++i) {
+					for (T& value : f(i)) {
+						value *= step_factor;
+					}
+				}
+				term = f;
+			}
+			return f;
+		}
+
+		// Principal square root, the X with X^2 = A whose eigenvalues have
+		// positive real part.
+		template<typename T>
+		Matrix<T> sqrtm(const Matrix<T>& a) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Functions::sqrtm", 28 * a.get_rows() * a.get_rows() * a.get_rows(),
+				6 * a.get_rows() * a.get_rows() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Functions::sqrtm");
+			const Decompositions::SCHUR_Decomposition::Schur_Decomposition<T> schur(a);
+			Detail::check_real_principal<T>(schur.eigenvalues(), "Matrix has no real principal square root");
+			return Detail::from_schur<T>(schur.get_Q(), Detail::triangular_sqrt(schur.get_T()));
+		}
+
+		// Principal logarithm, the X with exp(X) = A whose eigenvalues have
+		// imaginary part in (-pi, pi). Throws for a singular matrix.
+		template<typename T>
+		Matrix<T> logm(const Matrix<T>& a) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Functions::logm", 40 * a.get_rows() * a.get_rows() * a.get_rows(),
+				8 * a.get_rows() * a.get_rows() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Functions::logm");
+			const Decompositions::SCHUR_Decomposition::Schur_Decomposition<T> schur(a);
+			const auto eigenvalues = schur.eigenvalues();
+			for (const auto& value : eigenvalues) {
+				if (value == decltype(value){}) {
+					throw std::runtime_error("Matrix is singular and has no logarithm");
+				}
+			}
+			Detail::check_real_principal<T>(eigenvalues, "Matrix has no real principal logarithm");
+			return Detail::from_schur<T>(schur.get_Q(), Detail::triangular_log(schur.get_T()));
+		}
+
+		// A^k by binary exponentiation: floor(log2 k) squarings and one product
+		// per further set bit of k. Every product is a gemm into one of two
+		// preallocated buffers that then trade places, so the loop allocates
+		// nothing; passing A as an rvalue reuses its storage as the first of
+		// them.
+		template<typename T>
+		Matrix<T> matrix_power(Matrix<T>&& a, unsigned long long k) {
+			const size_t n = a.get_rows();
+			if (!a.is_square()) {
+				throw std::invalid_argument("Matrix power requires square matrix");
+			}
+			size_t products = 0;
+			for (unsigned long long bits = k; bits > 1; bits >>= 1) {
+				products += 1 + (bits & 1u);
+			}
+			MATRIXLIB_PROFILE_ZONE("Algebra::Functions::matrix_power", 2 * n * n * n * products, 3 * n * n * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Functions::matrix_power");
+			if (k == 0) {
+				return Detail::identity<T>(n);
+			}
+			if (a.structure().kind() == Core::Structure::identity) {
+				return std::move(a);
+			}
+			if (a.structure().kind() == Core::Structure::diagonal) {
+				for (size_t i = 0; i < n; ++i) {
+					a(i)[i] = std::pow(a(i, i), static_cast<NormType<T>>(k));
+				}
+				a.set_structure(Core::StructureTag(Core::Structure::diagonal));
+				return std::move(a);
+			}
+
+			Matrix<T> base = std::move(a);
+			Matrix<T> result;
+			Matrix<T> buffer(n, n);
+			for (;;) {
+				if (k & 1u) {
+					if (result.get_rows() == 0) {
+						result = base;
+					}
+					else {
+						Core::Kernels::gemm(T{ 1 }, Core::MatrixView<const T>(result), Core::Op::no_transpose,
+							Core::MatrixView<const T>(base), Core::Op::no_transpose, T{ 0 }, Core::view(buffer));
+						std::swap(result, buffer);
+					}
+				}
+				k >>= 1;
+				if (k == 0) {
+					break;
+				}
+				Core::Kernels::gemm(T{ 1 }, Core::MatrixView<const T>(base), Core::Op::no_transpose,
+					Core::MatrixView<const T>(base), Core::Op::no_transpose, T{ 0 }, Core::view(buffer));
+				std::swap(base, buffer);
+			}
+			return result;
+		}
+		template<typename T>
+		Matrix<T> matrix_power(const Matrix<T>& a, unsigned long long k) {
+			return matrix_power(Matrix<T>(a), k);
+		}
+
+		// p(A) = coefficients[0] I + coefficients[1] A + ... + coefficients[d] A^d
+		// by Paterson-Stockmeyer: with s ~ sqrt(d), A^2..A^s are formed once
+		// and p is evaluated as a polynomial in A^s whose coefficients are
+		// combinations of those powers, which takes s - 1 + floor(d / s)
+		// products (about 2 sqrt(d)) instead of d - 1 for Horner. The Horner
+		// steps in A^s write into two buffers used in turn. An rvalue A becomes
+		// the stored first power.
+		template<typename T>
+		Matrix<T> polyval(const std::vector<T>& coefficients, Matrix<T>&& a) {
+			const size_t n = a.get_rows();
+			if (!a.is_square()) {
+				throw std::invalid_argument("Matrix polynomial requires square matrix");
+			}
+			size_t degree = coefficients.size();
+			while (degree > 0 && coefficients[degree - 1] == T{ 0 }) {
+				--degree;
+			}
+			if (degree == 0) {
+				return Matrix<T>(n, n);
+			}
+			--degree;
+			const size_t step = std::max<size_t>(1, static_cast<size_t>(std::lround(std::sqrt(static_cast<double>(degree)))));
+			const size_t blocks = degree / step;
+			MATRIXLIB_PROFILE_ZONE("Algebra::Functions::polyval", 2 * n * n * n * (step - 1 + blocks), (step + 3) * n * n * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Functions::polyval");
+
+			// powers[j] = A^(j + 1), j < step.
+			std::vector<Matrix<T>> powers;
+			powers.reserve(step);
+			powers.push_back(std::move(a));
+			for (size_t j = 1; j < step && j < degree; ++j) {
+				powers.push_back(powers.back() * powers.front());
+			}
+
+			// B_k = sum_j coefficients[k step + j] A^j over j < step (the last
+			// block up to the degree), added onto target.
+			auto add_block = [&](Matrix<T>& target, size_t k) {
+				const size_t first = k * step;
+				const size_t last = std::min(degree, first + step - 1);
+				for (size_t i = 0; i < n; ++i) {
+					target(i)[i] += coefficients[first];
+				}
+				for (size_t j = first + 1; j <= last; ++j) {
+					if (coefficients[j] != T{ 0 }) {
+						Detail::add_scaled(target, coefficients[j], powers[j - first - 1]);
+					}
+				}
+			};
+
+			Matrix<T> result(n, n);
+			add_block(result, blocks);
+			if (blocks == 0) {
+				return result;
+			}
+			const Matrix<T>& stride = powers[step - 1];
+			Matrix<T> buffer(n, n);
+			for (size_t k = blocks; k-- > 0;) {
+				Core::Kernels::gemm(T{ 1 }, Core::MatrixView<const T>(result), Core::Op::no_transpose,
+					Core::MatrixView<const T>(stride), Core::Op::no_transpose, T{ 0 }, Core::view(buffer));
+				add_block(buffer, k);
+				std::swap(result, buffer);
+			}
+			return result;
+		}
+		template<typename T>
+		Matrix<T> polyval(const std::vector<T>& coefficients, const Matrix<T>& a) {
+			return polyval(coefficients, Matrix<T>(a));
+		}
+
+	}
+}
@@ -3,62 +3,110 @@
 #include <complex>
 #include <vector>
 
+#include "../core/allocation_tracker.h"
+#include "../core/instrumentation.h"
 #include "../core/matrix.h"
+#include "../core/transpose_kernel.h"
 #include "../core/type_traits.h"
 #include "../decompositions/lup_decomposition.h"
+#include "small_kernels.h"
 
 namespace Algebra {
 	namespace Operations {
 
 		using Core::Traits::is_complex;
 
-		template<typename T>
-		Core::Matrix<T> transpose(const Core::Matrix<T>& matrix) {
-			Core::Matrix<T> result(matrix.get_columns(), matrix.get_rows());
-			for (size_t i = 0; i < matrix.get_rows(); ++i) {
-				for (size_t j = 0; j < matrix.get_columns(); ++j) {
-					result(j, i) = matrix(i, j);
-				}
-			}
+		// Tiled transpose (see core/transpose_kernel.h), split across threads for
+		// large matrices.
+		template<typename T, typename Allocator>
+		Core::Matrix<T, Allocator> transpose(const Core::Matrix<T, Allocator>& matrix) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Operations::transpose", 0, 2 * matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Operations::transpose");
+			Core::Matrix<T, Allocator> result(matrix.get_columns(), matrix.get_rows(), matrix.get_allocator());
+			Core::Kernels::transpose(Core::view(matrix), Core::view(result));
 
 			return result;
 		}
-		template<typename T>
-		Core::Matrix<T> transpose(Core::Matrix<T>&& matrix) {
-			Core::Matrix<T> result(matrix.get_columns(), matrix.get_rows());
-			for (size_t i = 0; i < matrix.get_rows(); ++i) {
-				for (size_t j = 0; j < matrix.get_columns(); ++j) {
-					result(j, i) = std::move(matrix(i, j));
-				}
+		// A square matrix is transposed in its own storage. Rows are separate
+		// buffers, so a rectangular one changes the shape of every row and
+		// still needs new rows.
+		template<typename T, typename Allocator>
+		Core::Matrix<T, Allocator> transpose(Core::Matrix<T, Allocator>&& matrix) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Operations::transpose", 0, 2 * matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Operations::transpose");
+			if (matrix.get_rows() == matrix.get_columns()) {
+				Core::Kernels::transpose_in_place(Core::view(matrix));
+				return std::move(matrix);
 			}
+			Core::Matrix<T, Allocator> result(matrix.get_columns(), matrix.get_rows(), matrix.get_allocator());
+			Core::Kernels::transpose(Core::MatrixView<const T>(matrix), Core::view(result));
+			matrix = Core::Matrix<T, Allocator>();
 
 			return result;
 		}
 
 
-		template<typename T>
-		typename std::enable_if <is_complex<T>::value, Core::Matrix<T>>::type
-			hermitian_matrix(const Core::Matrix<T>& matrix) {
-			Core::Matrix<T> result(matrix.get_columns(), matrix.get_rows());
-			for (size_t i = 0; i < matrix.get_rows(); ++i) {
-				for (size_t j = 0; j < matrix.get_columns(); ++j) {
-					result(j, i) = std::conj(matrix(i, j));
-				}
+		// The conjugation is applied while the tiles are written, not in a
+		// second sweep.
+		template<typename T, typename Allocator>
+		typename std::enable_if <is_complex<T>::value, Core::Matrix<T, Allocator>>::type
+			hermitian_matrix(const Core::Matrix<T, Allocator>& matrix) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Operations::hermitian_matrix", matrix.get_rows() * matrix.get_columns(),
+				2 * matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Operations::hermitian_matrix");
+			Core::Matrix<T, Allocator> result(matrix.get_columns(), matrix.get_rows(), matrix.get_allocator());
+			Core::Kernels::transpose(Core::view(matrix), Core::view(result), true);
+
+			return result;
+		}
+		template<typename T, typename Allocator>
+		typename std::enable_if_t<is_complex<T>::value, Core::Matrix<T, Allocator>>
+			hermitian_matrix(Core::Matrix<T, Allocator>&& matrix) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Operations::hermitian_matrix", matrix.get_rows() * matrix.get_columns(),
+				2 * matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Operations::hermitian_matrix");
+			if (matrix.get_rows() == matrix.get_columns()) {
+				Core::Kernels::transpose_in_place(Core::view(matrix), true);
+				return std::move(matrix);
 			}
+			Core::Matrix<T, Allocator> result(matrix.get_columns(), matrix.get_rows(), matrix.get_allocator());
+			Core::Kernels::transpose(Core::MatrixView<const T>(matrix), Core::view(result), true);
+			matrix = Core::Matrix<T, Allocator>();
 
 			return result;
 		}
+
+
+		// A^-1; closed form up to 4x4 (see small_kernels.h), LUP solves against
+		// the identity above that.
 		template<typename T>
-		typename std::enable_if_t<is_complex<T>::value, Core::Matrix<T>>
-			hermitian_matrix(Core::Matrix<T>&& matrix) {
-			for (auto& row : matrix) {
-				for (auto& elem : row) {
-					elem = std::conj(elem);
-				}
+		Core::Matrix<T> inverse(const Core::Matrix<T>& matrix) {
+			if (!matrix.is_square()) {
+				throw std::invalid_argument("Inverse requires square matrix");
 			}
-			return transpose(std::move(matrix));
+			if (matrix.get_rows() != 0 && matrix.get_rows() <= Small::max_size) {
+				return Small::inverse(matrix);
+			}
+			MATRIXLIB_PROFILE_ZONE("Algebra::Operations::inverse", 8 * matrix.get_rows() * matrix.get_rows() * matrix.get_rows() / 3,
+				2 * matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Operations::inverse");
+			Core::Matrix<T> identity(matrix.get_rows(), matrix.get_columns());
+			identity.identity_matrix(T{ 1 });
+			return Decompositions::LUP_Decomposition::Lup_Decomposition<T>(matrix).solve(identity);
 		}
 
+		// X with A X = B, dispatched like inverse.
+		template<typename T>
+		Core::Matrix<T> solve(const Core::Matrix<T>& a, const Core::Matrix<T>& b) {
+			if (!a.is_square()) {
+				throw std::invalid_argument("Solve requires square matrix");
+			}
+			if (a.get_rows() != 0 && a.get_rows() <= Small::max_size) {
+				return Small::solve(a, b);
+			}
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Operations::solve");
+			return Decompositions::LUP_Decomposition::Lup_Decomposition<T>(a).solve(b);
+		}
 
 	}
 }
\ No newline at end of file
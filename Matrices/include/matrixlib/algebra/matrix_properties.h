@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
+
 #include "../core/matrix.h"
+#include "../core/structure.h"
 #include "../core/type_traits.h"
 #include "../algebra/matrix_operations.h"
 
@@ -141,5 +144,79 @@ namespace Algebra {
 		}
 	
 
+		// Finds the narrowest structure that fits the matrix, in one pass over
+		// the entries (plus a symmetry check when no band is found). Kernels
+		// trust the tag, skipping entries outside the band or reading one
+		// triangle for the other, so only exact zeros, ones and mirrored
+		// entries count.
+		template<typename T>
+		[[nodiscard]] Core::StructureTag detect_structure(const Core::Matrix<T>& matrix) {
+			const size_t rows = matrix.get_rows();
+			const size_t columns = matrix.get_columns();
+			if (rows == 0 || columns == 0) {
+				return Core::StructureTag();
+			}
+
+			size_t lower = 0;
+			size_t upper = 0;
+			bool unit_diagonal = matrix.is_square();
+			for (size_t i = 0; i < rows; ++i) {
+				for (size_t j = 0; j < columns; ++j) {
+					if (matrix(i, j) == T{ 0 }) {
+						if (i == j) {
+							unit_diagonal = false;
+						}
+						continue;
+					}
+					if (i > j) {
+						lower = std::max(lower, i - j);
+					}
+					else if (j > i) {
+						upper = std::max(upper, j - i);
+					}
+					else if (matrix(i, j) != T{ 1 }) {
+						unit_diagonal = false;
+					}
+				}
+			}
+
+			if (lower == 0 && upper == 0 && unit_diagonal) {
+				return Core::StructureTag(Core::Structure::identity);
+			}
+			Core::StructureTag band = Core::StructureTag::banded(lower, upper, rows, columns);
+			if (!band.is_general() || !matrix.is_square()) {
+				return band;
+			}
+			bool symmetric = true;
+			bool hermitian = is_complex<T>::value;
+			for (size_t i = 0; i < rows && (symmetric || hermitian); ++i) {
+				if constexpr (is_complex<T>::value) {
+					hermitian = hermitian && matrix(i, i).imag() == 0;
+				}
+				for (size_t j = i + 1; j < columns; ++j) {
+					symmetric = symmetric && matrix(i, j) == matrix(j, i);
+					if constexpr (is_complex<T>::value) {
+						hermitian = hermitian && matrix(i, j) == std::conj(matrix(j, i));
+					}
+				}
+			}
+			if (hermitian) {
+				return Core::StructureTag(Core::Structure::hermitian);
+			}
+			if (symmetric) {
+				return Core::StructureTag(Core::Structure::symmetric);
+			}
+			return band;
+		}
+
+		// detect_structure, remembered on the matrix so later products, solves
+		// and determinants can use it.
+		template<typename T>
+		Core::StructureTag tag_structure(Core::Matrix<T>& matrix) {
+			Core::StructureTag structure = detect_structure(matrix);
+			matrix.set_structure(structure);
+			return structure;
+		}
+
 	}
 }
\ No newline at end of file
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
+#include <limits>
+#include <vector>
 
+#include "../core/instrumentation.h"
 #include "../core/matrix.h"
+#include "../core/parallel.h"
 #include "../core/type_traits.h"
 
 namespace Algebra {
@@ -10,97 +16,331 @@ namespace Algebra {
 
 		using Core::Traits::is_complex;
 
+		enum NormMask : unsigned {
+			frobenius = 1u << 0,
+			column_sum = 1u << 1,
+			row_sum = 1u << 2,
+			max_entry = 1u << 3,
+			entrywise_l1 = 1u << 4,
+			all_norms = (1u << 5) - 1
+		};
+
+		// Results of norms(); only the fields selected by mask are computed.
 		template<typename T>
-		Core::Traits::NormType<T>
-			frobenius_norm(const Core::Matrix<T>& matrix) {
-			using ReturnType = Core::Traits::EpsilonType<T>;
-			
-			ReturnType result{};
-			
-			for (size_t i = 0; i < matrix.get_rows(); ++i) {
-				for (size_t j = 0; j < matrix.get_columns(); ++j) {
-					result += std::norm(matrix(i, j));
+		struct NormSet {
+			Core::Traits::NormType<T> frobenius{};
+			Core::Traits::NormType<T> l_one_columns{};
+			Core::Traits::NormType<T> l_one_rows{};
+			Core::Traits::NormType<T> max{};
+			Core::Traits::NormType<T> l1{};
+			unsigned mask = 0;
+		};
+
+		namespace Detail {
+
+			// Block partial of a reduction. The Frobenius part is kept LAPACK
+			// lassq style as scale^2 * sum_of_squares, so neither huge nor tiny
+			// entries overflow or flush to zero.
+			template<typename R>
+			struct NormPartial {
+				R scale{};
+				R sum_of_squares{};
+				R max_row_sum{};
+				R max{};
+				R l1{};
+
+				void add_squares(R other_scale, R other_sum) {
+					if (other_scale == R{ 0 }) {
+						return;
+					}
+					if (scale < other_scale) {
+						const R ratio = scale / other_scale;
+						sum_of_squares = other_sum + sum_of_squares * ratio * ratio;
+						scale = other_scale;
+					}
+					else {
+						const R ratio = other_scale / scale;
+						sum_of_squares += other_sum * ratio * ratio;
+					}
+				}
+			};
+
+			inline constexpr size_t norm_block_elements = size_t{ 1 } << 16;
+			inline constexpr size_t max_norm_blocks = 64;
+
+			// Adds the squares of count real values to partial, lassq style. When
+			// the largest magnitude is subnormal its reciprocal overflows, so only
+			// then are the values divided by it; otherwise the loop multiplies.
+			template<typename R>
+			void accumulate_squares(const R* values, size_t count, NormPartial<R>& partial) {
+				R largest{};
+				for (size_t j = 0; j < count; ++j) {
+					largest = std::max(largest, std::abs(values[j]));
+				}
+				if (largest == R{ 0 }) {
+					return;
+				}
+				R s0{}, s1{};
+				size_t j = 0;
+				if (largest >= std::numeric_limits<R>::min()) {
+					const R inverse = R{ 1 } / largest;
+					for (; j + 2 <= count; j += 2) {
+						const R a = values[j] * inverse;
+						const R b = values[j + 1] * inverse;
+						s0 += a * a;
+						s1 += b * b;
+					}
+					for (; j < count; ++j) {
+						const R a = values[j] * inverse;
+						s0 += a * a;
+					}
+				}
+				else {
+					for (; j < count; ++j) {
+						const R a = values[j] / largest;
+						s0 += a * a;
+					}
+				}
+				partial.add_squares(largest, s0 + s1);
+			}
+
+			// A row is handled while it is in cache: the scaled squares of its
+			// real and imaginary parts are summed first, then every |a_ij| is
+			// computed once and feeds the row sum, the column sums and the maximum.
+			template<typename T, typename R>
+			void accumulate_row(const T* row, size_t columns, unsigned mask, R* column_sums, NormPartial<R>& partial) {
+				if ((mask & frobenius) != 0) {
+					accumulate_squares(reinterpret_cast<const R*>(row), columns * (sizeof(T) / sizeof(R)), partial);
+				}
+
+				const bool want_columns = (mask & column_sum) != 0;
+				R row_sum{};
+				R row_max{};
+				for (size_t j = 0; j < columns; ++j) {
+					R modulus;
+					if constexpr (is_complex<T>::value) {
+						const R re = row[j].real();
+						const R im = row[j].imag();
+						// |z| = big * sqrt(1 + (small / big)^2) neither overflows nor
+						// underflows, and unlike std::abs it vectorizes.
+						const R big = std::max(std::abs(re), std::abs(im));
+						const R small = std::min(std::abs(re), std::abs(im));
+						const R ratio = big == R{ 0 } ? R{ 0 } : small / big;
+						modulus = big * std::sqrt(R{ 1 } + ratio * ratio);
+					}
+					else {
+						modulus = std::abs(row[j]);
+					}
+					row_sum += modulus;
+					row_max = std::max(row_max, modulus);
+					if (want_columns) {
+						column_sums[j] += modulus;
+					}
 				}
+
+				partial.max_row_sum = std::max(partial.max_row_sum, row_sum);
+				partial.max = std::max(partial.max, row_max);
+				partial.l1 += row_sum;
 			}
-			return std::sqrt(result);
 		}
 
 
+		// Any subset of the five norms below in one row-major pass. Rows are cut
+		// into a fixed number of blocks that depends only on the shape, blocks
+		// are spread over threads, and the block partials (column sums
+		// included) are combined in block order, so the result does not depend
+		// on the thread count.
 		template<typename T>
-		Core::Traits::NormType<T>			
-			inductive_l_one_norm_columns(const Core::Matrix<T>& matrix) {
-			using ReturnType = Core::Traits::EpsilonType<T>;			
-			
-			ReturnType result{};
+		NormSet<T> norms(const Core::Matrix<T>& matrix, unsigned mask = all_norms) {
+			using R = Core::Traits::NormType<T>;
+			const size_t rows = matrix.get_rows();
+			const size_t columns = matrix.get_columns();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Norms::norms", 3 * rows * columns, rows * columns * sizeof(T));
 
-			for (size_t i = 0; i < matrix.get_columns(); ++i) {
-				ReturnType current_result{};
-				for (size_t j = 0; j < matrix.get_rows(); ++j) {
-					current_result += std::abs(matrix(j, i));
+			NormSet<T> result;
+			result.mask = mask & all_norms;
+			if (rows == 0 || columns == 0 || result.mask == 0) {
+				return result;
+			}
+
+			const size_t blocks = std::min({ rows, Detail::max_norm_blocks,
+				std::max<size_t>(1, rows * columns / Detail::norm_block_elements) });
+			const size_t rows_per_block = (rows + blocks - 1) / blocks;
+			const bool want_columns = (mask & column_sum) != 0;
+
+			std::vector<Detail::NormPartial<R>> partials(blocks);
+			std::vector<R> column_sums(want_columns ? blocks * columns : 0);
+			Core::Parallel::parallel_for(0, blocks, 1, [&](size_t first, size_t last) {
+				for (size_t block = first; block < last; ++block) {
+					R* block_columns = want_columns ? column_sums.data() + block * columns : nullptr;
+					const size_t row_end = std::min(rows, (block + 1) * rows_per_block);
+					for (size_t i = block * rows_per_block; i < row_end; ++i) {
+						Detail::accumulate_row(matrix(i).data(), columns, mask, block_columns, partials[block]);
+					}
 				}
-				if (current_result > result) {
-					result = current_result;
+			});
+
+			Detail::NormPartial<R> total = partials[0];
+			for (size_t block = 1; block < blocks; ++block) {
+				const Detail::NormPartial<R>& partial = partials[block];
+				total.add_squares(partial.scale, partial.sum_of_squares);
+				total.max_row_sum = std::max(total.max_row_sum, partial.max_row_sum);
+				total.max = std::max(total.max, partial.max);
+				total.l1 += partial.l1;
+				if (want_columns) {
+					const R* source = column_sums.data() + block * columns;
+					for (size_t j = 0; j < columns; ++j) {
+						column_sums[j] += source[j];
+					}
 				}
 			}
 
+			result.frobenius = total.scale * std::sqrt(total.sum_of_squares);
+			result.l_one_rows = total.max_row_sum;
+			result.max = total.max;
+			result.l1 = total.l1;
+			if (want_columns) {
+				result.l_one_columns = *std::max_element(column_sums.begin(), column_sums.begin() + columns);
+			}
 			return result;
 		}
 
 
 		template<typename T>
-		Core::Traits::NormType<T>			
-			inductive_l_one_norm_rows(const Core::Matrix<T>& matrix) {
-			using ReturnType = Core::Traits::EpsilonType<T>;
-			
-			ReturnType result{};
+		Core::Traits::NormType<T>
+			frobenius_norm(const Core::Matrix<T>& matrix) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Norms::frobenius_norm", 2 * matrix.get_rows() * matrix.get_columns(),
+				matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			return norms(matrix, frobenius).frobenius;
+		}
 
-			for (size_t i = 0; i < matrix.get_rows(); ++i) {
-				ReturnType current_result{};
-				for (size_t j = 0; j < matrix.get_columns(); ++j) {
-					current_result += std::abs(matrix(i, j));
-				}
-				if (current_result > result) {
-					result = current_result;
-				}
-			}
 
-			return result;
+		template<typename T>
+		Core::Traits::NormType<T>			
+			inductive_l_one_norm_columns(const Core::Matrix<T>& matrix) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Norms::inductive_l_one_norm_columns", 2 * matrix.get_rows() * matrix.get_columns(),
+				matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			return norms(matrix, column_sum).l_one_columns;
 		}
 
 
 		template<typename T>
 		Core::Traits::NormType<T>			
-			max_norm(const Core::Matrix<T>& matrix) {
-			using ReturnType = Core::Traits::EpsilonType<T>;
-		
-			ReturnType result{};
+			inductive_l_one_norm_rows(const Core::Matrix<T>& matrix) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Norms::inductive_l_one_norm_rows", 2 * matrix.get_rows() * matrix.get_columns(),
+				matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			return norms(matrix, row_sum).l_one_rows;
+		}
 
-			for (size_t i = 0; i < matrix.get_rows(); ++i) {
-				for (size_t j = 0; j < matrix.get_columns(); ++j) {
-					result = std::max(result, std::abs(matrix(i, j)));
-				}
-			}
 
-			return result;
+		template<typename T>
+		Core::Traits::NormType<T>			
+			max_norm(const Core::Matrix<T>& matrix) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Norms::max_norm", 2 * matrix.get_rows() * matrix.get_columns(),
+				matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			return norms(matrix, max_entry).max;
 		}
 
 
 		template<typename T>
 		Core::Traits::NormType<T>			
 			l1_norm(const Core::Matrix<T>& matrix) {
-			using ReturnType = Core::Traits::EpsilonType<T>;
-		
-			ReturnType result{};
+			MATRIXLIB_PROFILE_ZONE("Algebra::Norms::l1_norm", 2 * matrix.get_rows() * matrix.get_columns(),
+				matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			return norms(matrix, entrywise_l1).l1;
+		};
+	
+
+		template<typename R>
+		struct NormEstimate {
+			R value{};
+			size_t iterations = 0;
+			bool converged = false;
+		};
+
+		// ||A||_2 by power iteration on A^H A, applied as A x followed by A^H y,
+		// both as row-major sweeps so A^H A is never formed. The estimate grows
+		// monotonically towards the largest singular value; iteration stops once
+		// it changes by at most relative_tolerance. Each step costs 4mn flops.
+		template<typename T>
+		NormEstimate<Core::Traits::NormType<T>> spectral_norm_estimate(const Core::Matrix<T>& matrix,
+			Core::Traits::NormType<T> relative_tolerance = Core::Traits::NormType<T>(1e-6), size_t max_iterations = 100) {
+			using R = Core::Traits::NormType<T>;
+			const size_t rows = matrix.get_rows();
+			const size_t columns = matrix.get_columns();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Norms::spectral_norm_estimate", 4 * rows * columns * max_iterations,
+				2 * rows * columns * max_iterations * sizeof(T));
 
-			for (size_t i = 0; i < matrix.get_rows(); ++i) {
-				for (size_t j = 0; j < matrix.get_columns(); ++j) {
-					result += std::abs(matrix(i,j));
+			NormEstimate<R> estimate;
+			if (rows == 0 || columns == 0) {
+				estimate.converged = true;
+				return estimate;
+			}
+
+			auto normalize = [](std::vector<T>& vector) {
+				R scale{};
+				for (const T& value : vector) {
+					scale = std::max(scale, static_cast<R>(std::abs(value)));
+				}
+				if (scale == R{ 0 }) {
+					return R{ 0 };
+				}
+				R sum{};
+				for (const T& value : vector) {
+					sum += std::norm(value / scale);
+				}
+				const R length = scale * std::sqrt(sum);
+				for (T& value : vector) {
+					value /= length;
 				}
+				return length;
+			};
+
+			// A fixed, irregular start vector: deterministic, and unlikely to be
+			// orthogonal to the dominant right singular vector.
+			std::vector<T> x(columns);
+			for (size_t j = 0; j < columns; ++j) {
+				x[j] = T(R(1) + R(0.5) * std::sin(R(1.7) * static_cast<R>(j + 1)));
 			}
+			normalize(x);
+			std::vector<T> y(rows);
+
+			for (size_t iteration = 1; iteration <= max_iterations; ++iteration) {
+				for (size_t i = 0; i < rows; ++i) {
+					const T* row = matrix(i).data();
+					T sum{};
+					for (size_t j = 0; j < columns; ++j) {
+						sum += row[j] * x[j];
+					}
+					y[i] = sum;
+				}
+				std::fill(x.begin(), x.end(), T{});
+				for (size_t i = 0; i < rows; ++i) {
+					const T* row = matrix(i).data();
+					const T value = y[i];
+					for (size_t j = 0; j < columns; ++j) {
+						x[j] += Core::Traits::conjugate(row[j]) * value;
+					}
+				}
+
+				// ||A^H A x|| for unit x approaches sigma_max^2.
+				const R value = std::sqrt(normalize(x));
+				estimate.iterations = iteration;
+				if (value == R{ 0 }) {
+					estimate.value = R{ 0 };
+					estimate.converged = true;
+					break;
+				}
+				const R previous = estimate.value;
+				estimate.value = value;
+				if (iteration > 1 && std::abs(value - previous) <= relative_tolerance * value) {
+					estimate.converged = true;
+					break;
+				}
+			}
+			return estimate;
+		}
 
-			return result;
-		};
-	
 	}
 
 }
\ No newline at end of file
@@ -2,11 +2,24 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
+#include <limits>
 #include <vector>
 
+#include "../algebra/norms.h"
+#include "../core/allocation_tracker.h"
+#include "../core/instrumentation.h"
 #include "../core/matrix.h"
+#include "../core/parallel.h"
+#include "../core/syrk_kernel.h"
+#include "../core/vector.h"
+#include "../core/vector_kernel.h"
+#include "../decompositions/lup_decomposition.h"
 #include "../decompositions/qr_decomposition.h"
+#include "../decompositions/qrcp_decomposition.h"
+#include "small_kernels.h"
 #include "matrixlib/core/type_traits.h"
 
 namespace Algebra {
@@ -21,6 +34,7 @@ namespace Algebra {
 
 		template<typename T>
 		T trace(const Core::Matrix<T>& matrix) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::trace", matrix.get_rows(), matrix.get_rows() * sizeof(T));
 			if (!matrix.is_square()) {
 				throw std::invalid_argument("It isnon-sqaure Matrix");
 			}
@@ -31,60 +45,218 @@ namespace Algebra {
 
 			return result;
 		}
-		
-		
-		template<typename T>
-		long rank(const Core::Matrix<T>& matrix, EpsilonType<T> epsilon) {
 
-			if (matrix.get_rows() == 0 || matrix.get_columns() == 0) {
-				return 0;
-			}
+		// Fused reductions over products that are never formed: each reads A
+		// and B once, O(n^2) work and O(n) extra memory where trace(A * B)
+		// would spend an O(n^3) product and an n^2 temporary. Rows are cut into
+		// a number of blocks that depends only on the shape and spread over
+		// threads; sums are combined in block order, so the results do not
+		// depend on the thread count.
+		namespace Detail {
 
-			Core::Matrix<T> work_matrix = matrix;
-			long rank = 0;
+			inline constexpr size_t reduction_block_elements = size_t{ 1 } << 15;
+			inline constexpr size_t max_reduction_blocks = 64;
+			inline constexpr size_t product_tile = 64;
 
-			std::vector<bool> used_rows(matrix.get_rows(), false);
-
-			for (size_t col = 0; col < matrix.get_columns(); ++col) {
-				size_t pivot_row = 0;
-				auto max_val = static_cast<decltype(epsilon)>(0);
+			inline size_t reduction_blocks(size_t rows, size_t columns) {
+				return std::min({ rows, max_reduction_blocks, std::max<size_t>(1, rows * columns / reduction_block_elements) });
+			}
 
-				for (size_t row = 0; row < matrix.get_rows(); ++row) {
-					if (!used_rows[row]) {
-						auto current_val = std::abs(work_matrix(row, col));
-						if (current_val > max_val) {
-							max_val = current_val;
-							pivot_row = row;
+			// diagonal[i] = sum_k A(i, k) B(k, i) for rows first..last. Column i of
+			// B is strided, so B is taken in product_tile x product_tile tiles
+			// that stay in cache; a symmetric or hermitian B is read by rows.
+			template<typename T>
+			void diagonal_of_product_rows(const Matrix<T>& a, const Matrix<T>& b, size_t first, size_t last, T* diagonal) {
+				const size_t inner = a.get_columns();
+				const Core::Structure kind = b.structure().kind();
+				if (kind == Core::Structure::symmetric || (kind == Core::Structure::hermitian && !is_complex<T>::value)) {
+					for (size_t i = first; i < last; ++i) {
+						diagonal[i] = Core::Kernels::dot<false>(a(i).data(), b(i).data(), inner);
+					}
+					return;
+				}
+				if (kind == Core::Structure::hermitian) {
+					// B(k, i) = conj(B(i, k)).
+					for (size_t i = first; i < last; ++i) {
+						diagonal[i] = Core::Kernels::dot<true>(b(i).data(), a(i).data(), inner);
+					}
+					return;
+				}
+				// A tile of B is transposed into a per-thread buffer, so column i
+				// becomes a contiguous run and the dot product is unit-stride.
+				thread_local std::vector<T> tile;
+				tile.resize(product_tile * product_tile);
+				std::fill(diagonal + first, diagonal + last, T{ 0 });
+				for (size_t i0 = first; i0 < last; i0 += product_tile) {
+					const size_t i1 = std::min(last, i0 + product_tile);
+					for (size_t k0 = 0; k0 < inner; k0 += product_tile) {
+						const size_t k1 = std::min(inner, k0 + product_tile);
+						for (size_t k = k0; k < k1; ++k) {
+							const T* b_row = b(k).data();
+							for (size_t i = i0; i < i1; ++i) {
+								tile[(i - i0) * product_tile + (k - k0)] = b_row[i];
+							}
+						}
+						for (size_t i = i0; i < i1; ++i) {
+							diagonal[i] += Core::Kernels::dot<false>(a(i).data() + k0, tile.data() + (i - i0) * product_tile, k1 - k0);
 						}
 					}
 				}
+			}
+
+			// Calls function(block, first_row, end_row) for every block of rows,
+			// blocks spread over threads.
+			template<typename Function>
+			void for_each_row(size_t rows, size_t columns, Function&& function) {
+				if (rows == 0) {
+					return;
+				}
+				const size_t blocks = reduction_blocks(rows, columns);
+				const size_t rows_per_block = (rows + blocks - 1) / blocks;
+				Core::Parallel::parallel_for(0, blocks, 1, [&](size_t begin, size_t end) {
+					for (size_t block = begin; block < end; ++block) {
+						function(block, std::min(rows, block * rows_per_block), std::min(rows, (block + 1) * rows_per_block));
+					}
+				});
+			}
 
-				if (max_val < epsilon) {
-					continue;
+			template<typename T>
+			void check_product(const Matrix<T>& a, const Matrix<T>& b) {
+				if (a.get_columns() != b.get_rows() || a.get_rows() != b.get_columns()) {
+					throw std::invalid_argument("Product must be square: A is m x n, B is n x m");
 				}
+			}
 
-				used_rows[pivot_row] = true;
-				rank++;
+		}
 
-				for (size_t j = col + 1; j < matrix.get_columns(); ++j) {
-					work_matrix(pivot_row, j) /= work_matrix(pivot_row, col);
+		// diag(A * B) for A m x n and B n x m.
+		template<typename T>
+		std::vector<T> diag_of_product(const Matrix<T>& a, const Matrix<T>& b) {
+			Detail::check_product(a, b);
+			const size_t m = a.get_rows();
+			const size_t n = a.get_columns();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::diag_of_product", 2 * m * n, (2 * m * n + m) * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Characteristics::diag_of_product");
+			std::vector<T> diagonal(m);
+			Detail::for_each_row(m, n, [&](size_t, size_t first, size_t last) {
+				Detail::diagonal_of_product_rows(a, b, first, last, diagonal.data());
+			});
+			return diagonal;
+		}
+
+		// trace(A * B) for A m x n and B n x m.
+		template<typename T>
+		T trace_of_product(const Matrix<T>& a, const Matrix<T>& b) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::trace_of_product", 2 * a.get_rows() * a.get_columns(),
+				2 * a.get_rows() * a.get_columns() * sizeof(T));
+			const std::vector<T> diagonal = diag_of_product(a, b);
+			T result{};
+			for (const T& value : diagonal) {
+				result += value;
+			}
+			return result;
+		}
+
+		// x^H A y for A m x n, x of length m and y of length n.
+		template<typename T>
+		T bilinear_form(const std::vector<T>& x, const Matrix<T>& a, const std::vector<T>& y) {
+			const size_t m = a.get_rows();
+			const size_t n = a.get_columns();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::bilinear_form", 2 * m * n + 2 * m, (m * n + m + n) * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Characteristics::bilinear_form");
+			if (x.size() != m || y.size() != n) {
+				throw std::invalid_argument("Vector lengths must match the matrix dimensions");
+			}
+			// (A y)_i for the rows of each block, folded into the block's sum.
+			std::vector<T> partials(m == 0 ? 0 : Detail::reduction_blocks(m, n));
+			Detail::for_each_row(m, n, [&](size_t block, size_t first, size_t last) {
+				T sum{};
+				for (size_t i = first; i < last; ++i) {
+					sum += Core::Traits::conjugate(x[i]) * Core::Kernels::dot<false>(a(i).data(), y.data(), n);
 				}
+				partials[block] = sum;
+			});
+			T result{};
+			for (const T& partial : partials) {
+				result += partial;
+			}
+			return result;
+		}
 
-				for (size_t row = 0; row < matrix.get_rows(); ++row) {
-					if (!used_rows[row] && row != pivot_row) {
-						for (size_t j = col + 1; j < matrix.get_columns(); ++j) {
-							work_matrix(row, j) -= work_matrix(row, col) * work_matrix(pivot_row, j);
-						}
-					}
+		// x^H A x for square A.
+		template<typename T>
+		T quadratic_form(const std::vector<T>& x, const Matrix<T>& a) {
+			if (!a.is_square()) {
+				throw std::invalid_argument("Quadratic form requires square matrix");
+			}
+			return bilinear_form(x, a, x);
+		}
+
+		// result[i] = <a_i, b_i> = sum_j conj(A(i, j)) B(i, j) for every row of
+		// two matrices of the same shape; for real matrices, diag(A B^T).
+		template<typename T>
+		std::vector<T> rowwise_dot(const Matrix<T>& a, const Matrix<T>& b) {
+			const size_t m = a.get_rows();
+			const size_t n = a.get_columns();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::rowwise_dot", 2 * m * n, (2 * m * n + m) * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Characteristics::rowwise_dot");
+			if (b.get_rows() != m || b.get_columns() != n) {
+				throw std::invalid_argument("Matrix dimensions must agree");
+			}
+			std::vector<T> result(m);
+			Detail::for_each_row(m, n, [&](size_t, size_t first, size_t last) {
+				for (size_t i = first; i < last; ++i) {
+					result[i] = Core::Kernels::dot<true>(a(i).data(), b(i).data(), n);
 				}
+			});
+			return result;
+		}
+		
+		
+		// Numerical rank from a column-pivoted QR: the number of |R(i, i)| above
+		// relative_tolerance * |R(0, 0)|. Works for rectangular matrices; use
+		// Qrcp_Decomposition directly to also get the pivot order and R.
+		template<typename T>
+		long relative_rank(const Core::Matrix<T>& matrix, EpsilonType<T> relative_tolerance) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::relative_rank",
+				2 * matrix.get_rows() * matrix.get_columns() * std::min(matrix.get_rows(), matrix.get_columns()),
+				2 * matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Characteristics::relative_rank");
+
+			if (matrix.get_rows() == 0 || matrix.get_columns() == 0) {
+				return 0;
 			}
+			return static_cast<long>(Decompositions::QRCP_Decomposition::Qrcp_Decomposition<T>(matrix).rank(relative_tolerance));
+		}
+		// With the default relative tolerance max(m, n) * machine epsilon.
+		template<typename T>
+		long rank(const Core::Matrix<T>& matrix) {
+			return relative_rank(matrix, static_cast<EpsilonType<T>>(std::max(matrix.get_rows(), matrix.get_columns())) *
+				std::numeric_limits<EpsilonType<T>>::epsilon());
+		}
+		// Number of |R(i, i)| of at least epsilon. The threshold is absolute, as
+		// the pivot threshold of the elimination this used to run, so the result
+		// depends on the scale of the matrix; relative_rank does not.
+		template<typename T>
+		long rank(const Core::Matrix<T>& matrix, EpsilonType<T> epsilon) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::rank",
+				2 * matrix.get_rows() * matrix.get_columns() * std::min(matrix.get_rows(), matrix.get_columns()),
+				2 * matrix.get_rows() * matrix.get_columns() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Characteristics::rank");
 
-			return rank;
+			if (matrix.get_rows() == 0 || matrix.get_columns() == 0) {
+				return 0;
+			}
+			const auto diagonal = Decompositions::QRCP_Decomposition::Qrcp_Decomposition<T>(matrix).diagonal_magnitudes();
+			return static_cast<long>(std::count_if(diagonal.begin(), diagonal.end(),
+				[epsilon](auto magnitude) { return magnitude >= epsilon; }));
 		}
 	
 
 		template <typename T>
 		T determinant(const Decompositions::LUP_Decomposition::Lup_Decomposition<T>& decomposition) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::determinant", decomposition.get_U().get_rows(),
+				decomposition.get_U().get_rows() * sizeof(T));
 			T result{ 1 };
 			for (size_t i = 0; i < decomposition.get_L().get_rows(); ++i) {
 				result = result  * decomposition.get_U()(i, i);
@@ -92,12 +264,207 @@ namespace Algebra {
 
 			return result* (decomposition.get_permutations()%2 == 0 ? 1:-1);
 		}
+		// Triangular and diagonal matrices (by structure tag) need only the
+		// product of the diagonal, matrices up to 4x4 use the closed forms of
+		// small_kernels.h, and the rest go through an LUP decomposition, which
+		// itself narrows elimination to a known band.
+		template <typename T>
+		T determinant(const Core::Matrix<T>& matrix) {
+			if (!matrix.is_square()) {
+				throw std::invalid_argument("Determinant requires square matrix");
+			}
+			const Core::StructureTag& structure = matrix.structure();
+			if (structure.kind() == Core::Structure::identity) {
+				return T{ 1 };
+			}
+			if (matrix.get_rows() != 0 &&
+				(structure.lower_bandwidth(matrix.get_rows()) == 0 || structure.upper_bandwidth(matrix.get_columns()) == 0)) {
+				MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::determinant", matrix.get_rows(), matrix.get_rows() * sizeof(T));
+				T result{ 1 };
+				for (size_t i = 0; i < matrix.get_rows(); ++i) {
+					result *= matrix(i, i);
+				}
+				return result;
+			}
+			if (matrix.get_rows() != 0 && matrix.get_rows() <= Small::max_size) {
+				return Small::determinant(matrix);
+			}
+			return determinant(Decompositions::LUP_Decomposition::Lup_Decomposition<T>(matrix));
+		}
+
+
+		// det A = sign * exp(log_magnitude). sign is +-1 for real T and a unit
+		// complex number otherwise; a singular matrix gives sign 0 and
+		// log_magnitude -inf.
+		template<typename T>
+		struct LogDeterminant {
+			T sign{ 1 };
+			NormType<T> log_magnitude{};
+		};
+
+		// What the caller knows about the matrix passed to slogdet.
+		enum class Assume {
+			general,
+			positive_definite
+		};
+
+		namespace Detail {
+
+			inline constexpr size_t slogdet_block_size = 64;
+
+			template<typename T>
+			LogDeterminant<T> singular_log_determinant() {
+				return { T{ 0 }, -std::numeric_limits<NormType<T>>::infinity() };
+			}
+
+			// Right-looking blocked LU with partial pivoting, in place. Every
+			// pivot goes into the sign and the sum of logs as soon as it is
+			// found; L and U are never extracted. Panels of slogdet_block_size
+			// columns are factored row by row, the block row to their right is
+			// solved with the unit lower triangle, and the trailing matrix is
+			// updated with one gemm per panel.
+			template<typename T, typename Allocator>
+			LogDeterminant<T> lu_log_determinant(Core::Matrix<T, Allocator>& a) {
+				using R = NormType<T>;
+				const size_t n = a.get_rows();
+				const Core::MatrixView<T> whole = Core::view(a);
+				LogDeterminant<T> result;
+				for (size_t k0 = 0; k0 < n; k0 += slogdet_block_size) {
+					const size_t end = std::min(n, k0 + slogdet_block_size);
+					for (size_t j = k0; j < end; ++j) {
+						size_t pivot = j;
+						R largest = std::abs(whole(j, j));
+						for (size_t i = j + 1; i < n; ++i) {
+							const R candidate = std::abs(whole(i, j));
+							if (candidate > largest) {
+								largest = candidate;
+								pivot = i;
+							}
+						}
+						if (largest == R{ 0 }) {
+							return singular_log_determinant<T>();
+						}
+						if (pivot != j) {
+							a.swap_rows(j, pivot);
+							result.sign = -result.sign;
+						}
+						const T* pivot_row = whole.row(j);
+						const T value = pivot_row[j];
+						result.log_magnitude += std::log(largest);
+						result.sign *= value / largest;
+						for (size_t i = j + 1; i < n; ++i) {
+							T* row = whole.row(i);
+							row[j] /= value;
+							const T factor = row[j];
+							for (size_t c = j + 1; c < end; ++c) {
+								row[c] -= factor * pivot_row[c];
+							}
+						}
+					}
+					if (end == n) {
+						break;
+					}
+					for (size_t i = k0 + 1; i < end; ++i) {
+						T* row = whole.row(i);
+						for (size_t p = k0; p < i; ++p) {
+							const T factor = row[p];
+							const T* solved = whole.row(p);
+							for (size_t c = end; c < n; ++c) {
+								row[c] -= factor * solved[c];
+							}
+						}
+					}
+					Core::Kernels::gemm(T{ -1 },
+						Core::const_view(whole.block(end, k0, n - end, end - k0)), Core::Op::no_transpose,
+						Core::const_view(whole.block(k0, end, end - k0, n - end)), Core::Op::no_transpose,
+						T{ 1 }, whole.block(end, end, n - end, n - end));
+				}
+				if constexpr (is_complex<T>::value) {
+					// The unit phases drift by rounding over n products.
+					result.sign /= std::abs(result.sign);
+				}
+				return result;
+			}
+
+			// Blocked upper Cholesky A = R^H R in place, reading only the upper
+			// triangle; log|det A| is the sum of the logs of the pivots r_ii^2.
+			// Returns false on a pivot that is not positive.
+			template<typename T, typename Allocator>
+			bool cholesky_log_determinant(Core::Matrix<T, Allocator>& a, LogDeterminant<T>& result) {
+				using R = NormType<T>;
+				const size_t n = a.get_rows();
+				const Core::MatrixView<T> whole = Core::view(a);
+				result = LogDeterminant<T>();
+				for (size_t k0 = 0; k0 < n; k0 += slogdet_block_size) {
+					const size_t end = std::min(n, k0 + slogdet_block_size);
+					// The panel rows are finished out to column n, which also
+					// produces R12 = R11^-H A12.
+					for (size_t i = k0; i < end; ++i) {
+						T* pivot_row = whole.row(i);
+						const R pivot = std::real(pivot_row[i]);
+						if (!(pivot > R{ 0 })) {
+							return false;
+						}
+						result.log_magnitude += std::log(pivot);
+						const R diagonal = std::sqrt(pivot);
+						pivot_row[i] = T(diagonal);
+						for (size_t c = i + 1; c < n; ++c) {
+							pivot_row[c] /= diagonal;
+						}
+						for (size_t p = i + 1; p < end; ++p) {
+							const T coefficient = Core::Traits::conjugate(pivot_row[p]);
+							T* row = whole.row(p);
+							for (size_t c = p; c < n; ++c) {
+								row[c] -= coefficient * pivot_row[c];
+							}
+						}
+					}
+					if (end == n) {
+						break;
+					}
+					// A22 -= R12^H R12 on the upper triangle only.
+					Core::Kernels::rank_k_update(T{ -1 }, Core::const_view(whole.block(k0, end, end - k0, n - end)),
+						true, is_complex<T>::value, T{ 1 }, whole.block(end, end, n - end, n - end), Core::Triangle::upper);
+				}
+				return true;
+			}
+
+		}
+
+		// Sign and log-magnitude of det A, which stay finite where the product
+		// of pivots would overflow or underflow (n in the hundreds is enough).
+		// The factorization runs in place on one scratch copy. With
+		// Assume::positive_definite a Cholesky factorization is used, which
+		// halves the work; if it breaks down the LU path runs instead.
+		template<typename T>
+		LogDeterminant<T> slogdet(const Core::Matrix<T>& matrix, Assume assume = Assume::general) {
+			if (!matrix.is_square()) {
+				throw std::invalid_argument("Determinant requires square matrix");
+			}
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::slogdet",
+				(assume == Assume::positive_definite ? 1 : 2) * matrix.get_rows() * matrix.get_rows() * matrix.get_rows() / 3,
+				2 * matrix.get_rows() * matrix.get_rows() * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Characteristics::slogdet");
+
+			Core::Memory::ArenaScope scratch_scope;
+			Core::ScratchMatrix<T> scratch(matrix);
+			if (assume == Assume::positive_definite) {
+				LogDeterminant<T> result;
+				if (Detail::cholesky_log_determinant(scratch, result)) {
+					return result;
+				}
+				scratch = Core::ScratchMatrix<T>(matrix);
+			}
+			return Detail::lu_log_determinant(scratch);
+		}
 	
 
 		template<typename T>
 		std::vector<T> eigen_values(Decompositions::QR_Decomposition::Qr_Decomposition<T> value, const size_t amount_of_iterations){
 			Core::Matrix<T> result;
 			std::vector<T> answer;
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::eigen_values", 0, 0);
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Characteristics::eigen_values");
 			for(size_t i = 0; i < amount_of_iterations; ++i){
 				result = value.get_R() * value.get_Q();
 				value.recompute_decomposition(result);
@@ -110,6 +477,113 @@ namespace Algebra {
 			return answer;
 		}
 	
+		// The eigenvalues of a triangular or diagonal matrix (by structure tag)
+		// are its diagonal; other matrices run the QR iteration above.
+		template<typename T>
+		std::vector<T> eigen_values(const Core::Matrix<T>& matrix, const size_t amount_of_iterations) {
+			if (!matrix.is_square()) {
+				throw std::invalid_argument("Eigenvalues require square matrix");
+			}
+			const Core::StructureTag& structure = matrix.structure();
+			if (structure.lower_bandwidth(matrix.get_rows()) == 0 || structure.upper_bandwidth(matrix.get_columns()) == 0) {
+				std::vector<T> answer(matrix.get_rows());
+				for (size_t i = 0; i < matrix.get_rows(); ++i) {
+					answer[i] = matrix(i, i);
+				}
+				return answer;
+			}
+			return eigen_values(Decompositions::QR_Decomposition::Qr_Decomposition<T>(matrix), amount_of_iterations);
+		}
+
+		// Estimate of ||A^-1||_1 from an existing factorization (Hager's method
+		// with Higham's refinements, as in LAPACK lacn2). Each step is one solve
+		// with A and one with A^H, i.e. O(n^2); at most five steps are taken,
+		// plus one extra solve for Higham's alternating test vector. The result
+		// is a lower bound that is almost always within a factor of 3. The
+		// iteration works in four vectors allocated once.
+		template<typename T>
+		NormType<T> inverse_one_norm_estimate(const Decompositions::LUP_Decomposition::Lup_Decomposition<T>& decomposition) {
+			using R = NormType<T>;
+			const size_t n = decomposition.get_L().get_rows();
+			MATRIXLIB_PROFILE_ZONE("Algebra::Characteristics::inverse_one_norm_estimate", 22 * n * n, 12 * n * n * sizeof(T));
+			MATRIXLIB_ALLOCATION_SCOPE("Algebra::Characteristics::inverse_one_norm_estimate");
+			if (n == 0) {
+				return R{ 0 };
+			}
+
+			auto one_norm = [](const Core::Vector<T>& vector) {
+				R sum{};
+				for (const T& value : vector) {
+					sum += std::abs(value);
+				}
+				return sum;
+			};
+
+			Core::Vector<T> x(n, T(R(1) / static_cast<R>(n)));
+			Core::Vector<T> y(n);
+			Core::Vector<T> sign(n);
+			Core::Vector<T> z(n);
+			R estimate{};
+			size_t previous_index = n;
+			constexpr size_t max_steps = 5;
+			for (size_t step = 0; step < max_steps; ++step) {
+				decomposition.solve(x, y);
+				const R y_norm = one_norm(y);
+				if (step > 0 && y_norm <= estimate) {
+					break;
+				}
+				estimate = y_norm;
+
+				// x <- sign(y); for complex entries the unit phase y_i / |y_i|.
+				for (size_t i = 0; i < n; ++i) {
+					const R magnitude = std::abs(y[i]);
+					sign[i] = magnitude == R{ 0 } ? T{ 1 } : y[i] / magnitude;
+				}
+				decomposition.solve(sign, z, Core::Op::conjugate_transpose);
+
+				size_t index = 0;
+				R largest{};
+				for (size_t i = 0; i < n; ++i) {
+					if (std::abs(z[i]) > largest) {
+						largest = std::abs(z[i]);
+						index = i;
+					}
+				}
+				R z_dot_x{};
+				for (size_t i = 0; i < n; ++i) {
+					z_dot_x += std::real(Core::Traits::conjugate(z[i]) * x[i]);
+				}
+				if (step > 0 && (largest <= z_dot_x || index == previous_index)) {
+					break;
+				}
+				previous_index = index;
+				x.fill(T{ 0 });
+				x[index] = T{ 1 };
+			}
+
+			// Higham's safeguard against matrices that fool the sign iteration.
+			for (size_t i = 0; i < n; ++i) {
+				const R magnitude = R(1) + (n > 1 ? static_cast<R>(i) / static_cast<R>(n - 1) : R(0));
+				x[i] = T(i % 2 == 0 ? magnitude : -magnitude);
+			}
+			decomposition.solve(x, y);
+			const R alternative = R(2) * one_norm(y) / (R(3) * static_cast<R>(n));
+			return std::max(estimate, alternative);
+		}
+
+		// kappa_1(A) ~ ||A||_1 * ||A^-1||_1 for a matrix already factored, with
+		// ||A||_1 supplied by the caller (e.g. norms(A, column_sum)).
+		template<typename T>
+		NormType<T> condition_number_estimate(const Decompositions::LUP_Decomposition::Lup_Decomposition<T>& decomposition,
+			NormType<T> matrix_one_norm) {
+			return matrix_one_norm * inverse_one_norm_estimate(decomposition);
+		}
+		template<typename T>
+		NormType<T> condition_number_estimate(const Core::Matrix<T>& matrix,
+			const Decompositions::LUP_Decomposition::Lup_Decomposition<T>& decomposition) {
+			return condition_number_estimate(decomposition, Algebra::Norms::norms(matrix, Algebra::Norms::column_sum).l_one_columns);
+		}
+
 		template<typename T>
 		std::vector<NormType<T>> singular_values(const Matrix<T>& matrix){
 
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "../core/instrumentation.h"
+#include "../core/matrix.h"
+#include "../core/static_matrix.h"
+#include "../core/type_traits.h"
+
+// Determinant, inverse and solve for n = 1..4 as straight-line code: cofactor
+// expansions and adjugates written out per size, picked with if constexpr on
+// the StaticMatrix dimension. They allocate nothing and have no loops left
+// to run, which is what geometry code calling them per point needs.
+//
+// Cofactor formulas are not backward stable. Their error is bounded by a
+// few ulps of the Hadamard-type bound prod_i sum_j |a_ij| (the scale below),
+// so when |det| falls under sqrt(epsilon) times that bound the kernels
+// switch to Gaussian elimination with partial pivoting, unrolled the same way.
+// Larger static sizes always take that path.
+//
+// The Matrix overloads dispatch on the run-time size and are what
+// Characteristics::determinant, Operations::inverse and Operations::solve use
+// for matrices up to max_size.
+
+namespace Algebra {
+	namespace Small {
+
+		using Core::StaticMatrix;
+		using Core::Traits::NormType;
+
+		inline constexpr std::size_t max_size = 4;
+
+		namespace Detail {
+
+			// |re| + |im|: an upper bound of |z| that needs no square root.
+			template<typename T>
+			[[nodiscard]] constexpr NormType<T> magnitude(const T& value) noexcept {
+				if constexpr (Core::Traits::is_complex<T>::value) {
+					return (value.real() < 0 ? -value.real() : value.real()) + (value.imag() < 0 ? -value.imag() : value.imag());
+				}
+				else {
+					return value < T{ 0 } ? -value : value;
+				}
+			}
+
+			// prod_i sum_j |a_ij|, which bounds |det A| and every term of its
+			// cofactor expansion.
+			template<typename T, std::size_t N>
+			[[nodiscard]] constexpr NormType<T> scale(const StaticMatrix<T, N, N>& a) noexcept {
+				NormType<T> result{ 1 };
+				for (std::size_t i = 0; i < N; ++i) {
+					NormType<T> sum{};
+					for (std::size_t j = 0; j < N; ++j) {
+						sum += magnitude(a(i, j));
+					}
+					result *= sum;
+				}
+				return result;
+			}
+
+			template<typename T, std::size_t N>
+			[[nodiscard]] bool closed_form_is_safe(const T& det, const StaticMatrix<T, N, N>& a) {
+				const NormType<T> threshold = std::sqrt(std::numeric_limits<NormType<T>>::epsilon());
+				return magnitude(det) > threshold * scale(a);
+			}
+
+			template<typename T, std::size_t N>
+			[[nodiscard]] constexpr T cofactor_determinant(const StaticMatrix<T, N, N>& a) noexcept {
+				if constexpr (N == 1) {
+					return a(0, 0);
+				}
+				else if constexpr (N == 2) {
+					return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+				}
+				else if constexpr (N == 3) {
+					return a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1))
+						+ a(0, 1) * (a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2))
+						+ a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+				}
+				else {
+					static_assert(N == 4, "Cofactor determinants are written out up to 4x4");
+					// Laplace expansion along rows 0-1 against rows 2-3.
+					const T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+					const T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+					const T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+					const T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+					const T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+					const T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+					const T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+					const T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+					const T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+					const T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+					const T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+					const T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+					return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+				}
+			}
+
+			// adj(A), with det A returned through det from the same minors.
+			template<typename T, std::size_t N>
+			[[nodiscard]] constexpr StaticMatrix<T, N, N> adjugate(const StaticMatrix<T, N, N>& a, T& det) noexcept {
+				StaticMatrix<T, N, N> r;
+				if constexpr (N == 1) {
+					r(0, 0) = T{ 1 };
+					det = a(0, 0);
+				}
+				else if constexpr (N == 2) {
+					r(0, 0) = a(1, 1);
+					r(0, 1) = -a(0, 1);
+					r(1, 0) = -a(1, 0);
+					r(1, 1) = a(0, 0);
+					det = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+				}
+				else if constexpr (N == 3) {
+					r(0, 0) = a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1);
+					r(1, 0) = a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2);
+					r(2, 0) = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+					r(0, 1) = a(0, 2) * a(2, 1) - a(0, 1) * a(2, 2);
+					r(1, 1) = a(0, 0) * a(2, 2) - a(0, 2) * a(2, 0);
+					r(2, 1) = a(0, 1) * a(2, 0) - a(0, 0) * a(2, 1);
+					r(0, 2) = a(0, 1) * a(1, 2) - a(0, 2) * a(1, 1);
+					r(1, 2) = a(0, 2) * a(1, 0) - a(0, 0) * a(1, 2);
+					r(2, 2) = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+					det = a(0, 0) * r(0, 0) + a(0, 1) * r(1, 0) + a(0, 2) * r(2, 0);
+				}
+				else {
+					static_assert(N == 4, "Adjugates are written out up to 4x4");
+					const T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+					const T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+					const T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+					const T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+					const T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+					const T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+					const T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+					const T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+					const T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+					const T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+					const T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+					const T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+					det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+					r(0, 0) = a(1, 1) * c5 - a(1, 2) * c4 + a(1, 3) * c3;
+					r(0, 1) = -a(0, 1) * c5 + a(0, 2) * c4 - a(0, 3) * c3;
+					r(0, 2) = a(3, 1) * s5 - a(3, 2) * s4 + a(3, 3) * s3;
+					r(0, 3) = -a(2, 1) * s5 + a(2, 2) * s4 - a(2, 3) * s3;
+					r(1, 0) = -a(1, 0) * c5 + a(1, 2) * c2 - a(1, 3) * c1;
+					r(1, 1) = a(0, 0) * c5 - a(0, 2) * c2 + a(0, 3) * c1;
+					r(1, 2) = -a(3, 0) * s5 + a(3, 2) * s2 - a(3, 3) * s1;
+					r(1, 3) = a(2, 0) * s5 - a(2, 2) * s2 + a(2, 3) * s1;
+					r(2, 0) = a(1, 0) * c4 - a(1, 1) * c2 + a(1, 3) * c0;
+					r(2, 1) = -a(0, 0) * c4 + a(0, 1) * c2 - a(0, 3) * c0;
+					r(2, 2) = a(3, 0) * s4 - a(3, 1) * s2 + a(3, 3) * s0;
+					r(2, 3) = -a(2, 0) * s4 + a(2, 1) * s2 - a(2, 3) * s0;
+					r(3, 0) = -a(1, 0) * c3 + a(1, 1) * c1 - a(1, 2) * c0;
+					r(3, 1) = a(0, 0) * c3 - a(0, 1) * c1 + a(0, 2) * c0;
+					r(3, 2) = -a(3, 0) * s3 + a(3, 1) * s1 - a(3, 2) * s0;
+					r(3, 3) = a(2, 0) * s3 - a(2, 1) * s1 + a(2, 2) * s0;
+				}
+				return r;
+			}
+
+			template<typename T, std::size_t N>
+			[[nodiscard]] constexpr T pivoted_determinant(StaticMatrix<T, N, N> a) noexcept {
+				T det{ 1 };
+				for (std::size_t k = 0; k < N; ++k) {
+					std::size_t pivot = k;
+					for (std::size_t i = k + 1; i < N; ++i) {
+						if (magnitude(a(i, k)) > magnitude(a(pivot, k))) {
+							pivot = i;
+						}
+					}
+					if (a(pivot, k) == T{ 0 }) {
+						return T{ 0 };
+					}
+					if (pivot != k) {
+						std::swap(a(k), a(pivot));
+						det = -det;
+					}
+					det *= a(k, k);
+					for (std::size_t i = k + 1; i < N; ++i) {
+						const T factor = a(i, k) / a(k, k);
+						for (std::size_t j = k + 1; j < N; ++j) {
+							a(i, j) -= factor * a(k, j);
+						}
+					}
+				}
+				return det;
+			}
+
+			// Overwrites the columns of b (anything with b(i, j), k columns)
+			// with A^-1 b; false if A has an exactly zero pivot.
+			template<typename T, std::size_t N, typename Rhs>
+			[[nodiscard]] bool pivoted_solve(StaticMatrix<T, N, N> a, Rhs& b, std::size_t k) {
+				for (std::size_t c = 0; c < N; ++c) {
+					std::size_t pivot = c;
+					for (std::size_t i = c + 1; i < N; ++i) {
+						if (magnitude(a(i, c)) > magnitude(a(pivot, c))) {
+							pivot = i;
+						}
+					}
+					if (a(pivot, c) == T{ 0 }) {
+						return false;
+					}
+					if (pivot != c) {
+						std::swap(a(c), a(pivot));
+						for (std::size_t j = 0; j < k; ++j) {
+							std::swap(b(c, j), b(pivot, j));
+						}
+					}
+					for (std::size_t i = c + 1; i < N; ++i) {
+						const T factor = a(i, c) / a(c, c);
+						for (std::size_t j = c + 1; j < N; ++j) {
+							a(i, j) -= factor * a(c, j);
+						}
+						for (std::size_t j = 0; j < k; ++j) {
+							b(i, j) -= factor * b(c, j);
+						}
+					}
+				}
+				for (std::size_t i = N; i-- > 0;) {
+					for (std::size_t j = 0; j < k; ++j) {
+						T sum = b(i, j);
+						for (std::size_t p = i + 1; p < N; ++p) {
+							sum -= a(i, p) * b(p, j);
+						}
+						b(i, j) = sum / a(i, i);
+					}
+				}
+				return true;
+			}
+
+			// Runs function on the matrix converted to StaticMatrix<T, n, n>.
+			template<typename T, typename Allocator, typename Function>
+			decltype(auto) with_static_size(const Core::Matrix<T, Allocator>& a, Function&& function) {
+				if (a.get_rows() != a.get_columns()) {
+					throw std::invalid_argument("Matrix must be square");
+				}
+				switch (a.get_rows()) {
+				case 1: return function(StaticMatrix<T, 1, 1>(a));
+				case 2: return function(StaticMatrix<T, 2, 2>(a));
+				case 3: return function(StaticMatrix<T, 3, 3>(a));
+				case 4: return function(StaticMatrix<T, 4, 4>(a));
+				default: throw std::invalid_argument("Closed-form kernels take matrices from 1x1 to 4x4");
+				}
+			}
+
+		}
+
+		template<typename T, std::size_t N>
+		[[nodiscard]] T determinant(const StaticMatrix<T, N, N>& a) {
+			if constexpr (N <= max_size) {
+				const T det = Detail::cofactor_determinant(a);
+				if (Detail::closed_form_is_safe(det, a)) {
+					return det;
+				}
+			}
+			return Detail::pivoted_determinant(a);
+		}
+
+		// Throws std::runtime_error for a singular matrix.
+		template<typename T, std::size_t N>
+		[[nodiscard]] StaticMatrix<T, N, N> inverse(const StaticMatrix<T, N, N>& a) {
+			if constexpr (N <= max_size) {
+				T det{};
+				StaticMatrix<T, N, N> result = Detail::adjugate(a, det);
+				if (Detail::closed_form_is_safe(det, a)) {
+					return result / det;
+				}
+			}
+			StaticMatrix<T, N, N> result = StaticMatrix<T, N, N>::identity();
+			if (!Detail::pivoted_solve(a, result, N)) {
+				throw std::runtime_error("Matrix is singular or nearly singular");
+			}
+			return result;
+		}
+
+		// X with A X = B; throws std::runtime_error for a singular A.
+		template<typename T, std::size_t N, std::size_t K>
+		[[nodiscard]] StaticMatrix<T, N, K> solve(const StaticMatrix<T, N, N>& a, const StaticMatrix<T, N, K>& b) {
+			if constexpr (N <= max_size) {
+				T det{};
+				const StaticMatrix<T, N, N> adjugate = Detail::adjugate(a, det);
+				if (Detail::closed_form_is_safe(det, a)) {
+					return adjugate * b / det;
+				}
+			}
+			StaticMatrix<T, N, K> result = b;
+			if (!Detail::pivoted_solve(a, result, K)) {
+				throw std::runtime_error("Matrix is singular or nearly singular");
+			}
+			return result;
+		}
+
+		template<typename T, typename Allocator>
+		[[nodiscard]] T determinant(const Core::Matrix<T, Allocator>& a) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Small::determinant", 0, a.get_rows() * a.get_columns() * sizeof(T));
+			return Detail::with_static_size(a, [](const auto& fixed) { return determinant(fixed); });
+		}
+
+		template<typename T, typename Allocator>
+		[[nodiscard]] Core::Matrix<T> inverse(const Core::Matrix<T, Allocator>& a) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Small::inverse", 0, 2 * a.get_rows() * a.get_columns() * sizeof(T));
+			return Detail::with_static_size(a, [](const auto& fixed) { return inverse(fixed).to_matrix(); });
+		}
+
+		// B may have any number of columns.
+		template<typename T, typename Allocator>
+		[[nodiscard]] Core::Matrix<T, Allocator> solve(const Core::Matrix<T, Allocator>& a, const Core::Matrix<T, Allocator>& b) {
+			MATRIXLIB_PROFILE_ZONE("Algebra::Small::solve", 0, (a.get_rows() * a.get_columns() + 2 * b.get_rows() * b.get_columns()) * sizeof(T));
+			if (b.get_rows() != a.get_rows()) {
+				throw std::invalid_argument("Right-hand side must have as many rows as the matrix");
+			}
+			return Detail::with_static_size(a, [&b](const auto& fixed) {
+				using Fixed = std::decay_t<decltype(fixed)>;
+				constexpr std::size_t n = Fixed::rows;
+				const std::size_t k = b.get_columns();
+				Core::Matrix<T, Allocator> x(b);
+				T det{};
+				const Fixed adjugate = Detail::adjugate(fixed, det);
+				if (Detail::closed_form_is_safe(det, fixed)) {
+					for (std::size_t j = 0; j < k; ++j) {
+						for (std::size_t i = 0; i < n; ++i) {
+							T sum{};
+							for (std::size_t p = 0; p < n; ++p) {
+								sum += adjugate(i, p) * b(p, j);
+							}
+							x(i, j) = sum / det;
+						}
+					}
+				}
+				else if (!Detail::pivoted_solve(fixed, x, k)) {
+					throw std::runtime_error("Matrix is singular or nearly singular");
+				}
+				return x;
+			});
+		}
+
+	}
+}
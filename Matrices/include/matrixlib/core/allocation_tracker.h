@@ -0,0 +1,548 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Accounting for the storage owned by Core::Matrix. Every matrix carries a
+// MatrixFootprint that reports its row buffers to the tracker when it is
+// created, copied, resized by assignment or destroyed. Tracking is switched on
+// at run time; while it is off a footprint costs one relaxed atomic load.
+//
+// AllocationScope tags the calling thread: allocations made while a scope is
+// open are counted against it (and against every enclosing scope), and the
+// full tag path, e.g. "Lup_Decomposition::computeDecomposition/Core::Matrix::operator*",
+// is the allocation site reported by top_allocation_sites.
+//
+// Footprints are computed from shapes and only cover Matrix and Vector
+// storage. Nothing else is in them: std::vector temporaries inside kernels,
+// the thread_local gemm packing and gemv partial buffers, scratch arena
+// chunks and worker start-up in parallel_for. To see those, a program
+// writes MATRIXLIB_DEFINE_HEAP_ALLOCATION_HOOKS() once at namespace scope
+// in one translation unit. That replaces the global operator
+// new, and from then on every heap allocation made by the calling thread
+// while a scope is open shows up in the scope's heap_allocations(). Only
+// heap_allocations() == 0 shows that a loop does not allocate.
+
+#define MATRIXLIB_DEFINE_HEAP_ALLOCATION_HOOKS() \
+	void* operator new(std::size_t size) { return ::Core::Memory::Detail::counted_allocate(size); } \
+	void* operator new[](std::size_t size) { return ::Core::Memory::Detail::counted_allocate(size); } \
+	void operator delete(void* block) noexcept { std::free(block); } \
+	void operator delete[](void* block) noexcept { std::free(block); } \
+	void operator delete(void* block, std::size_t) noexcept { std::free(block); } \
+	void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+
+#define MATRIXLIB_ALLOCATION_CONCAT_IMPL(a, b) a##b
+#define MATRIXLIB_ALLOCATION_CONCAT(a, b) MATRIXLIB_ALLOCATION_CONCAT_IMPL(a, b)
+#define MATRIXLIB_ALLOCATION_SCOPE(tag) \
+	::Core::Memory::AllocationScope MATRIXLIB_ALLOCATION_CONCAT(matrixlib_allocation_scope_, __LINE__)(tag)
+
+namespace Core {
+	namespace Memory {
+
+		struct AllocationStats {
+			std::uint64_t allocations = 0;
+			std::uint64_t deallocations = 0;
+			std::uint64_t bytes_allocated = 0;
+			std::uint64_t live_bytes = 0;
+			std::uint64_t peak_live_bytes = 0;
+		};
+
+		struct AllocationSite {
+			std::string path;
+			std::uint64_t allocations = 0;
+			std::uint64_t bytes = 0;
+			std::uint64_t peak_live_bytes = 0;
+		};
+
+		namespace Detail {
+
+			inline constexpr std::size_t type_slots = 6;
+
+			template<typename T> struct type_slot;
+			template<> struct type_slot<float> { static constexpr std::size_t value = 0; };
+			template<> struct type_slot<double> { static constexpr std::size_t value = 1; };
+			template<> struct type_slot<long double> { static constexpr std::size_t value = 2; };
+			template<> struct type_slot<std::complex<float>> { static constexpr std::size_t value = 3; };
+			template<> struct type_slot<std::complex<double>> { static constexpr std::size_t value = 4; };
+			template<> struct type_slot<std::complex<long double>> { static constexpr std::size_t value = 5; };
+
+			inline constexpr std::array<const char*, type_slots> type_names = {
+				"float", "double", "long double",
+				"complex<float>", "complex<double>", "complex<long double>"
+			};
+
+			struct Counters {
+				std::atomic<std::uint64_t> allocations{ 0 };
+				std::atomic<std::uint64_t> deallocations{ 0 };
+				std::atomic<std::uint64_t> bytes_allocated{ 0 };
+				std::atomic<std::int64_t> live_bytes{ 0 };
+				std::atomic<std::int64_t> peak_live_bytes{ 0 };
+			};
+
+			inline void raise_peak(std::atomic<std::int64_t>& peak, std::int64_t value) noexcept {
+				std::int64_t current = peak.load(std::memory_order_relaxed);
+				while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+				}
+			}
+
+			struct Tracker {
+				std::atomic<bool> enabled{ false };
+				std::array<Counters, type_slots> types{};
+				Counters total{};
+
+				std::mutex sites_mutex;
+				std::unordered_map<std::string, AllocationSite> sites;
+			};
+
+			inline Tracker& tracker() {
+				static Tracker instance;
+				return instance;
+			}
+
+			inline std::atomic<bool>& heap_hooks_installed() noexcept {
+				static std::atomic<bool> installed{ false };
+				return installed;
+			}
+
+			// Set while the tracker itself allocates (scope paths, the site
+			// table), so its own bookkeeping is not charged to the scopes.
+			inline bool& heap_counting_suspended() noexcept {
+				thread_local bool suspended = false;
+				return suspended;
+			}
+
+			class UncountedHeap {
+			public:
+				UncountedHeap() noexcept : previous_(std::exchange(heap_counting_suspended(), true)) {}
+				UncountedHeap(const UncountedHeap&) = delete;
+				UncountedHeap& operator=(const UncountedHeap&) = delete;
+				~UncountedHeap() { heap_counting_suspended() = previous_; }
+
+			private:
+				bool previous_;
+			};
+
+			inline void record_heap_allocation(std::size_t bytes) noexcept;
+
+			inline void* counted_allocate(std::size_t size) {
+				void* block = nullptr;
+				while ((block = std::malloc(size == 0 ? 1 : size)) == nullptr) {
+					const std::new_handler handler = std::get_new_handler();
+					if (handler == nullptr) {
+						throw std::bad_alloc();
+					}
+					handler();
+				}
+				record_heap_allocation(size);
+				return block;
+			}
+
+			inline AllocationStats to_stats(const Counters& counters) noexcept {
+				AllocationStats stats;
+				stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+				stats.deallocations = counters.deallocations.load(std::memory_order_relaxed);
+				stats.bytes_allocated = counters.bytes_allocated.load(std::memory_order_relaxed);
+				stats.live_bytes = static_cast<std::uint64_t>(std::max<std::int64_t>(0, counters.live_bytes.load(std::memory_order_relaxed)));
+				stats.peak_live_bytes = static_cast<std::uint64_t>(counters.peak_live_bytes.load(std::memory_order_relaxed));
+				return stats;
+			}
+
+			inline void reset_counters(Counters& counters) noexcept {
+				counters.allocations.store(0, std::memory_order_relaxed);
+				counters.deallocations.store(0, std::memory_order_relaxed);
+				counters.bytes_allocated.store(0, std::memory_order_relaxed);
+				counters.peak_live_bytes.store(counters.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+		}
+
+
+		inline void set_allocation_tracking_enabled(bool enabled) noexcept {
+			Detail::tracker().enabled.store(enabled, std::memory_order_relaxed);
+		}
+		[[nodiscard]] inline bool allocation_tracking_enabled() noexcept {
+			return Detail::tracker().enabled.load(std::memory_order_relaxed);
+		}
+		// True once the operator new from MATRIXLIB_DEFINE_HEAP_ALLOCATION_HOOKS
+		// has run; without it heap_allocations() stays at zero.
+		[[nodiscard]] inline bool heap_allocations_counted() noexcept {
+			return Detail::heap_hooks_installed().load(std::memory_order_relaxed);
+		}
+
+
+		inline void record_allocation(std::size_t type_slot, std::uint64_t count, std::uint64_t bytes) noexcept;
+		inline void record_deallocation(std::size_t type_slot, std::uint64_t count, std::uint64_t bytes) noexcept;
+
+
+		class AllocationScope {
+		public:
+			explicit AllocationScope(const char* tag) {
+				if (!allocation_tracking_enabled()) {
+					return;
+				}
+				Detail::UncountedHeap uncounted;
+				active_ = true;
+				parent_ = current();
+				path_ = parent_ != nullptr ? parent_->path_ + "/" + tag : std::string(tag);
+				current() = this;
+			}
+
+			AllocationScope(const AllocationScope&) = delete;
+			AllocationScope& operator=(const AllocationScope&) = delete;
+
+			~AllocationScope() {
+				if (!active_) {
+					return;
+				}
+				current() = parent_;
+
+				Detail::UncountedHeap uncounted;
+				Detail::Tracker& tracker = Detail::tracker();
+				try {
+					std::lock_guard<std::mutex> lock(tracker.sites_mutex);
+					AllocationSite& site = tracker.sites[path_];
+					site.path = path_;
+					site.peak_live_bytes = std::max(site.peak_live_bytes, peak_bytes_);
+				}
+				catch (...) {
+					// The site table is diagnostics only; a failed insertion drops it.
+				}
+			}
+
+			// Figures for this scope instance, counting only the calling thread.
+			[[nodiscard]] std::uint64_t allocations() const noexcept { return allocations_; }
+			[[nodiscard]] std::uint64_t deallocations() const noexcept { return deallocations_; }
+			[[nodiscard]] std::uint64_t bytes() const noexcept { return bytes_; }
+			[[nodiscard]] std::int64_t live_bytes() const noexcept { return live_bytes_; }
+			[[nodiscard]] std::uint64_t peak_bytes() const noexcept { return peak_bytes_; }
+			[[nodiscard]] const std::string& path() const noexcept { return path_; }
+			// Every operator new on this thread while the scope was open, Matrix
+			// storage included. Needs MATRIXLIB_DEFINE_HEAP_ALLOCATION_HOOKS.
+			[[nodiscard]] std::uint64_t heap_allocations() const noexcept { return heap_allocations_; }
+			[[nodiscard]] std::uint64_t heap_bytes() const noexcept { return heap_bytes_; }
+
+			[[nodiscard]] static AllocationScope*& current() noexcept {
+				thread_local AllocationScope* scope = nullptr;
+				return scope;
+			}
+
+		private:
+			friend void record_allocation(std::size_t, std::uint64_t, std::uint64_t) noexcept;
+			friend void record_deallocation(std::size_t, std::uint64_t, std::uint64_t) noexcept;
+			friend void Detail::record_heap_allocation(std::size_t) noexcept;
+
+			bool active_ = false;
+			AllocationScope* parent_ = nullptr;
+			std::string path_;
+
+			std::uint64_t allocations_ = 0;
+			std::uint64_t deallocations_ = 0;
+			std::uint64_t bytes_ = 0;
+			std::int64_t live_bytes_ = 0;
+			std::uint64_t peak_bytes_ = 0;
+			std::uint64_t heap_allocations_ = 0;
+			std::uint64_t heap_bytes_ = 0;
+		};
+
+
+		// Never throws, so the noexcept Matrix constructors can record: if the
+		// site table cannot be updated the allocation is still counted, just
+		// not attributed to a site.
+		inline void record_allocation(std::size_t type_slot, std::uint64_t count, std::uint64_t bytes) noexcept {
+			Detail::Tracker& tracker = Detail::tracker();
+			for (Detail::Counters* counters : { &tracker.types[type_slot], &tracker.total }) {
+				counters->allocations.fetch_add(count, std::memory_order_relaxed);
+				counters->bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+				const std::int64_t live = counters->live_bytes.fetch_add(static_cast<std::int64_t>(bytes), std::memory_order_relaxed)
+					+ static_cast<std::int64_t>(bytes);
+				Detail::raise_peak(counters->peak_live_bytes, live);
+			}
+
+			AllocationScope* innermost = AllocationScope::current();
+			for (AllocationScope* scope = innermost; scope != nullptr; scope = scope->parent_) {
+				scope->allocations_ += count;
+				scope->bytes_ += bytes;
+				scope->live_bytes_ += static_cast<std::int64_t>(bytes);
+				scope->peak_bytes_ = std::max(scope->peak_bytes_, static_cast<std::uint64_t>(std::max<std::int64_t>(0, scope->live_bytes_)));
+			}
+			if (innermost != nullptr) {
+				Detail::UncountedHeap uncounted;
+				try {
+					std::lock_guard<std::mutex> lock(tracker.sites_mutex);
+					AllocationSite& site = tracker.sites[innermost->path_];
+					site.path = innermost->path_;
+					site.allocations += count;
+					site.bytes += bytes;
+				}
+				catch (...) {
+				}
+			}
+		}
+
+		inline void record_deallocation(std::size_t type_slot, std::uint64_t count, std::uint64_t bytes) noexcept {
+			Detail::Tracker& tracker = Detail::tracker();
+			for (Detail::Counters* counters : { &tracker.types[type_slot], &tracker.total }) {
+				counters->deallocations.fetch_add(count, std::memory_order_relaxed);
+				counters->live_bytes.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+			}
+			for (AllocationScope* scope = AllocationScope::current(); scope != nullptr; scope = scope->parent_) {
+				scope->deallocations_ += count;
+				scope->live_bytes_ -= static_cast<std::int64_t>(bytes);
+			}
+		}
+
+
+		inline void Detail::record_heap_allocation(std::size_t bytes) noexcept {
+			if (!heap_hooks_installed().load(std::memory_order_relaxed)) {
+				heap_hooks_installed().store(true, std::memory_order_relaxed);
+			}
+			if (heap_counting_suspended()) {
+				return;
+			}
+			for (AllocationScope* scope = AllocationScope::current(); scope != nullptr; scope = scope->parent_) {
+				++scope->heap_allocations_;
+				scope->heap_bytes_ += bytes;
+			}
+		}
+
+
+		// The storage a matrix of the given shape holds: one buffer for the row
+		// objects and one per non-empty row. Only footprints created while tracking
+		// was on are released again, so toggling tracking never skews live bytes.
+		template<typename T>
+		class MatrixFootprint {
+		public:
+			MatrixFootprint() noexcept = default;
+			MatrixFootprint(std::size_t rows, std::size_t columns) noexcept {
+				acquire(rows, columns);
+			}
+
+			MatrixFootprint(const MatrixFootprint& other) noexcept {
+				acquire(other.rows_, other.columns_);
+			}
+			MatrixFootprint(MatrixFootprint&& other) noexcept
+				: rows_(std::exchange(other.rows_, 0)),
+				columns_(std::exchange(other.columns_, 0)),
+				tracked_(std::exchange(other.tracked_, false)) {}
+
+			MatrixFootprint& operator=(const MatrixFootprint& other) noexcept {
+				if (this != &other && (rows_ != other.rows_ || columns_ != other.columns_)) {
+					release();
+					acquire(other.rows_, other.columns_);
+				}
+				return *this;
+			}
+			MatrixFootprint& operator=(MatrixFootprint&& other) noexcept {
+				if (this != &other) {
+					release();
+					rows_ = std::exchange(other.rows_, 0);
+					columns_ = std::exchange(other.columns_, 0);
+					tracked_ = std::exchange(other.tracked_, false);
+				}
+				return *this;
+			}
+
+			~MatrixFootprint() { release(); }
+
+			// The matrix changed shape in place, keeping its buffers: only the
+			// row buffers and bytes gained or lost are recorded.
+			void reshape(std::size_t rows, std::size_t columns) noexcept {
+				if (tracked_) {
+					const std::uint64_t old_count = allocations(rows_, columns_);
+					const std::uint64_t new_count = allocations(rows, columns);
+					const std::uint64_t old_bytes = bytes(rows_, columns_);
+					const std::uint64_t new_bytes = bytes(rows, columns);
+					if (new_count > old_count || new_bytes > old_bytes) {
+						record_allocation(Detail::type_slot<T>::value, new_count > old_count ? new_count - old_count : 0,
+							new_bytes > old_bytes ? new_bytes - old_bytes : 0);
+					}
+					if (old_count > new_count || old_bytes > new_bytes) {
+						record_deallocation(Detail::type_slot<T>::value, old_count > new_count ? old_count - new_count : 0,
+							old_bytes > new_bytes ? old_bytes - new_bytes : 0);
+					}
+				}
+				rows_ = rows;
+				columns_ = columns;
+			}
+
+			[[nodiscard]] static constexpr std::uint64_t allocations(std::size_t rows, std::size_t columns) noexcept {
+				return rows == 0 ? 0 : 1 + (columns == 0 ? 0 : rows);
+			}
+			[[nodiscard]] static constexpr std::uint64_t bytes(std::size_t rows, std::size_t columns) noexcept {
+				return rows * sizeof(std::vector<T>) + rows * columns * sizeof(T);
+			}
+
+		private:
+			std::size_t rows_ = 0;
+			std::size_t columns_ = 0;
+			bool tracked_ = false;
+
+			void acquire(std::size_t rows, std::size_t columns) noexcept {
+				rows_ = rows;
+				columns_ = columns;
+				tracked_ = allocation_tracking_enabled() && rows != 0;
+				if (tracked_) {
+					record_allocation(Detail::type_slot<T>::value, allocations(rows, columns), bytes(rows, columns));
+				}
+			}
+			void release() noexcept {
+				if (tracked_) {
+					record_deallocation(Detail::type_slot<T>::value, allocations(rows_, columns_), bytes(rows_, columns_));
+					tracked_ = false;
+				}
+				rows_ = columns_ = 0;
+			}
+		};
+
+		// The single buffer of a Core::Vector of the given size.
+		template<typename T>
+		class VectorFootprint {
+		public:
+			VectorFootprint() noexcept = default;
+			explicit VectorFootprint(std::size_t size) noexcept {
+				acquire(size);
+			}
+
+			VectorFootprint(const VectorFootprint& other) noexcept {
+				acquire(other.size_);
+			}
+			VectorFootprint(VectorFootprint&& other) noexcept
+				: size_(std::exchange(other.size_, 0)),
+				tracked_(std::exchange(other.tracked_, false)) {}
+
+			VectorFootprint& operator=(const VectorFootprint& other) noexcept {
+				if (this != &other && size_ != other.size_) {
+					release();
+					acquire(other.size_);
+				}
+				return *this;
+			}
+			VectorFootprint& operator=(VectorFootprint&& other) noexcept {
+				if (this != &other) {
+					release();
+					size_ = std::exchange(other.size_, 0);
+					tracked_ = std::exchange(other.tracked_, false);
+				}
+				return *this;
+			}
+
+			~VectorFootprint() { release(); }
+
+		private:
+			std::size_t size_ = 0;
+			bool tracked_ = false;
+
+			void acquire(std::size_t size) noexcept {
+				size_ = size;
+				tracked_ = allocation_tracking_enabled() && size != 0;
+				if (tracked_) {
+					record_allocation(Detail::type_slot<T>::value, 1, size * sizeof(T));
+				}
+			}
+			void release() noexcept {
+				if (tracked_) {
+					record_deallocation(Detail::type_slot<T>::value, 1, size_ * sizeof(T));
+					tracked_ = false;
+				}
+				size_ = 0;
+			}
+		};
+
+
+		template<typename T>
+		[[nodiscard]] AllocationStats matrix_allocation_stats() noexcept {
+			return Detail::to_stats(Detail::tracker().types[Detail::type_slot<T>::value]);
+		}
+
+		[[nodiscard]] inline AllocationStats total_allocation_stats() noexcept {
+			return Detail::to_stats(Detail::tracker().total);
+		}
+
+		// Clears counts and sites; live bytes are kept and become the new peak.
+		inline void reset_allocation_stats() {
+			Detail::Tracker& tracker = Detail::tracker();
+			for (auto& counters : tracker.types) {
+				Detail::reset_counters(counters);
+			}
+			Detail::reset_counters(tracker.total);
+			std::lock_guard<std::mutex> lock(tracker.sites_mutex);
+			tracker.sites.clear();
+		}
+
+		// Sites whose path starts with phase (all sites for an empty phase),
+		// largest allocated volume first.
+		[[nodiscard]] inline std::vector<AllocationSite> top_allocation_sites(std::size_t count, const std::string& phase = "") {
+			Detail::Tracker& tracker = Detail::tracker();
+			std::vector<AllocationSite> result;
+			{
+				std::lock_guard<std::mutex> lock(tracker.sites_mutex);
+				for (const auto& entry : tracker.sites) {
+					if (entry.first.compare(0, phase.size(), phase) == 0) {
+						result.push_back(entry.second);
+					}
+				}
+			}
+			std::sort(result.begin(), result.end(), [](const AllocationSite& lhs, const AllocationSite& rhs) {
+				return lhs.bytes != rhs.bytes ? lhs.bytes > rhs.bytes : lhs.path < rhs.path;
+			});
+			if (result.size() > count) {
+				result.resize(count);
+			}
+			return result;
+		}
+
+		inline void write_allocation_report(std::ostream& os, std::size_t site_count = 10) {
+			const auto flags = os.flags();
+
+			os << std::left << std::setw(24) << "matrix type"
+				<< std::right << std::setw(14) << "allocations"
+				<< std::setw(14) << "frees"
+				<< std::setw(16) << "bytes"
+				<< std::setw(16) << "live bytes"
+				<< std::setw(16) << "peak bytes" << '\n';
+			auto write_row = [&os](const char* name, const AllocationStats& stats) {
+				os << std::left << std::setw(24) << name
+					<< std::right << std::setw(14) << stats.allocations
+					<< std::setw(14) << stats.deallocations
+					<< std::setw(16) << stats.bytes_allocated
+					<< std::setw(16) << stats.live_bytes
+					<< std::setw(16) << stats.peak_live_bytes << '\n';
+			};
+			for (std::size_t i = 0; i < Detail::type_slots; ++i) {
+				const AllocationStats stats = Detail::to_stats(Detail::tracker().types[i]);
+				if (stats.allocations != 0 || stats.live_bytes != 0) {
+					write_row(Detail::type_names[i], stats);
+				}
+			}
+			write_row("total", total_allocation_stats());
+
+			const auto sites = top_allocation_sites(site_count);
+			if (!sites.empty()) {
+				os << '\n' << std::left << std::setw(72) << "site"
+					<< std::right << std::setw(14) << "allocations"
+					<< std::setw(16) << "bytes"
+					<< std::setw(16) << "peak bytes" << '\n';
+				for (const auto& site : sites) {
+					os << std::left << std::setw(72) << site.path
+						<< std::right << std::setw(14) << site.allocations
+						<< std::setw(16) << site.bytes
+						<< std::setw(16) << site.peak_live_bytes << '\n';
+				}
+			}
+
+			os.flags(flags);
+		}
+
+	}
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "matrix_view.h"
+#include "type_traits.h"
+
+// Blocked, packed matrix product C = alpha * op(A) * op(B) + beta * C.
+//
+// For every KC x NC panel of op(B) the panel is copied, already transposed or
+// conjugated as requested, into a contiguous thread-local buffer; MR rows of
+// op(A) at a time are packed the same way with alpha folded in. The micro
+// kernel then streams contiguous rows of the packed panel into MR rows of C,
+// which is a loop the compiler vectorizes. The packing buffers grow to the
+// largest panel seen and are reused afterwards, so repeated products of the
+// same shape do not allocate.
+
+namespace Core {
+	namespace Kernels {
+
+		using Traits::conjugate;
+
+		inline constexpr std::size_t gemm_mr = 4;
+		inline constexpr std::size_t gemm_kc = 128;
+		inline constexpr std::size_t gemm_nc = 256;
+
+		namespace Detail {
+
+			template<typename T>
+			struct GemmWorkspace {
+				std::vector<T> packed_a;
+				std::vector<T> packed_b;
+			};
+
+			template<typename T>
+			GemmWorkspace<T>& gemm_workspace() {
+				thread_local GemmWorkspace<T> workspace;
+				return workspace;
+			}
+
+			// op(A)(i, p) for the flags the kernels understand.
+			template<typename T>
+			inline T element(const MatrixView<const T>& a, Op op, std::size_t i, std::size_t p) {
+				switch (op) {
+				case Op::no_transpose: return a(i, p);
+				case Op::transpose: return a(p, i);
+				case Op::conjugate_transpose: return conjugate(a(p, i));
+				case Op::conjugate: return conjugate(a(i, p));
+				}
+				return T{};
+			}
+
+			template<typename T>
+			void pack_b(const MatrixView<const T>& b, Op op, std::size_t kk, std::size_t kc,
+				std::size_t jj, std::size_t nc, T* packed) {
+				if (!is_transposed(op)) {
+					for (std::size_t p = 0; p < kc; ++p) {
+						const T* source = b.row(kk + p) + jj;
+						T* target = packed + p * nc;
+						if (is_conjugated(op)) {
+							for (std::size_t j = 0; j < nc; ++j) {
+								target[j] = conjugate(source[j]);
+							}
+						}
+						else {
+							std::copy(source, source + nc, target);
+						}
+					}
+				}
+				else {
+					// op(B)(p, j) = B(j, p): walk rows of B and scatter into columns
+					// of the panel, which keeps the reads from B contiguous.
+					for (std::size_t j = 0; j < nc; ++j) {
+						const T* source = b.row(jj + j) + kk;
+						for (std::size_t p = 0; p < kc; ++p) {
+							packed[p * nc + j] = is_conjugated(op) ? conjugate(source[p]) : source[p];
+						}
+					}
+				}
+			}
+
+			template<typename T>
+			void pack_a(const MatrixView<const T>& a, Op op, std::size_t ii, std::size_t mr,
+				std::size_t kk, std::size_t kc, const T& alpha, T* packed) {
+				if (!is_transposed(op)) {
+					for (std::size_t r = 0; r < mr; ++r) {
+						const T* source = a.row(ii + r) + kk;
+						for (std::size_t p = 0; p < kc; ++p) {
+							packed[r * kc + p] = alpha * (is_conjugated(op) ? conjugate(source[p]) : source[p]);
+						}
+					}
+				}
+				else {
+					for (std::size_t p = 0; p < kc; ++p) {
+						const T* source = a.row(kk + p) + ii;
+						for (std::size_t r = 0; r < mr; ++r) {
+							packed[r * kc + p] = alpha * (is_conjugated(op) ? conjugate(source[r]) : source[r]);
+						}
+					}
+				}
+			}
+
+			template<typename T>
+			void micro_kernel(std::size_t mr, std::size_t kc, std::size_t nc,
+				const T* packed_a, const T* packed_b, T* const* c) {
+				if (mr == gemm_mr) {
+					T* c0 = c[0];
+					T* c1 = c[1];
+					T* c2 = c[2];
+					T* c3 = c[3];
+					for (std::size_t p = 0; p < kc; ++p) {
+						const T a0 = packed_a[p];
+						const T a1 = packed_a[kc + p];
+						const T a2 = packed_a[2 * kc + p];
+						const T a3 = packed_a[3 * kc + p];
+						const T* b = packed_b + p * nc;
+						for (std::size_t j = 0; j < nc; ++j) {
+							const T value = b[j];
+							c0[j] += a0 * value;
+							c1[j] += a1 * value;
+							c2[j] += a2 * value;
+							c3[j] += a3 * value;
+						}
+					}
+					return;
+				}
+				for (std::size_t r = 0; r < mr; ++r) {
+					T* row = c[r];
+					for (std::size_t p = 0; p < kc; ++p) {
+						const T a = packed_a[r * kc + p];
+						const T* b = packed_b + p * nc;
+						for (std::size_t j = 0; j < nc; ++j) {
+							row[j] += a * b[j];
+						}
+					}
+				}
+			}
+		}
+
+
+		template<typename T>
+		void scale(const T& beta, const MatrixView<T>& c) {
+			if (beta == T{ 1 }) {
+				return;
+			}
+			for (std::size_t i = 0; i < c.get_rows(); ++i) {
+				T* row = c.row(i);
+				if (beta == T{ 0 }) {
+					std::fill(row, row + c.get_columns(), T{ 0 });
+				}
+				else {
+					for (std::size_t j = 0; j < c.get_columns(); ++j) {
+						row[j] *= beta;
+					}
+				}
+			}
+		}
+
+		// Shapes are checked by the callers; C must not overlap A or B.
+		template<typename T>
+		void gemm(const T& alpha, const MatrixView<const T>& a, Op op_a,
+			const MatrixView<const T>& b, Op op_b, const T& beta, const MatrixView<T>& c) {
+			const std::size_t m = c.get_rows();
+			const std::size_t n = c.get_columns();
+			const std::size_t k = is_transposed(op_a) ? a.get_rows() : a.get_columns();
+
+			scale(beta, c);
+			if (alpha == T{ 0 } || k == 0 || m == 0 || n == 0) {
+				return;
+			}
+
+			Detail::GemmWorkspace<T>& workspace = Detail::gemm_workspace<T>();
+			const std::size_t panel = std::min(k, gemm_kc) * std::min(n, gemm_nc);
+			if (workspace.packed_b.size() < panel) {
+				workspace.packed_b.resize(panel);
+			}
+			if (workspace.packed_a.size() < gemm_mr * gemm_kc) {
+				workspace.packed_a.resize(gemm_mr * gemm_kc);
+			}
+
+			T* c_rows[gemm_mr];
+			for (std::size_t kk = 0; kk < k; kk += gemm_kc) {
+				const std::size_t kc = std::min(gemm_kc, k - kk);
+				for (std::size_t jj = 0; jj < n; jj += gemm_nc) {
+					const std::size_t nc = std::min(gemm_nc, n - jj);
+					Detail::pack_b(b, op_b, kk, kc, jj, nc, workspace.packed_b.data());
+
+					for (std::size_t ii = 0; ii < m; ii += gemm_mr) {
+						const std::size_t mr = std::min(gemm_mr, m - ii);
+						Detail::pack_a(a, op_a, ii, mr, kk, kc, alpha, workspace.packed_a.data());
+						for (std::size_t r = 0; r < mr; ++r) {
+							c_rows[r] = c.row(ii + r) + jj;
+						}
+						Detail::micro_kernel(mr, kc, nc, workspace.packed_a.data(), workspace.packed_b.data(), c_rows);
+					}
+				}
+			}
+		}
+
+		// C = A * B where A(i, k) == 0 outside -lower_a <= k - i <= upper_a and
+		// likewise for B, so row i of C only gathers the rows of B inside A's
+		// band, each over B's band. Bandwidths must already be clamped to the
+		// shapes; C must be zeroed and must not overlap A or B.
+		template<typename T>
+		void banded_multiply(const MatrixView<const T>& a, std::size_t lower_a, std::size_t upper_a,
+			const MatrixView<const T>& b, std::size_t lower_b, std::size_t upper_b, const MatrixView<T>& c) {
+			const std::size_t k = a.get_columns();
+			const std::size_t n = b.get_columns();
+			for (std::size_t i = 0; i < a.get_rows(); ++i) {
+				const T* a_row = a.row(i);
+				T* c_row = c.row(i);
+				const std::size_t p_end = std::min(k, i + upper_a + 1);
+				for (std::size_t p = i > lower_a ? i - lower_a : 0; p < p_end; ++p) {
+					const T value = a_row[p];
+					const T* b_row = b.row(p);
+					const std::size_t j_end = std::min(n, p + upper_b + 1);
+					for (std::size_t j = p > lower_b ? p - lower_b : 0; j < j_end; ++j) {
+						c_row[j] += value * b_row[j];
+					}
+				}
+			}
+		}
+
+		// A <- A * B for square B, one row at a time through a thread-local row
+		// buffer, so the product can reuse A's storage without reading rows it
+		// has already overwritten.
+		template<typename T>
+		void multiply_rows_in_place(const MatrixView<T>& a, const MatrixView<const T>& b) {
+			const std::size_t n = b.get_columns();
+			thread_local std::vector<T> row_buffer;
+			if (row_buffer.size() < n) {
+				row_buffer.resize(n);
+			}
+			T* buffer = row_buffer.data();
+
+			for (std::size_t i = 0; i < a.get_rows(); ++i) {
+				T* row = a.row(i);
+				std::fill(buffer, buffer + n, T{ 0 });
+				for (std::size_t p = 0; p < a.get_columns(); ++p) {
+					const T value = row[p];
+					const T* b_row = b.row(p);
+					for (std::size_t j = 0; j < n; ++j) {
+						buffer[j] += value * b_row[j];
+					}
+				}
+				std::copy(buffer, buffer + n, row);
+			}
+		}
+
+	}
+}
@@ -0,0 +1,537 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "perf_counters.h"
+
+// Opt-in profiling layer. Library code marks its public operations and the
+// phases of decompositions with MATRIXLIB_PROFILE_ZONE; the macro expands to
+// nothing unless MATRIXLIB_ENABLE_INSTRUMENTATION is defined, so the flop and
+// byte expressions passed to it are not even evaluated in normal builds.
+// With set_hardware_counters_enabled(true) zones also accumulate the
+// perf_event_open counters from perf_counters.h, from which write_summary and
+// write_roofline derive IPC, arithmetic intensity and a roofline position.
+
+#define MATRIXLIB_INSTRUMENTATION_CONCAT_IMPL(a, b) a##b
+#define MATRIXLIB_INSTRUMENTATION_CONCAT(a, b) MATRIXLIB_INSTRUMENTATION_CONCAT_IMPL(a, b)
+
+#if defined(MATRIXLIB_ENABLE_INSTRUMENTATION)
+#define MATRIXLIB_PROFILE_ZONE(name, flops, bytes)                                                        \
+	static const std::size_t MATRIXLIB_INSTRUMENTATION_CONCAT(matrixlib_zone_id_, __LINE__) =             \
+		::Core::Instrumentation::register_zone(name);                                                     \
+	::Core::Instrumentation::ScopedZone MATRIXLIB_INSTRUMENTATION_CONCAT(matrixlib_zone_, __LINE__)(      \
+		MATRIXLIB_INSTRUMENTATION_CONCAT(matrixlib_zone_id_, __LINE__),                                   \
+		static_cast<std::uint64_t>(flops), static_cast<std::uint64_t>(bytes))
+#else
+#define MATRIXLIB_PROFILE_ZONE(name, flops, bytes) ((void)0)
+#endif
+
+namespace Core {
+	namespace Instrumentation {
+
+		inline constexpr std::size_t max_zones = 256;
+		inline constexpr std::size_t trace_capacity_per_thread = std::size_t{ 1 } << 16;
+
+		struct ZoneSummary {
+			std::string name;
+			std::uint64_t calls = 0;
+			std::uint64_t nanoseconds = 0;
+			std::uint64_t flops = 0;
+			std::uint64_t bytes = 0;
+
+			// Summed only over the calls for which the counter could be read.
+			std::array<std::uint64_t, hardware_counter_count> hardware{};
+			std::array<std::uint64_t, hardware_counter_count> hardware_calls{};
+
+			[[nodiscard]] bool has(HardwareCounter counter) const noexcept {
+				return hardware_calls[static_cast<std::size_t>(counter)] != 0;
+			}
+			[[nodiscard]] std::uint64_t operator[](HardwareCounter counter) const noexcept {
+				return hardware[static_cast<std::size_t>(counter)];
+			}
+
+			[[nodiscard]] double seconds() const noexcept { return static_cast<double>(nanoseconds) * 1e-9; }
+			[[nodiscard]] double gflops_per_second() const noexcept {
+				return nanoseconds == 0 ? 0.0 : static_cast<double>(flops) / static_cast<double>(nanoseconds);
+			}
+			[[nodiscard]] double gbytes_per_second() const noexcept {
+				return nanoseconds == 0 ? 0.0 : static_cast<double>(bytes) / static_cast<double>(nanoseconds);
+			}
+
+			[[nodiscard]] double instructions_per_cycle() const noexcept {
+				if (!has(HardwareCounter::cycles) || !has(HardwareCounter::instructions) || (*this)[HardwareCounter::cycles] == 0) {
+					return 0.0;
+				}
+				return static_cast<double>((*this)[HardwareCounter::instructions]) /
+					static_cast<double>((*this)[HardwareCounter::cycles]);
+			}
+
+			// Flops per byte from the analytic counts each zone declares.
+			[[nodiscard]] double arithmetic_intensity() const noexcept {
+				return bytes == 0 ? 0.0 : static_cast<double>(flops) / static_cast<double>(bytes);
+			}
+
+			// Flops per byte of memory traffic estimated from last-level cache misses.
+			[[nodiscard]] double measured_arithmetic_intensity(std::size_t cache_line_bytes = 64) const noexcept {
+				if (!has(HardwareCounter::llc_misses) || (*this)[HardwareCounter::llc_misses] == 0) {
+					return 0.0;
+				}
+				const double work = has(HardwareCounter::fp_operations)
+					? static_cast<double>((*this)[HardwareCounter::fp_operations])
+					: static_cast<double>(flops);
+				return work / (static_cast<double>((*this)[HardwareCounter::llc_misses]) * static_cast<double>(cache_line_bytes));
+			}
+		};
+
+
+		struct RooflineModel {
+			double peak_gflops_per_second = 0.0;
+			double peak_gbytes_per_second = 0.0;
+
+			[[nodiscard]] double ridge_point() const noexcept {
+				return peak_gbytes_per_second == 0.0 ? 0.0 : peak_gflops_per_second / peak_gbytes_per_second;
+			}
+		};
+
+		struct RooflinePoint {
+			double arithmetic_intensity = 0.0;
+			double achieved_gflops_per_second = 0.0;
+			double attainable_gflops_per_second = 0.0;
+			double efficiency = 0.0;
+			bool memory_bound = false;
+		};
+
+		[[nodiscard]] inline RooflinePoint roofline_position(const ZoneSummary& zone, const RooflineModel& model) noexcept {
+			RooflinePoint point;
+			point.arithmetic_intensity = zone.arithmetic_intensity();
+			point.achieved_gflops_per_second = zone.gflops_per_second();
+			point.attainable_gflops_per_second = std::min(model.peak_gflops_per_second,
+				point.arithmetic_intensity * model.peak_gbytes_per_second);
+			point.efficiency = point.attainable_gflops_per_second == 0.0 ? 0.0
+				: point.achieved_gflops_per_second / point.attainable_gflops_per_second;
+			point.memory_bound = point.arithmetic_intensity < model.ridge_point();
+			return point;
+		}
+
+		namespace Detail {
+
+			// Zones add only to their own thread's counters, but reset() zeroes
+			// them from another thread, so the add is a read-modify-write: a
+			// load and store could write back a value from before the reset.
+			// Uncontended, a relaxed fetch_add stays cheap and lock-free.
+			inline void add_relaxed(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept {
+				counter.fetch_add(value, std::memory_order_relaxed);
+			}
+
+			struct ZoneCounters {
+				std::atomic<std::uint64_t> calls{ 0 };
+				std::atomic<std::uint64_t> nanoseconds{ 0 };
+				std::atomic<std::uint64_t> flops{ 0 };
+				std::atomic<std::uint64_t> bytes{ 0 };
+				std::array<std::atomic<std::uint64_t>, hardware_counter_count> hardware{};
+				std::array<std::atomic<std::uint64_t>, hardware_counter_count> hardware_calls{};
+			};
+
+			struct TraceEvent {
+				std::uint32_t zone = 0;
+				std::uint64_t start_ns = 0;
+				std::uint64_t duration_ns = 0;
+				std::uint64_t flops = 0;
+				std::uint64_t bytes = 0;
+			};
+
+			struct ThreadData {
+				explicit ThreadData(std::uint32_t id) : thread_id(id) {}
+
+				std::uint32_t thread_id;
+				std::array<ZoneCounters, max_zones> zones{};
+
+				// The ring buffer is allocated on the first traced zone and is
+				// written by its thread while write_chrome_trace or reset may be
+				// reading it, so both sides hold trace_mutex. It is uncontended
+				// unless a trace is being written.
+				std::mutex trace_mutex;
+				std::unique_ptr<TraceEvent[]> trace;
+				std::uint64_t trace_count = 0;
+
+				std::unique_ptr<PerfCounterGroup> perf;
+			};
+
+			struct Registry {
+				std::mutex mutex;
+				std::array<const char*, max_zones> zone_names{};
+				std::atomic<std::size_t> zone_count{ 0 };
+				std::vector<std::unique_ptr<ThreadData>> threads;
+				std::atomic<bool> trace_enabled{ false };
+				std::atomic<bool> hardware_counters_enabled{ false };
+				const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+			};
+
+			inline Registry& registry() {
+				static Registry instance;
+				return instance;
+			}
+
+			// Thread blocks are owned by the registry and outlive their threads, so
+			// the numbers of finished workers still show up in the report.
+			inline ThreadData& thread_data() {
+				thread_local ThreadData* data = nullptr;
+				if (data == nullptr) {
+					Registry& reg = registry();
+					std::lock_guard<std::mutex> lock(reg.mutex);
+					reg.threads.push_back(std::make_unique<ThreadData>(static_cast<std::uint32_t>(reg.threads.size())));
+					data = reg.threads.back().get();
+				}
+				return *data;
+			}
+
+			inline std::uint64_t now_ns() noexcept {
+				return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - registry().epoch).count());
+			}
+
+			inline PerfCounterGroup& perf_counters(ThreadData& data) {
+				if (!data.perf) {
+					data.perf = std::make_unique<PerfCounterGroup>();
+				}
+				return *data.perf;
+			}
+
+			inline void record_trace(ThreadData& data, const TraceEvent& event) {
+				std::lock_guard<std::mutex> lock(data.trace_mutex);
+				if (!data.trace) {
+					data.trace = std::make_unique<TraceEvent[]>(trace_capacity_per_thread);
+				}
+				data.trace[data.trace_count % trace_capacity_per_thread] = event;
+				++data.trace_count;
+			}
+
+			inline void write_json_string(std::ostream& os, const char* text) {
+				os << '"';
+				for (const char* c = text; *c != '\0'; ++c) {
+					if (*c == '"' || *c == '\\') {
+						os << '\\';
+					}
+					os << *c;
+				}
+				os << '"';
+			}
+		}
+
+
+		inline std::size_t register_zone(const char* name) {
+			Detail::Registry& reg = Detail::registry();
+			std::lock_guard<std::mutex> lock(reg.mutex);
+			const std::size_t count = reg.zone_count.load(std::memory_order_relaxed);
+			for (std::size_t i = 0; i < count; ++i) {
+				if (std::string(reg.zone_names[i]) == name) {
+					return i;
+				}
+			}
+			if (count == max_zones) {
+				throw std::length_error("Too many instrumentation zones");
+			}
+			reg.zone_names[count] = name;
+			reg.zone_count.store(count + 1, std::memory_order_release);
+			return count;
+		}
+
+		inline void set_trace_enabled(bool enabled) noexcept {
+			Detail::registry().trace_enabled.store(enabled, std::memory_order_relaxed);
+		}
+		[[nodiscard]] inline bool trace_enabled() noexcept {
+			return Detail::registry().trace_enabled.load(std::memory_order_relaxed);
+		}
+
+		// Counters are opened lazily, per thread, by the first zone that thread
+		// enters while this is on.
+		inline void set_hardware_counters_enabled(bool enabled) noexcept {
+			Detail::registry().hardware_counters_enabled.store(enabled, std::memory_order_relaxed);
+		}
+		[[nodiscard]] inline bool hardware_counters_enabled() noexcept {
+			return Detail::registry().hardware_counters_enabled.load(std::memory_order_relaxed);
+		}
+
+		// Whether the calling thread could open at least one counter, and why not.
+		[[nodiscard]] inline bool hardware_counters_available() {
+			return Detail::perf_counters(Detail::thread_data()).available();
+		}
+		[[nodiscard]] inline std::string hardware_counters_status() {
+			return Detail::perf_counters(Detail::thread_data()).status();
+		}
+
+
+		class ScopedZone {
+		public:
+			ScopedZone(std::size_t zone, std::uint64_t flops, std::uint64_t bytes)
+				: data_(&Detail::thread_data()), zone_(zone), flops_(flops), bytes_(bytes) {
+				if (hardware_counters_enabled()) {
+					perf_ = &Detail::perf_counters(*data_);
+					hardware_start_ = perf_->read();
+				}
+				start_ = Detail::now_ns();
+			}
+
+			ScopedZone(const ScopedZone&) = delete;
+			ScopedZone& operator=(const ScopedZone&) = delete;
+
+			~ScopedZone() {
+				const std::uint64_t elapsed = Detail::now_ns() - start_;
+				Detail::ZoneCounters& counters = data_->zones[zone_];
+				Detail::add_relaxed(counters.calls, 1);
+				Detail::add_relaxed(counters.nanoseconds, elapsed);
+				Detail::add_relaxed(counters.flops, flops_);
+				Detail::add_relaxed(counters.bytes, bytes_);
+
+				if (perf_ != nullptr) {
+					const CounterSample sample = difference(perf_->read(), hardware_start_);
+					for (std::size_t i = 0; i < hardware_counter_count; ++i) {
+						if (sample.valid[i]) {
+							Detail::add_relaxed(counters.hardware[i], sample.values[i]);
+							Detail::add_relaxed(counters.hardware_calls[i], 1);
+						}
+					}
+				}
+
+				if (trace_enabled()) {
+					try {
+						Detail::record_trace(*data_, { static_cast<std::uint32_t>(zone_), start_, elapsed, flops_, bytes_ });
+					}
+					catch (...) {
+						// A failed trace buffer allocation only loses the event.
+					}
+				}
+			}
+
+		private:
+			Detail::ThreadData* data_;
+			std::size_t zone_;
+			std::uint64_t flops_;
+			std::uint64_t bytes_;
+			std::uint64_t start_ = 0;
+			PerfCounterGroup* perf_ = nullptr;
+			CounterSample hardware_start_;
+		};
+
+
+		// Aggregates the per-thread counters. Intended to be called once worker
+		// threads are quiescent; concurrent updates are read without tearing but
+		// may be missed.
+		[[nodiscard]] inline std::vector<ZoneSummary> snapshot() {
+			Detail::Registry& reg = Detail::registry();
+			std::lock_guard<std::mutex> lock(reg.mutex);
+
+			const std::size_t count = reg.zone_count.load(std::memory_order_acquire);
+			std::vector<ZoneSummary> result(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				result[i].name = reg.zone_names[i];
+			}
+			for (const auto& thread : reg.threads) {
+				for (std::size_t i = 0; i < count; ++i) {
+					const Detail::ZoneCounters& counters = thread->zones[i];
+					result[i].calls += counters.calls.load(std::memory_order_relaxed);
+					result[i].nanoseconds += counters.nanoseconds.load(std::memory_order_relaxed);
+					result[i].flops += counters.flops.load(std::memory_order_relaxed);
+					result[i].bytes += counters.bytes.load(std::memory_order_relaxed);
+					for (std::size_t c = 0; c < hardware_counter_count; ++c) {
+						result[i].hardware[c] += counters.hardware[c].load(std::memory_order_relaxed);
+						result[i].hardware_calls[c] += counters.hardware_calls[c].load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			result.erase(std::remove_if(result.begin(), result.end(),
+				[](const ZoneSummary& zone) { return zone.calls == 0; }), result.end());
+			std::sort(result.begin(), result.end(),
+				[](const ZoneSummary& lhs, const ZoneSummary& rhs) { return lhs.nanoseconds > rhs.nanoseconds; });
+			return result;
+		}
+
+		[[nodiscard]] inline ZoneSummary zone_summary(const std::string& name) {
+			for (auto& zone : snapshot()) {
+				if (zone.name == name) {
+					return zone;
+				}
+			}
+			ZoneSummary empty;
+			empty.name = name;
+			return empty;
+		}
+
+		inline void reset() {
+			Detail::Registry& reg = Detail::registry();
+			std::lock_guard<std::mutex> lock(reg.mutex);
+			for (const auto& thread : reg.threads) {
+				for (auto& counters : thread->zones) {
+					counters.calls.store(0, std::memory_order_relaxed);
+					counters.nanoseconds.store(0, std::memory_order_relaxed);
+					counters.flops.store(0, std::memory_order_relaxed);
+					counters.bytes.store(0, std::memory_order_relaxed);
+					for (std::size_t c = 0; c < hardware_counter_count; ++c) {
+						counters.hardware[c].store(0, std::memory_order_relaxed);
+						counters.hardware_calls[c].store(0, std::memory_order_relaxed);
+					}
+				}
+				std::lock_guard<std::mutex> trace_lock(thread->trace_mutex);
+				thread->trace_count = 0;
+			}
+		}
+
+
+		namespace Detail {
+
+			inline void write_counter(std::ostream& os, const ZoneSummary& zone, HardwareCounter counter, int width) {
+				if (zone.has(counter)) {
+					os << std::setw(width) << zone[counter];
+				}
+				else {
+					os << std::setw(width) << "n/a";
+				}
+			}
+		}
+
+		// Hardware columns are added while hardware counters are enabled; counters
+		// the kernel refused to open are printed as n/a.
+		inline void write_summary(std::ostream& os) {
+			const auto zones = snapshot();
+			const bool hardware = hardware_counters_enabled();
+			const auto flags = os.flags();
+			const auto precision = os.precision();
+
+			os << std::left << std::setw(48) << "zone"
+				<< std::right << std::setw(12) << "calls"
+				<< std::setw(14) << "total ms"
+				<< std::setw(14) << "mean us"
+				<< std::setw(16) << "flops"
+				<< std::setw(16) << "bytes"
+				<< std::setw(10) << "GFLOP/s"
+				<< std::setw(10) << "GB/s";
+			if (hardware) {
+				os << std::setw(8) << "IPC"
+					<< std::setw(14) << "L1D misses"
+					<< std::setw(14) << "LLC misses"
+					<< std::setw(16) << "FP ops"
+					<< std::setw(10) << "flop/B";
+			}
+			os << '\n';
+
+			os << std::fixed << std::setprecision(3);
+			for (const auto& zone : zones) {
+				os << std::left << std::setw(48) << zone.name
+					<< std::right << std::setw(12) << zone.calls
+					<< std::setw(14) << static_cast<double>(zone.nanoseconds) * 1e-6
+					<< std::setw(14) << static_cast<double>(zone.nanoseconds) * 1e-3 / static_cast<double>(zone.calls)
+					<< std::setw(16) << zone.flops
+					<< std::setw(16) << zone.bytes
+					<< std::setw(10) << zone.gflops_per_second()
+					<< std::setw(10) << zone.gbytes_per_second();
+				if (hardware) {
+					if (zone.has(HardwareCounter::cycles) && zone.has(HardwareCounter::instructions)) {
+						os << std::setw(8) << zone.instructions_per_cycle();
+					}
+					else {
+						os << std::setw(8) << "n/a";
+					}
+					Detail::write_counter(os, zone, HardwareCounter::l1d_read_misses, 14);
+					Detail::write_counter(os, zone, HardwareCounter::llc_misses, 14);
+					Detail::write_counter(os, zone, HardwareCounter::fp_operations, 16);
+					os << std::setw(10) << zone.arithmetic_intensity();
+				}
+				os << '\n';
+			}
+
+			if (hardware && !hardware_counters_available()) {
+				os << "hardware counters unavailable: " << hardware_counters_status() << '\n';
+			}
+
+			os.flags(flags);
+			os.precision(precision);
+		}
+
+		// Places every zone on the roofline of the given machine: attainable
+		// performance is min(peak, intensity * bandwidth), and zones left of the
+		// ridge point are limited by memory bandwidth.
+		inline void write_roofline(std::ostream& os, const RooflineModel& model) {
+			const auto zones = snapshot();
+			const auto flags = os.flags();
+			const auto precision = os.precision();
+
+			os << std::left << std::setw(48) << "zone"
+				<< std::right << std::setw(10) << "flop/B"
+				<< std::setw(12) << "GFLOP/s"
+				<< std::setw(12) << "attainable"
+				<< std::setw(12) << "efficiency"
+				<< std::setw(10) << "bound" << '\n';
+
+			os << std::fixed << std::setprecision(3);
+			for (const auto& zone : zones) {
+				const RooflinePoint point = roofline_position(zone, model);
+				os << std::left << std::setw(48) << zone.name
+					<< std::right << std::setw(10) << point.arithmetic_intensity
+					<< std::setw(12) << point.achieved_gflops_per_second
+					<< std::setw(12) << point.attainable_gflops_per_second
+					<< std::setw(12) << point.efficiency
+					<< std::setw(10) << (point.memory_bound ? "memory" : "compute") << '\n';
+			}
+
+			os.flags(flags);
+			os.precision(precision);
+		}
+
+		// Chrome trace-event format ("X" complete events, microsecond timestamps);
+		// load the output in chrome://tracing or Perfetto. Only zones closed while
+		// tracing was enabled are exported, up to trace_capacity_per_thread per thread.
+		inline void write_chrome_trace(std::ostream& os) {
+			Detail::Registry& reg = Detail::registry();
+			std::lock_guard<std::mutex> lock(reg.mutex);
+			const auto flags = os.flags();
+			const auto precision = os.precision();
+
+			os << "{\"traceEvents\":[";
+			os << std::fixed << std::setprecision(3);
+			bool first = true;
+			std::vector<Detail::TraceEvent> events;
+			for (const auto& thread : reg.threads) {
+				// Copy the events out so the thread is blocked only for the copy,
+				// not for the formatting.
+				{
+					std::lock_guard<std::mutex> trace_lock(thread->trace_mutex);
+					events.clear();
+					if (thread->trace) {
+						const std::uint64_t count = thread->trace_count;
+						const std::uint64_t begin = count > trace_capacity_per_thread ? count - trace_capacity_per_thread : 0;
+						for (std::uint64_t i = begin; i < count; ++i) {
+							events.push_back(thread->trace[i % trace_capacity_per_thread]);
+						}
+					}
+				}
+				for (const Detail::TraceEvent& event : events) {
+					os << (first ? "" : ",") << "\n{\"name\":";
+					Detail::write_json_string(os, reg.zone_names[event.zone]);
+					os << ",\"cat\":\"matrixlib\",\"ph\":\"X\""
+						<< ",\"ts\":" << static_cast<double>(event.start_ns) * 1e-3
+						<< ",\"dur\":" << static_cast<double>(event.duration_ns) * 1e-3
+						<< ",\"pid\":1,\"tid\":" << thread->thread_id
+						<< ",\"args\":{\"flops\":" << event.flops << ",\"bytes\":" << event.bytes << "}}";
+					first = false;
+				}
+			}
+			os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+			os.flags(flags);
+			os.precision(precision);
+		}
+
+	}
+}
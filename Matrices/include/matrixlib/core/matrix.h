@@ -1,42 +1,67 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <complex>
 
+#include "allocation_tracker.h"
+#include "gemm_kernel.h"
+#include "instrumentation.h"
+#include "matrix_view.h"
+#include "scratch_allocator.h"
+#include "structure.h"
+#include "syrk_kernel.h"
 #include "type_traits.h"
 
 namespace Core {
 
     using Traits::is_valid_matrix_type;
 
-	template<typename T>
+	// Rows are stored as std::vector<T, Allocator>; the default keeps them plain
+	// std::vector<T>, while Memory::ScratchAllocator (see ScratchMatrix) places
+	// temporaries in the thread-local arena or size-class pool.
+	template<typename T, typename Allocator = std::allocator<T>>
 	class Matrix {
 	public:
+        using allocator_type = Allocator;
+        using row_type = std::vector<T, Allocator>;
+
         Matrix() noexcept : rows(0), columns(0) {}
+        explicit Matrix(const Allocator& allocator) noexcept
+            : data(storage_allocator(allocator)), rows(0), columns(0) {}
         
         
-        Matrix(size_t rows, size_t columns)
+        Matrix(size_t rows, size_t columns, const Allocator& allocator = Allocator())
             noexcept(std::is_nothrow_constructible_v<std::vector<T>>)
-            : data(rows, std::vector<T>(columns)),
+            : data(rows, row_type(columns, allocator), storage_allocator(allocator)),
             rows(rows),
-            columns(columns) {}
-        Matrix(size_t rows, size_t columns, const T& value)
+            columns(columns),
+            footprint(rows, columns) {}
+        Matrix(size_t rows, size_t columns, const T& value, const Allocator& allocator = Allocator())
             noexcept(std::is_nothrow_copy_constructible_v<T>)
-            : data(rows, std::vector<T>(columns, value)),
+            : data(rows, row_type(columns, value, allocator), storage_allocator(allocator)),
             rows(rows),
-            columns(columns) {}
+            columns(columns),
+            footprint(rows, columns) {}
         
         
-        explicit Matrix(const std::vector<std::vector<T>>& data)
-            : data(data),
+        explicit Matrix(const std::vector<std::vector<T>>& data, const Allocator& allocator = Allocator())
+            : data(storage_allocator(allocator)),
             rows(data.size()),
             columns(data.empty() ? 0 : data[0].size())
         {
+            this->data.reserve(rows);
+            for (const auto& row : data) {
+                this->data.emplace_back(row.begin(), row.end(), allocator);
+            }
             check_rectangular();
+            footprint = Memory::MatrixFootprint<T>(rows, columns);
         }
-        explicit Matrix(const std::vector<T>& data_, bool is_column = false) 
-            : rows(is_column ? data_.size() : 1),
+        explicit Matrix(const std::vector<T>& data_, bool is_column = false, const Allocator& allocator = Allocator())
+            : data(storage_allocator(allocator)),
+              rows(is_column ? data_.size() : 1),
               columns(is_column ? 1 : data_.size())
         {
             if (data_.empty()) {
@@ -44,10 +69,7 @@ namespace Core {
                 return;
             }
 
-            data.resize(rows);
-            for (auto& row : data) {
-                row.resize(columns);
-            }
+            data.resize(rows, row_type(columns, allocator));
 
             if (is_column) {
                 for (size_t i = 0; i < rows; ++i) {
@@ -58,15 +80,35 @@ namespace Core {
                     data[0][j] = data_[j];
                 }
             }
+            footprint = Memory::MatrixFootprint<T>(rows, columns);
         }
         
         
+        // Copies between storage policies, e.g. to keep the result of a scratch
+        // computation after its ArenaScope has closed.
+        template<typename OtherAllocator,
+            typename = std::enable_if_t<!std::is_same_v<OtherAllocator, Allocator>>>
+        explicit Matrix(const Matrix<T, OtherAllocator>& other, const Allocator& allocator = Allocator())
+            : data(other.get_rows(), row_type(other.get_columns(), allocator), storage_allocator(allocator)),
+            rows(other.get_rows()),
+            columns(other.get_columns()),
+            footprint(rows, columns),
+            structure_(other.structure())
+        {
+            for (size_t i = 0; i < rows; ++i) {
+                std::copy(other(i).begin(), other(i).end(), data[i].begin());
+            }
+        }
+
         Matrix(const Matrix& other) = default;
         Matrix(Matrix&& other) noexcept
             : data(std::move(other.data)),
             rows(other.rows),
-            columns(other.columns){
+            columns(other.columns),
+            footprint(std::move(other.footprint)),
+            structure_(other.structure_){
             other.rows = other.columns = 0;  
+            other.structure_ = StructureTag();
         }
         
         ~Matrix() = default;
@@ -74,10 +116,48 @@ namespace Core {
         Matrix& operator=(const Matrix& other) = default;
         Matrix& operator=(Matrix&& other) noexcept = default;
 
+        // Copies the values of other, reusing the existing rows when the shapes
+        // agree. Unlike move assignment this never adopts other's storage, which
+        // matters when other lives in a scratch arena.
+        template<typename OtherAllocator>
+        Matrix& assign(const Matrix<T, OtherAllocator>& other) {
+            if (rows != other.get_rows() || columns != other.get_columns()) {
+                *this = Matrix(other.get_rows(), other.get_columns(), get_allocator());
+            }
+            for (size_t i = 0; i < rows; ++i) {
+                std::copy(other(i).begin(), other(i).end(), data[i].begin());
+            }
+            structure_ = other.structure();
+            return *this;
+        }
+
+        [[nodiscard]] Allocator get_allocator() const noexcept { return Allocator(data.get_allocator()); }
+
         [[nodiscard]] constexpr size_t get_rows() const noexcept { return rows; }
         [[nodiscard]] constexpr size_t get_columns() const noexcept { return columns; }
 
+        // See core/structure.h. Any non-const access resets the tag to general,
+        // reads included, so code that only reads uses get() or a const
+        // reference; code that writes through raw row pointers calls
+        // mark_modified() first.
+        [[nodiscard]] const StructureTag& structure() const noexcept { return structure_; }
+        // Only stores when the tag is not already general, so element writes in
+        // a loop over an untagged matrix cost a load and a predictable branch.
+        void mark_modified() noexcept {
+            if (!structure_.is_general()) {
+                structure_ = StructureTag();
+            }
+        }
+        void set_structure(const StructureTag& structure) {
+            if (structure.kind() == Structure::identity && rows != columns) {
+                throw std::invalid_argument("identity structure requires square matrix");
+            }
+            structure_ = structure;
+        }
+
         [[nodiscard]] friend Matrix operator+(const Matrix& lhs, const Matrix& rhs) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator+", lhs.rows * lhs.columns, 3 * lhs.rows * lhs.columns * sizeof(T));
+            MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator+");
             lhs.check_dimensions(rhs);
             Matrix result(lhs.rows, lhs.columns);
             for (size_t i = 0; i < lhs.rows; ++i) {
@@ -97,12 +177,14 @@ namespace Core {
         }
         [[nodiscard]] friend Matrix operator+(Matrix&& lhs, Matrix&& rhs) {
             lhs += rhs;
-            rhs = Matrix<T>();
+            rhs = Matrix();
             return std::move(lhs);
         }    
         
         
         [[nodiscard]] friend Matrix operator-(const Matrix& lhs, const Matrix& rhs) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator-", lhs.rows * lhs.columns, 3 * lhs.rows * lhs.columns * sizeof(T));
+            MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator-");
             lhs.check_dimensions(rhs);
             Matrix result(lhs.rows, lhs.columns);
             for (size_t i = 0; i < lhs.rows; ++i) {
@@ -117,6 +199,8 @@ namespace Core {
             return std::move(lhs);
         }
         [[nodiscard]] friend Matrix operator-(const Matrix& lhs, Matrix&& rhs) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator-", lhs.rows * lhs.columns, 3 * lhs.rows * lhs.columns * sizeof(T));
+            MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator-");
             for (size_t i = 0; i < lhs.rows; ++i) {
                 for (size_t j = 0; j < lhs.columns; ++j) {
                     rhs(i, j) = lhs(i, j) - rhs(i, j);
@@ -126,26 +210,23 @@ namespace Core {
         }
         [[nodiscard]] friend Matrix operator-(Matrix&& lhs, Matrix&& rhs) {
             lhs -= rhs;
-            rhs = Matrix<T>();
+            rhs = Matrix();
             return std::move(lhs);
         }
         
         
         [[nodiscard]] friend Matrix operator*(const Matrix& lhs, const Matrix& rhs) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator*", 2 * lhs.rows * lhs.columns * rhs.columns,
+                (lhs.rows * lhs.columns + rhs.rows * rhs.columns + lhs.rows * rhs.columns) * sizeof(T));
+            MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator*");
             if (lhs.columns != rhs.rows) {
                 throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
             }
-            Matrix result(lhs.rows, rhs.columns);
-            for (size_t i = 0; i < lhs.rows; ++i) {
-                for (size_t j = 0; j < rhs.columns; ++j) {
-                    for (size_t k = 0; k < lhs.columns; ++k) {
-                        result.data[i][j] += lhs.data[i][k] * rhs.data[k][j];
-                    }
-                }
-            }
-            return result;
+            return multiply(lhs, rhs);
         }
         [[nodiscard]] friend Matrix operator*(const Matrix& matrix, T scalar) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator*(scalar)", matrix.rows * matrix.columns, 2 * matrix.rows * matrix.columns * sizeof(T));
+            MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator*(scalar)");
             Matrix result(matrix.rows, matrix.columns);
             for (size_t i = 0; i < matrix.rows; ++i) {
                 for (size_t j = 0; j < matrix.columns; ++j) {
@@ -158,69 +239,48 @@ namespace Core {
             return matrix * scalar;
         }
         [[nodiscard]] friend Matrix operator*(Matrix&& lhs, const Matrix& rhs) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator*", 2 * lhs.rows * lhs.columns * rhs.columns,
+                (lhs.rows * lhs.columns + rhs.rows * rhs.columns + lhs.rows * rhs.columns) * sizeof(T));
+            MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator*");
             if (lhs.columns != rhs.rows) {
                 throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
             }
 
-            Matrix result(lhs.rows, rhs.columns);
-            for (size_t i = 0; i < lhs.rows; ++i) {
-                for (size_t j = 0; j < rhs.columns; ++j) {
-                    result.data[i][j] = 0;
-                    for (size_t k = 0; k < lhs.columns; ++k) {
-                        result.data[i][j] += lhs.data[i][k] * rhs.data[k][j];
-                    }
-                }
-            }
-            lhs = Matrix<T>();
+            Matrix result = multiply(lhs, rhs);
+            lhs = Matrix();
             return result;
         }
         [[nodiscard]] friend Matrix operator*(const Matrix& lhs, Matrix&& rhs) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator*", 2 * lhs.rows * lhs.columns * rhs.columns,
+                (lhs.rows * lhs.columns + rhs.rows * rhs.columns + lhs.rows * rhs.columns) * sizeof(T));
+            MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator*");
             if (lhs.columns != rhs.rows) {
                 throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
             }
 
-            Matrix result(lhs.rows, rhs.columns);
-            for (size_t i = 0; i < lhs.rows; ++i) {
-                for (size_t j = 0; j < rhs.columns; ++j) {
-                    result.data[i][j] = 0;
-                    for (size_t k = 0; k < lhs.columns; ++k) {
-                        result.data[i][j] += lhs.data[i][k] * rhs.data[k][j];
-                    }
-                }
-            }
-            rhs = Matrix<T>();
+            Matrix result = multiply(lhs, rhs);
+            rhs = Matrix();
             return result;
         }
         [[nodiscard]] friend Matrix operator*(Matrix&& lhs, Matrix&& rhs) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator*", 2 * lhs.rows * lhs.columns * rhs.columns,
+                (lhs.rows * lhs.columns + rhs.rows * rhs.columns + lhs.rows * rhs.columns) * sizeof(T));
+            MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator*");
             if (lhs.columns != rhs.rows) {
                 throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
             }
 
-            if (lhs.rows == rhs.rows && lhs.columns == rhs.columns) {
-                for (size_t i = 0; i < lhs.rows; ++i) {
-                    for (size_t j = 0; j < rhs.columns; ++j) {
-                        T sum = 0;
-                        for (size_t k = 0; k < lhs.columns; ++k) {
-                            sum += lhs.data[i][k] * rhs.data[k][j];
-                        }
-                        lhs.data[i][j] = sum;
-                    }
-                }
-                rhs = Matrix<T>();
+            // With a square right operand the result has lhs's shape, so it is
+            // built row by row in lhs's own storage.
+            if (rhs.rows == rhs.columns && &lhs != &rhs && lhs.structure_.is_general() && rhs.structure_.is_general()) {
+                Kernels::multiply_rows_in_place(MatrixView<T>(lhs), MatrixView<const T>(rhs));
+                rhs = Matrix();
                 return std::move(lhs);
             }
             else {
-                Matrix result(lhs.rows, rhs.columns);
-                for (size_t i = 0; i < lhs.rows; ++i) {
-                    for (size_t j = 0; j < rhs.columns; ++j) {
-                        result.data[i][j] = 0;
-                        for (size_t k = 0; k < lhs.columns; ++k) {
-                            result.data[i][j] += lhs.data[i][k] * rhs.data[k][j];
-                        }
-                    }
-                }
-                lhs = Matrix<T>();
-                rhs = Matrix<T>();
+                Matrix result = multiply(lhs, rhs);
+                lhs = Matrix();
+                rhs = Matrix();
                 return result;
             }
         }
@@ -245,15 +305,21 @@ namespace Core {
             return os;
         }
  
-        T& operator()(size_t i, size_t j) { return data[i][j]; }
+        T& operator()(size_t i, size_t j) { mark_modified(); return data[i][j]; }
         const T& operator()(size_t i, size_t j) const { return data[i][j]; }
 
-        std::vector<T>& operator()(size_t i) { return data[i]; }
-        const std::vector<T>& operator()(size_t i) const { return data[i]; }
+        row_type& operator()(size_t i) { mark_modified(); return data[i]; }
+        const row_type& operator()(size_t i) const { return data[i]; }
+
+        // Read-only access that keeps the structure tag of a non-const matrix.
+        [[nodiscard]] const T& get(size_t i, size_t j) const { return data[i][j]; }
+        [[nodiscard]] const row_type& get(size_t i) const { return data[i]; }
         
         
         Matrix& operator+=(const Matrix& other) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator+=", rows * columns, 3 * rows * columns * sizeof(T));
             check_dimensions(other);
+            structure_ = StructureTag();
             for (size_t i = 0; i < rows; ++i) {
                 for (size_t j = 0; j < columns; ++j) {
                     data[i][j] += other.data[i][j];
@@ -264,7 +330,9 @@ namespace Core {
         
         
         Matrix& operator-=(const Matrix& other) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator-=", rows * columns, 3 * rows * columns * sizeof(T));
             check_dimensions(other);
+            structure_ = StructureTag();
             for (size_t i = 0; i < rows; ++i) {
                 for (size_t j = 0; j < columns; ++j) {
                     data[i][j] -= other.data[i][j];
@@ -275,6 +343,14 @@ namespace Core {
        
         
         Matrix& operator*=(T scalar) {
+            MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator*=(scalar)", rows * columns, 2 * rows * columns * sizeof(T));
+            // Scaling keeps the zero pattern; a complex factor breaks Hermitian symmetry.
+            if (structure_.kind() == Structure::identity) {
+                structure_ = StructureTag(Structure::diagonal);
+            }
+            else if (structure_.kind() == Structure::hermitian && Traits::conjugate(scalar) != scalar) {
+                structure_ = StructureTag();
+            }
             for (auto& row : data) {
                 for (auto& elem : row) {
                     elem *= scalar;
@@ -305,12 +381,77 @@ namespace Core {
             if (i >= rows || j >= columns) {
                 throw std::out_of_range("matrix indeces is out of range");
             }
+           structure_ = StructureTag();
            std::swap(data[i], data[j]);
         }
 
 
-        auto begin() { return data.begin(); }
-        auto end() { return data.end(); }
+        // Shape changes that keep the existing row buffers, so growing a
+        // factor by one row or column allocates at most that row (rows grow
+        // their capacity geometrically). New entries are zero and the
+        // structure tag is reset. resize keeps the leading block.
+        void resize(size_t new_rows, size_t new_columns) {
+            structure_ = StructureTag();
+            if (new_rows < rows) {
+                data.erase(data.begin() + static_cast<std::ptrdiff_t>(new_rows), data.end());
+            }
+            if (new_columns != columns) {
+                for (auto& row : data) {
+                    row.resize(new_columns);
+                }
+            }
+            data.reserve(new_rows);
+            while (data.size() < new_rows) {
+                data.emplace_back(new_columns, T{}, get_allocator());
+            }
+            rows = new_rows;
+            columns = new_columns;
+            footprint.reshape(rows, columns);
+        }
+        void insert_row(size_t position) {
+            if (position > rows) {
+                throw std::out_of_range("row position is out of range");
+            }
+            structure_ = StructureTag();
+            data.emplace(data.begin() + static_cast<std::ptrdiff_t>(position), columns, T{}, get_allocator());
+            ++rows;
+            footprint.reshape(rows, columns);
+        }
+        void erase_row(size_t position) {
+            if (position >= rows) {
+                throw std::out_of_range("row position is out of range");
+            }
+            structure_ = StructureTag();
+            data.erase(data.begin() + static_cast<std::ptrdiff_t>(position));
+            --rows;
+            footprint.reshape(rows, columns);
+        }
+        void insert_column(size_t position) {
+            if (position > columns) {
+                throw std::out_of_range("column position is out of range");
+            }
+            structure_ = StructureTag();
+            for (auto& row : data) {
+                row.insert(row.begin() + static_cast<std::ptrdiff_t>(position), T{});
+            }
+            ++columns;
+            footprint.reshape(rows, columns);
+        }
+        void erase_column(size_t position) {
+            if (position >= columns) {
+                throw std::out_of_range("column position is out of range");
+            }
+            structure_ = StructureTag();
+            for (auto& row : data) {
+                row.erase(row.begin() + static_cast<std::ptrdiff_t>(position));
+            }
+            --columns;
+            footprint.reshape(rows, columns);
+        }
+
+
+        auto begin() { mark_modified(); return data.begin(); }
+        auto end() { mark_modified(); return data.end(); }
         
         
         auto begin() const { return data.begin(); }
@@ -327,11 +468,48 @@ namespace Core {
 			"Matrix<T> requires T to be either float, double or ComplexNumber<float/double>");
 
 		
-        std::vector<std::vector<T>> data;
+        using storage_type = std::vector<row_type,
+            typename std::allocator_traits<Allocator>::template rebind_alloc<row_type>>;
+
+        storage_type data;
 		
         size_t rows;
 		size_t columns;
 
+        Memory::MatrixFootprint<T> footprint;
+
+        StructureTag structure_;
+
+        // Banded operands (triangular and diagonal included) only visit their
+        // band; everything else goes through the packed gemm kernel.
+        static Matrix multiply(const Matrix& lhs, const Matrix& rhs) {
+            Matrix result(lhs.rows, rhs.columns, lhs.get_allocator());
+            if (lhs.structure_.kind() == Structure::identity) {
+                result.assign(rhs);
+                return result;
+            }
+            if (rhs.structure_.kind() == Structure::identity) {
+                result.assign(lhs);
+                return result;
+            }
+            if (lhs.structure_.has_band(lhs.rows, lhs.columns) || rhs.structure_.has_band(rhs.rows, rhs.columns)) {
+                Kernels::banded_multiply(MatrixView<const T>(lhs),
+                    lhs.structure_.lower_bandwidth(lhs.rows), lhs.structure_.upper_bandwidth(lhs.columns),
+                    MatrixView<const T>(rhs),
+                    rhs.structure_.lower_bandwidth(rhs.rows), rhs.structure_.upper_bandwidth(rhs.columns),
+                    MatrixView<T>(result));
+                result.structure_ = product_structure(lhs.structure_, lhs.rows, rhs.structure_, rhs.rows, rhs.columns);
+                return result;
+            }
+            Kernels::gemm(T{ 1 }, MatrixView<const T>(lhs), Op::no_transpose,
+                MatrixView<const T>(rhs), Op::no_transpose, T{ 0 }, MatrixView<T>(result));
+            return result;
+        }
+
+        static typename storage_type::allocator_type storage_allocator(const Allocator& allocator) {
+            return typename storage_type::allocator_type(allocator);
+        }
+
         void check_rectangular() const {
             for (const auto& row : data) {
                 if (row.size() != columns) {
@@ -346,7 +524,86 @@ namespace Core {
         }
     
         //TODO: оптимизировать умножение
-        Matrix<T> multiply_classic(const Matrix& other) const{}
-        Matrix<T> multiply_blocked(const Matrix& other, size_t block_size = 32) const{}
+        Matrix multiply_classic(const Matrix& other) const{}
+        Matrix multiply_blocked(const Matrix& other, size_t block_size = 32) const{}
     };
+
+    template<typename T>
+    using ScratchMatrix = Matrix<T, Memory::ScratchAllocator<T>>;
+
+
+    namespace Detail {
+
+        // True when lhs * rhs is A A^T, A A^H, A^T A or A^H A of one operand A;
+        // transposed tells the last two apart, conjugate the ^H forms.
+        template<typename T>
+        bool is_rank_k_product(const OpView<T>& lhs, const OpView<T>& rhs, bool& transposed, bool& conjugate) {
+            const MatrixView<const T>& a = lhs.operand();
+            const MatrixView<const T>& b = rhs.operand();
+            if (a.storage() == nullptr || a.storage() != b.storage() || a.row_offset() != b.row_offset() ||
+                a.column_offset() != b.column_offset() || a.get_rows() != b.get_rows() || a.get_columns() != b.get_columns()) {
+                return false;
+            }
+            Op adjoint_op;
+            if (lhs.op() == Op::no_transpose && is_transposed(rhs.op())) {
+                transposed = false;
+                adjoint_op = rhs.op();
+            }
+            else if (is_transposed(lhs.op()) && rhs.op() == Op::no_transpose) {
+                transposed = true;
+                adjoint_op = lhs.op();
+            }
+            else {
+                return false;
+            }
+            conjugate = adjoint_op == Op::conjugate_transpose && Traits::is_complex<T>::value;
+            return true;
+        }
+
+    }
+
+    // Products with transposed(), conjugated() or adjoint() operands. The op
+    // is applied while gemm packs the operand, so no transposed copy is made.
+    // transposed(a) * a, adjoint(a) * a and the like compute one triangle
+    // with the rank-k kernel (core/syrk_kernel.h) and mirror it, about half
+    // the work, and come back tagged symmetric or hermitian.
+    template<typename T, typename Allocator = std::allocator<T>>
+    [[nodiscard]] Matrix<T, Allocator> multiply(const OpView<T>& lhs, const OpView<T>& rhs,
+        const Allocator& allocator = Allocator()) {
+        MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator*", 2 * lhs.get_rows() * lhs.get_columns() * rhs.get_columns(),
+            (lhs.get_rows() * lhs.get_columns() + rhs.get_rows() * rhs.get_columns() + lhs.get_rows() * rhs.get_columns()) * sizeof(T));
+        MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator*");
+        if (lhs.get_columns() != rhs.get_rows()) {
+            throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
+        }
+        Matrix<T, Allocator> result(lhs.get_rows(), rhs.get_columns(), allocator);
+        bool transposed = false;
+        bool conjugate = false;
+        if (Detail::is_rank_k_product(lhs, rhs, transposed, conjugate)) {
+            Kernels::rank_k_update(T{ 1 }, lhs.operand(), transposed, conjugate, T{ 0 }, MatrixView<T>(result), Triangle::upper);
+            Kernels::mirror_triangle(MatrixView<T>(result), Triangle::upper, conjugate);
+            if constexpr (Traits::is_complex<T>::value) {
+                for (size_t i = 0; conjugate && i < result.get_rows(); ++i) {
+                    result(i)[i] = T(result(i, i).real());
+                }
+            }
+            result.set_structure(StructureTag(conjugate ? Structure::hermitian : Structure::symmetric));
+            return result;
+        }
+        Kernels::gemm(T{ 1 }, lhs.operand(), lhs.op(), rhs.operand(), rhs.op(), T{ 0 }, MatrixView<T>(result));
+        return result;
+    }
+
+    template<typename T>
+    [[nodiscard]] Matrix<T> operator*(const OpView<T>& lhs, const OpView<T>& rhs) {
+        return multiply<T>(lhs, rhs);
+    }
+    template<typename T, typename Allocator>
+    [[nodiscard]] Matrix<T, Allocator> operator*(const OpView<T>& lhs, const Matrix<T, Allocator>& rhs) {
+        return multiply<T>(lhs, OpView<T>(rhs), rhs.get_allocator());
+    }
+    template<typename T, typename Allocator>
+    [[nodiscard]] Matrix<T, Allocator> operator*(const Matrix<T, Allocator>& lhs, const OpView<T>& rhs) {
+        return multiply<T>(OpView<T>(lhs), rhs, lhs.get_allocator());
+    }
 }
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "matrix.h"
+#include "type_traits.h"
+
+// Many matrices of one shape in a single buffer. Matrices are grouped by
+// `lanes`, and inside a group the same entry of every member is stored next
+// to each other:
+//
+//   (b, i, j) -> ((b / lanes * rows + i) * columns + j) * lanes + b % lanes
+//
+// so a kernel that works on one group walks every entry as a short contiguous
+// vector across the batch, which the compiler maps onto SIMD lanes, while a
+// group (lanes * rows * columns elements) stays in cache for the whole
+// factorization. The last group is padded up to `lanes` members.
+
+namespace Core {
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class MatrixBatch {
+	public:
+		using allocator_type = Allocator;
+
+		static constexpr std::size_t lanes = 8;
+
+		MatrixBatch() noexcept = default;
+		MatrixBatch(std::size_t count, std::size_t rows, std::size_t columns, const Allocator& allocator = Allocator())
+			: data_((count + lanes - 1) / lanes * lanes * rows * columns, T{}, allocator),
+			count_(count), rows_(rows), columns_(columns) {}
+
+		[[nodiscard]] std::size_t size() const noexcept { return count_; }
+		[[nodiscard]] std::size_t get_rows() const noexcept { return rows_; }
+		[[nodiscard]] std::size_t get_columns() const noexcept { return columns_; }
+		[[nodiscard]] std::size_t groups() const noexcept { return (count_ + lanes - 1) / lanes; }
+		[[nodiscard]] bool same_shape(const MatrixBatch& other) const noexcept {
+			return count_ == other.count_ && rows_ == other.rows_ && columns_ == other.columns_;
+		}
+
+		T& operator()(std::size_t b, std::size_t i, std::size_t j) { return data_[index(b, i, j)]; }
+		const T& operator()(std::size_t b, std::size_t i, std::size_t j) const { return data_[index(b, i, j)]; }
+
+		// First element of group g; entry (i, j) of its members starts at
+		// (i * columns + j) * lanes.
+		[[nodiscard]] T* group(std::size_t g) noexcept { return data_.data() + g * lanes * rows_ * columns_; }
+		[[nodiscard]] const T* group(std::size_t g) const noexcept { return data_.data() + g * lanes * rows_ * columns_; }
+
+		[[nodiscard]] Matrix<T> get(std::size_t b) const {
+			check_index(b);
+			Matrix<T> result(rows_, columns_);
+			for (std::size_t i = 0; i < rows_; ++i) {
+				for (std::size_t j = 0; j < columns_; ++j) {
+					result(i, j) = data_[index(b, i, j)];
+				}
+			}
+			return result;
+		}
+		template<typename OtherAllocator>
+		void set(std::size_t b, const Matrix<T, OtherAllocator>& matrix) {
+			check_index(b);
+			if (matrix.get_rows() != rows_ || matrix.get_columns() != columns_) {
+				throw std::invalid_argument("Matrix does not match the shape of the batch");
+			}
+			for (std::size_t i = 0; i < rows_; ++i) {
+				for (std::size_t j = 0; j < columns_; ++j) {
+					data_[index(b, i, j)] = matrix(i, j);
+				}
+			}
+		}
+
+		void fill(const T& value) {
+			std::fill(data_.begin(), data_.end(), value);
+		}
+		// Every member becomes value * I (padding included).
+		void identity_matrix(const T& value) {
+			std::fill(data_.begin(), data_.end(), T{});
+			for (std::size_t g = 0; g < groups(); ++g) {
+				T* base = group(g);
+				for (std::size_t i = 0; i < std::min(rows_, columns_); ++i) {
+					std::fill(base + (i * columns_ + i) * lanes, base + (i * columns_ + i + 1) * lanes, value);
+				}
+			}
+		}
+
+	private:
+		static_assert(
+			Traits::is_valid_matrix_type<T>::value,
+			"Matrix<T> requires T to be either float, double, long double or ComplexNumber<float/double/long double>");
+
+		std::vector<T, Allocator> data_;
+		std::size_t count_ = 0;
+		std::size_t rows_ = 0;
+		std::size_t columns_ = 0;
+
+		[[nodiscard]] std::size_t index(std::size_t b, std::size_t i, std::size_t j) const noexcept {
+			return ((b / lanes * rows_ + i) * columns_ + j) * lanes + b % lanes;
+		}
+		void check_index(std::size_t b) const {
+			if (b >= count_) {
+				throw std::out_of_range("Batch index is out of range");
+			}
+		}
+	};
+
+}
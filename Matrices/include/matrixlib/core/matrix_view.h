@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "structure.h"
+
+namespace Core {
+
+	template<typename T, typename Allocator>
+	class Matrix;
+	template<typename T, std::size_t R, std::size_t C>
+	class StaticMatrix;
+
+	// How a kernel reads an operand, in the spirit of the BLAS TRANS argument.
+	enum class Op {
+		no_transpose,
+		transpose,
+		conjugate_transpose,
+		conjugate
+	};
+
+	// Which triangle of a symmetric or hermitian matrix a kernel reads or
+	// writes, as the BLAS UPLO argument.
+	enum class Triangle {
+		upper,
+		lower
+	};
+
+	[[nodiscard]] constexpr bool is_transposed(Op op) noexcept {
+		return op == Op::transpose || op == Op::conjugate_transpose;
+	}
+	[[nodiscard]] constexpr bool is_conjugated(Op op) noexcept {
+		return op == Op::conjugate_transpose || op == Op::conjugate;
+	}
+
+
+	// Non-owning window onto a rectangular block of a Matrix (of any allocator)
+	// or a StaticMatrix.
+	// Rows stay separate allocations, so a view hands out one contiguous row
+	// pointer at a time; kernels fetch it once per row and run over it.
+	// MatrixView<const T> is the read-only flavour.
+	template<typename T>
+	class MatrixView {
+	public:
+		using value_type = std::remove_const_t<T>;
+
+		MatrixView() noexcept = default;
+
+		template<typename Allocator, typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+		MatrixView(Matrix<value_type, Allocator>& matrix) noexcept
+			: storage_(&matrix), row_(&row_of<Matrix<value_type, Allocator>>),
+			rows_(matrix.get_rows()), columns_(matrix.get_columns()) {
+			// Writes through the view bypass Matrix, so forget its structure now.
+			matrix.set_structure(StructureTag());
+		}
+
+		template<typename Allocator, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+		MatrixView(const Matrix<value_type, Allocator>& matrix) noexcept
+			: storage_(const_cast<Matrix<value_type, Allocator>*>(&matrix)), row_(&row_of<Matrix<value_type, Allocator>>),
+			rows_(matrix.get_rows()), columns_(matrix.get_columns()) {}
+
+		template<std::size_t R, std::size_t C, typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+		MatrixView(StaticMatrix<value_type, R, C>& matrix) noexcept
+			: storage_(&matrix), row_(&row_of<StaticMatrix<value_type, R, C>>), rows_(R), columns_(C) {}
+
+		template<std::size_t R, std::size_t C, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+		MatrixView(const StaticMatrix<value_type, R, C>& matrix) noexcept
+			: storage_(const_cast<StaticMatrix<value_type, R, C>*>(&matrix)), row_(&row_of<StaticMatrix<value_type, R, C>>),
+			rows_(R), columns_(C) {}
+
+		template<typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+		MatrixView(const MatrixView<value_type>& other) noexcept
+			: storage_(other.storage()), row_(other.row_function()),
+			row_offset_(other.row_offset()), column_offset_(other.column_offset()),
+			rows_(other.get_rows()), columns_(other.get_columns()) {}
+
+		[[nodiscard]] std::size_t get_rows() const noexcept { return rows_; }
+		[[nodiscard]] std::size_t get_columns() const noexcept { return columns_; }
+		[[nodiscard]] bool empty() const noexcept { return rows_ == 0 || columns_ == 0; }
+
+		[[nodiscard]] T* row(std::size_t i) const { return row_(storage_, row_offset_ + i) + column_offset_; }
+		[[nodiscard]] T& operator()(std::size_t i, std::size_t j) const { return row(i)[j]; }
+
+		[[nodiscard]] MatrixView block(std::size_t row, std::size_t column, std::size_t rows, std::size_t columns) const {
+			if (row + rows > rows_ || column + columns > columns_) {
+				throw std::out_of_range("matrix view block is out of range");
+			}
+			MatrixView result = *this;
+			result.row_offset_ += row;
+			result.column_offset_ += column;
+			result.rows_ = rows;
+			result.columns_ = columns;
+			return result;
+		}
+
+		// True when both views look at the same matrix and their blocks intersect.
+		template<typename U>
+		[[nodiscard]] bool overlaps(const MatrixView<U>& other) const noexcept {
+			if (storage_ == nullptr || storage_ != other.storage() || empty() || other.empty()) {
+				return false;
+			}
+			return row_offset_ < other.row_offset() + other.get_rows() && other.row_offset() < row_offset_ + rows_ &&
+				column_offset_ < other.column_offset() + other.get_columns() && other.column_offset() < column_offset_ + columns_;
+		}
+
+		// Always yields mutable rows; a const view only adds const on the way out.
+		using RowFunction = value_type* (*)(void*, std::size_t);
+
+		[[nodiscard]] void* storage() const noexcept { return storage_; }
+		[[nodiscard]] RowFunction row_function() const noexcept { return row_; }
+		[[nodiscard]] std::size_t row_offset() const noexcept { return row_offset_; }
+		[[nodiscard]] std::size_t column_offset() const noexcept { return column_offset_; }
+
+	private:
+		void* storage_ = nullptr;
+		RowFunction row_ = nullptr;
+		std::size_t row_offset_ = 0;
+		std::size_t column_offset_ = 0;
+		std::size_t rows_ = 0;
+		std::size_t columns_ = 0;
+
+		template<typename MatrixType>
+		static value_type* row_of(void* storage, std::size_t i) {
+			// The const accessor leaves the structure tag alone.
+			return const_cast<value_type*>(static_cast<const MatrixType*>(storage)->operator()(i).data());
+		}
+	};
+
+	[[nodiscard]] constexpr Op make_op(bool transposed, bool conjugated) noexcept {
+		if (transposed) {
+			return conjugated ? Op::conjugate_transpose : Op::transpose;
+		}
+		return conjugated ? Op::conjugate : Op::no_transpose;
+	}
+
+
+	// A read-only operand together with the Op a product or solve should apply
+	// to it. transposed(a), adjoint(a) and conjugated(a) return one of these, so
+	// transposed(a) * b hands Op::transpose straight to the gemm packing
+	// routines instead of building the transposed matrix first. get_rows and
+	// get_columns describe op(A). The operand must outlive the OpView: a
+	// temporary lives to the end of the full expression, so transposed(f()) * b
+	// is fine, but an OpView of a temporary kept in a variable dangles.
+	template<typename T>
+	class OpView {
+	public:
+		OpView(const MatrixView<const T>& operand, Op op = Op::no_transpose) noexcept
+			: operand_(operand), op_(op) {}
+		OpView(const MatrixView<T>& operand, Op op = Op::no_transpose) noexcept
+			: operand_(operand), op_(op) {}
+		template<typename Allocator>
+		OpView(const Matrix<T, Allocator>& operand, Op op = Op::no_transpose) noexcept
+			: operand_(operand), op_(op) {}
+
+		[[nodiscard]] const MatrixView<const T>& operand() const noexcept { return operand_; }
+		[[nodiscard]] Op op() const noexcept { return op_; }
+
+		[[nodiscard]] std::size_t get_rows() const noexcept {
+			return is_transposed(op_) ? operand_.get_columns() : operand_.get_rows();
+		}
+		[[nodiscard]] std::size_t get_columns() const noexcept {
+			return is_transposed(op_) ? operand_.get_rows() : operand_.get_columns();
+		}
+
+	private:
+		MatrixView<const T> operand_;
+		Op op_;
+	};
+
+	template<typename T>
+	[[nodiscard]] OpView<T> transposed(const OpView<T>& operand) noexcept {
+		return OpView<T>(operand.operand(), make_op(!is_transposed(operand.op()), is_conjugated(operand.op())));
+	}
+	template<typename T>
+	[[nodiscard]] OpView<T> conjugated(const OpView<T>& operand) noexcept {
+		return OpView<T>(operand.operand(), make_op(is_transposed(operand.op()), !is_conjugated(operand.op())));
+	}
+	template<typename T>
+	[[nodiscard]] OpView<T> adjoint(const OpView<T>& operand) noexcept {
+		return OpView<T>(operand.operand(), make_op(!is_transposed(operand.op()), !is_conjugated(operand.op())));
+	}
+
+	template<typename T, typename Allocator>
+	[[nodiscard]] OpView<T> transposed(const Matrix<T, Allocator>& matrix) noexcept {
+		return OpView<T>(matrix, Op::transpose);
+	}
+	template<typename T, typename Allocator>
+	[[nodiscard]] OpView<T> conjugated(const Matrix<T, Allocator>& matrix) noexcept {
+		return OpView<T>(matrix, Op::conjugate);
+	}
+	// Conjugate transpose; for real T the same as transposed.
+	template<typename T, typename Allocator>
+	[[nodiscard]] OpView<T> adjoint(const Matrix<T, Allocator>& matrix) noexcept {
+		return OpView<T>(matrix, Op::conjugate_transpose);
+	}
+
+
+	template<typename T, typename Allocator>
+	[[nodiscard]] MatrixView<T> view(Matrix<T, Allocator>& matrix) noexcept {
+		return MatrixView<T>(matrix);
+	}
+	template<typename T, typename Allocator>
+	[[nodiscard]] MatrixView<const T> view(const Matrix<T, Allocator>& matrix) noexcept {
+		return MatrixView<const T>(matrix);
+	}
+	template<typename T>
+	[[nodiscard]] MatrixView<const T> const_view(const MatrixView<T>& view) noexcept {
+		return MatrixView<const T>(view);
+	}
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Minimal fork-join helper for the data-parallel kernels. A range is split
+// into at most max_threads() contiguous chunks; chunk boundaries depend only
+// on the range and the thread count, never on timing. The caller and a
+// process-wide pool of worker threads claim chunks until none are left.
+// Workers start on first use and then sleep on a condition variable between
+// calls, so a call costs one wake-up rather than a thread start and join,
+// and it allocates nothing. Ranges too small to give every thread min_chunk
+// items, calls made from inside a chunk (on a worker or on the caller), and
+// calls made while another thread's call holds the pool all run serially.
+
+namespace Core {
+	namespace Parallel {
+
+		namespace Detail {
+			inline std::atomic<std::size_t>& thread_limit() noexcept {
+				static std::atomic<std::size_t> limit{ 0 };
+				return limit;
+			}
+			// Set while the thread runs chunks of a parallel_for call.
+			inline bool& inside_pool() noexcept {
+				thread_local bool inside = false;
+				return inside;
+			}
+
+			// One parallel_for call, owned by the caller's stack frame.
+			struct Job {
+				void (*run_chunk)(void* context, std::size_t chunk);
+				void* context;
+				std::size_t chunks;
+				std::atomic<std::size_t> next{ 0 };
+
+				std::mutex error_mutex;
+				std::exception_ptr error;
+				std::size_t error_chunk = 0;
+
+				// Claims and runs chunks until none are left; keeps the error of
+				// the lowest failing chunk, as a serial loop would report it.
+				void work() noexcept {
+					for (std::size_t chunk = next.fetch_add(1, std::memory_order_relaxed); chunk < chunks;
+						chunk = next.fetch_add(1, std::memory_order_relaxed)) {
+						try {
+							run_chunk(context, chunk);
+						}
+						catch (...) {
+							std::lock_guard<std::mutex> lock(error_mutex);
+							if (!error || chunk < error_chunk) {
+								error = std::current_exception();
+								error_chunk = chunk;
+							}
+						}
+					}
+				}
+			};
+
+			class WorkerPool {
+			public:
+				static WorkerPool& instance() {
+					static WorkerPool pool;
+					return pool;
+				}
+
+				WorkerPool(const WorkerPool&) = delete;
+				WorkerPool& operator=(const WorkerPool&) = delete;
+
+				~WorkerPool() {
+					{
+						std::lock_guard<std::mutex> lock(mutex_);
+						stop_ = true;
+					}
+					wake_.notify_all();
+					for (auto& worker : workers_) {
+						worker.join();
+					}
+				}
+
+				// Runs every chunk of job on the caller and up to helpers workers.
+				// Returns false without running anything if another thread is
+				// using the pool.
+				bool run(Job& job, std::size_t helpers) {
+					std::unique_lock<std::mutex> submit(submit_mutex_, std::try_to_lock);
+					if (!submit.owns_lock()) {
+						return false;
+					}
+					start_workers(helpers);
+					{
+						std::lock_guard<std::mutex> lock(mutex_);
+						job_ = &job;
+						++generation_;
+					}
+					wake_.notify_all();
+
+					// The caller still holds submit_mutex_, so calls nested in its
+					// chunks must go serial before they try to lock it again.
+					inside_pool() = true;
+					job.work();
+					inside_pool() = false;
+
+					std::unique_lock<std::mutex> lock(mutex_);
+					job_ = nullptr;
+					done_.wait(lock, [this] { return busy_ == 0; });
+					return true;
+				}
+
+			private:
+				std::mutex submit_mutex_;
+				std::mutex mutex_;
+				std::condition_variable wake_;
+				std::condition_variable done_;
+				std::vector<std::thread> workers_;
+				Job* job_ = nullptr;
+				std::uint64_t generation_ = 0;
+				std::size_t busy_ = 0;
+				bool stop_ = false;
+
+				WorkerPool() = default;
+
+				// Grows the pool once; if a thread cannot be started the caller
+				// and the workers already running take its chunks.
+				void start_workers(std::size_t count) {
+					while (workers_.size() < count) {
+						try {
+							workers_.emplace_back([this] { serve(); });
+						}
+						catch (...) {
+							return;
+						}
+					}
+				}
+
+				void serve() {
+					inside_pool() = true;
+					std::uint64_t seen = 0;
+					std::unique_lock<std::mutex> lock(mutex_);
+					for (;;) {
+						wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+						if (stop_) {
+							return;
+						}
+						seen = generation_;
+						Job* job = job_;
+						if (job == nullptr) {
+							continue;
+						}
+						++busy_;
+						lock.unlock();
+						job->work();
+						lock.lock();
+						if (--busy_ == 0) {
+							done_.notify_all();
+						}
+					}
+				}
+			};
+		}
+
+		// 0 restores the default, std::thread::hardware_concurrency().
+		inline void set_max_threads(std::size_t threads) noexcept {
+			Detail::thread_limit().store(threads, std::memory_order_relaxed);
+		}
+		[[nodiscard]] inline std::size_t max_threads() noexcept {
+			const std::size_t limit = Detail::thread_limit().load(std::memory_order_relaxed);
+			if (limit != 0) {
+				return limit;
+			}
+			return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+		}
+
+		// Calls function(chunk_begin, chunk_end) over disjoint chunks covering
+		// [begin, end). The exception thrown by the lowest failing chunk is
+		// rethrown once every chunk has finished.
+		template<typename Function>
+		void parallel_for(std::size_t begin, std::size_t end, std::size_t min_chunk, Function&& function) {
+			if (end <= begin) {
+				return;
+			}
+			const std::size_t count = end - begin;
+			const std::size_t threads = std::min(max_threads(), count / std::max<std::size_t>(min_chunk, 1));
+			if (threads <= 1 || Detail::inside_pool()) {
+				function(begin, end);
+				return;
+			}
+
+			struct Context {
+				Function& function;
+				std::size_t begin;
+				std::size_t count;
+				std::size_t threads;
+			} context{ function, begin, count, threads };
+
+			Detail::Job job;
+			job.run_chunk = [](void* erased, std::size_t chunk) {
+				Context& c = *static_cast<Context*>(erased);
+				c.function(c.begin + c.count * chunk / c.threads, c.begin + c.count * (chunk + 1) / c.threads);
+			};
+			job.context = &context;
+			job.chunks = threads;
+
+			if (!Detail::WorkerPool::instance().run(job, threads - 1)) {
+				function(begin, end);
+				return;
+			}
+			if (job.error) {
+				std::rethrow_exception(job.error);
+			}
+		}
+
+	}
+}
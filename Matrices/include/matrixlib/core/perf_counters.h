@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Per-thread hardware performance counters on top of Linux perf_event_open.
+// The counters form one perf group led by the first that opens: the kernel
+// schedules them together, so ratios such as IPC compare the same time
+// window even when it multiplexes, and one read() returns them all. A
+// counter the PMU lacks, say an LLC event, is left out and the rest still
+// report; on other platforms, inside most containers, or with a restrictive
+// perf_event_paranoid, nothing opens and every value reads as unavailable
+// instead of failing.
+
+namespace Core {
+	namespace Instrumentation {
+
+		enum class HardwareCounter : std::size_t {
+			cycles,
+			instructions,
+			l1d_read_misses,
+			llc_misses,
+			fp_operations
+		};
+
+		inline constexpr std::size_t hardware_counter_count = 5;
+
+		[[nodiscard]] constexpr const char* hardware_counter_name(HardwareCounter counter) noexcept {
+			switch (counter) {
+			case HardwareCounter::cycles: return "cycles";
+			case HardwareCounter::instructions: return "instructions";
+			case HardwareCounter::l1d_read_misses: return "L1D read misses";
+			case HardwareCounter::llc_misses: return "LLC misses";
+			case HardwareCounter::fp_operations: return "FP operations";
+			}
+			return "unknown";
+		}
+
+		struct CounterSample {
+			std::array<std::uint64_t, hardware_counter_count> values{};
+			std::array<bool, hardware_counter_count> valid{};
+
+			[[nodiscard]] std::uint64_t operator[](HardwareCounter counter) const noexcept {
+				return values[static_cast<std::size_t>(counter)];
+			}
+			[[nodiscard]] bool has(HardwareCounter counter) const noexcept {
+				return valid[static_cast<std::size_t>(counter)];
+			}
+		};
+
+		namespace Detail {
+
+			// There is no portable perf event for floating-point operations, so the
+			// raw PMU code is taken from MATRIXLIB_PERF_FP_EVENT (hex, e.g. the
+			// FP_ARITH_INST_RETIRED encoding of the local CPU) or set_fp_operations_event.
+			inline std::uint64_t& fp_operations_raw_event() {
+				static std::uint64_t config = [] {
+					const char* value = std::getenv("MATRIXLIB_PERF_FP_EVENT");
+					return value == nullptr ? std::uint64_t{ 0 } : std::strtoull(value, nullptr, 16);
+				}();
+				return config;
+			}
+		}
+
+		// Must be called before the first thread opens its counters.
+		inline void set_fp_operations_event(std::uint64_t raw_config) noexcept {
+			Detail::fp_operations_raw_event() = raw_config;
+		}
+
+
+		class PerfCounterGroup {
+		public:
+			PerfCounterGroup() {
+				fds_.fill(-1);
+#if defined(__linux__)
+				open(HardwareCounter::cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+				open(HardwareCounter::instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+				open(HardwareCounter::l1d_read_misses, PERF_TYPE_HW_CACHE,
+					PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+				open(HardwareCounter::llc_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+				if (Detail::fp_operations_raw_event() != 0) {
+					open(HardwareCounter::fp_operations, PERF_TYPE_RAW, Detail::fp_operations_raw_event());
+				}
+				else if (status_.empty()) {
+					status_ = "FP operations: no raw event configured";
+				}
+#else
+				status_ = "hardware counters require Linux perf_event_open";
+#endif
+			}
+
+			PerfCounterGroup(const PerfCounterGroup&) = delete;
+			PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+			~PerfCounterGroup() {
+#if defined(__linux__)
+				for (int fd : fds_) {
+					if (fd >= 0 && fd != leader_) {
+						::close(fd);
+					}
+				}
+				if (leader_ >= 0) {
+					::close(leader_);
+				}
+#endif
+			}
+
+			[[nodiscard]] bool available() const noexcept { return leader_ >= 0; }
+			[[nodiscard]] bool available(HardwareCounter counter) const noexcept {
+				return fds_[static_cast<std::size_t>(counter)] >= 0;
+			}
+
+			// Describes the first counter that failed to open, empty if all did.
+			[[nodiscard]] const std::string& status() const noexcept { return status_; }
+
+			// Values are scaled by the group's enabled/running time so that a
+			// group the kernel multiplexed still estimates the full interval.
+			[[nodiscard]] CounterSample read() const noexcept {
+				CounterSample sample;
+#if defined(__linux__)
+				if (leader_ < 0) {
+					return sample;
+				}
+				// nr, time enabled, time running, then one value per member in
+				// the order they joined the group.
+				std::uint64_t buffer[3 + hardware_counter_count] = {};
+				const ssize_t bytes = ::read(leader_, buffer, sizeof(buffer));
+				if (bytes < static_cast<ssize_t>(3 * sizeof(std::uint64_t))) {
+					return sample;
+				}
+				const std::size_t values = std::min<std::size_t>({ static_cast<std::size_t>(buffer[0]), members_,
+					static_cast<std::size_t>(bytes) / sizeof(std::uint64_t) - 3 });
+				const std::uint64_t enabled = buffer[1];
+				const std::uint64_t running = buffer[2];
+				for (std::size_t k = 0; k < values; ++k) {
+					std::uint64_t value = buffer[3 + k];
+					if (running != 0 && running < enabled) {
+						value = static_cast<std::uint64_t>(static_cast<double>(value) *
+							static_cast<double>(enabled) / static_cast<double>(running));
+					}
+					sample.values[order_[k]] = value;
+					sample.valid[order_[k]] = true;
+				}
+#endif
+				return sample;
+			}
+
+		private:
+			std::array<int, hardware_counter_count> fds_{};
+			// Group members by position in a group read.
+			std::array<std::size_t, hardware_counter_count> order_{};
+			std::size_t members_ = 0;
+			int leader_ = -1;
+			std::string status_;
+
+#if defined(__linux__)
+			void open(HardwareCounter counter, std::uint32_t type, std::uint64_t config) {
+				perf_event_attr attr;
+				std::memset(&attr, 0, sizeof(attr));
+				attr.size = sizeof(attr);
+				attr.type = type;
+				attr.config = config;
+				attr.disabled = 0;
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+				const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0);
+				if (fd < 0) {
+					if (status_.empty()) {
+						status_ = std::string(hardware_counter_name(counter)) + ": " + std::strerror(errno);
+					}
+					return;
+				}
+				fds_[static_cast<std::size_t>(counter)] = static_cast<int>(fd);
+				if (leader_ < 0) {
+					leader_ = static_cast<int>(fd);
+				}
+				order_[members_++] = static_cast<std::size_t>(counter);
+			}
+#endif
+		};
+
+		[[nodiscard]] inline CounterSample difference(const CounterSample& end, const CounterSample& begin) noexcept {
+			CounterSample result;
+			for (std::size_t i = 0; i < hardware_counter_count; ++i) {
+				result.valid[i] = end.valid[i] && begin.valid[i];
+				result.values[i] = result.valid[i] && end.values[i] >= begin.values[i] ? end.values[i] - begin.values[i] : 0;
+			}
+			return result;
+		}
+
+	}
+}
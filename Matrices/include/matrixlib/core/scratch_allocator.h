@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Thread-local scratch memory for matrix temporaries.
+//
+// A ScratchAllocator<T> holds one value, scope_: how many ArenaScopes were
+// open on the calling thread when it was created. It bumps a pointer in the
+// thread's ScratchArena only while that same scope is the innermost one.
+// Otherwise it takes a block from the thread's size-class pool, which keeps
+// freed blocks instead of returning them to malloc. Either way no lock is
+// taken. A container made outside any scope, or in an outer one, therefore
+// gets pool blocks when it grows inside a nested scope. Those blocks stay
+// valid after the inner scope closes.
+//
+// is_always_equal stays true despite scope_. Each block starts with a
+// BlockHeader recording where it came from (arena, pool or heap), so any
+// instance can free memory from any other, and containers may swap or
+// move-assign storage without comparing allocators.
+//
+// Closing a scope rewinds the arena in one step, and nothing checks who
+// still points into it. Everything allocated in the scope must be dead by
+// then. A ScratchMatrix built in an inner scope and moved out, whether
+// returned or moved into a member or an outer container, keeps its arena
+// rows and dangles once the scope unwinds. Copy results that outlive the
+// scope into ordinary storage with Matrix<T>(scratch) or Matrix::assign.
+
+namespace Core {
+	namespace Memory {
+
+		namespace Detail {
+
+			enum class BlockOrigin : std::uint32_t { arena, pool, heap };
+
+			// Precedes every block handed out, so deallocation knows where the
+			// memory came from without any per-allocator state.
+			struct alignas(std::max_align_t) BlockHeader {
+				BlockOrigin origin;
+				std::uint32_t size_class;
+			};
+
+			inline constexpr std::size_t header_size = sizeof(BlockHeader);
+			inline constexpr std::size_t alignment = alignof(std::max_align_t);
+
+			inline constexpr std::size_t round_up(std::size_t value, std::size_t to) noexcept {
+				return (value + to - 1) / to * to;
+			}
+		}
+
+
+		class ScratchArena {
+		public:
+			struct Marker {
+				std::size_t chunk = 0;
+				std::size_t offset = 0;
+			};
+
+			ScratchArena() = default;
+			ScratchArena(const ScratchArena&) = delete;
+			ScratchArena& operator=(const ScratchArena&) = delete;
+
+			~ScratchArena() {
+				for (auto& chunk : chunks_) {
+					::operator delete(chunk.memory);
+				}
+			}
+
+			[[nodiscard]] void* allocate(std::size_t bytes) {
+				bytes = Detail::round_up(bytes, Detail::alignment);
+				while (current_ < chunks_.size() && chunks_[current_].size - offset_ < bytes) {
+					++current_;
+					offset_ = 0;
+				}
+				if (current_ == chunks_.size()) {
+					const std::size_t previous = chunks_.empty() ? 0 : chunks_.back().size;
+					const std::size_t size = std::max({ minimum_chunk_size, bytes, 2 * previous });
+					chunks_.push_back({ static_cast<std::byte*>(::operator new(size)), size });
+					offset_ = 0;
+				}
+				void* result = chunks_[current_].memory + offset_;
+				offset_ += bytes;
+				high_water_ = std::max(high_water_, used_before(current_) + offset_);
+				return result;
+			}
+
+			[[nodiscard]] Marker mark() const noexcept { return { current_, offset_ }; }
+
+			// Chunks are kept for reuse; they are returned to the system only when
+			// the owning thread exits.
+			void release(Marker marker) noexcept {
+				current_ = marker.chunk;
+				offset_ = marker.offset;
+			}
+
+			[[nodiscard]] std::size_t bytes_in_use() const noexcept { return used_before(current_) + offset_; }
+			[[nodiscard]] std::size_t high_water_mark() const noexcept { return high_water_; }
+			[[nodiscard]] std::size_t capacity() const noexcept {
+				std::size_t total = 0;
+				for (const auto& chunk : chunks_) {
+					total += chunk.size;
+				}
+				return total;
+			}
+
+			[[nodiscard]] static ScratchArena& local() {
+				thread_local ScratchArena arena;
+				return arena;
+			}
+
+		private:
+			struct Chunk {
+				std::byte* memory;
+				std::size_t size;
+			};
+
+			static constexpr std::size_t minimum_chunk_size = std::size_t{ 64 } << 10;
+
+			std::vector<Chunk> chunks_;
+			std::size_t current_ = 0;
+			std::size_t offset_ = 0;
+			std::size_t high_water_ = 0;
+
+			[[nodiscard]] std::size_t used_before(std::size_t chunk) const noexcept {
+				std::size_t total = 0;
+				for (std::size_t i = 0; i < chunk && i < chunks_.size(); ++i) {
+					total += chunks_[i].size;
+				}
+				return total;
+			}
+		};
+
+
+		// Power-of-two size classes from 64 bytes to 1 MiB. Each class keeps a
+		// bounded free list of blocks; larger requests go straight to the heap.
+		class SizeClassPool {
+		public:
+			static constexpr std::size_t class_count = 15;
+			static constexpr std::size_t smallest_block = 64;
+			static constexpr std::size_t cached_blocks_per_class = 64;
+
+			SizeClassPool() = default;
+			SizeClassPool(const SizeClassPool&) = delete;
+			SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+			~SizeClassPool() {
+				for (auto& list : free_lists_) {
+					for (void* block : list) {
+						::operator delete(block);
+					}
+				}
+			}
+
+			[[nodiscard]] static constexpr std::size_t size_class(std::size_t bytes) noexcept {
+				std::size_t index = 0;
+				std::size_t size = smallest_block;
+				while (size < bytes && index < class_count) {
+					size <<= 1;
+					++index;
+				}
+				return index;
+			}
+			[[nodiscard]] static constexpr std::size_t class_size(std::size_t index) noexcept {
+				return smallest_block << index;
+			}
+
+			[[nodiscard]] void* allocate(std::size_t index) {
+				auto& list = free_lists_[index];
+				if (!list.empty()) {
+					void* block = list.back();
+					list.pop_back();
+					++reused_;
+					return block;
+				}
+				return ::operator new(class_size(index));
+			}
+
+			void deallocate(void* block, std::size_t index) noexcept {
+				auto& list = free_lists_[index];
+				if (list.size() < cached_blocks_per_class) {
+					try {
+						list.push_back(block);
+						return;
+					}
+					catch (...) {
+					}
+				}
+				::operator delete(block);
+			}
+
+			[[nodiscard]] std::size_t reused_blocks() const noexcept { return reused_; }
+
+			[[nodiscard]] static SizeClassPool& local() {
+				thread_local SizeClassPool pool;
+				return pool;
+			}
+
+		private:
+			std::array<std::vector<void*>, class_count> free_lists_;
+			std::size_t reused_ = 0;
+		};
+
+
+		// Routes every ScratchAllocator allocation on this thread into the arena
+		// until the scope closes, then releases all of it at once. Scopes nest.
+		class ArenaScope {
+		public:
+			ArenaScope() : arena_(ScratchArena::local()), marker_(arena_.mark()) {
+				++depth();
+			}
+
+			ArenaScope(const ArenaScope&) = delete;
+			ArenaScope& operator=(const ArenaScope&) = delete;
+
+			~ArenaScope() {
+				--depth();
+				arena_.release(marker_);
+			}
+
+			[[nodiscard]] static bool active() noexcept { return depth() != 0; }
+			// Number of scopes open on this thread.
+			[[nodiscard]] static std::size_t level() noexcept { return depth(); }
+
+		private:
+			ScratchArena& arena_;
+			ScratchArena::Marker marker_;
+
+			[[nodiscard]] static std::size_t& depth() noexcept {
+				thread_local std::size_t value = 0;
+				return value;
+			}
+		};
+
+
+		template<typename T>
+		class ScratchAllocator {
+		public:
+			using value_type = T;
+			using is_always_equal = std::true_type;
+			using propagate_on_container_move_assignment = std::true_type;
+
+			ScratchAllocator() noexcept : scope_(ArenaScope::level()) {}
+			template<typename U>
+			ScratchAllocator(const ScratchAllocator<U>& other) noexcept : scope_(other.scope()) {}
+
+			// Scope depth the allocator was created at; 0 outside any scope.
+			[[nodiscard]] std::size_t scope() const noexcept { return scope_; }
+
+			[[nodiscard]] T* allocate(std::size_t n) {
+				if (n > (std::numeric_limits<std::size_t>::max() - Detail::header_size) / sizeof(T)) {
+					throw std::bad_array_new_length();
+				}
+				static_assert(alignof(T) <= Detail::alignment, "ScratchAllocator supports fundamental alignments only");
+
+				const std::size_t bytes = Detail::header_size + n * sizeof(T);
+				Detail::BlockHeader header{};
+				void* block = nullptr;
+				if (scope_ != 0 && scope_ == ArenaScope::level()) {
+					block = ScratchArena::local().allocate(bytes);
+					header.origin = Detail::BlockOrigin::arena;
+				}
+				else if (const std::size_t index = SizeClassPool::size_class(bytes); index < SizeClassPool::class_count) {
+					block = SizeClassPool::local().allocate(index);
+					header.origin = Detail::BlockOrigin::pool;
+					header.size_class = static_cast<std::uint32_t>(index);
+				}
+				else {
+					block = ::operator new(bytes);
+					header.origin = Detail::BlockOrigin::heap;
+				}
+				*static_cast<Detail::BlockHeader*>(block) = header;
+				return reinterpret_cast<T*>(static_cast<std::byte*>(block) + Detail::header_size);
+			}
+
+			void deallocate(T* pointer, std::size_t) noexcept {
+				void* block = reinterpret_cast<std::byte*>(pointer) - Detail::header_size;
+				const Detail::BlockHeader header = *static_cast<Detail::BlockHeader*>(block);
+				switch (header.origin) {
+				case Detail::BlockOrigin::arena:
+					break;
+				case Detail::BlockOrigin::pool:
+					SizeClassPool::local().deallocate(block, header.size_class);
+					break;
+				case Detail::BlockOrigin::heap:
+					::operator delete(block);
+					break;
+				}
+			}
+
+			// Every block records its origin, so any instance can free it.
+			template<typename U>
+			friend bool operator==(const ScratchAllocator&, const ScratchAllocator<U>&) noexcept { return true; }
+			template<typename U>
+			friend bool operator!=(const ScratchAllocator&, const ScratchAllocator<U>&) noexcept { return false; }
+
+		private:
+			std::size_t scope_;
+		};
+
+	}
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "matrix.h"
+#include "matrix_view.h"
+#include "type_traits.h"
+
+// R x C matrix with its entries inline (std::array rows), for the 2x2 to 4x4
+// transforms of inner loops. Nothing allocates, shapes are part of the type so
+// mismatched products do not compile, and every loop has compile-time bounds
+// so the compiler unrolls it and keeps small operands in registers. For real
+// T the whole interface is constexpr; with std::complex, whose arithmetic is
+// only constexpr from C++20, the same code runs at run time.
+//
+// A StaticMatrix converts to and from Core::Matrix, and view() gives a
+// MatrixView onto it, so it can be handed to any kernel that takes one.
+
+namespace Core {
+
+	template<typename T, std::size_t R, std::size_t C>
+	class StaticMatrix {
+	public:
+		using value_type = T;
+		using row_type = std::array<T, C>;
+
+		static constexpr std::size_t rows = R;
+		static constexpr std::size_t columns = C;
+
+		constexpr StaticMatrix() noexcept : data_{} {}
+		// Entries in row-major order; exactly R * C of them.
+		template<typename... Values, typename = std::enable_if_t<
+			sizeof...(Values) == R * C && (std::is_convertible_v<Values, T> && ...)>>
+		constexpr StaticMatrix(const Values&... values) noexcept : data_{} {
+			const T entries[] = { static_cast<T>(values)... };
+			for (std::size_t i = 0; i < R; ++i) {
+				for (std::size_t j = 0; j < C; ++j) {
+					data_[i][j] = entries[i * C + j];
+				}
+			}
+		}
+
+		template<typename Allocator>
+		explicit StaticMatrix(const Matrix<T, Allocator>& matrix) : StaticMatrix(MatrixView<const T>(matrix)) {}
+		explicit StaticMatrix(const MatrixView<const T>& view) : data_{} {
+			if (view.get_rows() != R || view.get_columns() != C) {
+				throw std::invalid_argument("Matrix does not match the static dimensions");
+			}
+			for (std::size_t i = 0; i < R; ++i) {
+				const T* row = view.row(i);
+				for (std::size_t j = 0; j < C; ++j) {
+					data_[i][j] = row[j];
+				}
+			}
+		}
+
+		[[nodiscard]] static constexpr StaticMatrix identity() noexcept {
+			static_assert(R == C, "Identity matrix must be square");
+			StaticMatrix result;
+			for (std::size_t i = 0; i < R; ++i) {
+				result.data_[i][i] = T{ 1 };
+			}
+			return result;
+		}
+
+		[[nodiscard]] Matrix<T> to_matrix() const {
+			Matrix<T> result(R, C);
+			for (std::size_t i = 0; i < R; ++i) {
+				std::copy(data_[i].begin(), data_[i].end(), result(i).begin());
+			}
+			return result;
+		}
+		explicit operator Matrix<T>() const { return to_matrix(); }
+
+		[[nodiscard]] static constexpr std::size_t get_rows() noexcept { return R; }
+		[[nodiscard]] static constexpr std::size_t get_columns() noexcept { return C; }
+
+		constexpr T& operator()(std::size_t i, std::size_t j) noexcept { return data_[i][j]; }
+		constexpr const T& operator()(std::size_t i, std::size_t j) const noexcept { return data_[i][j]; }
+		constexpr row_type& operator()(std::size_t i) noexcept { return data_[i]; }
+		constexpr const row_type& operator()(std::size_t i) const noexcept { return data_[i]; }
+
+		constexpr StaticMatrix& operator+=(const StaticMatrix& other) noexcept {
+			for (std::size_t i = 0; i < R; ++i) {
+				for (std::size_t j = 0; j < C; ++j) {
+					data_[i][j] += other.data_[i][j];
+				}
+			}
+			return *this;
+		}
+		constexpr StaticMatrix& operator-=(const StaticMatrix& other) noexcept {
+			for (std::size_t i = 0; i < R; ++i) {
+				for (std::size_t j = 0; j < C; ++j) {
+					data_[i][j] -= other.data_[i][j];
+				}
+			}
+			return *this;
+		}
+		constexpr StaticMatrix& operator*=(const T& scalar) noexcept {
+			for (std::size_t i = 0; i < R; ++i) {
+				for (std::size_t j = 0; j < C; ++j) {
+					data_[i][j] *= scalar;
+				}
+			}
+			return *this;
+		}
+		constexpr StaticMatrix& operator/=(const T& scalar) noexcept {
+			for (std::size_t i = 0; i < R; ++i) {
+				for (std::size_t j = 0; j < C; ++j) {
+					data_[i][j] /= scalar;
+				}
+			}
+			return *this;
+		}
+
+		[[nodiscard]] friend constexpr StaticMatrix operator+(StaticMatrix lhs, const StaticMatrix& rhs) noexcept { return lhs += rhs; }
+		[[nodiscard]] friend constexpr StaticMatrix operator-(StaticMatrix lhs, const StaticMatrix& rhs) noexcept { return lhs -= rhs; }
+		[[nodiscard]] friend constexpr StaticMatrix operator-(StaticMatrix matrix) noexcept { return matrix *= T{ -1 }; }
+		[[nodiscard]] friend constexpr StaticMatrix operator*(StaticMatrix matrix, const T& scalar) noexcept { return matrix *= scalar; }
+		[[nodiscard]] friend constexpr StaticMatrix operator*(const T& scalar, StaticMatrix matrix) noexcept { return matrix *= scalar; }
+		[[nodiscard]] friend constexpr StaticMatrix operator/(StaticMatrix matrix, const T& scalar) noexcept { return matrix /= scalar; }
+
+		// Inner dimensions are checked by the type: only C x K operands match.
+		template<std::size_t K>
+		[[nodiscard]] friend constexpr StaticMatrix<T, R, K> operator*(const StaticMatrix& lhs, const StaticMatrix<T, C, K>& rhs) noexcept {
+			StaticMatrix<T, R, K> result;
+			for (std::size_t i = 0; i < R; ++i) {
+				for (std::size_t p = 0; p < C; ++p) {
+					const T scale = lhs.data_[i][p];
+					for (std::size_t j = 0; j < K; ++j) {
+						result(i, j) += scale * rhs(p, j);
+					}
+				}
+			}
+			return result;
+		}
+		// Matrix times column vector.
+		[[nodiscard]] friend constexpr std::array<T, R> operator*(const StaticMatrix& matrix, const std::array<T, C>& vector) noexcept {
+			std::array<T, R> result{};
+			for (std::size_t i = 0; i < R; ++i) {
+				for (std::size_t j = 0; j < C; ++j) {
+					result[i] += matrix.data_[i][j] * vector[j];
+				}
+			}
+			return result;
+		}
+
+		[[nodiscard]] friend constexpr bool operator==(const StaticMatrix& lhs, const StaticMatrix& rhs) noexcept {
+			for (std::size_t i = 0; i < R; ++i) {
+				for (std::size_t j = 0; j < C; ++j) {
+					if (!(lhs.data_[i][j] == rhs.data_[i][j])) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+		[[nodiscard]] friend constexpr bool operator!=(const StaticMatrix& lhs, const StaticMatrix& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+
+		friend std::ostream& operator<<(std::ostream& os, const StaticMatrix& matrix) {
+			for (const auto& row : matrix.data_) {
+				for (const auto& elem : row) {
+					os << elem << ' ';
+				}
+				os << '\n';
+			}
+			return os;
+		}
+
+	private:
+		static_assert(
+			Traits::is_valid_matrix_type<T>::value,
+			"Matrix<T> requires T to be either float, double, long double or ComplexNumber<float/double/long double>");
+		static_assert(R > 0 && C > 0, "StaticMatrix dimensions must be positive");
+
+		std::array<row_type, R> data_;
+	};
+
+	template<typename T>
+	using StaticMatrix2 = StaticMatrix<T, 2, 2>;
+	template<typename T>
+	using StaticMatrix3 = StaticMatrix<T, 3, 3>;
+	template<typename T>
+	using StaticMatrix4 = StaticMatrix<T, 4, 4>;
+
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] MatrixView<T> view(StaticMatrix<T, R, C>& matrix) noexcept {
+		return MatrixView<T>(matrix);
+	}
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] MatrixView<const T> view(const StaticMatrix<T, R, C>& matrix) noexcept {
+		return MatrixView<const T>(matrix);
+	}
+
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] constexpr StaticMatrix<T, C, R> transpose(const StaticMatrix<T, R, C>& matrix) noexcept {
+		StaticMatrix<T, C, R> result;
+		for (std::size_t i = 0; i < R; ++i) {
+			for (std::size_t j = 0; j < C; ++j) {
+				result(j, i) = matrix(i, j);
+			}
+		}
+		return result;
+	}
+	// Conjugate transpose; for real T the same as transpose.
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] constexpr StaticMatrix<T, C, R> adjoint(const StaticMatrix<T, R, C>& matrix) noexcept {
+		StaticMatrix<T, C, R> result;
+		for (std::size_t i = 0; i < R; ++i) {
+			for (std::size_t j = 0; j < C; ++j) {
+				result(j, i) = Traits::conjugate(matrix(i, j));
+			}
+		}
+		return result;
+	}
+
+	template<typename T, std::size_t N>
+	[[nodiscard]] constexpr T trace(const StaticMatrix<T, N, N>& matrix) noexcept {
+		T sum{};
+		for (std::size_t i = 0; i < N; ++i) {
+			sum += matrix(i, i);
+		}
+		return sum;
+	}
+
+	namespace Detail {
+		// std::abs is not constexpr for floating point before C++23.
+		template<typename T>
+		[[nodiscard]] constexpr Traits::NormType<T> magnitude(const T& value) noexcept {
+			if constexpr (Traits::is_complex<T>::value) {
+				return std::abs(value);
+			}
+			else {
+				return value < T{ 0 } ? -value : value;
+			}
+		}
+	}
+
+	// Norms with the meaning of their Algebra::Norms counterparts.
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] constexpr Traits::NormType<T> max_norm(const StaticMatrix<T, R, C>& matrix) noexcept {
+		Traits::NormType<T> result{};
+		for (std::size_t i = 0; i < R; ++i) {
+			for (std::size_t j = 0; j < C; ++j) {
+				const Traits::NormType<T> value = Detail::magnitude(matrix(i, j));
+				result = value > result ? value : result;
+			}
+		}
+		return result;
+	}
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] constexpr Traits::NormType<T> l1_norm(const StaticMatrix<T, R, C>& matrix) noexcept {
+		Traits::NormType<T> result{};
+		for (std::size_t i = 0; i < R; ++i) {
+			for (std::size_t j = 0; j < C; ++j) {
+				result += Detail::magnitude(matrix(i, j));
+			}
+		}
+		return result;
+	}
+	// Largest column sum, ||A||_1.
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] constexpr Traits::NormType<T> inductive_l_one_norm_columns(const StaticMatrix<T, R, C>& matrix) noexcept {
+		Traits::NormType<T> result{};
+		for (std::size_t j = 0; j < C; ++j) {
+			Traits::NormType<T> sum{};
+			for (std::size_t i = 0; i < R; ++i) {
+				sum += Detail::magnitude(matrix(i, j));
+			}
+			result = sum > result ? sum : result;
+		}
+		return result;
+	}
+	// Largest row sum, ||A||_inf.
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] constexpr Traits::NormType<T> inductive_l_one_norm_rows(const StaticMatrix<T, R, C>& matrix) noexcept {
+		Traits::NormType<T> result{};
+		for (std::size_t i = 0; i < R; ++i) {
+			Traits::NormType<T> sum{};
+			for (std::size_t j = 0; j < C; ++j) {
+				sum += Detail::magnitude(matrix(i, j));
+			}
+			result = sum > result ? sum : result;
+		}
+		return result;
+	}
+	// Sum of |a_ij|^2; constexpr where frobenius_norm, needing a square root,
+	// cannot be.
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] constexpr Traits::NormType<T> squared_frobenius_norm(const StaticMatrix<T, R, C>& matrix) noexcept {
+		Traits::NormType<T> result{};
+		for (std::size_t i = 0; i < R; ++i) {
+			for (std::size_t j = 0; j < C; ++j) {
+				if constexpr (Traits::is_complex<T>::value) {
+					result += matrix(i, j).real() * matrix(i, j).real() + matrix(i, j).imag() * matrix(i, j).imag();
+				}
+				else {
+					result += matrix(i, j) * matrix(i, j);
+				}
+			}
+		}
+		return result;
+	}
+	// Unscaled, unlike Algebra::Norms::frobenius_norm: it overflows once the
+	// squares of the entries do.
+	template<typename T, std::size_t R, std::size_t C>
+	[[nodiscard]] Traits::NormType<T> frobenius_norm(const StaticMatrix<T, R, C>& matrix) noexcept {
+		return std::sqrt(squared_frobenius_norm(matrix));
+	}
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Structure a matrix is known to have. The tag is a promise made by whoever
+// sets it (Matrix::set_structure or Algebra::Properties::tag_structure); it is
+// not re-checked, and any non-const access to the matrix other than
+// Matrix::get drops it back to general. Kernels only look at the bandwidths:
+// a(i, j) == 0 whenever i - j > lower_bandwidth() or j - i > upper_bandwidth().
+
+namespace Core {
+
+	enum class Structure : std::uint8_t {
+		general,
+		symmetric,
+		hermitian,
+		upper_triangular,
+		lower_triangular,
+		diagonal,
+		banded,
+		identity
+	};
+
+	class StructureTag {
+	public:
+		static constexpr std::size_t unbounded = std::numeric_limits<std::size_t>::max();
+
+		constexpr StructureTag() noexcept = default;
+		// Any kind but banded, whose bandwidths come from banded().
+		constexpr StructureTag(Structure kind) noexcept : kind_(kind) {
+			switch (kind) {
+			case Structure::upper_triangular: lower_ = 0; break;
+			case Structure::lower_triangular: upper_ = 0; break;
+			case Structure::diagonal:
+			case Structure::identity: lower_ = upper_ = 0; break;
+			default: break;
+			}
+		}
+
+		// Normalized against the shape: a band that covers the whole matrix on
+		// one side becomes triangular (or general), a zero band diagonal.
+		[[nodiscard]] static constexpr StructureTag banded(std::size_t lower, std::size_t upper,
+			std::size_t rows = unbounded, std::size_t columns = unbounded) noexcept {
+			const bool full_lower = rows == 0 || lower >= rows - 1;
+			const bool full_upper = columns == 0 || upper >= columns - 1;
+			if (full_lower && full_upper) {
+				return StructureTag();
+			}
+			if (lower == 0 && upper == 0) {
+				return StructureTag(Structure::diagonal);
+			}
+			if (lower == 0 && full_upper) {
+				return StructureTag(Structure::upper_triangular);
+			}
+			if (upper == 0 && full_lower) {
+				return StructureTag(Structure::lower_triangular);
+			}
+			StructureTag tag;
+			tag.kind_ = Structure::banded;
+			tag.lower_ = full_lower ? unbounded : lower;
+			tag.upper_ = full_upper ? unbounded : upper;
+			return tag;
+		}
+
+		[[nodiscard]] constexpr Structure kind() const noexcept { return kind_; }
+		[[nodiscard]] constexpr bool is_general() const noexcept { return kind_ == Structure::general; }
+
+		[[nodiscard]] constexpr std::size_t lower_bandwidth() const noexcept { return lower_; }
+		[[nodiscard]] constexpr std::size_t upper_bandwidth() const noexcept { return upper_; }
+		// Bandwidths clamped to a rows x columns matrix.
+		[[nodiscard]] constexpr std::size_t lower_bandwidth(std::size_t rows) const noexcept {
+			return rows == 0 ? 0 : std::min(lower_, rows - 1);
+		}
+		[[nodiscard]] constexpr std::size_t upper_bandwidth(std::size_t columns) const noexcept {
+			return columns == 0 ? 0 : std::min(upper_, columns - 1);
+		}
+		[[nodiscard]] constexpr bool has_band(std::size_t rows, std::size_t columns) const noexcept {
+			return lower_bandwidth(rows) + 1 < rows || upper_bandwidth(columns) + 1 < columns;
+		}
+
+		friend constexpr bool operator==(const StructureTag& lhs, const StructureTag& rhs) noexcept {
+			return lhs.kind_ == rhs.kind_ && lhs.lower_ == rhs.lower_ && lhs.upper_ == rhs.upper_;
+		}
+		friend constexpr bool operator!=(const StructureTag& lhs, const StructureTag& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+
+	private:
+		Structure kind_ = Structure::general;
+		std::size_t lower_ = unbounded;
+		std::size_t upper_ = unbounded;
+	};
+
+	// Structure of lhs * rhs: bands add up; identity factors pass the other
+	// operand's tag through.
+	[[nodiscard]] constexpr StructureTag product_structure(const StructureTag& lhs, std::size_t lhs_rows,
+		const StructureTag& rhs, std::size_t rhs_rows, std::size_t rhs_columns) noexcept {
+		if (lhs.kind() == Structure::identity) {
+			return rhs;
+		}
+		if (rhs.kind() == Structure::identity) {
+			return lhs;
+		}
+		return StructureTag::banded(lhs.lower_bandwidth(lhs_rows) + rhs.lower_bandwidth(rhs_rows),
+			lhs.upper_bandwidth(rhs_rows) + rhs.upper_bandwidth(rhs_columns), lhs_rows, rhs_columns);
+	}
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "gemm_kernel.h"
+#include "matrix_view.h"
+#include "parallel.h"
+#include "type_traits.h"
+#include "vector_kernel.h"
+
+// Symmetric and hermitian rank-k update on one triangle of C:
+//
+//     C = alpha * op(A) * op(A)^T + beta * C      (syrk)
+//     C = alpha * op(A) * op(A)^H + beta * C      (herk, conjugate = true)
+//
+// with op(A) = A (C = A A^H, one row of C per row of A) or op(A) = A^H
+// (C = A^H A, the Gram matrix of the columns of A). C is cut into
+// syrk_tile x syrk_tile tiles and only those on or inside the requested
+// triangle are visited, about half the work of the full product. Off-diagonal
+// tiles are plain gemm calls whose op flags read A in place, so no transposed
+// copy is made. A diagonal tile is halved recursively, the off-diagonal half
+// going to gemm again, down to syrk_leaf x syrk_leaf blocks summed
+// directly; the other triangle is never read or written. Tiles are
+// independent and spread over threads.
+
+namespace Core {
+	namespace Kernels {
+
+		inline constexpr std::size_t syrk_tile = 128;
+		inline constexpr std::size_t syrk_leaf = 8;
+		// Multiply-adds each thread should get before the tiles are split up.
+		inline constexpr std::size_t syrk_parallel_grain = std::size_t{ 1 } << 20;
+
+		namespace Detail {
+
+			struct RankKShape {
+				bool transposed;
+				bool conjugate;
+			};
+
+			// C(rows, columns) = alpha * op(A)_rows * op(A)_columns^H + beta * C(...)
+			// for a tile that lies off the diagonal.
+			template<typename T>
+			void rank_k_block(const T& alpha, const MatrixView<const T>& a, RankKShape shape, const T& beta,
+				const MatrixView<T>& c, std::size_t row, std::size_t rows, std::size_t column, std::size_t columns) {
+				const Op adjoint = shape.conjugate ? Op::conjugate_transpose : Op::transpose;
+				const MatrixView<T> target = c.block(row, column, rows, columns);
+				if (shape.transposed) {
+					const std::size_t k = a.get_rows();
+					gemm(alpha, a.block(0, row, k, rows), adjoint, a.block(0, column, k, columns), Op::no_transpose, beta, target);
+				}
+				else {
+					const std::size_t k = a.get_columns();
+					gemm(alpha, a.block(row, 0, rows, k), Op::no_transpose, a.block(column, 0, columns, k), adjoint, beta, target);
+				}
+			}
+
+			// The triangle of the diagonal block first..first + size of C, already
+			// scaled by beta, gets alpha * op(A) op(A)^H added.
+			template<typename T>
+			void rank_k_diagonal(const T& alpha, const MatrixView<const T>& a, RankKShape shape, const MatrixView<T>& c,
+				std::size_t first, std::size_t size, Triangle triangle) {
+				const bool upper = triangle == Triangle::upper;
+				if (size > syrk_leaf) {
+					const std::size_t half = size / 2;
+					rank_k_diagonal(alpha, a, shape, c, first, half, triangle);
+					rank_k_diagonal(alpha, a, shape, c, first + half, size - half, triangle);
+					if (upper) {
+						rank_k_block(alpha, a, shape, T{ 1 }, c, first, half, first + half, size - half);
+					}
+					else {
+						rank_k_block(alpha, a, shape, T{ 1 }, c, first + half, size - half, first, half);
+					}
+					return;
+				}
+
+				if (shape.transposed) {
+					// C(i, j) += alpha * sum_p op(A(p, i)) A(p, j), one row of A at a time.
+					for (std::size_t p = 0; p < a.get_rows(); ++p) {
+						const T* row = a.row(p);
+						for (std::size_t i = first; i < first + size; ++i) {
+							const T coefficient = alpha * (shape.conjugate ? conjugate(row[i]) : row[i]);
+							T* c_row = c.row(i);
+							const std::size_t j_begin = upper ? i : first;
+							const std::size_t j_end = upper ? first + size : i + 1;
+							for (std::size_t j = j_begin; j < j_end; ++j) {
+								c_row[j] += coefficient * row[j];
+							}
+						}
+					}
+					return;
+				}
+				// C(i, j) += alpha * <row j, row i>.
+				const std::size_t k = a.get_columns();
+				for (std::size_t i = first; i < first + size; ++i) {
+					T* c_row = c.row(i);
+					const std::size_t j_begin = upper ? i : first;
+					const std::size_t j_end = upper ? first + size : i + 1;
+					for (std::size_t j = j_begin; j < j_end; ++j) {
+						const T sum = shape.conjugate ? dot<true>(a.row(j), a.row(i), k) : dot<false>(a.row(i), a.row(j), k);
+						c_row[j] += alpha * sum;
+					}
+				}
+			}
+
+			// The triangle of a diagonal tile times beta; beta == 0 clears it.
+			template<typename T>
+			void scale_triangle(const T& beta, const MatrixView<T>& c, std::size_t first, std::size_t size, Triangle triangle) {
+				for (std::size_t i = first; i < first + size; ++i) {
+					T* row = c.row(i);
+					const std::size_t j_begin = triangle == Triangle::upper ? i : first;
+					const std::size_t j_end = triangle == Triangle::upper ? first + size : i + 1;
+					for (std::size_t j = j_begin; j < j_end; ++j) {
+						row[j] = beta == T{ 0 } ? T{ 0 } : beta * row[j];
+					}
+				}
+			}
+
+		}
+
+		// Shapes are checked by the callers: C is n x n with n the rows of op(A).
+		// C must not overlap A.
+		template<typename T>
+		void rank_k_update(const T& alpha, const MatrixView<const T>& a, bool transposed, bool conjugate,
+			const T& beta, const MatrixView<T>& c, Triangle triangle) {
+			const std::size_t n = c.get_rows();
+			const std::size_t k = transposed ? a.get_rows() : a.get_columns();
+			const Detail::RankKShape shape{ transposed, conjugate };
+			const std::size_t tiles_per_side = (n + syrk_tile - 1) / syrk_tile;
+
+			std::vector<std::pair<std::size_t, std::size_t>> tiles;
+			tiles.reserve(tiles_per_side * (tiles_per_side + 1) / 2);
+			for (std::size_t bi = 0; bi < tiles_per_side; ++bi) {
+				for (std::size_t bj = 0; bj < tiles_per_side; ++bj) {
+					if (triangle == Triangle::upper ? bi <= bj : bi >= bj) {
+						tiles.emplace_back(bi, bj);
+					}
+				}
+			}
+
+			const std::size_t tile_work = std::max<std::size_t>(1, syrk_tile * syrk_tile * std::max<std::size_t>(k, 1));
+			const std::size_t min_tiles = std::max<std::size_t>(1, syrk_parallel_grain / tile_work);
+			Parallel::parallel_for(0, tiles.size(), min_tiles, [&](std::size_t first, std::size_t last) {
+				for (std::size_t t = first; t < last; ++t) {
+					const std::size_t row = tiles[t].first * syrk_tile;
+					const std::size_t column = tiles[t].second * syrk_tile;
+					const std::size_t rows = std::min(syrk_tile, n - row);
+					const std::size_t columns = std::min(syrk_tile, n - column);
+					if (row != column) {
+						Detail::rank_k_block(alpha, a, shape, beta, c, row, rows, column, columns);
+						continue;
+					}
+					Detail::scale_triangle(beta, c, row, rows, triangle);
+					if (alpha != T{ 0 } && k != 0) {
+						Detail::rank_k_diagonal(alpha, a, shape, c, row, rows, triangle);
+					}
+				}
+			});
+		}
+
+		// Copies the given triangle of a square C onto the other one, conjugated
+		// if asked, in square blocks so the column reads stay in cache.
+		template<typename T>
+		void mirror_triangle(const MatrixView<T>& c, Triangle triangle, bool conjugate_mirror) {
+			constexpr std::size_t block = 32;
+			const std::size_t n = c.get_rows();
+			for (std::size_t ii = 0; ii < n; ii += block) {
+				for (std::size_t jj = 0; jj <= ii; jj += block) {
+					for (std::size_t i = ii; i < std::min(n, ii + block); ++i) {
+						T* row = c.row(i);
+						for (std::size_t j = jj; j < std::min(i, jj + block); ++j) {
+							// (i, j) lies in the lower triangle, (j, i) in the upper one.
+							if (triangle == Triangle::upper) {
+								row[j] = conjugate_mirror ? conjugate(c(j, i)) : c(j, i);
+							}
+							else {
+								c(j, i) = conjugate_mirror ? conjugate(row[j]) : row[j];
+							}
+						}
+					}
+				}
+			}
+		}
+
+	}
+}
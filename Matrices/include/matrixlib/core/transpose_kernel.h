@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "matrix_view.h"
+#include "parallel.h"
+#include "type_traits.h"
+
+// Cache-friendly transposition. The out-of-place kernel halves the larger
+// dimension recursively until a block fits in cache, then moves 8 x 8 tiles
+// through a small local buffer: a tile is read row by row from the source and
+// written row by row to the destination, so neither side is walked with a
+// column stride. Square matrices are transposed in place by swapping mirrored
+// tiles. Conjugation, when requested, happens during the same pass.
+
+namespace Core {
+	namespace Kernels {
+
+		inline constexpr std::size_t transpose_tile = 8;
+		inline constexpr std::size_t transpose_leaf = 64;
+		// Elements each thread should get before a transpose is split up.
+		inline constexpr std::size_t transpose_parallel_grain = std::size_t{ 1 } << 16;
+
+		namespace Detail {
+
+			template<typename T>
+			inline T maybe_conjugate(const T& value, bool conjugate) {
+				return conjugate ? Traits::conjugate(value) : value;
+			}
+
+			// dst(j, i) = src(i, j) for i in [r0, r1), j in [c0, c1).
+			template<typename T>
+			void transpose_leaf_block(const MatrixView<const T>& src, const MatrixView<T>& dst,
+				std::size_t r0, std::size_t r1, std::size_t c0, std::size_t c1, bool conjugate) {
+				T tile[transpose_tile][transpose_tile];
+				for (std::size_t ii = r0; ii < r1; ii += transpose_tile) {
+					const std::size_t height = std::min(transpose_tile, r1 - ii);
+					for (std::size_t jj = c0; jj < c1; jj += transpose_tile) {
+						const std::size_t width = std::min(transpose_tile, c1 - jj);
+						for (std::size_t r = 0; r < height; ++r) {
+							const T* source = src.row(ii + r) + jj;
+							for (std::size_t c = 0; c < width; ++c) {
+								tile[c][r] = source[c];
+							}
+						}
+						for (std::size_t c = 0; c < width; ++c) {
+							T* target = dst.row(jj + c) + ii;
+							for (std::size_t r = 0; r < height; ++r) {
+								target[r] = maybe_conjugate(tile[c][r], conjugate);
+							}
+						}
+					}
+				}
+			}
+
+			template<typename T>
+			void transpose_recursive(const MatrixView<const T>& src, const MatrixView<T>& dst,
+				std::size_t r0, std::size_t r1, std::size_t c0, std::size_t c1, bool conjugate) {
+				const std::size_t height = r1 - r0;
+				const std::size_t width = c1 - c0;
+				if (height <= transpose_leaf && width <= transpose_leaf) {
+					transpose_leaf_block(src, dst, r0, r1, c0, c1, conjugate);
+					return;
+				}
+				// Split on a tile boundary so the leaves see whole tiles.
+				if (height >= width) {
+					const std::size_t middle = r0 + (height / 2 + transpose_tile - 1) / transpose_tile * transpose_tile;
+					transpose_recursive(src, dst, r0, middle, c0, c1, conjugate);
+					transpose_recursive(src, dst, middle, r1, c0, c1, conjugate);
+				}
+				else {
+					const std::size_t middle = c0 + (width / 2 + transpose_tile - 1) / transpose_tile * transpose_tile;
+					transpose_recursive(src, dst, r0, r1, c0, middle, conjugate);
+					transpose_recursive(src, dst, r0, r1, middle, c1, conjugate);
+				}
+			}
+
+			// Exchanges tile (ti, tj) with the transpose of tile (tj, ti), ti != tj.
+			template<typename T>
+			void swap_mirrored_tiles(const MatrixView<T>& a, std::size_t ti, std::size_t tj, bool conjugate) {
+				const std::size_t n = a.get_rows();
+				const std::size_t i0 = ti * transpose_tile;
+				const std::size_t j0 = tj * transpose_tile;
+				const std::size_t height = std::min(transpose_tile, n - i0);
+				const std::size_t width = std::min(transpose_tile, n - j0);
+
+				T upper[transpose_tile][transpose_tile];
+				T lower[transpose_tile][transpose_tile];
+				for (std::size_t r = 0; r < height; ++r) {
+					const T* source = a.row(i0 + r) + j0;
+					std::copy(source, source + width, upper[r]);
+				}
+				for (std::size_t r = 0; r < width; ++r) {
+					const T* source = a.row(j0 + r) + i0;
+					std::copy(source, source + height, lower[r]);
+				}
+				for (std::size_t r = 0; r < height; ++r) {
+					T* target = a.row(i0 + r) + j0;
+					for (std::size_t c = 0; c < width; ++c) {
+						target[c] = maybe_conjugate(lower[c][r], conjugate);
+					}
+				}
+				for (std::size_t r = 0; r < width; ++r) {
+					T* target = a.row(j0 + r) + i0;
+					for (std::size_t c = 0; c < height; ++c) {
+						target[c] = maybe_conjugate(upper[c][r], conjugate);
+					}
+				}
+			}
+
+			template<typename T>
+			void transpose_diagonal_tile(const MatrixView<T>& a, std::size_t t, bool conjugate) {
+				const std::size_t i0 = t * transpose_tile;
+				const std::size_t size = std::min(transpose_tile, a.get_rows() - i0);
+				for (std::size_t r = 0; r < size; ++r) {
+					T* row = a.row(i0 + r) + i0;
+					row[r] = maybe_conjugate(row[r], conjugate);
+					for (std::size_t c = r + 1; c < size; ++c) {
+						T& mirrored = a.row(i0 + c)[i0 + r];
+						const T value = row[c];
+						row[c] = maybe_conjugate(mirrored, conjugate);
+						mirrored = maybe_conjugate(value, conjugate);
+					}
+				}
+			}
+
+			template<typename T>
+			void transpose_tile_row(const MatrixView<T>& a, std::size_t ti, std::size_t tiles, bool conjugate) {
+				transpose_diagonal_tile(a, ti, conjugate);
+				for (std::size_t tj = ti + 1; tj < tiles; ++tj) {
+					swap_mirrored_tiles(a, ti, tj, conjugate);
+				}
+			}
+		}
+
+
+		// dst = src^T (or src^H); dst must be src.get_columns() x src.get_rows()
+		// and must not overlap src. Row strips of src go to different threads.
+		template<typename T>
+		void transpose(const MatrixView<const T>& src, const MatrixView<T>& dst, bool conjugate = false) {
+			const std::size_t rows = src.get_rows();
+			const std::size_t columns = src.get_columns();
+			if (rows == 0 || columns == 0) {
+				return;
+			}
+			const std::size_t strips = (rows + transpose_tile - 1) / transpose_tile;
+			const std::size_t min_strips = std::max<std::size_t>(1, transpose_parallel_grain / (transpose_tile * columns));
+			Parallel::parallel_for(0, strips, min_strips, [&](std::size_t first, std::size_t last) {
+				Detail::transpose_recursive(src, dst, first * transpose_tile, std::min(rows, last * transpose_tile),
+					0, columns, conjugate);
+			});
+		}
+
+		// a = a^T (or a^H) for square a. Tile row k is paired with tile row
+		// tiles - 1 - k, so every task swaps about the same number of tiles.
+		template<typename T>
+		void transpose_in_place(const MatrixView<T>& a, bool conjugate = false) {
+			const std::size_t n = a.get_rows();
+			const std::size_t tiles = (n + transpose_tile - 1) / transpose_tile;
+			const std::size_t pairs = (tiles + 1) / 2;
+			const std::size_t min_pairs = std::max<std::size_t>(1, transpose_parallel_grain / (2 * transpose_tile * std::max<std::size_t>(n, 1)));
+			Parallel::parallel_for(0, pairs, min_pairs, [&](std::size_t first, std::size_t last) {
+				for (std::size_t k = first; k < last; ++k) {
+					Detail::transpose_tile_row(a, k, tiles, conjugate);
+					if (tiles - 1 - k != k) {
+						Detail::transpose_tile_row(a, tiles - 1 - k, tiles, conjugate);
+					}
+				}
+			});
+		}
+
+	}
+}
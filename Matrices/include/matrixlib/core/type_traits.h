@@ -60,5 +60,24 @@ namespace Core {
         template<typename T>
         using NormType = typename norm_value_type<T>::type;
 
+        // std::conj promotes real arguments to std::complex; this keeps T.
+        template<typename T>
+        constexpr T conjugate(const T& value) {
+            if constexpr (is_complex<T>::value) {
+                return std::conj(value);
+            }
+            else {
+                return value;
+            }
+        }
+
+        template<typename T>
+        struct type_identity {
+            using type = T;
+        };
+
+        template<typename T>
+        using type_identity_t = typename type_identity<T>::type;
+
     }
 }
\ No newline at end of file
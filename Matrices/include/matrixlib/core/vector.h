@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "allocation_tracker.h"
+#include "instrumentation.h"
+#include "matrix.h"
+#include "matrix_view.h"
+#include "type_traits.h"
+#include "vector_kernel.h"
+
+// A dense vector in one contiguous buffer. Matrix(std::vector<T>, true)
+// still builds an n x 1 column, but that is n + 1 allocations and every
+// product with it goes through gemm; Vector is one allocation and
+// Matrix * Vector runs the gemv kernel. VectorView is the non-owning
+// counterpart, over a Vector, a std::vector, a matrix row or any pointer and
+// length; Algebra::Blas takes views.
+
+namespace Core {
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class Vector {
+	public:
+		using allocator_type = Allocator;
+		using value_type = T;
+		using storage_type = std::vector<T, Allocator>;
+
+		Vector() noexcept = default;
+		explicit Vector(const Allocator& allocator) noexcept : data_(allocator) {}
+		explicit Vector(size_t size, const Allocator& allocator = Allocator())
+			: data_(size, T{}, allocator), footprint(size) {}
+		Vector(size_t size, const T& value, const Allocator& allocator = Allocator())
+			: data_(size, value, allocator), footprint(size) {}
+		Vector(std::initializer_list<T> values, const Allocator& allocator = Allocator())
+			: data_(values, allocator), footprint(values.size()) {}
+		explicit Vector(const std::vector<T>& values, const Allocator& allocator = Allocator())
+			: data_(values.begin(), values.end(), allocator), footprint(values.size()) {}
+
+		// From an n x 1 column or a 1 x n row.
+		template<typename OtherAllocator>
+		explicit Vector(const Matrix<T, OtherAllocator>& matrix, const Allocator& allocator = Allocator())
+			: data_(allocator) {
+			if (matrix.get_columns() == 1) {
+				data_.resize(matrix.get_rows());
+				for (size_t i = 0; i < matrix.get_rows(); ++i) {
+					data_[i] = matrix(i, 0);
+				}
+			}
+			else if (matrix.get_rows() == 1) {
+				data_.assign(matrix(0).begin(), matrix(0).end());
+			}
+			else if (matrix.get_rows() != 0) {
+				throw std::invalid_argument("Vector requires a single row or column");
+			}
+			footprint = Memory::VectorFootprint<T>(data_.size());
+		}
+
+		[[nodiscard]] Allocator get_allocator() const noexcept { return data_.get_allocator(); }
+
+		[[nodiscard]] size_t size() const noexcept { return data_.size(); }
+		[[nodiscard]] bool empty() const noexcept { return data_.empty(); }
+		[[nodiscard]] T* data() noexcept { return data_.data(); }
+		[[nodiscard]] const T* data() const noexcept { return data_.data(); }
+
+		T& operator[](size_t i) noexcept { return data_[i]; }
+		const T& operator[](size_t i) const noexcept { return data_[i]; }
+		T& operator()(size_t i) noexcept { return data_[i]; }
+		const T& operator()(size_t i) const noexcept { return data_[i]; }
+		T& at(size_t i) { return data_.at(i); }
+		const T& at(size_t i) const { return data_.at(i); }
+
+		auto begin() noexcept { return data_.begin(); }
+		auto end() noexcept { return data_.end(); }
+		auto begin() const noexcept { return data_.begin(); }
+		auto end() const noexcept { return data_.end(); }
+
+		void fill(const T& value) { std::fill(data_.begin(), data_.end(), value); }
+
+		// n x 1 column, or 1 x n row.
+		[[nodiscard]] Matrix<T> to_matrix(bool is_column = true) const {
+			return Matrix<T>(std::vector<T>(data_.begin(), data_.end()), is_column);
+		}
+
+		Vector& operator+=(const Vector& other) {
+			check_size(other);
+			Kernels::axpy<false>(T{ 1 }, other.data(), data(), size());
+			return *this;
+		}
+		Vector& operator-=(const Vector& other) {
+			check_size(other);
+			Kernels::axpy<false>(T{ -1 }, other.data(), data(), size());
+			return *this;
+		}
+		Vector& operator*=(const T& scalar) {
+			for (T& value : data_) {
+				value *= scalar;
+			}
+			return *this;
+		}
+
+		friend Vector operator+(Vector lhs, const Vector& rhs) { return lhs += rhs; }
+		friend Vector operator-(Vector lhs, const Vector& rhs) { return lhs -= rhs; }
+		friend Vector operator*(Vector lhs, const T& scalar) { return lhs *= scalar; }
+		friend Vector operator*(const T& scalar, Vector rhs) { return rhs *= scalar; }
+
+		friend bool operator==(const Vector& lhs, const Vector& rhs) { return lhs.data_ == rhs.data_; }
+		friend bool operator!=(const Vector& lhs, const Vector& rhs) { return !(lhs == rhs); }
+
+		friend std::ostream& operator<<(std::ostream& os, const Vector& vector) {
+			os << '[';
+			for (size_t i = 0; i < vector.size(); ++i) {
+				os << (i == 0 ? "" : " ") << vector[i];
+			}
+			return os << ']';
+		}
+
+	private:
+		static_assert(
+			is_valid_matrix_type<T>::value,
+			"Vector<T> requires T to be either float, double, long double or ComplexNumber<float/double/long double>");
+
+		storage_type data_;
+		Memory::VectorFootprint<T> footprint;
+
+		void check_size(const Vector& other) const {
+			if (size() != other.size()) {
+				throw std::invalid_argument("Vector sizes must agree");
+			}
+		}
+	};
+
+
+	// Non-owning window onto contiguous elements. VectorView<const T> is the
+	// read-only flavour.
+	template<typename T>
+	class VectorView {
+	public:
+		using value_type = std::remove_const_t<T>;
+
+		VectorView() noexcept = default;
+		VectorView(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+		template<typename Allocator, typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+		VectorView(Vector<value_type, Allocator>& vector) noexcept : data_(vector.data()), size_(vector.size()) {}
+		template<typename Allocator, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+		VectorView(const Vector<value_type, Allocator>& vector) noexcept : data_(vector.data()), size_(vector.size()) {}
+
+		template<typename Allocator, typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+		VectorView(std::vector<value_type, Allocator>& vector) noexcept : data_(vector.data()), size_(vector.size()) {}
+		template<typename Allocator, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+		VectorView(const std::vector<value_type, Allocator>& vector) noexcept : data_(vector.data()), size_(vector.size()) {}
+
+		template<typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+		VectorView(const VectorView<value_type>& other) noexcept : data_(other.data()), size_(other.size()) {}
+
+		[[nodiscard]] size_t size() const noexcept { return size_; }
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+		[[nodiscard]] T* data() const noexcept { return data_; }
+		[[nodiscard]] T& operator[](size_t i) const noexcept { return data_[i]; }
+
+		[[nodiscard]] VectorView subview(size_t offset, size_t count) const {
+			if (offset + count > size_) {
+				throw std::out_of_range("vector view range is out of range");
+			}
+			return VectorView(data_ + offset, count);
+		}
+
+		template<typename U>
+		[[nodiscard]] bool overlaps(const VectorView<U>& other) const noexcept {
+			if (empty() || other.empty()) {
+				return false;
+			}
+			const auto* begin = static_cast<const void*>(data_);
+			const auto* other_begin = static_cast<const void*>(other.data());
+			return std::less<const void*>()(begin, static_cast<const void*>(other.data() + other.size())) &&
+				std::less<const void*>()(other_begin, static_cast<const void*>(data_ + size_));
+		}
+
+	private:
+		T* data_ = nullptr;
+		size_t size_ = 0;
+	};
+
+	// Row i of a matrix as a vector.
+	template<typename T, typename Allocator>
+	[[nodiscard]] VectorView<const T> row_view(const Matrix<T, Allocator>& matrix, size_t i) {
+		if (i >= matrix.get_rows()) {
+			throw std::out_of_range("row index is out of range");
+		}
+		return VectorView<const T>(matrix(i).data(), matrix.get_columns());
+	}
+
+
+	template<typename T, typename AllocatorA, typename AllocatorX>
+	[[nodiscard]] Vector<T> operator*(const Matrix<T, AllocatorA>& matrix, const Vector<T, AllocatorX>& vector) {
+		MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator*(Vector)", 2 * matrix.get_rows() * matrix.get_columns(),
+			(matrix.get_rows() * matrix.get_columns() + matrix.get_columns() + matrix.get_rows()) * sizeof(T));
+		MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator*(Vector)");
+		if (matrix.get_columns() != vector.size()) {
+			throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
+		}
+		Vector<T> result(matrix.get_rows());
+		Kernels::gemv(T{ 1 }, MatrixView<const T>(matrix), Op::no_transpose, vector.data(), T{ 0 }, result.data());
+		return result;
+	}
+	// op(A) x for transposed(), conjugated() or adjoint() operands.
+	template<typename T, typename AllocatorX>
+	[[nodiscard]] Vector<T> operator*(const OpView<T>& matrix, const Vector<T, AllocatorX>& vector) {
+		MATRIXLIB_PROFILE_ZONE("Core::Matrix::operator*(Vector)", 2 * matrix.get_rows() * matrix.get_columns(),
+			(matrix.get_rows() * matrix.get_columns() + matrix.get_columns() + matrix.get_rows()) * sizeof(T));
+		MATRIXLIB_ALLOCATION_SCOPE("Core::Matrix::operator*(Vector)");
+		if (matrix.get_columns() != vector.size()) {
+			throw std::invalid_argument("Incompatible matrix dimensions for multiplication");
+		}
+		Vector<T> result(matrix.get_rows());
+		Kernels::gemv(T{ 1 }, matrix.operand(), matrix.op(), vector.data(), T{ 0 }, result.data());
+		return result;
+	}
+}
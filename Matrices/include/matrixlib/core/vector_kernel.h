@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "matrix_view.h"
+#include "parallel.h"
+#include "type_traits.h"
+
+// Level 1 and 2 kernels: dot, axpy and gemv over contiguous data. They are
+// bound by memory bandwidth, so each element is read once, the inner loops are
+// unit-stride, and complex values are handled as pairs of reals: std::complex
+// multiplication guards against NaN/inf with a library call the compiler
+// cannot vectorize. Reductions keep several independent accumulators so the
+// loop is not one long dependency chain. Large ranges are cut into blocks
+// that depend only on the size and spread over threads, and block partials
+// are combined in block order, so no result depends on the thread count.
+
+namespace Core {
+	namespace Kernels {
+
+		// Elements per block of a parallel level 1/2 kernel; waking the pooled
+		// workers costs well under one block of work.
+		inline constexpr std::size_t vector_block_elements = std::size_t{ 1 } << 15;
+		inline constexpr std::size_t max_vector_blocks = 64;
+
+		namespace Detail {
+
+			// Per-block partial y of a transposed gemv, kept per thread so
+			// repeated calls do not allocate. gemv asks for at most
+			// vector_block_elements values, so the buffer stays small.
+			template<typename T>
+			std::vector<T>& gemv_partials(std::size_t size) {
+				thread_local std::vector<T> partials;
+				if (partials.size() < size) {
+					partials.resize(size);
+				}
+				return partials;
+			}
+		}
+
+		[[nodiscard]] inline std::size_t vector_blocks(std::size_t elements) noexcept {
+			return std::min(max_vector_blocks, std::max<std::size_t>(1, elements / vector_block_elements));
+		}
+
+		// sum_j op(a_j) * b_j, op the conjugate if Conjugate.
+		template<bool Conjugate, typename T>
+		T dot(const T* a, const T* b, std::size_t n) {
+			if constexpr (Traits::is_complex<T>::value) {
+				using R = Traits::NormType<T>;
+				const R* x = reinterpret_cast<const R*>(a);
+				const R* y = reinterpret_cast<const R*>(b);
+				const R sign = Conjugate ? R{ -1 } : R{ 1 };
+				R re0{}, re1{}, im0{}, im1{};
+				std::size_t j = 0;
+				for (; j + 2 <= n; j += 2) {
+					re0 += x[2 * j] * y[2 * j] - sign * x[2 * j + 1] * y[2 * j + 1];
+					im0 += x[2 * j] * y[2 * j + 1] + sign * x[2 * j + 1] * y[2 * j];
+					re1 += x[2 * j + 2] * y[2 * j + 2] - sign * x[2 * j + 3] * y[2 * j + 3];
+					im1 += x[2 * j + 2] * y[2 * j + 3] + sign * x[2 * j + 3] * y[2 * j + 2];
+				}
+				for (; j < n; ++j) {
+					re0 += x[2 * j] * y[2 * j] - sign * x[2 * j + 1] * y[2 * j + 1];
+					im0 += x[2 * j] * y[2 * j + 1] + sign * x[2 * j + 1] * y[2 * j];
+				}
+				return T(re0 + re1, im0 + im1);
+			}
+			else {
+				T s0{}, s1{}, s2{}, s3{};
+				std::size_t j = 0;
+				for (; j + 4 <= n; j += 4) {
+					s0 += a[j] * b[j];
+					s1 += a[j + 1] * b[j + 1];
+					s2 += a[j + 2] * b[j + 2];
+					s3 += a[j + 3] * b[j + 3];
+				}
+				for (; j < n; ++j) {
+					s0 += a[j] * b[j];
+				}
+				return (s0 + s1) + (s2 + s3);
+			}
+		}
+
+		// y += alpha * op(x), op the conjugate if Conjugate.
+		template<bool Conjugate, typename T>
+		void axpy(const T& alpha, const T* x, T* y, std::size_t n) {
+			if constexpr (Traits::is_complex<T>::value) {
+				using R = Traits::NormType<T>;
+				const R* source = reinterpret_cast<const R*>(x);
+				R* target = reinterpret_cast<R*>(y);
+				const R alpha_re = alpha.real();
+				const R alpha_im = alpha.imag();
+				const R sign = Conjugate ? R{ -1 } : R{ 1 };
+				for (std::size_t j = 0; j < n; ++j) {
+					const R re = source[2 * j];
+					const R im = sign * source[2 * j + 1];
+					target[2 * j] += alpha_re * re - alpha_im * im;
+					target[2 * j + 1] += alpha_re * im + alpha_im * re;
+				}
+			}
+			else {
+				for (std::size_t j = 0; j < n; ++j) {
+					y[j] += alpha * x[j];
+				}
+			}
+		}
+
+		// y = beta * y; beta == 0 clears y without reading it.
+		template<typename T>
+		void scale(const T& beta, T* y, std::size_t n) {
+			if (beta == T{ 0 }) {
+				std::fill(y, y + n, T{ 0 });
+			}
+			else if (beta != T{ 1 }) {
+				for (std::size_t j = 0; j < n; ++j) {
+					y[j] *= beta;
+				}
+			}
+		}
+
+		// y = alpha * op(A) * x + beta * y. With op(A) = A (or conj(A)) every
+		// y_i is a row dot product and rows are split over threads. With
+		// op(A) = A^T (or A^H) the rows of A are added into y in turn, scaled by
+		// alpha * x_i, so A is still streamed by rows: wide matrices split the
+		// columns of y over threads, tall narrow ones (all partials fitting in
+		// one block) give every block of rows a partial y. y must not overlap A
+		// or x.
+		template<typename T>
+		void gemv(const T& alpha, const MatrixView<const T>& a, Op op, const T* x, const T& beta, T* y) {
+			const std::size_t rows = a.get_rows();
+			const std::size_t columns = a.get_columns();
+			const bool conjugate = is_conjugated(op);
+
+			if (!is_transposed(op)) {
+				const std::size_t min_rows = std::max<std::size_t>(1, vector_block_elements / std::max<std::size_t>(columns, 1));
+				Parallel::parallel_for(0, rows, min_rows, [&](std::size_t first, std::size_t last) {
+					for (std::size_t i = first; i < last; ++i) {
+						const T sum = conjugate ? dot<true>(a.row(i), x, columns) : dot<false>(a.row(i), x, columns);
+						y[i] = beta == T{ 0 } ? alpha * sum : alpha * sum + beta * y[i];
+					}
+				});
+				return;
+			}
+
+			scale(beta, y, columns);
+			auto accumulate_rows = [&](std::size_t first, std::size_t last, std::size_t column_begin, std::size_t column_end, T* target) {
+				for (std::size_t i = first; i < last; ++i) {
+					const T coefficient = alpha * x[i];
+					if (coefficient == T{ 0 }) {
+						continue;
+					}
+					const T* row = a.row(i) + column_begin;
+					if (conjugate) {
+						axpy<true>(coefficient, row, target + column_begin, column_end - column_begin);
+					}
+					else {
+						axpy<false>(coefficient, row, target + column_begin, column_end - column_begin);
+					}
+				}
+			};
+			const std::size_t blocks = std::min(rows, vector_blocks(rows * columns));
+			const std::size_t min_columns = std::max<std::size_t>(64, vector_block_elements / std::max<std::size_t>(rows, 1));
+			if (blocks <= 1 || blocks * columns > vector_block_elements) {
+				// Column chunks: each y_j still sums over i in order, so the split
+				// does not change the result.
+				Parallel::parallel_for(0, columns, min_columns, [&](std::size_t first, std::size_t last) {
+					accumulate_rows(0, rows, first, last, y);
+				});
+				return;
+			}
+			const std::size_t rows_per_block = (rows + blocks - 1) / blocks;
+			T* partials = Detail::gemv_partials<T>(blocks * columns).data();
+			std::fill(partials, partials + blocks * columns, T{ 0 });
+			Parallel::parallel_for(0, blocks, 1, [&](std::size_t first, std::size_t last) {
+				for (std::size_t block = first; block < last; ++block) {
+					accumulate_rows(std::min(rows, block * rows_per_block), std::min(rows, (block + 1) * rows_per_block),
+						0, columns, partials + block * columns);
+				}
+			});
+			for (std::size_t block = 0; block < blocks; ++block) {
+				const T* partial = partials + block * columns;
+				for (std::size_t j = 0; j < columns; ++j) {
+					y[j] += partial[j];
+				}
+			}
+		}
+
+	}
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/allocation_tracker.h"
+#include "../core/instrumentation.h"
+#include "../core/matrix.h"
+#include "../core/type_traits.h"
+#include "givens.h"
+
+namespace Decompositions {
+	namespace CHOLESKY_Decomposition {
+
+		using Core::Traits::is_valid_matrix_type;
+		using Core::Traits::NormType;
+
+		// A = R^H R for Hermitian positive definite A, with R upper triangular
+		// and a positive real diagonal. Only the upper triangle of A is read.
+		//
+		// The factor can follow changes of A without being recomputed:
+		// update(x) gives the factor of A + x x^H with Givens rotations and
+		// downdate(x) that of A - x x^H with hyperbolic rotations (in the mixed
+		// form of Bojanczyk et al., which is stable whenever the result is
+		// well conditioned), both in O(n^2). The matrix overloads take the k
+		// vectors as columns and apply all of them in a single sweep over R, so
+		// R is read once instead of k times. A downdate that would leave A
+		// indefinite throws std::runtime_error and leaves the factor as it was
+		// (up to rounding).
+		template<typename T>
+		class Cholesky_Decomposition {
+		public:
+			using NormValue = NormType<T>;
+
+			explicit Cholesky_Decomposition(const Core::Matrix<T>& matrix) {
+				if (matrix.get_rows() != matrix.get_columns()) {
+					throw std::invalid_argument("Cholesky decomposition requires square matrix");
+				}
+				if (matrix.get_rows() == 0) {
+					throw std::invalid_argument("Matrix must not be empty");
+				}
+				compute_decomposition(matrix);
+			}
+
+			[[nodiscard]] size_t get_rows() const noexcept { return R_.get_rows(); }
+			[[nodiscard]] size_t get_columns() const noexcept { return R_.get_columns(); }
+
+			[[nodiscard]] const Core::Matrix<T>& get_R() const noexcept { return R_; }
+			// L = R^H, so that A = L L^H.
+			[[nodiscard]] Core::Matrix<T> get_L() const {
+				const size_t n = get_rows();
+				Core::Matrix<T> l(n, n);
+				for (size_t i = 0; i < n; ++i) {
+					for (size_t j = i; j < n; ++j) {
+						l(j, i) = Core::Traits::conjugate(R_(i, j));
+					}
+				}
+				l.set_structure(Core::StructureTag(Core::Structure::lower_triangular));
+				return l;
+			}
+
+			// Factor of A + x x^H.
+			void update(const std::vector<T>& x) {
+				update(Core::Matrix<T>(x, true));
+			}
+			// Factor of A + X X^H; X is n x k.
+			void update(const Core::Matrix<T>& vectors) {
+				const size_t n = get_rows();
+				const size_t k = vectors.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Cholesky_Decomposition::update", 6 * n * n * k, (n * n / 2 + 2 * n * k) * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Cholesky_Decomposition::update");
+				Core::Matrix<T> w = adjoint_rows(vectors);
+
+				// Row i of R absorbs column i of every w(p); both rows are then
+				// rotated over the columns to the right.
+				for (size_t i = 0; i < n; ++i) {
+					T* r = R_(i).data();
+					for (size_t p = 0; p < k; ++p) {
+						T* row = w(p).data();
+						if (row[i] == T{ 0 }) {
+							continue;
+						}
+						const Givens::Rotation<T> rotation = Givens::make_rotation(r[i], row[i]);
+						row[i] = T{ 0 };
+						const T s_conjugate = Core::Traits::conjugate(rotation.s);
+						for (size_t j = i + 1; j < n; ++j) {
+							const T first = r[j];
+							const T second = row[j];
+							r[j] = rotation.c * first + rotation.s * second;
+							row[j] = rotation.c * second - s_conjugate * first;
+						}
+					}
+				}
+				R_.set_structure(Core::StructureTag(Core::Structure::upper_triangular));
+			}
+
+			// Factor of A - x x^H.
+			void downdate(const std::vector<T>& x) {
+				downdate(Core::Matrix<T>(x, true));
+			}
+			// Factor of A - X X^H; X is n x k.
+			void downdate(const Core::Matrix<T>& vectors) {
+				const size_t n = get_rows();
+				const size_t k = vectors.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Cholesky_Decomposition::downdate", 6 * n * n * k, (n * n / 2 + 2 * n * k) * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Cholesky_Decomposition::downdate");
+				Core::Matrix<T> w = adjoint_rows(vectors);
+
+				// Rotation (i, p) maps row i of R and w(p) through
+				//   r' = c (r - conj(rho) w),  w' = w / c - rho r',
+				// with rho = w(p)(i) / R(i, i) and c = 1 / sqrt(1 - |rho|^2).
+				std::vector<HyperbolicStep> steps;
+				steps.reserve(n * k);
+				for (size_t i = 0; i < n; ++i) {
+					T* r = R_(i).data();
+					for (size_t p = 0; p < k; ++p) {
+						T* row = w(p).data();
+						if (row[i] == T{ 0 }) {
+							continue;
+						}
+						const T rho = row[i] / r[i];
+						const NormValue remaining = NormValue{ 1 } - std::norm(rho);
+						if (!(remaining > NormValue{ 0 })) {
+							restore(steps, w);
+							throw std::runtime_error("Downdate would make the matrix not positive definite");
+						}
+						const NormValue c = NormValue{ 1 } / std::sqrt(remaining);
+						const T rho_conjugate = Core::Traits::conjugate(rho);
+						r[i] = T(std::real(r[i]) * std::sqrt(remaining));
+						row[i] = T{ 0 };
+						for (size_t j = i + 1; j < n; ++j) {
+							r[j] = c * (r[j] - rho_conjugate * row[j]);
+							row[j] = row[j] / c - rho * r[j];
+						}
+						steps.push_back({ i, p, rho, c });
+					}
+				}
+				R_.set_structure(Core::StructureTag(Core::Structure::upper_triangular));
+			}
+
+			// Solves A X = B with R^H Y = B, then R X = Y.
+			template<typename Allocator>
+			[[nodiscard]] Core::Matrix<T, Allocator> solve(const Core::Matrix<T, Allocator>& b) const {
+				const size_t n = get_rows();
+				const size_t k = b.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Cholesky_Decomposition::solve", 2 * n * n * k, (n * n + 2 * n * k) * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Cholesky_Decomposition::solve");
+				if (b.get_rows() != n) {
+					throw std::invalid_argument("Right-hand side must have as many rows as the matrix");
+				}
+
+				// R^H is lower triangular: walk rows of R and push each solved row
+				// of Y into the rows below it.
+				Core::Matrix<T, Allocator> x(b);
+				for (size_t i = 0; i < n; ++i) {
+					T* row = x(i).data();
+					const T* r = R_(i).data();
+					for (size_t j = 0; j < k; ++j) {
+						row[j] /= r[i];
+					}
+					for (size_t q = i + 1; q < n; ++q) {
+						const T coefficient = Core::Traits::conjugate(r[q]);
+						T* target = x(q).data();
+						for (size_t j = 0; j < k; ++j) {
+							target[j] -= coefficient * row[j];
+						}
+					}
+				}
+				for (size_t i = n; i-- > 0;) {
+					T* row = x(i).data();
+					const T* r = R_(i).data();
+					for (size_t q = i + 1; q < n; ++q) {
+						const T* solved = x(q).data();
+						for (size_t j = 0; j < k; ++j) {
+							row[j] -= r[q] * solved[j];
+						}
+					}
+					for (size_t j = 0; j < k; ++j) {
+						row[j] /= r[i];
+					}
+				}
+				return x;
+			}
+
+		private:
+			static_assert(
+				is_valid_matrix_type<T>::value,
+				"Matrix<T> requires T to be either float, double, long double or ComplexNumber<float/double/long double>");
+
+			struct HyperbolicStep {
+				size_t row;
+				size_t vector;
+				T rho;
+				NormValue c;
+			};
+
+			Core::Matrix<T> R_;
+
+			void compute_decomposition(const Core::Matrix<T>& matrix) {
+				const size_t n = matrix.get_rows();
+				MATRIXLIB_PROFILE_ZONE("Cholesky_Decomposition::compute_decomposition", n * n * n / 3, n * n * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Cholesky_Decomposition::compute_decomposition");
+
+				// A band is kept by the factor, so rows outside it need no update.
+				const size_t band = matrix.structure().upper_bandwidth(n);
+				R_ = Core::Matrix<T>(n, n);
+				for (size_t i = 0; i < n; ++i) {
+					std::copy(matrix(i).begin() + i, matrix(i).begin() + std::min(n, i + band + 1), R_(i).begin() + i);
+				}
+				for (size_t i = 0; i < n; ++i) {
+					T* pivot_row = R_(i).data();
+					const NormValue pivot = std::real(pivot_row[i]);
+					if (!(pivot > NormValue{ 0 })) {
+						throw std::runtime_error("Matrix is not positive definite");
+					}
+					const NormValue diagonal = std::sqrt(pivot);
+					const size_t end = std::min(n, i + band + 1);
+					pivot_row[i] = T(diagonal);
+					for (size_t j = i + 1; j < end; ++j) {
+						pivot_row[j] /= diagonal;
+					}
+					for (size_t p = i + 1; p < end; ++p) {
+						const T coefficient = Core::Traits::conjugate(pivot_row[p]);
+						T* row = R_(p).data();
+						for (size_t j = p; j < end; ++j) {
+							row[j] -= coefficient * pivot_row[j];
+						}
+					}
+				}
+				R_.set_structure(band + 1 < n ? Core::StructureTag::banded(0, band, n, n)
+					: Core::StructureTag(Core::Structure::upper_triangular));
+			}
+
+			// Rows x_p^H of the update vectors, which is what R^H R is built from.
+			[[nodiscard]] Core::Matrix<T> adjoint_rows(const Core::Matrix<T>& vectors) const {
+				if (vectors.get_rows() != get_rows()) {
+					throw std::invalid_argument("Update vectors must have as many entries as the matrix has rows");
+				}
+				Core::Matrix<T> w(vectors.get_columns(), vectors.get_rows());
+				for (size_t j = 0; j < vectors.get_rows(); ++j) {
+					for (size_t p = 0; p < vectors.get_columns(); ++p) {
+						w(p, j) = Core::Traits::conjugate(vectors(j, p));
+					}
+				}
+				return w;
+			}
+
+			// Undoes the hyperbolic rotations of a failed downdate, newest
+			// first: w = c (w' + rho r'), r = r' / c + conj(rho) w.
+			void restore(const std::vector<HyperbolicStep>& steps, Core::Matrix<T>& w) {
+				for (size_t s = steps.size(); s-- > 0;) {
+					const HyperbolicStep& step = steps[s];
+					T* r = R_(step.row).data();
+					T* row = w(step.vector).data();
+					const T rho_conjugate = Core::Traits::conjugate(step.rho);
+					for (size_t j = step.row; j < get_columns(); ++j) {
+						row[j] = step.c * (row[j] + step.rho * r[j]);
+						r[j] = r[j] / step.c + rho_conjugate * row[j];
+					}
+					r[step.row] = T(std::real(r[step.row]));
+				}
+				R_.set_structure(Core::StructureTag(Core::Structure::upper_triangular));
+			}
+		};
+
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+
+#include "../core/matrix.h"
+#include "../core/type_traits.h"
+
+// Plane rotations G = [c s; -conj(s) c] with real c, as produced by LAPACK
+// lartg, for factorization updates that touch two rows at a time.
+
+namespace Decompositions {
+	namespace Givens {
+
+		using Core::Traits::NormType;
+
+		template<typename T>
+		struct Rotation {
+			NormType<T> c{ 1 };
+			T s{};
+		};
+
+		// Rotation with G (a; b) = (r; 0); a is overwritten with r.
+		template<typename T>
+		[[nodiscard]] Rotation<T> make_rotation(T& a, const T& b) {
+			using Real = NormType<T>;
+			Rotation<T> rotation;
+			if (b == T{ 0 }) {
+				return rotation;
+			}
+			const Real a_magnitude = std::abs(a);
+			const Real b_magnitude = std::abs(b);
+			if (a_magnitude == Real{ 0 }) {
+				rotation.c = Real{ 0 };
+				rotation.s = Core::Traits::conjugate(b) / b_magnitude;
+				a = T(b_magnitude);
+				return rotation;
+			}
+			const Real norm = std::hypot(a_magnitude, b_magnitude);
+			const T phase = a / a_magnitude;
+			rotation.c = a_magnitude / norm;
+			rotation.s = phase * Core::Traits::conjugate(b) / norm;
+			a = phase * norm;
+			return rotation;
+		}
+
+		// (row i; row j) <- G (row i; row j) for columns from..end.
+		template<typename T, typename Allocator>
+		void rotate_rows(Core::Matrix<T, Allocator>& matrix, size_t i, size_t j, const Rotation<T>& rotation, size_t from = 0) {
+			T* x = matrix(i).data();
+			T* y = matrix(j).data();
+			for (size_t column = from; column < matrix.get_columns(); ++column) {
+				const T first = x[column];
+				const T second = y[column];
+				x[column] = rotation.c * first + rotation.s * second;
+				y[column] = rotation.c * second - Core::Traits::conjugate(rotation.s) * first;
+			}
+		}
+
+		// (column i, column j) <- (column i, column j) G^H, so that Q G^H G R
+		// keeps the product when G is applied to the rows of R.
+		template<typename T, typename Allocator>
+		void rotate_columns(Core::Matrix<T, Allocator>& matrix, size_t i, size_t j, const Rotation<T>& rotation) {
+			const T s_conjugate = Core::Traits::conjugate(rotation.s);
+			for (size_t row = 0; row < matrix.get_rows(); ++row) {
+				T* values = matrix(row).data();
+				const T first = values[i];
+				const T second = values[j];
+				values[i] = rotation.c * first + s_conjugate * second;
+				values[j] = rotation.c * second - rotation.s * first;
+			}
+		}
+
+	}
+}
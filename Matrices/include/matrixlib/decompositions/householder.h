@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+#include "../core/matrix.h"
+#include "../core/type_traits.h"
+
+// Householder reflectors stored in place, LAPACK style: H = I - tau v v^H
+// with v = (1; x), where x overwrites the entries below the diagonal of the
+// column it annihilated and the unit head is implied.
+
+namespace Decompositions {
+	namespace Householder {
+
+		using Core::Traits::NormType;
+
+		// ||A(from:, column)||_2 without overflow.
+		template<typename T, typename Allocator>
+		[[nodiscard]] NormType<T> column_norm(const Core::Matrix<T, Allocator>& a, size_t column, size_t from) {
+			using Real = NormType<T>;
+			Real scale{};
+			for (size_t i = from; i < a.get_rows(); ++i) {
+				scale = std::max(scale, static_cast<Real>(std::abs(a(i, column))));
+			}
+			if (scale == Real{ 0 }) {
+				return Real{ 0 };
+			}
+			Real sum{};
+			for (size_t i = from; i < a.get_rows(); ++i) {
+				sum += std::norm(a(i, column) / scale);
+			}
+			return scale * std::sqrt(sum);
+		}
+
+		// LAPACK larfg on A(row:, column): chooses beta and tau so that
+		// H^H (alpha; x) = (beta; 0), stores beta at (row, column) and v below
+		// it, and returns tau (zero when the column is already reduced).
+		template<typename T, typename Allocator>
+		T generate_reflector(Core::Matrix<T, Allocator>& a, size_t row, size_t column) {
+			using Real = NormType<T>;
+			const Real x_norm = column_norm(a, column, row + 1);
+			const T alpha = a(row, column);
+			const Real alpha_real = std::real(alpha);
+			const Real alpha_imag = std::imag(alpha);
+			if (x_norm == Real{ 0 } && alpha_imag == Real{ 0 }) {
+				return T{ 0 };
+			}
+			const Real magnitude = std::hypot(std::hypot(alpha_real, alpha_imag), x_norm);
+			const Real beta = alpha_real >= Real{ 0 } ? -magnitude : magnitude;
+			T tau;
+			if constexpr (Core::Traits::is_complex<T>::value) {
+				tau = T((beta - alpha_real) / beta, -alpha_imag / beta);
+			}
+			else {
+				tau = T((beta - alpha_real) / beta);
+			}
+			const T scale = T{ 1 } / (alpha - T(beta));
+			for (size_t i = row + 1; i < a.get_rows(); ++i) {
+				a(i)[column] *= scale;
+			}
+			a(row)[column] = T(beta);
+			return tau;
+		}
+
+	}
+}
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <complex>
+#include <numeric>
+#include <vector>
 
+#include "../core/allocation_tracker.h"
+#include "../core/instrumentation.h"
 #include "../core/type_traits.h"
 #include "../core/matrix.h"
+#include "../core/vector.h"
+#include "../core/vector_kernel.h"
 
 namespace Decompositions {
 	namespace LUP_Decomposition {
@@ -23,6 +30,12 @@ namespace Decompositions {
 			Core::Matrix<T> L_;
 			Core::Matrix<T> U_;
 			Core::Matrix<T> P_;
+			// Row i of PA is row permutation_[i] of A.
+			std::vector<size_t> permutation_;
+			// Widest i - j with L(i, j) != 0 and j - i with U(i, j) != 0;
+			// substitution in solve only visits these bands.
+			size_t lower_band_ = 0;
+			size_t upper_band_ = 0;
 
 			bool decomposed = false;
 
@@ -33,57 +46,97 @@ namespace Decompositions {
 			}
 
 			void computeDecomposition(const Core::Matrix<T>& matrix, const EpsilonType<T> epsilon = default_epsilon<T>()) {
-				Core::Matrix<T> copy_matrix = matrix;
+				const size_t n = matrix.get_rows();
+				MATRIXLIB_PROFILE_ZONE("Lup_Decomposition::computeDecomposition", 2 * n * n * n / 3, 4 * n * n * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Lup_Decomposition::computeDecomposition");
+
+				// The working copy is scratch: it comes from the thread's arena and is
+				// released with the scope instead of going back through malloc.
+				Core::Memory::ArenaScope scratch_scope;
+				Core::ScratchMatrix<T> copy_matrix(matrix);
+				// Reads go through the const view and writes through row pointers,
+				// so the elimination loops never touch the structure tag.
+				const Core::ScratchMatrix<T>& source = copy_matrix;
 
 				L_ = Core::Matrix<T>(matrix.get_rows(), matrix.get_columns(), 0);
 				U_ = Core::Matrix<T>(matrix.get_rows(), matrix.get_columns(), 0);
 				P_ = Core::Matrix<T>(matrix.get_rows(), matrix.get_columns(), 0);
 
 				P_.identity_matrix(1.0);
+				permutation_.resize(n);
+				std::iota(permutation_.begin(), permutation_.end(), size_t{ 0 });
+
+				// With a known band only the rows inside the lower band are eliminated
+				// and row updates stop where pivoting can have spread the upper band
+				// to. A matrix without an upper band (lower triangular, diagonal) is
+				// factored without pivoting, which then changes no entry of U.
+				const size_t lower = matrix.structure().lower_bandwidth(n);
+				const size_t upper = matrix.structure().upper_bandwidth(n);
+				const bool pivoting = upper != 0;
+				const size_t fill = pivoting ? lower + upper : upper;
 
-				for (size_t i = 0; i < copy_matrix.get_columns(); ++i) {
+				{
+					MATRIXLIB_PROFILE_ZONE("Lup_Decomposition::elimination", 2 * n * n * n / 3, n * n * n / 3 * sizeof(T));
+					MATRIXLIB_ALLOCATION_SCOPE("Lup_Decomposition::elimination");
+					for (size_t i = 0; i < copy_matrix.get_columns(); ++i) {
+						const size_t row_end = std::min(n, i + lower + 1);
+						const size_t column_end = std::min(n, i + fill + 1);
 
-					size_t row_to_swap = i;
-					auto max_absolute_value = std::abs(copy_matrix(i,i));
-					for (size_t j = i+1; j < copy_matrix.get_rows(); ++j) {
-						if (std::abs(copy_matrix(j, i)) > max_absolute_value) {
-							max_absolute_value = std::abs(copy_matrix(j, i));
-							row_to_swap = j;
+						size_t row_to_swap = i;
+						auto max_absolute_value = std::abs(source(i, i));
+						for (size_t j = i+1; pivoting && j < row_end; ++j) {
+							if (std::abs(source(j, i)) > max_absolute_value) {
+								max_absolute_value = std::abs(source(j, i));
+								row_to_swap = j;
+							}
 						}
-					}
 
-					if (max_absolute_value < epsilon) {
-						throw std::runtime_error("Matrix is singular or nearly singular");
-					}
+						if (max_absolute_value < epsilon) {
+							throw std::runtime_error("Matrix is singular or nearly singular");
+						}
 
-					if (row_to_swap != i) {
-						copy_matrix.swap_rows(i, row_to_swap);
-						P_.swap_rows(i, row_to_swap);
-						amount_of_permutations +=1 ;
+						if (row_to_swap != i) {
+							copy_matrix.swap_rows(i, row_to_swap);
+							P_.swap_rows(i, row_to_swap);
+							std::swap(permutation_[i], permutation_[row_to_swap]);
+							amount_of_permutations +=1 ;
 
-					}
+						}
 
-					for (size_t j = i+1; j < copy_matrix.get_rows(); ++j) {
-						copy_matrix(j, i) /= copy_matrix(i, i);
-						for (size_t k = i+1; k < copy_matrix.get_columns(); ++k) {
-							copy_matrix(j, k) -= copy_matrix(j, i) * copy_matrix(i, k);
+						const T* pivot_row = copy_matrix(i).data();
+						for (size_t j = i+1; j < row_end; ++j) {
+							T* row = copy_matrix(j).data();
+							row[i] /= pivot_row[i];
+							const T factor = row[i];
+							for (size_t k = i+1; k < column_end; ++k) {
+								row[k] -= factor * pivot_row[k];
+							}
 						}
 					}
 				}
 
+				MATRIXLIB_PROFILE_ZONE("Lup_Decomposition::extract_factors", 0, 3 * n * n * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Lup_Decomposition::extract_factors");
+				lower_band_ = upper_band_ = 0;
 				for (size_t i = 0; i < copy_matrix.get_rows(); ++i) {
 					for (size_t j = 0; j < copy_matrix.get_columns(); ++j) {
 						if (i >= j) {
 							if(i == j){
 								L_(i, j) = 1;
-								U_(i, j) = copy_matrix(i, j);
+								U_(i, j) = source(i, j);
 							}
 							else {
-								L_(i, j) = copy_matrix(i, j);
+								L_(i, j) = source(i, j);
+								if (L_(i, j) != T{ 0 }) {
+									lower_band_ = std::max(lower_band_, i - j);
+								}
 							}
 						}
 						else {
-							U_(i, j) = copy_matrix(i, j);
+							U_(i, j) = source(i, j);
+							if (U_(i, j) != T{ 0 }) {
+								upper_band_ = std::max(upper_band_, j - i);
+							}
 						}
 					}
 				}
@@ -107,6 +160,135 @@ namespace Decompositions {
 			const Core::Matrix<T>& get_U() const { return U_; }
 			const Core::Matrix<T>& get_P() const { return P_; }
 			const unsigned long long get_permutations() const { return amount_of_permutations; }
+			const std::vector<size_t>& get_permutation() const { return permutation_; }
+
+			// Solves op(A) X = B for every column of B, where PA = LU. The op is
+			// applied by reading L and U in the matching order (as in LAPACK getrs),
+			// so A^T X = B or A^H X = B need no transposed factors. Substitution
+			// stays inside the bands of L and U, so a banded A costs
+			// O(n (lower + upper) k) rather than O(n^2 k).
+			template<typename Allocator>
+			[[nodiscard]] Core::Matrix<T, Allocator> solve(const Core::Matrix<T, Allocator>& b,
+				Core::Op op = Core::Op::no_transpose) const {
+				const size_t n = L_.get_rows();
+				const size_t k = b.get_columns();
+				const size_t lower = lower_band_;
+				const size_t upper = upper_band_;
+				MATRIXLIB_PROFILE_ZONE("Lup_Decomposition::solve", 2 * n * (lower + upper + 1) * k,
+					(n * (lower + upper + 1) + 2 * n * k) * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Lup_Decomposition::solve");
+				if (b.get_rows() != n) {
+					throw std::invalid_argument("Right-hand side must have as many rows as the matrix");
+				}
+
+				const bool conjugated = Core::is_conjugated(op);
+				auto factor = [conjugated](const Core::Matrix<T>& matrix, size_t i, size_t j) {
+					return conjugated ? Core::Traits::conjugate(matrix(i, j)) : matrix(i, j);
+				};
+				// x -= coefficient * y over whole rows of the right-hand side.
+				auto subtract_row = [k](T* x, const T* y, const T& coefficient) {
+					for (size_t j = 0; j < k; ++j) {
+						x[j] -= coefficient * y[j];
+					}
+				};
+				auto divide_row = [k](T* x, const T& divisor) {
+					for (size_t j = 0; j < k; ++j) {
+						x[j] /= divisor;
+					}
+				};
+
+				Core::Matrix<T, Allocator> x(n, k, b.get_allocator());
+				if (!Core::is_transposed(op)) {
+					// op(A) = P^T op(L) op(U): permute, then forward and back substitution.
+					for (size_t i = 0; i < n; ++i) {
+						std::copy(b(permutation_[i]).begin(), b(permutation_[i]).end(), x(i).begin());
+					}
+					for (size_t i = 0; i < n; ++i) {
+						for (size_t p = i - std::min(i, lower); p < i; ++p) {
+							subtract_row(x(i).data(), x(p).data(), factor(L_, i, p));
+						}
+					}
+					for (size_t i = n; i-- > 0;) {
+						for (size_t p = i + 1; p < std::min(n, i + upper + 1); ++p) {
+							subtract_row(x(i).data(), x(p).data(), factor(U_, i, p));
+						}
+						divide_row(x(i).data(), factor(U_, i, i));
+					}
+					return x;
+				}
+
+				// op(A) = op(U) op(L) P: solve with op(U) (lower), then op(L) (upper),
+				// walking rows of U and L so the factors are still read contiguously.
+				Core::Matrix<T, Allocator> w(b);
+				for (size_t i = 0; i < n; ++i) {
+					divide_row(w(i).data(), factor(U_, i, i));
+					for (size_t q = i + 1; q < std::min(n, i + upper + 1); ++q) {
+						subtract_row(w(q).data(), w(i).data(), factor(U_, i, q));
+					}
+				}
+				for (size_t i = n; i-- > 0;) {
+					for (size_t q = i - std::min(i, lower); q < i; ++q) {
+						subtract_row(w(q).data(), w(i).data(), factor(L_, i, q));
+					}
+				}
+				for (size_t i = 0; i < n; ++i) {
+					x(permutation_[i]).swap(w(i));
+				}
+				return x;
+			}
+
+			// op(A) x = b for a single right-hand side, written into x without
+			// allocating, for iterations that solve many times (e.g. the 1-norm
+			// estimator). x must not overlap b.
+			void solve(Core::VectorView<const T> b, Core::VectorView<T> x, Core::Op op = Core::Op::no_transpose) const {
+				const size_t n = L_.get_rows();
+				MATRIXLIB_PROFILE_ZONE("Lup_Decomposition::solve(Vector)", 2 * n * (lower_band_ + upper_band_ + 1),
+					(n * (lower_band_ + upper_band_ + 1) + 2 * n) * sizeof(T));
+				if (b.size() != n || x.size() != n) {
+					throw std::invalid_argument("Vector sizes must match the matrix");
+				}
+				const bool conjugated = Core::is_conjugated(op);
+				auto factor = [conjugated](const Core::Matrix<T>& matrix, size_t i, size_t j) {
+					return conjugated ? Core::Traits::conjugate(matrix(i, j)) : matrix(i, j);
+				};
+				auto row_dot = [conjugated](const T* row, const T* values, size_t count) {
+					return conjugated ? Core::Kernels::dot<true>(row, values, count) : Core::Kernels::dot<false>(row, values, count);
+				};
+
+				if (!Core::is_transposed(op)) {
+					for (size_t i = 0; i < n; ++i) {
+						x[i] = b[permutation_[i]];
+					}
+					for (size_t i = 1; i < n; ++i) {
+						const size_t first = i - std::min(i, lower_band_);
+						x[i] -= row_dot(L_(i).data() + first, x.data() + first, i - first);
+					}
+					for (size_t i = n; i-- > 0;) {
+						const size_t last = std::min(n, i + upper_band_ + 1);
+						x[i] = (x[i] - row_dot(U_(i).data() + i + 1, x.data() + i + 1, last - i - 1)) / factor(U_, i, i);
+					}
+					return;
+				}
+
+				// As in the matrix solve, with w_i kept in x[permutation_[i]] so
+				// that the final scatter needs no second buffer.
+				for (size_t i = 0; i < n; ++i) {
+					x[permutation_[i]] = b[i];
+				}
+				for (size_t i = 0; i < n; ++i) {
+					T& w_i = x[permutation_[i]];
+					w_i /= factor(U_, i, i);
+					for (size_t q = i + 1; q < std::min(n, i + upper_band_ + 1); ++q) {
+						x[permutation_[q]] -= factor(U_, i, q) * w_i;
+					}
+				}
+				for (size_t i = n; i-- > 0;) {
+					const T w_i = x[permutation_[i]];
+					for (size_t q = i - std::min(i, lower_band_); q < i; ++q) {
+						x[permutation_[q]] -= factor(L_, i, q) * w_i;
+					}
+				}
+			}
 		};
 
 	}
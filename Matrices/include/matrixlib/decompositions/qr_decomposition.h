@@ -1,142 +1,710 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
-#include <numeric>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
+#include "../core/allocation_tracker.h"
+#include "../core/gemm_kernel.h"
+#include "../core/instrumentation.h"
 #include "../core/matrix.h"
-#include "../algebra/matrix_operations.h"
+#include "../core/matrix_view.h"
+#include "../core/scratch_allocator.h"
+#include "givens.h"
+#include "householder.h"
 
 
 namespace Decompositions {
 
 	namespace QR_Decomposition {
 
-		using Core::Traits::EpsilonType;
-		using Core::Traits::is_complex;
 		using Core::Traits::is_valid_matrix_type;
-		using Core::Traits::default_epsilon;
+		using Core::Traits::NormType;
 
 		using Core::Matrix;
 
-		using namespace Algebra::Operations;
-
+		// Economy Householder QR, A = Q R, for any m x n matrix; k = min(m, n).
+		// Only the k reflectors are kept (LAPACK geqrf layout: R on and above
+		// the diagonal, Householder vectors below it), so the factorization needs
+		// O(mn) memory. Columns are reduced in panels of block_size; each panel's
+		// reflectors are combined into I - V T V^H (compact WY) and applied to
+		// the trailing columns with two gemm calls. Q is never formed unless
+		// get_Q() is called: apply_Q, apply_Q_adjoint and solve use the
+		// reflectors directly.
+		//
+		// add_row, remove_row, add_column, remove_column and update modify the
+		// factorization in place with Givens rotations (Golub & Van Loan 6.5).
+		// The first of them forms the thin Q explicitly; after that every change
+		// costs O(k n) for R plus O(m k) for Q instead of a new O(m n k)
+		// factorization. Rotations slowly erode the orthogonality of Q, so with
+		// set_refactor_interval(count) the factors are rebuilt from Q R after
+		// every count changes.
 		template<typename T>
 		class Qr_Decomposition {
 		public:
+			static constexpr size_t block_size = 32;
 
-			const Matrix<T>& get_Q() const{ return Q_; }
-			const Matrix<T>& get_R() const{ return R_; }
-		
 			explicit Qr_Decomposition(const Matrix<T>& matrix){
-				if ((matrix.get_rows() != matrix.get_columns())){
-					throw std::invalid_argument("LUP decomposition requires square matrix");
-				}
-				if (matrix.get_rows() == 0) {
+				recompute_decomposition(matrix);
+			}
+			// Factors the matrix in its own storage.
+			explicit Qr_Decomposition(Matrix<T>&& matrix){
+				if (matrix.get_rows() == 0 || matrix.get_columns() == 0) {
 					throw std::invalid_argument("Matrix must not be empty");
 				}
 
-				R_ = matrix;
-				Q_ = Core::Matrix<T>(matrix.get_rows(), matrix.get_columns(), 0);
-				Q_.identity_matrix(T {1});
-				compute_decomposition(matrix);
+				factors_ = std::move(matrix);
+				compute_decomposition();
 			}
-		
+
 			void recompute_decomposition(const Matrix<T>& matrix){
-				if ((matrix.get_rows() != matrix.get_columns())){
-					throw std::invalid_argument("LUP decomposition requires square matrix");
-				}
-				if (matrix.get_rows() == 0) {
+				if (matrix.get_rows() == 0 || matrix.get_columns() == 0) {
 					throw std::invalid_argument("Matrix must not be empty");
 				}
 
-				R_ = matrix;
-				Q_ = Core::Matrix<T>(matrix.get_rows(), matrix.get_columns(), 0);
-				Q_.identity_matrix(T {1});
-				compute_decomposition(matrix);
+				factors_ = matrix;
+				compute_decomposition();
+			}
+
+			[[nodiscard]] size_t get_rows() const noexcept { return updated_ ? q_.get_rows() : factors_.get_rows(); }
+			[[nodiscard]] size_t get_columns() const noexcept { return updated_ ? r_.get_columns() : factors_.get_columns(); }
+
+			// k x n upper trapezoidal factor (triangular when m >= n).
+			[[nodiscard]] Matrix<T> get_R() const {
+				if (updated_) {
+					return r_;
+				}
+				const size_t k = std::min(get_rows(), get_columns());
+				Matrix<T> r(k, get_columns());
+				for (size_t i = 0; i < k; ++i) {
+					std::copy(factors_(i).begin() + i, factors_(i).end(), r(i).begin() + i);
+				}
+				r.set_structure(Core::StructureTag(Core::Structure::upper_triangular));
+				return r;
+			}
+
+			// Thin m x k factor with orthonormal columns.
+			[[nodiscard]] Matrix<T> get_Q() const {
+				if (updated_) {
+					return q_;
+				}
+				const size_t m = get_rows();
+				const size_t k = std::min(m, get_columns());
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::get_Q", 4 * m * k * k - 4 * k * k * k / 3, 2 * m * k * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::get_Q");
+				Matrix<T> q(m, k);
+				for (size_t i = 0; i < k; ++i) {
+					q(i, i) = T{ 1 };
+				}
+				// Columns left of a panel are still unit vectors above its rows,
+				// so each panel only touches the columns from its own offset on.
+				for (size_t offset = last_panel(); ; offset -= block_size) {
+					apply_panel(offset, Core::view(q).block(offset, offset, m - offset, k - offset), false);
+					if (offset == 0) {
+						break;
+					}
+				}
+				return q;
+			}
+
+			// Q c for the thin Q: c is k x p, the result m x p.
+			template<typename Allocator>
+			[[nodiscard]] Core::Matrix<T, Allocator> apply_Q(const Core::Matrix<T, Allocator>& c) const {
+				const size_t m = get_rows();
+				const size_t k = std::min(m, get_columns());
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::apply_Q", 4 * m * k * c.get_columns(), 0);
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::apply_Q");
+				if (c.get_rows() != k) {
+					throw std::invalid_argument("Right-hand side must have as many rows as Q has columns");
+				}
+				Core::Matrix<T, Allocator> result(m, c.get_columns(), c.get_allocator());
+				if (updated_) {
+					Core::Kernels::gemm(T{ 1 }, Core::view(q_), Core::Op::no_transpose, Core::view(c), Core::Op::no_transpose,
+						T{ 0 }, Core::view(result));
+					return result;
+				}
+				for (size_t i = 0; i < k; ++i) {
+					std::copy(c(i).begin(), c(i).end(), result(i).begin());
+				}
+				for (size_t offset = last_panel(); ; offset -= block_size) {
+					apply_panel(offset, Core::view(result).block(offset, 0, m - offset, c.get_columns()), false);
+					if (offset == 0) {
+						break;
+					}
+				}
+				return result;
+			}
+
+			// Q^H b for the thin Q: b is m x p, the result k x p.
+			template<typename Allocator>
+			[[nodiscard]] Core::Matrix<T, Allocator> apply_Q_adjoint(const Core::Matrix<T, Allocator>& b) const {
+				const size_t m = get_rows();
+				const size_t k = std::min(m, get_columns());
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::apply_Q_adjoint", 4 * m * k * b.get_columns(), 0);
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::apply_Q_adjoint");
+				if (b.get_rows() != m) {
+					throw std::invalid_argument("Right-hand side must have as many rows as the matrix");
+				}
+				Core::Matrix<T, Allocator> result(k, b.get_columns(), b.get_allocator());
+				if (updated_) {
+					Core::Kernels::gemm(T{ 1 }, Core::view(q_), Core::Op::conjugate_transpose, Core::view(b), Core::Op::no_transpose,
+						T{ 0 }, Core::view(result));
+					return result;
+				}
+				Core::Matrix<T, Allocator> work(b);
+				for (size_t offset = 0; offset < k; offset += block_size) {
+					apply_panel(offset, Core::view(work).block(offset, 0, m - offset, b.get_columns()), true);
+				}
+				for (size_t i = 0; i < k; ++i) {
+					result(i).swap(work(i));
+				}
+				return result;
+			}
+
+			// Least-squares solution of min ||A X - B||_F for every column of B,
+			// for m >= n and A of full column rank: X = R^-1 Q^H B.
+			template<typename Allocator>
+			[[nodiscard]] Core::Matrix<T, Allocator> solve(const Core::Matrix<T, Allocator>& b) const {
+				const size_t m = get_rows();
+				const size_t n = get_columns();
+				const size_t k = b.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::solve", 4 * m * n * k + n * n * k, (m * n + 2 * m * k) * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::solve");
+				if (m < n) {
+					throw std::invalid_argument("Least squares requires at least as many rows as columns");
+				}
+				const Matrix<T>& r = updated_ ? r_ : factors_;
+				for (size_t i = 0; i < n; ++i) {
+					if (r(i, i) == T{ 0 }) {
+						throw std::runtime_error("Matrix is rank deficient");
+					}
+				}
+
+				Core::Matrix<T, Allocator> x = apply_Q_adjoint(b);
+				for (size_t i = n; i-- > 0;) {
+					T* row = x(i).data();
+					for (size_t p = i + 1; p < n; ++p) {
+						const T coefficient = r(i, p);
+						const T* solved = x(p).data();
+						for (size_t j = 0; j < k; ++j) {
+							row[j] -= coefficient * solved[j];
+						}
+					}
+					for (size_t j = 0; j < k; ++j) {
+						row[j] /= r(i, i);
+					}
+				}
+				return x;
+			}
+
+			// Inserts row as row `position` of A.
+			void add_row(const std::vector<T>& row, size_t position) {
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::add_row", 0, 0);
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::add_row");
+				if (row.size() != get_columns()) {
+					throw std::invalid_argument("Row must have as many entries as the matrix has columns");
+				}
+				if (position > get_rows()) {
+					throw std::out_of_range("Row position is out of range");
+				}
+				make_explicit();
+				const size_t m = q_.get_rows();
+				const size_t n = r_.get_columns();
+				const size_t k = q_.get_columns();
+
+				// [A; row] = [Q 0; 0 1] [R; row], with the new row of Q moved to
+				// `position`; rotations then fold row into R. Q and R grow in
+				// place, keeping their row buffers.
+				Matrix<T> q = std::move(q_);
+				q.insert_row(position);
+				q.resize(m + 1, k + 1);
+				q(position, k) = T{ 1 };
+				Matrix<T> r = std::move(r_);
+				r.resize(k + 1, n);
+				std::copy(row.begin(), row.end(), r(k).begin());
+				for (size_t i = 0; i < k; ++i) {
+					const Givens::Rotation<T> rotation = Givens::make_rotation(r(i)[i], r(k)[i]);
+					r(k)[i] = T{ 0 };
+					Givens::rotate_rows(r, i, k, rotation, i + 1);
+					Givens::rotate_columns(q, i, k, rotation);
+				}
+				// With k == n the extra row of R is now zero and is dropped.
+				set_explicit(std::move(q), std::move(r), std::min(m + 1, n));
+			}
+			void add_row(const std::vector<T>& row) {
+				add_row(row, get_rows());
+			}
+
+			// Removes row `position` of A.
+			void remove_row(size_t position) {
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::remove_row", 0, 0);
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::remove_row");
+				if (position >= get_rows()) {
+					throw std::out_of_range("Row position is out of range");
+				}
+				if (get_rows() == 1) {
+					throw std::invalid_argument("Cannot remove the only row of the matrix");
+				}
+				make_explicit();
+				const size_t m = q_.get_rows();
+				const size_t n = r_.get_columns();
+
+				// A thin Q first gets the direction of e(position) outside its range
+				// as an extra column, so that row `position` of Q has unit norm.
+				if (q_.get_columns() < m) {
+					std::vector<T> unit(m);
+					unit[position] = T{ 1 };
+					extend_Q(unit);
+				}
+				Matrix<T> q = std::move(q_);
+				const size_t k = q.get_columns();
+				Matrix<T> r = std::move(r_);
+				r.resize(k, n);
+
+				// Rotate the row of Q onto its first entry, working on its
+				// conjugate since the rotations act on Q from the right.
+				std::vector<T> w(k);
+				for (size_t j = 0; j < k; ++j) {
+					w[j] = Core::Traits::conjugate(q(position, j));
+				}
+				for (size_t i = k - 1; i > 0; --i) {
+					const Givens::Rotation<T> rotation = Givens::make_rotation(w[i - 1], w[i]);
+					w[i] = T{ 0 };
+					Givens::rotate_rows(r, i - 1, i, rotation, i - 1);
+					Givens::rotate_columns(q, i - 1, i, rotation);
+				}
+
+				// Column 0 of Q is now +-e(position): drop it with row 0 of the
+				// (Hessenberg) R, which leaves R triangular.
+				q.erase_row(position);
+				q.erase_column(0);
+				r.erase_row(0);
+				set_explicit(std::move(q), std::move(r), k - 1);
+			}
+
+			// Inserts column as column `position` of A.
+			void add_column(const std::vector<T>& column, size_t position) {
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::add_column", 0, 0);
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::add_column");
+				if (column.size() != get_rows()) {
+					throw std::invalid_argument("Column must have as many entries as the matrix has rows");
+				}
+				if (position > get_columns()) {
+					throw std::out_of_range("Column position is out of range");
+				}
+				make_explicit();
+				const size_t m = q_.get_rows();
+				const size_t n = r_.get_columns();
+
+				// The new column of R is Q^H column, plus the norm of the part
+				// outside the range of a thin Q as an extra row.
+				std::vector<T> w = project(column);
+				if (q_.get_columns() < m) {
+					w.push_back(extend_Q(column));
+				}
+				Matrix<T> q = std::move(q_);
+				const size_t k = q.get_columns();
+				Matrix<T> r = std::move(r_);
+				r.resize(k, n);
+				r.insert_column(position);
+				for (size_t i = 0; i < k; ++i) {
+					r(i, position) = w[i];
+				}
+
+				// Zero the spike below the diagonal from the bottom up.
+				for (size_t i = k - 1; i > position; --i) {
+					const Givens::Rotation<T> rotation = Givens::make_rotation(r(i - 1)[position], r(i)[position]);
+					r(i)[position] = T{ 0 };
+					Givens::rotate_rows(r, i - 1, i, rotation, position + 1);
+					Givens::rotate_columns(q, i - 1, i, rotation);
+				}
+				set_explicit(std::move(q), std::move(r), k);
+			}
+			void add_column(const std::vector<T>& column) {
+				add_column(column, get_columns());
+			}
+
+			// Removes column `position` of A.
+			void remove_column(size_t position) {
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::remove_column", 0, 0);
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::remove_column");
+				if (position >= get_columns()) {
+					throw std::out_of_range("Column position is out of range");
+				}
+				if (get_columns() == 1) {
+					throw std::invalid_argument("Cannot remove the only column of the matrix");
+				}
+				make_explicit();
+				const size_t m = q_.get_rows();
+				const size_t n = r_.get_columns();
+				const size_t k = q_.get_columns();
+
+				Matrix<T> q = std::move(q_);
+				Matrix<T> r = std::move(r_);
+				r.erase_column(position);
+				// Columns right of the gap are upper Hessenberg now.
+				for (size_t i = position; i + 1 < k && i < n - 1; ++i) {
+					const Givens::Rotation<T> rotation = Givens::make_rotation(r(i)[i], r(i + 1)[i]);
+					r(i + 1)[i] = T{ 0 };
+					Givens::rotate_rows(r, i, i + 1, rotation, i + 1);
+					Givens::rotate_columns(q, i, i + 1, rotation);
+				}
+				set_explicit(std::move(q), std::move(r), std::min(m, n - 1));
 			}
+
+			// A <- A + u v^H.
+			void update(const std::vector<T>& u, const std::vector<T>& v) {
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::update", 0, 0);
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::update");
+				if (u.size() != get_rows() || v.size() != get_columns()) {
+					throw std::invalid_argument("Update vectors must match the matrix dimensions");
+				}
+				make_explicit();
+				const size_t m = q_.get_rows();
+				const size_t n = r_.get_columns();
+
+				// A + u v^H = Q (R + w v^H) with w = Q^H u, extended as in add_column.
+				std::vector<T> w = project(u);
+				if (q_.get_columns() < m) {
+					w.push_back(extend_Q(u));
+				}
+				Matrix<T> q = std::move(q_);
+				const size_t k = q.get_columns();
+				Matrix<T> r = std::move(r_);
+				r.resize(k, n);
+
+				// Rotate w onto its first entry (R becomes upper Hessenberg), add
+				// the rank-one term to row 0, then restore the triangle.
+				for (size_t i = k - 1; i > 0; --i) {
+					const Givens::Rotation<T> rotation = Givens::make_rotation(w[i - 1], w[i]);
+					w[i] = T{ 0 };
+					Givens::rotate_rows(r, i - 1, i, rotation, i - 1);
+					Givens::rotate_columns(q, i - 1, i, rotation);
+				}
+				for (size_t j = 0; j < n; ++j) {
+					r(0)[j] += w[0] * Core::Traits::conjugate(v[j]);
+				}
+				for (size_t i = 0; i + 1 < k && i < n; ++i) {
+					const Givens::Rotation<T> rotation = Givens::make_rotation(r(i)[i], r(i + 1)[i]);
+					r(i + 1)[i] = T{ 0 };
+					Givens::rotate_rows(r, i, i + 1, rotation, i + 1);
+					Givens::rotate_columns(q, i, i + 1, rotation);
+				}
+				set_explicit(std::move(q), std::move(r), std::min(m, n));
+			}
+
+			// Rebuild the factors from Q R every `count` changes made by the
+			// update functions; 0 (the default) never does.
+			void set_refactor_interval(size_t count) noexcept { refactor_interval_ = count; }
+			[[nodiscard]] size_t refactor_interval() const noexcept { return refactor_interval_; }
+
+			// Householder factorization of the current Q R, which restores the
+			// orthogonality of Q lost to rounding in the updates.
+			void refactor() {
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::refactor", 0, 0);
+				updates_since_refactor_ = 0;
+				if (!updated_) {
+					return;
+				}
+				Matrix<T> product = q_ * r_;
+				updated_ = false;
+				q_ = Matrix<T>();
+				r_ = Matrix<T>();
+				factors_ = std::move(product);
+				compute_decomposition();
+			}
+
 		private:
 			static_assert(
 				is_valid_matrix_type<T>::value,
 				"Matrix<T> requires T to be either float, double, long double or ComplexNumber<float/double/long double>");
 
-			Matrix<T>Q_;
-			Matrix<T>R_;
+			Matrix<T> factors_;
+			std::vector<T> tau_;
+			// Upper triangular T of every panel, block_size x block_size (the
+			// last one may be smaller).
+			std::vector<Matrix<T>> panel_factors_;
 
-			bool decomposed = false;
+			// Explicit thin factors, used instead of the reflectors once the
+			// factorization has been updated.
+			bool updated_ = false;
+			Matrix<T> q_;
+			Matrix<T> r_;
+			size_t refactor_interval_ = 0;
+			size_t updates_since_refactor_ = 0;
 
-			bool is_decomposed() {
-				return decomposed;
+			[[nodiscard]] size_t last_panel() const noexcept {
+				return (std::min(get_rows(), get_columns()) - 1) / block_size * block_size;
 			}
-			
-			void compute_decomposition(const Matrix<T>& matrix, const EpsilonType<T> epsilon = default_epsilon<T>()){
-				Matrix<T> identity(matrix.get_rows(), matrix.get_columns(), 0);
-				identity.identity_matrix(T{1});
 
-				const size_t n = matrix.get_rows();
-				const size_t m = matrix.get_columns();
+			void make_explicit() {
+				if (updated_) {
+					return;
+				}
+				q_ = get_Q();
+				r_ = get_R();
+				updated_ = true;
+				factors_ = Matrix<T>();
+				tau_.clear();
+				panel_factors_.clear();
+			}
 
-				for(size_t k = 0; k < m; ++k){
+			// Keeps the first k columns of q and rows of r as the new factors.
+			void set_explicit(Matrix<T>&& q, Matrix<T>&& r, size_t k) {
+				if (q.get_columns() != k) {
+					q.resize(q.get_rows(), k);
+				}
+				if (r.get_rows() != k) {
+					r.resize(k, r.get_columns());
+				}
+				q_ = std::move(q);
+				r_ = std::move(r);
+				r_.set_structure(Core::StructureTag(Core::Structure::upper_triangular));
+				if (refactor_interval_ != 0 && ++updates_since_refactor_ >= refactor_interval_) {
+					refactor();
+				}
+			}
+
+			// Q^H x for the explicit Q.
+			[[nodiscard]] std::vector<T> project(const std::vector<T>& x) const {
+				std::vector<T> result(q_.get_columns());
+				for (size_t i = 0; i < q_.get_rows(); ++i) {
+					const T* row = q_(i).data();
+					for (size_t j = 0; j < result.size(); ++j) {
+						result[j] += Core::Traits::conjugate(row[j]) * x[i];
+					}
+				}
+				return result;
+			}
 
-					// berechnen alpha
-					T alpha{0};
-					
-					for(size_t i = k; i < n; ++i){
-						alpha += std::norm(matrix(i, k));
+			// x <- x - Q Q^H x.
+			void project_out(std::vector<T>& x) const {
+				const std::vector<T> coefficients = project(x);
+				for (size_t i = 0; i < q_.get_rows(); ++i) {
+					const T* row = q_(i).data();
+					T sum{};
+					for (size_t j = 0; j < coefficients.size(); ++j) {
+						sum += row[j] * coefficients[j];
 					}
-					
-					alpha = std::sqrt(alpha);
-					if(std::abs(alpha) < epsilon) continue;
-					
-					if constexpr (is_complex<T>::value) {
-    					T a_kk = matrix(k,k);
-    					if (std::abs(a_kk) > epsilon) {
-        					T phase = a_kk / std::abs(a_kk);
-        					alpha = -phase * T(alpha);
-    					} else {
-        					alpha = -T{alpha};
-    					}
-					} else {
-    					if(matrix(k,k) > epsilon) alpha = -alpha;
+					x[i] -= sum;
+				}
+			}
+
+			[[nodiscard]] static NormType<T> vector_norm(const std::vector<T>& x) {
+				NormType<T> sum{};
+				for (const T& value : x) {
+					sum += std::norm(value);
+				}
+				return std::sqrt(sum);
+			}
+
+			// Appends to a thin Q the unit vector z along the part of x outside
+			// its range (two Gram-Schmidt passes, then one more after
+			// normalizing) and returns z^H x. When x lies in the range of Q, z is
+			// built from the unit vector e(i) farthest from it instead, so the
+			// extended Q is orthonormal either way.
+			T extend_Q(const std::vector<T>& x) {
+				const size_t m = q_.get_rows();
+				const size_t k = q_.get_columns();
+				std::vector<T> z(x);
+				project_out(z);
+				project_out(z);
+				NormType<T> norm = vector_norm(z);
+				if (norm <= std::sqrt(std::numeric_limits<NormType<T>>::epsilon()) * vector_norm(x)) {
+					size_t farthest = 0;
+					NormType<T> smallest = std::numeric_limits<NormType<T>>::max();
+					for (size_t i = 0; i < m; ++i) {
+						NormType<T> row_norm{};
+						for (const T& value : q_(i)) {
+							row_norm += std::norm(value);
+						}
+						if (row_norm < smallest) {
+							smallest = row_norm;
+							farthest = i;
+						}
 					}
+					std::fill(z.begin(), z.end(), T{});
+					z[farthest] = T{ 1 };
+					project_out(z);
+					project_out(z);
+					norm = vector_norm(z);
+				}
+				for (T& value : z) {
+					value /= norm;
+				}
+				project_out(z);
+				norm = vector_norm(z);
+				T coefficient{};
+				for (size_t i = 0; i < m; ++i) {
+					z[i] /= norm;
+					coefficient += Core::Traits::conjugate(z[i]) * x[i];
+				}
+
+				q_.resize(m, k + 1);
+				for (size_t i = 0; i < m; ++i) {
+					q_(i)[k] = z[i];
+				}
+				return coefficient;
+			}
 
-					//berechnen s-ae
-					std::vector<T> intermediate_vector(m-k);
-					for(size_t i = 0; i < intermediate_vector.size(); ++i){
-						if(i == 0){
-							intermediate_vector[i] = matrix(i+k, k) - alpha;
-						}else{
-							intermediate_vector[i] = matrix(i+k, k);
-						}	
+			void compute_decomposition(){
+				const size_t m = get_rows();
+				const size_t n = get_columns();
+				const size_t k = std::min(m, n);
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::compute_decomposition",
+					4 * std::max(m, n) * k * k - 4 * k * k * k / 3, 2 * m * n * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::compute_decomposition");
+
+				tau_.assign(k, T{});
+				panel_factors_.clear();
+				for (size_t offset = 0; offset < k; offset += block_size) {
+					const size_t width = std::min(block_size, k - offset);
+					factor_panel(offset, width);
+					build_panel_factor(offset, width);
+					if (offset + width < n) {
+						apply_panel(offset, Core::view(factors_).block(offset, offset + width, m - offset, n - offset - width), true);
 					}
+				}
+			}
 
-					//berechnen k
-					T coefficient{0};
-					for(size_t i = k; i < n; ++i){
-						coefficient += matrix(i,k) * intermediate_vector[i-k];
+			// Unblocked Householder QR of columns offset..offset+width, applying
+			// each reflector only within the panel.
+			void factor_panel(size_t offset, size_t width) {
+				MATRIXLIB_PROFILE_ZONE("Qr_Decomposition::factor_panel", 4 * (get_rows() - offset) * width * width, 0);
+				const size_t m = get_rows();
+				const size_t end = offset + width;
+				std::vector<T> w(width);
+				for (size_t column = offset; column < end; ++column) {
+					const T tau = Householder::generate_reflector(factors_, column, column);
+					tau_[column] = tau;
+					if (tau == T{ 0 } || column + 1 == end) {
+						continue;
+					}
+					// A <- H^H A = A - conj(tau) v (v^H A) on the rest of the panel.
+					std::fill(w.begin(), w.end(), T{});
+					for (size_t i = column; i < m; ++i) {
+						const T v = Core::Traits::conjugate(i == column ? T{ 1 } : factors_(i, column));
+						const T* row = factors_(i).data();
+						for (size_t j = column + 1; j < end; ++j) {
+							w[j - offset] += v * row[j];
+						}
 					}
-					coefficient = T{1}/std::sqrt(T{2}*coefficient);
+					const T scale = Core::Traits::conjugate(tau);
+					for (size_t i = column; i < m; ++i) {
+						const T v = scale * (i == column ? T{ 1 } : factors_(i, column));
+						T* row = factors_(i).data();
+						for (size_t j = column + 1; j < end; ++j) {
+							row[j] -= v * w[j - offset];
+						}
+					}
+				}
+			}
 
-					//berechnen omega
-					std::vector<T> omega(n, 0);
-					for(size_t i = k; i<n;++i){
-						omega[i] = coefficient * intermediate_vector[i-k];
+			// V of the panel at offset with its unit diagonal and zeros above.
+			template<typename Allocator>
+			void copy_reflectors(size_t offset, size_t width, Core::Matrix<T, Allocator>& v) const {
+				for (size_t i = 0; i < v.get_rows(); ++i) {
+					const T* source = factors_(offset + i).data() + offset;
+					T* target = v(i).data();
+					const size_t below = std::min(i, width);
+					std::copy(source, source + below, target);
+					if (i < width) {
+						target[i] = T{ 1 };
+						std::fill(target + i + 1, target + width, T{});
 					}
+				}
+			}
+
+			// LAPACK larft (forward, columnwise) from the Gram matrix V^H V:
+			// T(:j, j) = -tau_j T(:j, :j) V(:, :j)^H v_j, T(j, j) = tau_j.
+			void build_panel_factor(size_t offset, size_t width) {
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::build_panel_factor");
+				Core::Memory::ArenaScope scratch_scope;
+				Core::ScratchMatrix<T> v(get_rows() - offset, width);
+				copy_reflectors(offset, width, v);
+				Core::ScratchMatrix<T> gram(width, width);
+				Core::Kernels::gemm(T{ 1 }, Core::const_view(Core::view(v)), Core::Op::conjugate_transpose,
+					Core::const_view(Core::view(v)), Core::Op::no_transpose, T{ 0 }, Core::view(gram));
 
-					//berechnen die Matrix von Haußholder
-					Matrix<T> Vn(omega,true);
-					Matrix<T> hausholder_matrix;
-					if constexpr(is_complex<T>::value){
-						hausholder_matrix = identity - 2 * Vn * (Algebra::Operations::hermitian_matrix(Vn));
-					}else{
-						hausholder_matrix = identity - 2 * Vn * transpose(Vn);
+				Matrix<T> t(width, width);
+				for (size_t j = 0; j < width; ++j) {
+					const T tau = tau_[offset + j];
+					t(j, j) = tau;
+					for (size_t i = 0; i < j; ++i) {
+						T sum{};
+						for (size_t p = i; p < j; ++p) {
+							sum += t(i, p) * gram(p, j);
+						}
+						t(i, j) = -tau * sum;
 					}
+				}
+				panel_factors_.push_back(std::move(t));
+			}
 
+			// c <- (I - V T V^H) c, or its adjoint, for the panel at offset; c
+			// spans rows offset..m of the matrix being transformed.
+			void apply_panel(size_t offset, const Core::MatrixView<T>& c, bool adjoint) const {
+				if (c.get_columns() == 0) {
+					return;
+				}
+				MATRIXLIB_ALLOCATION_SCOPE("Qr_Decomposition::apply_panel");
+				const Matrix<T>& t = panel_factors_[offset / block_size];
+				const size_t width = t.get_rows();
+				const size_t columns = c.get_columns();
+				Core::Memory::ArenaScope scratch_scope;
+				Core::ScratchMatrix<T> v(c.get_rows(), width);
+				copy_reflectors(offset, width, v);
 
-					//Transformationen durchführen
-					R_ = hausholder_matrix * R_;
-					Q_ = Q_ * hausholder_matrix;
+				// W = V^H c, W <- T W (or T^H W), c -= V W.
+				Core::ScratchMatrix<T> w(width, columns);
+				Core::Kernels::gemm(T{ 1 }, Core::const_view(Core::view(v)), Core::Op::conjugate_transpose,
+					Core::const_view(c), Core::Op::no_transpose, T{ 0 }, Core::view(w));
+				if (adjoint) {
+					for (size_t i = width; i-- > 0;) {
+						T* row = w(i).data();
+						const T diagonal = Core::Traits::conjugate(t(i, i));
+						for (size_t j = 0; j < columns; ++j) {
+							row[j] *= diagonal;
+						}
+						for (size_t p = 0; p < i; ++p) {
+							const T coefficient = Core::Traits::conjugate(t(p, i));
+							const T* source = w(p).data();
+							for (size_t j = 0; j < columns; ++j) {
+								row[j] += coefficient * source[j];
+							}
+						}
+					}
 				}
+				else {
+					for (size_t i = 0; i < width; ++i) {
+						T* row = w(i).data();
+						const T diagonal = t(i, i);
+						for (size_t j = 0; j < columns; ++j) {
+							row[j] *= diagonal;
+						}
+						for (size_t p = i + 1; p < width; ++p) {
+							const T coefficient = t(i, p);
+							const T* source = w(p).data();
+							for (size_t j = 0; j < columns; ++j) {
+								row[j] += coefficient * source[j];
+							}
+						}
+					}
+				}
+				Core::Kernels::gemm(T{ -1 }, Core::const_view(Core::view(v)), Core::Op::no_transpose,
+					Core::const_view(Core::view(w)), Core::Op::no_transpose, T{ 1 }, c);
 			}
 		};
+
+		// Least-squares solution of A X = B (m >= n, full column rank).
+		template<typename T, typename Allocator>
+		[[nodiscard]] Core::Matrix<T, Allocator> lstsq(const Matrix<T>& a, const Core::Matrix<T, Allocator>& b) {
+			MATRIXLIB_PROFILE_ZONE("QR_Decomposition::lstsq", 0, 0);
+			return Qr_Decomposition<T>(a).solve(b);
+		}
 	}
-}
\ No newline at end of file
+}
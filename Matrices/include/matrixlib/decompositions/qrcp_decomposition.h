@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "../core/allocation_tracker.h"
+#include "../core/gemm_kernel.h"
+#include "../core/instrumentation.h"
+#include "../core/matrix.h"
+#include "../core/matrix_view.h"
+#include "../core/scratch_allocator.h"
+#include "../core/type_traits.h"
+#include "householder.h"
+
+namespace Decompositions {
+	namespace QRCP_Decomposition {
+
+		using Core::Traits::is_valid_matrix_type;
+		using Core::Traits::NormType;
+
+		// Householder QR with column pivoting, A P = Q R, for any m x n matrix.
+		// Columns are chosen by largest remaining norm, so |R(i, i)| does not
+		// increase along the diagonal and its decay reveals the numerical rank.
+		// The factorization follows LAPACK geqp3/laqps: nb columns at a time are
+		// reduced against a deferred update V F^H, which is applied to the
+		// trailing matrix with one gemm per block, and the remaining column norms
+		// are downdated instead of recomputed unless cancellation makes the
+		// downdate unreliable.
+		template<typename T>
+		class Qrcp_Decomposition {
+		public:
+			using NormValue = NormType<T>;
+
+			static constexpr size_t block_size = 32;
+
+			explicit Qrcp_Decomposition(const Core::Matrix<T>& matrix) : factors_(matrix) {
+				if (matrix.get_rows() == 0 || matrix.get_columns() == 0) {
+					throw std::invalid_argument("Matrix must not be empty");
+				}
+				compute_decomposition();
+			}
+
+			[[nodiscard]] size_t get_rows() const noexcept { return factors_.get_rows(); }
+			[[nodiscard]] size_t get_columns() const noexcept { return factors_.get_columns(); }
+
+			// Column i of A P is column permutation[i] of A; the first rank()
+			// entries select a well-conditioned set of basis columns.
+			[[nodiscard]] const std::vector<size_t>& get_permutation() const noexcept { return permutation_; }
+
+			// min(m, n) x n upper trapezoidal factor.
+			[[nodiscard]] Core::Matrix<T> get_R() const {
+				const size_t k = std::min(get_rows(), get_columns());
+				Core::Matrix<T> r(k, get_columns());
+				for (size_t i = 0; i < k; ++i) {
+					std::copy(factors_(i).begin() + i, factors_(i).end(), r(i).begin() + i);
+				}
+				r.set_structure(Core::StructureTag(Core::Structure::upper_triangular));
+				return r;
+			}
+
+			// m x min(m, n) factor with orthonormal columns, accumulated from the
+			// stored reflectors on request.
+			[[nodiscard]] Core::Matrix<T> get_Q() const {
+				MATRIXLIB_PROFILE_ZONE("Qrcp_Decomposition::get_Q", 4 * get_rows() * get_rows() * std::min(get_rows(), get_columns()), 0);
+				const size_t m = get_rows();
+				const size_t k = std::min(m, get_columns());
+				Core::Matrix<T> q(m, k);
+				for (size_t i = 0; i < k; ++i) {
+					q(i, i) = T{ 1 };
+				}
+				std::vector<T> w(k);
+				for (size_t p = k; p-- > 0;) {
+					// Q <- H(p) Q on rows p..m, with v(p) = 1 implicit.
+					std::fill(w.begin(), w.end(), T{});
+					for (size_t i = p; i < m; ++i) {
+						const T v = i == p ? T{ 1 } : factors_(i, p);
+						const T* row = q(i).data();
+						for (size_t j = p; j < k; ++j) {
+							w[j] += Core::Traits::conjugate(v) * row[j];
+						}
+					}
+					for (size_t i = p; i < m; ++i) {
+						const T v = i == p ? T{ 1 } : factors_(i, p);
+						T* row = q(i).data();
+						for (size_t j = p; j < k; ++j) {
+							row[j] -= tau_[p] * v * w[j];
+						}
+					}
+				}
+				return q;
+			}
+
+			// |R(i, i)| in pivot order.
+			[[nodiscard]] std::vector<NormValue> diagonal_magnitudes() const {
+				std::vector<NormValue> result(std::min(get_rows(), get_columns()));
+				for (size_t i = 0; i < result.size(); ++i) {
+					result[i] = std::abs(factors_(i, i));
+				}
+				return result;
+			}
+
+			// Number of diagonal entries of R above relative_tolerance * |R(0, 0)|.
+			[[nodiscard]] size_t rank(NormValue relative_tolerance) const {
+				const std::vector<NormValue> diagonal = diagonal_magnitudes();
+				if (diagonal.empty() || diagonal[0] == NormValue{ 0 }) {
+					return 0;
+				}
+				const NormValue threshold = relative_tolerance * diagonal[0];
+				size_t result = 0;
+				while (result < diagonal.size() && diagonal[result] > threshold) {
+					++result;
+				}
+				return result;
+			}
+			// Default tolerance max(m, n) * machine epsilon, as in MATLAB's rank.
+			[[nodiscard]] size_t rank() const {
+				return rank(static_cast<NormValue>(std::max(get_rows(), get_columns())) * std::numeric_limits<NormValue>::epsilon());
+			}
+
+		private:
+			static_assert(
+				is_valid_matrix_type<T>::value,
+				"Matrix<T> requires T to be either float, double, long double or ComplexNumber<float/double/long double>");
+
+			// R on and above the diagonal, Householder vectors (unit head
+			// implied) below it.
+			Core::Matrix<T> factors_;
+			std::vector<T> tau_;
+			std::vector<size_t> permutation_;
+
+			void compute_decomposition() {
+				const size_t m = get_rows();
+				const size_t n = get_columns();
+				const size_t k = std::min(m, n);
+				MATRIXLIB_PROFILE_ZONE("Qrcp_Decomposition::compute_decomposition", 4 * m * n * k - 2 * (m + n) * k * k + 4 * k * k * k / 3,
+					2 * m * n * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Qrcp_Decomposition::compute_decomposition");
+
+				tau_.assign(k, T{});
+				permutation_.resize(n);
+				std::iota(permutation_.begin(), permutation_.end(), size_t{ 0 });
+
+				// Partial column norms and the norms they were last recomputed at.
+				std::vector<NormValue> partial_norms(n);
+				for (size_t j = 0; j < n; ++j) {
+					partial_norms[j] = Householder::column_norm(factors_, j, 0);
+				}
+				std::vector<NormValue> reference_norms(partial_norms);
+
+				Core::Memory::ArenaScope scratch_scope;
+				Core::ScratchMatrix<T> f(n, std::min(block_size, k));
+				std::vector<T> aux(block_size);
+				std::vector<T> product(n);
+				std::vector<size_t> stale;
+
+				for (size_t j = 0; j < k;) {
+					j += reduce_block(j, std::min(block_size, k - j), partial_norms, reference_norms, f, aux, product, stale);
+				}
+			}
+
+			// Reduces up to nb columns starting at column/row offset (laqps) and
+			// returns how many it finished. It stops early when a column norm
+			// has to be recomputed, since that needs the trailing update first.
+			size_t reduce_block(size_t offset, size_t nb, std::vector<NormValue>& partial_norms,
+				std::vector<NormValue>& reference_norms, Core::ScratchMatrix<T>& f, std::vector<T>& aux, std::vector<T>& product,
+				std::vector<size_t>& stale) {
+				MATRIXLIB_PROFILE_ZONE("Qrcp_Decomposition::reduce_block", 0, 0);
+				const size_t m = get_rows();
+				const size_t n = get_columns();
+				const size_t remaining = n - offset;
+				const size_t last_row = std::min(m, n) - 1;
+				const NormValue downdate_tolerance = std::sqrt(std::numeric_limits<NormValue>::epsilon());
+
+				// F(c, p) pairs column offset + c with reflector offset + p.
+				for (size_t c = 0; c < remaining; ++c) {
+					std::fill(f(c).begin(), f(c).begin() + nb, T{});
+				}
+				stale.clear();
+
+				size_t k = 0;
+				while (k < nb && stale.empty()) {
+					const size_t rk = offset + k;
+					const size_t column = offset + k;
+
+					const size_t pivot = column + static_cast<size_t>(std::max_element(partial_norms.begin() + column, partial_norms.end()) -
+						(partial_norms.begin() + column));
+					if (pivot != column) {
+						for (size_t i = 0; i < m; ++i) {
+							std::swap(factors_(i)[pivot], factors_(i)[column]);
+						}
+						std::swap_ranges(f(pivot - offset).begin(), f(pivot - offset).begin() + k, f(k).begin());
+						std::swap(permutation_[pivot], permutation_[column]);
+						partial_norms[pivot] = partial_norms[column];
+						reference_norms[pivot] = reference_norms[column];
+					}
+
+					// Bring column k up to date with the k reflectors of this block.
+					if (k > 0) {
+						const T* f_row = f(k).data();
+						for (size_t i = rk; i < m; ++i) {
+							T* row = factors_(i).data() + offset;
+							T sum{};
+							for (size_t p = 0; p < k; ++p) {
+								sum += row[p] * Core::Traits::conjugate(f_row[p]);
+							}
+							row[k] -= sum;
+						}
+					}
+
+					tau_[rk] = Householder::generate_reflector(factors_, rk, column);
+					const T diagonal = factors_(rk, column);
+					factors_(rk)[column] = T{ 1 };
+					const T tau = tau_[rk];
+
+					// A(rk:, :)^H v in one sweep over the rows below rk gives both
+					// F(k+1:, k) = tau * A(rk:, k+1:)^H v and aux = -tau * A(rk:, :k)^H v.
+					std::fill(product.begin(), product.begin() + remaining, T{});
+					for (size_t i = rk; i < m; ++i) {
+						const T* row = factors_(i).data() + offset;
+						const T v = row[k];
+						for (size_t c = 0; c < remaining; ++c) {
+							product[c] += Core::Traits::conjugate(row[c]) * v;
+						}
+					}
+					for (size_t c = k + 1; c < remaining; ++c) {
+						f(c)[k] = tau * product[c];
+					}
+					std::copy(product.begin(), product.begin() + k, aux.begin());
+					// F(:, k) += F(:, :k) * aux accounts for the earlier reflectors.
+					if (k > 0) {
+						for (size_t p = 0; p < k; ++p) {
+							aux[p] *= -tau;
+						}
+						for (size_t c = 0; c < remaining; ++c) {
+							T* f_row = f(c).data();
+							T sum{};
+							for (size_t p = 0; p < k; ++p) {
+								sum += f_row[p] * aux[p];
+							}
+							f_row[k] += sum;
+						}
+					}
+
+					// Row rk of the trailing block is final after this update.
+					{
+						T* row = factors_(rk).data() + offset;
+						for (size_t c = k + 1; c < remaining; ++c) {
+							const T* f_row = f(c).data();
+							T sum{};
+							for (size_t p = 0; p <= k; ++p) {
+								sum += row[p] * Core::Traits::conjugate(f_row[p]);
+							}
+							row[c] -= sum;
+						}
+					}
+
+					// Downdate the remaining norms by the entry just moved into R.
+					if (rk < last_row) {
+						const T* row = factors_(rk).data() + offset;
+						for (size_t c = k + 1; c < remaining; ++c) {
+							NormValue& norm = partial_norms[offset + c];
+							if (norm == NormValue{ 0 }) {
+								continue;
+							}
+							const NormValue ratio = std::abs(row[c]) / norm;
+							const NormValue factor = std::max(NormValue{ 0 }, (NormValue{ 1 } + ratio) * (NormValue{ 1 } - ratio));
+							const NormValue relative = norm / reference_norms[offset + c];
+							if (factor * relative * relative <= downdate_tolerance) {
+								stale.push_back(offset + c);
+							}
+							else {
+								norm *= std::sqrt(factor);
+							}
+						}
+					}
+
+					factors_(rk)[column] = diagonal;
+					++k;
+				}
+
+				// A(rk:, kb:) -= V F(kb:, :)^H for the rows still below the block.
+				const size_t rk = offset + k;
+				if (k < std::min(remaining, m - offset) && rk < m) {
+					Core::MatrixView<T> a = Core::view(factors_);
+					Core::Kernels::gemm(T{ -1 }, Core::MatrixView<const T>(a.block(rk, offset, m - rk, k)), Core::Op::no_transpose,
+						Core::MatrixView<const T>(Core::view(f).block(k, 0, remaining - k, k)), Core::Op::conjugate_transpose,
+						T{ 1 }, a.block(rk, offset + k, m - rk, remaining - k));
+				}
+
+				for (size_t column : stale) {
+					partial_norms[column] = rk < m ? Householder::column_norm(factors_, column, rk) : NormValue{ 0 };
+					reference_norms[column] = partial_norms[column];
+				}
+				return k;
+			}
+		};
+
+	}
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/allocation_tracker.h"
+#include "../core/instrumentation.h"
+#include "../core/matrix.h"
+#include "../core/type_traits.h"
+#include "givens.h"
+#include "householder.h"
+
+namespace Decompositions {
+	namespace SCHUR_Decomposition {
+
+		using Core::Matrix;
+		using Core::Traits::is_valid_matrix_type;
+		using Core::Traits::NormType;
+
+		// Complex Schur form A = Q T Q^H with Q unitary and T upper triangular,
+		// the eigenvalues of A on its diagonal. Real matrices are factored in
+		// complex arithmetic, so T is triangular rather than quasi-triangular.
+		// A is reduced to Hessenberg form with Householder reflectors and then
+		// to T by explicitly shifted single-shift QR sweeps (the Wilkinson
+		// shift is subtracted from the active diagonal, the sweep applies
+		// Givens rotations, the shift is added back; an exceptional shift
+		// every tenth sweep without deflation). Throws std::runtime_error if an
+		// eigenvalue has not converged after max_sweeps_per_eigenvalue sweeps.
+		template<typename T>
+		class Schur_Decomposition {
+		public:
+			using Real = NormType<T>;
+			using Complex = std::complex<Real>;
+
+			static constexpr size_t max_sweeps_per_eigenvalue = 30;
+
+			explicit Schur_Decomposition(const Matrix<T>& matrix) {
+				if (matrix.get_rows() != matrix.get_columns()) {
+					throw std::invalid_argument("Schur decomposition requires square matrix");
+				}
+				if (matrix.get_rows() == 0) {
+					throw std::invalid_argument("Matrix must not be empty");
+				}
+				compute_decomposition(matrix);
+			}
+
+			[[nodiscard]] size_t get_rows() const noexcept { return T_.get_rows(); }
+			[[nodiscard]] const Matrix<Complex>& get_T() const noexcept { return T_; }
+			[[nodiscard]] const Matrix<Complex>& get_Q() const noexcept { return Q_; }
+			[[nodiscard]] std::vector<Complex> eigenvalues() const {
+				std::vector<Complex> result(get_rows());
+				for (size_t i = 0; i < get_rows(); ++i) {
+					result[i] = T_(i, i);
+				}
+				return result;
+			}
+
+		private:
+			static_assert(
+				is_valid_matrix_type<T>::value,
+				"Matrix<T> requires T to be either float, double, long double or ComplexNumber<float/double/long double>");
+
+			Matrix<Complex> T_;
+			Matrix<Complex> Q_;
+
+			void compute_decomposition(const Matrix<T>& matrix) {
+				const size_t n = matrix.get_rows();
+				MATRIXLIB_PROFILE_ZONE("Schur_Decomposition::compute_decomposition", 25 * n * n * n, 4 * n * n * sizeof(Complex));
+				MATRIXLIB_ALLOCATION_SCOPE("Schur_Decomposition::compute_decomposition");
+				T_ = Matrix<Complex>(n, n);
+				for (size_t i = 0; i < n; ++i) {
+					for (size_t j = 0; j < n; ++j) {
+						T_(i)[j] = Complex(matrix(i, j));
+					}
+				}
+				Q_ = Matrix<Complex>(n, n);
+				Q_.identity_matrix(Complex(1));
+				reduce_to_hessenberg();
+				iterate();
+				for (size_t i = 1; i < n; ++i) {
+					std::fill(T_(i).begin(), T_(i).begin() + i, Complex{});
+				}
+				T_.set_structure(Core::StructureTag(Core::Structure::upper_triangular));
+			}
+
+			// Q^H A Q = H with reflectors on rows/columns k + 1..n of step k.
+			void reduce_to_hessenberg() {
+				const size_t n = get_rows();
+				std::vector<Complex> v(n);
+				std::vector<Complex> w(n);
+				for (size_t k = 0; k + 2 < n; ++k) {
+					const Complex tau = Householder::generate_reflector(T_, k + 1, k);
+					if (tau == Complex{}) {
+						continue;
+					}
+					v[k + 1] = Complex(1);
+					for (size_t i = k + 2; i < n; ++i) {
+						v[i] = T_(i, k);
+						T_(i)[k] = Complex{};
+					}
+					// H^H T: rows k + 1..n, columns k + 1..n.
+					std::fill(w.begin(), w.end(), Complex{});
+					for (size_t i = k + 1; i < n; ++i) {
+						const Complex coefficient = std::conj(v[i]);
+						const Complex* row = T_(i).data();
+						for (size_t j = k + 1; j < n; ++j) {
+							w[j] += coefficient * row[j];
+						}
+					}
+					const Complex tau_conjugate = std::conj(tau);
+					for (size_t i = k + 1; i < n; ++i) {
+						const Complex coefficient = tau_conjugate * v[i];
+						Complex* row = T_(i).data();
+						for (size_t j = k + 1; j < n; ++j) {
+							row[j] -= coefficient * w[j];
+						}
+					}
+					// T H and Q H: every row, columns k + 1..n.
+					apply_on_right(T_, v, tau, k + 1);
+					apply_on_right(Q_, v, tau, k + 1);
+				}
+			}
+
+			static void apply_on_right(Matrix<Complex>& matrix, const std::vector<Complex>& v, const Complex& tau, size_t from) {
+				for (size_t i = 0; i < matrix.get_rows(); ++i) {
+					Complex* row = matrix(i).data();
+					Complex sum{};
+					for (size_t j = from; j < matrix.get_columns(); ++j) {
+						sum += row[j] * v[j];
+					}
+					sum *= tau;
+					for (size_t j = from; j < matrix.get_columns(); ++j) {
+						row[j] -= sum * std::conj(v[j]);
+					}
+				}
+			}
+
+			// Eigenvalue of the trailing 2x2 block of rows hi - 1..hi closest to
+			// its last diagonal entry.
+			[[nodiscard]] Complex wilkinson_shift(size_t hi) const {
+				const Complex a = T_(hi - 1, hi - 1);
+				const Complex b = T_(hi - 1, hi);
+				const Complex c = T_(hi, hi - 1);
+				const Complex d = T_(hi, hi);
+				const Complex half_difference = (a - d) / Real(2);
+				const Complex root = std::sqrt(half_difference * half_difference + b * c);
+				const Complex first = (a + d) / Real(2) + root;
+				const Complex second = (a + d) / Real(2) - root;
+				return std::abs(first - d) < std::abs(second - d) ? first : second;
+			}
+
+			void iterate() {
+				const size_t n = get_rows();
+				const Real epsilon = std::numeric_limits<Real>::epsilon();
+				size_t hi = n - 1;
+				size_t sweeps = 0;
+				while (hi > 0) {
+					size_t lo = hi;
+					while (lo > 0) {
+						const Real scale = std::abs(T_(lo, lo)) + std::abs(T_(lo - 1, lo - 1));
+						if (std::abs(T_(lo, lo - 1)) <= epsilon * scale || T_(lo, lo - 1) == Complex{}) {
+							T_(lo)[lo - 1] = Complex{};
+							break;
+						}
+						--lo;
+					}
+					if (lo == hi) {
+						--hi;
+						sweeps = 0;
+						continue;
+					}
+					if (++sweeps > max_sweeps_per_eigenvalue) {
+						throw std::runtime_error("Schur iteration did not converge");
+					}
+
+					Complex shift = wilkinson_shift(hi);
+					if (sweeps % 10 == 0) {
+						shift = T_(hi, hi) + Real(0.75) * std::abs(std::real(T_(hi, hi - 1)));
+					}
+
+					// One explicitly shifted QR sweep on rows and columns lo..hi:
+					// H - mu I = G^H R, then R G^H + mu I.
+					for (size_t i = lo; i <= hi; ++i) {
+						T_(i)[i] -= shift;
+					}
+					std::vector<Givens::Rotation<Complex>> rotations(hi - lo);
+					for (size_t k = lo; k < hi; ++k) {
+						Complex head = T_(k, k);
+						rotations[k - lo] = Givens::make_rotation(head, T_(k + 1, k));
+						Givens::rotate_rows(T_, k, k + 1, rotations[k - lo], k);
+						T_(k + 1)[k] = Complex{};
+					}
+					for (size_t k = lo; k < hi; ++k) {
+						Givens::rotate_columns(T_, k, k + 1, rotations[k - lo]);
+						Givens::rotate_columns(Q_, k, k + 1, rotations[k - lo]);
+					}
+					for (size_t i = lo; i <= hi; ++i) {
+						T_(i)[i] += shift;
+					}
+				}
+			}
+		};
+
+	}
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../core/allocation_tracker.h"
+#include "../core/instrumentation.h"
+#include "../core/matrix.h"
+#include "../core/parallel.h"
+#include "qr_decomposition.h"
+
+namespace Decompositions {
+	namespace TSQR_Decomposition {
+
+		using Core::Matrix;
+		using Core::Traits::is_valid_matrix_type;
+		using QR_Decomposition::Qr_Decomposition;
+
+		// Tall-skinny QR (Demmel et al.) for m x n matrices with m >= n. The rows
+		// are cut into leaves of at least leaf_rows rows, each leaf is factored on
+		// its own thread, and the n x n R factors are merged pairwise in a binary
+		// tree until one R is left. Q stays implicit as the tree of per-node
+		// Householder factorizations; apply_Q, apply_Q_adjoint and solve walk
+		// it, so only the leaves touch all m rows and they do so in parallel.
+		// Leaf boundaries depend only on the shape, so the result is the same
+		// for any thread count.
+		template<typename T>
+		class Tsqr_Decomposition {
+		public:
+			static constexpr size_t leaf_rows = 4096;
+
+			explicit Tsqr_Decomposition(const Matrix<T>& matrix) {
+				const size_t m = matrix.get_rows();
+				const size_t n = matrix.get_columns();
+				if (m == 0 || n == 0) {
+					throw std::invalid_argument("Matrix must not be empty");
+				}
+				if (m < n) {
+					throw std::invalid_argument("TSQR requires at least as many rows as columns");
+				}
+				compute_decomposition(matrix);
+			}
+
+			[[nodiscard]] size_t get_rows() const noexcept { return offsets_.back(); }
+			[[nodiscard]] size_t get_columns() const noexcept { return r_.get_columns(); }
+			[[nodiscard]] size_t leaf_count() const noexcept { return offsets_.size() - 1; }
+
+			// n x n upper triangular factor from the root of the tree.
+			[[nodiscard]] const Matrix<T>& get_R() const noexcept { return r_; }
+
+			// Thin m x n factor, Q I.
+			[[nodiscard]] Matrix<T> get_Q() const {
+				Matrix<T> identity(get_columns(), get_columns());
+				identity.identity_matrix(T{ 1 });
+				return apply_Q(identity);
+			}
+
+			// Q c for the thin Q: c is n x k, the result m x k.
+			[[nodiscard]] Matrix<T> apply_Q(const Matrix<T>& c) const {
+				const size_t n = get_columns();
+				const size_t k = c.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Tsqr_Decomposition::apply_Q", 4 * get_rows() * n * k, 2 * get_rows() * (n + k) * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Tsqr_Decomposition::apply_Q");
+				if (c.get_rows() != n) {
+					throw std::invalid_argument("Right-hand side must have as many rows as the matrix has columns");
+				}
+
+				// Top-down: each node turns its n x k block into blocks for its two
+				// children, [top; bottom] = Q_node x.
+				std::vector<Matrix<T>> blocks{ c };
+				for (size_t level = tree_.size(); level-- > 0;) {
+					const std::vector<Qr_Decomposition<T>>& nodes = tree_[level];
+					std::vector<Matrix<T>> children(widths_[level]);
+					Core::Parallel::parallel_for(0, nodes.size(), 1, [&](size_t first, size_t last) {
+						for (size_t j = first; j < last; ++j) {
+							const Matrix<T> stacked = nodes[j].apply_Q(blocks[j]);
+							children[2 * j] = Matrix<T>(n, k);
+							children[2 * j + 1] = Matrix<T>(n, k);
+							copy_rows(stacked, 0, n, children[2 * j], 0);
+							copy_rows(stacked, n, n, children[2 * j + 1], 0);
+						}
+					});
+					if (widths_[level] % 2 != 0) {
+						children.back() = std::move(blocks.back());
+					}
+					blocks = std::move(children);
+				}
+
+				Matrix<T> result(get_rows(), k);
+				Core::Parallel::parallel_for(0, leaf_count(), 1, [&](size_t first, size_t last) {
+					for (size_t leaf = first; leaf < last; ++leaf) {
+						const Matrix<T> chunk = leaves_[leaf].apply_Q(blocks[leaf]);
+						copy_rows(chunk, 0, chunk.get_rows(), result, offsets_[leaf]);
+					}
+				});
+				return result;
+			}
+
+			// Q^H b for the thin Q: b is m x k, the result n x k.
+			[[nodiscard]] Matrix<T> apply_Q_adjoint(const Matrix<T>& b) const {
+				const size_t n = get_columns();
+				const size_t k = b.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Tsqr_Decomposition::apply_Q_adjoint", 4 * get_rows() * n * k, 2 * get_rows() * (n + k) * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Tsqr_Decomposition::apply_Q_adjoint");
+				if (b.get_rows() != get_rows()) {
+					throw std::invalid_argument("Right-hand side must have as many rows as the matrix");
+				}
+
+				// Bottom-up: every leaf, then every node, replaces its rows by
+				// Q_node^H applied to them.
+				std::vector<Matrix<T>> blocks(leaf_count());
+				Core::Parallel::parallel_for(0, leaf_count(), 1, [&](size_t first, size_t last) {
+					for (size_t leaf = first; leaf < last; ++leaf) {
+						const size_t rows = offsets_[leaf + 1] - offsets_[leaf];
+						Matrix<T> chunk(rows, k);
+						copy_rows(b, offsets_[leaf], rows, chunk, 0);
+						blocks[leaf] = leaves_[leaf].apply_Q_adjoint(chunk);
+					}
+				});
+				for (size_t level = 0; level < tree_.size(); ++level) {
+					const std::vector<Qr_Decomposition<T>>& nodes = tree_[level];
+					std::vector<Matrix<T>> parents(widths_[level + 1]);
+					Core::Parallel::parallel_for(0, nodes.size(), 1, [&](size_t first, size_t last) {
+						for (size_t j = first; j < last; ++j) {
+							Matrix<T> stacked(2 * n, k);
+							copy_rows(blocks[2 * j], 0, n, stacked, 0);
+							copy_rows(blocks[2 * j + 1], 0, n, stacked, n);
+							parents[j] = nodes[j].apply_Q_adjoint(stacked);
+						}
+					});
+					if (widths_[level] % 2 != 0) {
+						parents.back() = std::move(blocks.back());
+					}
+					blocks = std::move(parents);
+				}
+				return std::move(blocks.front());
+			}
+
+			// Least-squares solution of min ||A X - B||_F, X = R^-1 Q^H B, for A
+			// of full column rank.
+			[[nodiscard]] Matrix<T> solve(const Matrix<T>& b) const {
+				const size_t n = get_columns();
+				const size_t k = b.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Tsqr_Decomposition::solve", 4 * get_rows() * n * k + n * n * k, 0);
+				for (size_t i = 0; i < n; ++i) {
+					if (r_(i, i) == T{ 0 }) {
+						throw std::runtime_error("Matrix is rank deficient");
+					}
+				}
+				Matrix<T> x = apply_Q_adjoint(b);
+				for (size_t i = n; i-- > 0;) {
+					T* row = x(i).data();
+					for (size_t p = i + 1; p < n; ++p) {
+						const T coefficient = r_(i, p);
+						const T* solved = x(p).data();
+						for (size_t j = 0; j < k; ++j) {
+							row[j] -= coefficient * solved[j];
+						}
+					}
+					for (size_t j = 0; j < k; ++j) {
+						row[j] /= r_(i, i);
+					}
+				}
+				return x;
+			}
+
+		private:
+			static_assert(
+				is_valid_matrix_type<T>::value,
+				"Matrix<T> requires T to be either float, double, long double or ComplexNumber<float/double/long double>");
+
+			// Leaf i owns rows offsets_[i] .. offsets_[i + 1].
+			std::vector<size_t> offsets_;
+			std::vector<Qr_Decomposition<T>> leaves_;
+			// tree_[l][j] factors [R(2j); R(2j + 1)] of the widths_[l] factors on
+			// level l (level 0 being the leaves); an odd last factor moves up
+			// unchanged.
+			std::vector<std::vector<Qr_Decomposition<T>>> tree_;
+			std::vector<size_t> widths_;
+			Matrix<T> r_;
+
+			static void copy_rows(const Matrix<T>& source, size_t first, size_t count, Matrix<T>& target, size_t at) {
+				for (size_t i = 0; i < count; ++i) {
+					std::copy(source(first + i).begin(), source(first + i).end(), target(at + i).begin());
+				}
+			}
+
+			// Factors every group in parallel; group j is built by make(j).
+			template<typename Make>
+			static std::vector<Qr_Decomposition<T>> factor_all(size_t count, Make&& make) {
+				std::vector<std::optional<Qr_Decomposition<T>>> built(count);
+				Core::Parallel::parallel_for(0, count, 1, [&](size_t first, size_t last) {
+					for (size_t j = first; j < last; ++j) {
+						built[j].emplace(make(j));
+					}
+				});
+				std::vector<Qr_Decomposition<T>> result;
+				result.reserve(count);
+				for (auto& decomposition : built) {
+					result.push_back(std::move(*decomposition));
+				}
+				return result;
+			}
+
+			void compute_decomposition(const Matrix<T>& matrix) {
+				const size_t m = matrix.get_rows();
+				const size_t n = matrix.get_columns();
+				MATRIXLIB_PROFILE_ZONE("Tsqr_Decomposition::compute_decomposition", 4 * m * n * n, 2 * m * n * sizeof(T));
+				MATRIXLIB_ALLOCATION_SCOPE("Tsqr_Decomposition::compute_decomposition");
+
+				const size_t leaves = std::max<size_t>(1, m / std::max(leaf_rows, 2 * n));
+				offsets_.resize(leaves + 1);
+				for (size_t i = 0; i <= leaves; ++i) {
+					offsets_[i] = m * i / leaves;
+				}
+				leaves_ = factor_all(leaves, [&](size_t leaf) {
+					const size_t rows = offsets_[leaf + 1] - offsets_[leaf];
+					Matrix<T> chunk(rows, n);
+					copy_rows(matrix, offsets_[leaf], rows, chunk, 0);
+					return Qr_Decomposition<T>(std::move(chunk));
+				});
+
+				std::vector<Matrix<T>> factors(leaves);
+				for (size_t leaf = 0; leaf < leaves; ++leaf) {
+					factors[leaf] = leaves_[leaf].get_R();
+				}
+				widths_.assign(1, leaves);
+				tree_.clear();
+				while (factors.size() > 1) {
+					const size_t pairs = factors.size() / 2;
+					tree_.push_back(factor_all(pairs, [&](size_t j) {
+						Matrix<T> stacked(2 * n, n);
+						copy_rows(factors[2 * j], 0, n, stacked, 0);
+						copy_rows(factors[2 * j + 1], 0, n, stacked, n);
+						return Qr_Decomposition<T>(std::move(stacked));
+					}));
+					std::vector<Matrix<T>> parents(pairs + factors.size() % 2);
+					for (size_t j = 0; j < pairs; ++j) {
+						parents[j] = tree_.back()[j].get_R();
+					}
+					if (factors.size() % 2 != 0) {
+						parents.back() = std::move(factors.back());
+					}
+					factors = std::move(parents);
+					widths_.push_back(factors.size());
+				}
+				r_ = std::move(factors.front());
+			}
+		};
+
+	}
+}
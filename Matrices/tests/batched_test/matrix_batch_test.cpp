@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../../include/matrixlib/algebra/batched.h"
+#include "../../include/matrixlib/decompositions/cholesky_decomposition.h"
+#include "../../include/matrixlib/decompositions/lup_decomposition.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+namespace Batched = Algebra::Batched;
+
+namespace {
+
+    template<typename T>
+    std::vector<Matrix<T>> samples(size_t count, size_t rows, size_t columns, unsigned seed) {
+        std::mt19937 engine(seed);
+        std::vector<Matrix<T>> result;
+        for (size_t b = 0; b < count; ++b) {
+            result.push_back(sample<T>(rows, columns, engine));
+        }
+        return result;
+    }
+
+    template<typename T>
+    MatrixBatch<T> pack(const std::vector<Matrix<T>>& matrices) {
+        MatrixBatch<T> batch(matrices.size(), matrices.front().get_rows(), matrices.front().get_columns());
+        for (size_t b = 0; b < matrices.size(); ++b) {
+            batch.set(b, matrices[b]);
+        }
+        return batch;
+    }
+
+    template<typename T>
+    T determinant(const Matrix<T>& matrix) {
+        const Decompositions::LUP_Decomposition::Lup_Decomposition<T> lup(matrix);
+        T result = lup.get_permutations() % 2 == 0 ? T{ 1 } : T{ -1 };
+        for (size_t i = 0; i < matrix.get_rows(); ++i) {
+            result *= lup.get_U()(i, i);
+        }
+        return result;
+    }
+
+    template<typename T>
+    void check_lup(size_t count, size_t n, unsigned seed) {
+        const std::vector<Matrix<T>> a = samples<T>(count, n, n, seed);
+        const std::vector<Matrix<T>> b = samples<T>(count, n, 3, seed + 1);
+        const Batched::LupBatch<T> lup(pack(a));
+        EXPECT_TRUE(lup.singular().empty());
+
+        const MatrixBatch<T> x = lup.solve(pack(b));
+        const MatrixBatch<T> inverse = lup.inverse();
+        const std::vector<T> determinants = lup.determinants();
+        Matrix<T> identity(n, n);
+        identity.identity_matrix(T{ 1 });
+        for (size_t m = 0; m < count; ++m) {
+            expect_near(a[m] * x.get(m), b[m], 1e-9);
+            expect_near(a[m] * inverse.get(m), identity, 1e-9);
+            const T expected = determinant(a[m]);
+            EXPECT_NEAR(std::abs(determinants[m] - expected), 0.0, 1e-9 * std::max(1.0, std::abs(expected))) << m;
+        }
+    }
+
+}
+
+TEST(MatrixBatchTest, StoresMembersInterleavedByLane) {
+    MatrixBatch<double> batch(11, 2, 3);
+    EXPECT_EQ(batch.size(), 11u);
+    EXPECT_EQ(batch.groups(), 2u);
+    batch(9, 1, 2) = 4.0;
+    const size_t lanes = MatrixBatch<double>::lanes;
+    EXPECT_EQ(batch.group(1)[(1 * 3 + 2) * lanes + 1], 4.0);
+    EXPECT_EQ(batch.get(9)(1, 2), 4.0);
+    EXPECT_THROW((void)batch.get(11), std::out_of_range);
+    EXPECT_THROW(batch.set(0, Matrix<double>(3, 2)), std::invalid_argument);
+}
+
+TEST(MatrixBatchTest, GemmMatchesMatrixProducts) {
+    const std::vector<Matrix<double>> a = samples<double>(13, 5, 7, 1);
+    const std::vector<Matrix<double>> b = samples<double>(13, 7, 4, 2);
+    const std::vector<Matrix<double>> c = samples<double>(13, 5, 4, 3);
+    MatrixBatch<double> result = pack(c);
+    Batched::gemm(2.0, pack(a), pack(b), -1.0, result);
+    const MatrixBatch<double> product = Batched::multiply(pack(a), pack(b));
+    for (size_t m = 0; m < a.size(); ++m) {
+        expect_near(result.get(m), a[m] * b[m] * 2.0 - c[m], 1e-12);
+        expect_near(product.get(m), a[m] * b[m], 1e-12);
+    }
+    MatrixBatch<double> wrong(13, 4, 4);
+    EXPECT_THROW(Batched::gemm(1.0, pack(a), pack(b), 0.0, wrong), std::invalid_argument);
+}
+
+TEST(MatrixBatchTest, ComplexGemmMatchesMatrixProducts) {
+    using C = std::complex<double>;
+    const std::vector<Matrix<C>> a = samples<C>(9, 4, 4, 4);
+    const std::vector<Matrix<C>> b = samples<C>(9, 4, 4, 5);
+    const MatrixBatch<C> product = Batched::multiply(pack(a), pack(b));
+    for (size_t m = 0; m < a.size(); ++m) {
+        expect_near(product.get(m), a[m] * b[m], 1e-12);
+    }
+}
+
+TEST(MatrixBatchTest, LupSolvesInvertsAndGivesDeterminants) {
+    check_lup<double>(21, 3, 10);
+    check_lup<double>(8, 4, 11);
+    check_lup<double>(5, 16, 12);
+    check_lup<double>(9, 32, 13);
+    check_lup<std::complex<double>>(11, 6, 14);
+}
+
+TEST(MatrixBatchTest, SingularMemberIsReportedWithoutStoppingTheOthers) {
+    std::vector<Matrix<double>> a = samples<double>(10, 4, 4, 20);
+    for (size_t i = 0; i < 4; ++i) {
+        a[6](i, 2) = 0.0;
+    }
+    const Batched::LupBatch<double> lup(pack(a));
+    EXPECT_EQ(lup.singular(), std::vector<size_t>{ 6 });
+    EXPECT_TRUE(lup.is_singular(6));
+    EXPECT_FALSE(lup.is_singular(5));
+    EXPECT_NEAR(lup.determinants()[6], 0.0, 1e-12);
+    const std::vector<double> determinants = lup.determinants();
+    EXPECT_NEAR(determinants[2], determinant(a[2]), 1e-12);
+    EXPECT_THROW((void)lup.inverse(), std::runtime_error);
+    EXPECT_THROW((void)Batched::inverse(pack(a)), std::runtime_error);
+
+    // A pivot below epsilon counts as singular, as in Lup_Decomposition.
+    a[6] = samples<double>(1, 4, 4, 21)[0];
+    a[3] *= 1e-12;
+    const Batched::LupBatch<double> nearly(pack(a));
+    EXPECT_EQ(nearly.singular(), std::vector<size_t>{ 3 });
+    EXPECT_THROW((void)Decompositions::LUP_Decomposition::Lup_Decomposition<double>(a[3]), std::runtime_error);
+    EXPECT_EQ(Batched::LupBatch<double>(pack(a), 1e-20).singular(), std::vector<size_t>{});
+}
+
+TEST(MatrixBatchTest, CholeskyMatchesSingleFactorization) {
+    using C = std::complex<double>;
+    const size_t n = 7;
+    std::vector<Matrix<C>> a = samples<C>(12, n, n, 30);
+    for (Matrix<C>& matrix : a) {
+        matrix = adjoint(matrix) * matrix;
+        for (size_t i = 0; i < n; ++i) {
+            matrix(i, i) += C(static_cast<double>(n));
+        }
+    }
+    const std::vector<Matrix<C>> b = samples<C>(12, n, 2, 31);
+    const Batched::CholeskyBatch<C> cholesky(pack(a));
+    EXPECT_TRUE(cholesky.failed().empty());
+    const MatrixBatch<C> x = cholesky.solve(pack(b));
+    for (size_t m = 0; m < a.size(); ++m) {
+        const Decompositions::CHOLESKY_Decomposition::Cholesky_Decomposition<C> single(a[m]);
+        expect_near(cholesky.get_R().get(m), single.get_R(), 1e-12);
+        expect_near(a[m] * x.get(m), b[m], 1e-10);
+    }
+}
+
+TEST(MatrixBatchTest, CholeskyReportsIndefiniteMembers) {
+    std::vector<Matrix<double>> a(3, Matrix<double>(2, 2));
+    for (Matrix<double>& matrix : a) {
+        matrix.identity_matrix(1.0);
+    }
+    a[1](1, 1) = -1.0;
+    const Batched::CholeskyBatch<double> cholesky(pack(a));
+    EXPECT_EQ(cholesky.failed(), std::vector<size_t>{ 1 });
+    EXPECT_THROW((void)cholesky.solve(pack(a)), std::runtime_error);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "../../include/matrixlib/algebra/blas.h"
+#include "../../include/matrixlib/algebra/matrix_operations.h"
+#include "../../include/matrixlib/core/allocation_tracker.h"
+#include "../../include/matrixlib/core/matrix.h"
+
+using namespace Core;
+using Algebra::Blas::gemm;
+
+namespace {
+
+    Matrix<double> reference_product(const Matrix<double>& a, const Matrix<double>& b) {
+        Matrix<double> result(a.get_rows(), b.get_columns());
+        for (size_t i = 0; i < a.get_rows(); ++i) {
+            for (size_t j = 0; j < b.get_columns(); ++j) {
+                for (size_t k = 0; k < a.get_columns(); ++k) {
+                    result(i, j) += a(i, k) * b(k, j);
+                }
+            }
+        }
+        return result;
+    }
+
+    Matrix<double> filled(size_t rows, size_t columns, double seed) {
+        Matrix<double> result(rows, columns);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < columns; ++j) {
+                result(i, j) = seed + 0.5 * static_cast<double>(i) - 0.25 * static_cast<double>(j) + 0.01 * static_cast<double>(i * j);
+            }
+        }
+        return result;
+    }
+
+    void expect_near(const Matrix<double>& actual, const Matrix<double>& expected, double tolerance = 1e-9) {
+        ASSERT_EQ(actual.get_rows(), expected.get_rows());
+        ASSERT_EQ(actual.get_columns(), expected.get_columns());
+        for (size_t i = 0; i < actual.get_rows(); ++i) {
+            for (size_t j = 0; j < actual.get_columns(); ++j) {
+                EXPECT_NEAR(actual(i, j), expected(i, j), tolerance) << "at (" << i << ", " << j << ")";
+            }
+        }
+    }
+
+    TEST(GemmTest, MatchesReferenceAcrossBlockBoundaries) {
+        Matrix<double> a = filled(131, 140, 1.0);
+        Matrix<double> b = filled(140, 263, -2.0);
+        Matrix<double> c(131, 263);
+
+        gemm(1.0, a, b, 0.0, c);
+        expect_near(c, reference_product(a, b), 1e-8);
+    }
+
+    TEST(GemmTest, AlphaAndBetaAccumulateIntoOutput) {
+        Matrix<double> a = filled(5, 3, 1.0);
+        Matrix<double> b = filled(3, 4, 2.0);
+        Matrix<double> c = filled(5, 4, 3.0);
+        Matrix<double> expected = 2.0 * reference_product(a, b) + 0.5 * c;
+
+        gemm(2.0, a, b, 0.5, c);
+        expect_near(c, expected);
+    }
+
+    TEST(GemmTest, BetaZeroIgnoresPreviousContents) {
+        Matrix<double> a = filled(2, 2, 1.0);
+        Matrix<double> c(2, 2, std::numeric_limits<double>::quiet_NaN());
+
+        gemm(1.0, a, a, 0.0, c);
+        expect_near(c, reference_product(a, a));
+    }
+
+    TEST(GemmTest, TransposeFlagsReadOperandsTransposed) {
+        Matrix<double> a = filled(3, 5, 1.0);
+        Matrix<double> b = filled(4, 3, -1.0);
+        Matrix<double> c(5, 4);
+
+        gemm(1.0, a, Op::transpose, b, Op::transpose, 0.0, c);
+        expect_near(c, Algebra::Operations::transpose(reference_product(b, a)));
+    }
+
+    TEST(GemmTest, ConjugateTransposeOfComplexOperand) {
+        Matrix<std::complex<double>> a(2, 2);
+        a(0, 0) = { 1, 1 }; a(0, 1) = { 0, 2 };
+        a(1, 0) = { 3, 0 }; a(1, 1) = { 1, -1 };
+        Matrix<std::complex<double>> c(2, 2);
+
+        gemm(std::complex<double>(1), a, Op::conjugate_transpose, a, Op::no_transpose, std::complex<double>(0), c);
+        EXPECT_DOUBLE_EQ(c(0, 0).real(), 11.0);
+        EXPECT_DOUBLE_EQ(c(1, 1).real(), 6.0);
+        EXPECT_DOUBLE_EQ(c(0, 1).real(), std::conj(c(1, 0)).real());
+        EXPECT_DOUBLE_EQ(c(0, 1).imag(), std::conj(c(1, 0)).imag());
+    }
+
+    TEST(GemmTest, WritesIntoViewBlock) {
+        Matrix<double> a = filled(2, 3, 1.0);
+        Matrix<double> b = filled(3, 2, 2.0);
+        Matrix<double> c(4, 4, 7.0);
+
+        gemm<double>(1.0, view(a), view(b), 0.0, view(c).block(1, 2, 2, 2));
+        Matrix<double> expected = reference_product(a, b);
+        EXPECT_DOUBLE_EQ(c(0, 0), 7.0);
+        EXPECT_DOUBLE_EQ(c(1, 1), 7.0);
+        EXPECT_DOUBLE_EQ(c(1, 2), expected(0, 0));
+        EXPECT_DOUBLE_EQ(c(2, 3), expected(1, 1));
+    }
+
+    TEST(GemmTest, RejectsBadShapesAndAliasing) {
+        Matrix<double> a = filled(3, 3, 1.0);
+        Matrix<double> b = filled(2, 3, 1.0);
+        Matrix<double> c(3, 3);
+
+        EXPECT_THROW(gemm(1.0, a, b, 0.0, c), std::invalid_argument);
+        Matrix<double> wrong(2, 2);
+        EXPECT_THROW(gemm(1.0, a, a, 0.0, wrong), std::invalid_argument);
+        EXPECT_THROW(gemm(1.0, a, c, 0.0, a), std::invalid_argument);
+
+        Matrix<double> big(6, 6, 1.0);
+        EXPECT_THROW(gemm<double>(1.0, view(big).block(0, 0, 3, 3), view(a), 0.0, view(big).block(2, 2, 3, 3)),
+            std::invalid_argument);
+        EXPECT_NO_THROW(gemm<double>(1.0, view(big).block(0, 0, 3, 3), view(a), 0.0, view(big).block(3, 3, 3, 3)));
+    }
+
+    TEST(GemmTest, RepeatedCallsDoNotAllocate) {
+        Matrix<double> a = filled(64, 300, 1.0);
+        Matrix<double> b = filled(300, 300, 2.0);
+        Matrix<double> c(64, 300);
+        gemm(1.0, a, b, 0.0, c);
+
+        const auto& workspace = Kernels::Detail::gemm_workspace<double>();
+        const double* packed_a = workspace.packed_a.data();
+        const double* packed_b = workspace.packed_b.data();
+
+        Memory::set_allocation_tracking_enabled(true);
+        {
+            Memory::AllocationScope scope("repeated gemm");
+            for (int step = 0; step < 5; ++step) {
+                gemm(1.0, a, b, 1.0, c);
+            }
+            EXPECT_EQ(scope.allocations(), 0u);
+            if (Memory::heap_allocations_counted()) {
+                EXPECT_EQ(scope.heap_allocations(), 0u);
+            }
+        }
+        Memory::set_allocation_tracking_enabled(false);
+        EXPECT_EQ(workspace.packed_a.data(), packed_a);
+        EXPECT_EQ(workspace.packed_b.data(), packed_b);
+    }
+
+    TEST(GemmTest, RvalueSquareProductIsNotCorrupted) {
+        Matrix<double> a = filled(4, 4, 1.0);
+        Matrix<double> b = filled(4, 4, -3.0);
+        Matrix<double> expected = reference_product(a, b);
+
+        Matrix<double> product = Matrix<double>(a) * Matrix<double>(b);
+        expect_near(product, expected);
+    }
+
+    TEST(GemmTest, RvalueRectangularProductsMatchReference) {
+        Matrix<double> a = filled(3, 5, 1.0);
+        Matrix<double> b = filled(5, 2, 2.0);
+        Matrix<double> expected = reference_product(a, b);
+
+        expect_near(Matrix<double>(a) * Matrix<double>(b), expected);
+        expect_near(Matrix<double>(a) * b, expected);
+        expect_near(a * Matrix<double>(b), expected);
+        expect_near(Matrix<double>(a) * filled(5, 5, 0.0) * b,
+            reference_product(reference_product(a, filled(5, 5, 0.0)), b));
+    }
+
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+
+#include "../../include/matrixlib/algebra/blas.h"
+#include "../../include/matrixlib/core/allocation_tracker.h"
+#include "../../include/matrixlib/core/parallel.h"
+#include "../../include/matrixlib/core/vector.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+
+namespace {
+
+    template<typename T>
+    void expect_near(const Vector<T>& actual, const Matrix<T>& expected, double tolerance) {
+        ASSERT_EQ(expected.get_columns(), 1u);
+        ASSERT_EQ(actual.size(), expected.get_rows());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            EXPECT_NEAR(std::abs(actual[i] - expected(i, 0)), 0.0, tolerance) << i;
+        }
+    }
+
+    // alpha op(A) x + beta y through the gemm path, for reference.
+    template<typename T>
+    void check_gemv(size_t rows, size_t columns, Op op, unsigned seed) {
+        const Matrix<T> a = sample<T>(rows, columns, seed);
+        const size_t x_size = is_transposed(op) ? rows : columns;
+        const size_t y_size = is_transposed(op) ? columns : rows;
+        const Vector<T> x = sample_vector<T>(x_size, seed + 1);
+        Vector<T> y = sample_vector<T>(y_size, seed + 2);
+        const T alpha(0.5);
+        const T beta(-2.0);
+
+        Matrix<T> expected = Core::multiply(OpView<T>(a, op), OpView<T>(x.to_matrix()));
+        expected *= alpha;
+        expected += beta * y.to_matrix();
+        Algebra::Blas::gemv(alpha, a, op, x, beta, y);
+        expect_near(y, expected, 1e-12 * static_cast<double>(x_size));
+    }
+
+}
+
+TEST(GemvTest, VectorConstructionAndArithmetic) {
+    const Vector<double> v{ 1.0, 2.0, 3.0 };
+    EXPECT_EQ(Vector<double>(Matrix<double>(std::vector<double>{ 1.0, 2.0, 3.0 }, true)), v);
+    EXPECT_EQ(Vector<double>(Matrix<double>(std::vector<double>{ 1.0, 2.0, 3.0 }, false)), v);
+    EXPECT_THROW(Vector<double>(Matrix<double>(2, 2)), std::invalid_argument);
+    EXPECT_EQ(v.to_matrix().get_rows(), 3u);
+    EXPECT_EQ(v.to_matrix(false).get_columns(), 3u);
+
+    const Vector<double> w = 2.0 * v - Vector<double>(3, 1.0);
+    EXPECT_EQ(w, (Vector<double>{ 1.0, 3.0, 5.0 }));
+    EXPECT_THROW((void)(v + Vector<double>(2)), std::invalid_argument);
+
+    const Matrix<double> m(std::vector<std::vector<double>>{ { 1.0, 2.0, 3.0 }, { 4.0, 5.0, 6.0 } });
+    EXPECT_EQ(m * v, (Vector<double>{ 14.0, 32.0 }));
+    const Vector<double> u{ 1.0, -1.0 };
+    EXPECT_EQ(transposed(m) * u, (Vector<double>{ -3.0, -3.0, -3.0 }));
+    EXPECT_DOUBLE_EQ(row_view(m, 1)[2], 6.0);
+    EXPECT_THROW((void)row_view(m, 2), std::out_of_range);
+}
+
+TEST(GemvTest, VectorIsOneAllocation) {
+    Memory::set_allocation_tracking_enabled(true);
+    Memory::reset_allocation_stats();
+    {
+        const Vector<double> v(1000);
+        EXPECT_EQ(Memory::matrix_allocation_stats<double>().allocations, 1u);
+        EXPECT_EQ(Memory::matrix_allocation_stats<double>().live_bytes, 1000 * sizeof(double));
+    }
+    EXPECT_EQ(Memory::matrix_allocation_stats<double>().live_bytes, 0u);
+    Memory::set_allocation_tracking_enabled(false);
+}
+
+TEST(GemvTest, MatchesGemmForEveryOp) {
+    for (Op op : { Op::no_transpose, Op::transpose, Op::conjugate_transpose, Op::conjugate }) {
+        check_gemv<double>(17, 9, op, 1);
+        check_gemv<std::complex<double>>(9, 17, op, 2);
+        // Wide: y columns split over threads; tall and narrow: row blocks.
+        check_gemv<double>(64, 9000, op, 3);
+        check_gemv<std::complex<double>>(9000, 24, op, 4);
+    }
+    check_gemv<double>(300, 300, Op::transpose, 5);
+}
+
+TEST(GemvTest, BetaZeroIgnoresOutput) {
+    const Matrix<double> a = sample<double>(5, 4, 10);
+    const Vector<double> x = sample_vector<double>(4, 11);
+    Vector<double> y(5, std::numeric_limits<double>::quiet_NaN());
+    Algebra::Blas::gemv(1.0, a, x, 0.0, y);
+    expect_near(y, a * x.to_matrix(), 1e-14);
+
+    Vector<double> z(4, std::numeric_limits<double>::quiet_NaN());
+    Algebra::Blas::gemv_transposed(1.0, a, Vector<double>(5, 1.0), 0.0, z);
+    for (size_t j = 0; j < 4; ++j) {
+        double column_sum = 0.0;
+        for (size_t i = 0; i < 5; ++i) {
+            column_sum += a(i, j);
+        }
+        EXPECT_NEAR(z[j], column_sum, 1e-14);
+    }
+
+    EXPECT_THROW(Algebra::Blas::gemv(1.0, a, Vector<double>(5), 0.0, y), std::invalid_argument);
+    Vector<double> shared(8);
+    EXPECT_THROW(Algebra::Blas::gemv<double>(1.0, view(a), Op::no_transpose,
+        VectorView<const double>(shared.data(), 4), 0.0, VectorView<double>(shared.data() + 3, 5)), std::invalid_argument);
+}
+
+TEST(GemvTest, ResultsDoNotDependOnThreadCount) {
+    const Matrix<double> a = sample<double>(20000, 20, 20);
+    const Vector<double> x = sample_vector<double>(20000, 21);
+    Vector<double> serial(20);
+    Vector<double> threaded(20);
+    Parallel::set_max_threads(1);
+    Algebra::Blas::gemv_transposed(1.0, a, x, 0.0, serial);
+    const double serial_dot = Algebra::Blas::dot(x, x);
+    Parallel::set_max_threads(4);
+    Algebra::Blas::gemv_transposed(1.0, a, x, 0.0, threaded);
+    const double threaded_dot = Algebra::Blas::dot(x, x);
+    Parallel::set_max_threads(0);
+    EXPECT_EQ(serial, threaded);
+    EXPECT_EQ(serial_dot, threaded_dot);
+}
+
+TEST(GemvTest, RepeatedThreadedCallsReuseTheWorkers) {
+    const Matrix<double> a = sample<double>(512, 512, 22);
+    const Vector<double> x = sample_vector<double>(512, 23);
+    Vector<double> y(512);
+    const Matrix<double> tall = sample<double>(4096, 64, 24);
+    const Vector<double> long_x = sample_vector<double>(4096, 25);
+    Vector<double> narrow_y(64);
+    Parallel::set_max_threads(4);
+    Algebra::Blas::gemv(1.0, a, x, 0.0, y);
+    Algebra::Blas::gemv_transposed(1.0, tall, long_x, 0.0, narrow_y);
+
+    Memory::set_allocation_tracking_enabled(true);
+    {
+        // Workers are started once; later calls only wake them.
+        Memory::AllocationScope scope("repeated gemv");
+        for (int step = 0; step < 20; ++step) {
+            Algebra::Blas::gemv(1.0, a, x, 0.0, y);
+            Algebra::Blas::gemv_transposed(1.0, tall, long_x, 0.0, narrow_y);
+            EXPECT_GT(Algebra::Blas::dot(long_x, long_x), 0.0);
+            EXPECT_GT(Algebra::Blas::nrm2(long_x), 0.0);
+        }
+        if (Memory::heap_allocations_counted()) {
+            EXPECT_EQ(scope.heap_allocations(), 0u);
+        }
+    }
+    Memory::set_allocation_tracking_enabled(false);
+    Parallel::set_max_threads(0);
+}
+
+TEST(GemvTest, ShortWideTransposedSplitsColumns) {
+    const Matrix<double> a = sample<double>(2, 400000, 26);
+    const Vector<double> x = sample_vector<double>(2, 27);
+    Vector<double> y(400000);
+    Parallel::set_max_threads(4);
+    Vector<double> warm_up(64);
+    Algebra::Blas::gemv_transposed(1.0, sample<double>(4096, 64, 28), sample_vector<double>(4096, 29), 0.0, warm_up);
+
+    Memory::set_allocation_tracking_enabled(true);
+    {
+        // Two rows give at most two row blocks; the columns are split instead
+        // of keeping a partial y per block.
+        Memory::AllocationScope scope("short wide gemv");
+        Algebra::Blas::gemv_transposed(1.0, a, x, 0.0, y);
+        if (Memory::heap_allocations_counted()) {
+            EXPECT_EQ(scope.heap_allocations(), 0u);
+        }
+    }
+    Memory::set_allocation_tracking_enabled(false);
+    Parallel::set_max_threads(0);
+    for (size_t j = 0; j < y.size(); j += 997) {
+        EXPECT_NEAR(y[j], x[0] * a(0, j) + x[1] * a(1, j), 1e-15);
+    }
+}
+
+TEST(GemvTest, AxpyDotAndNrm2) {
+    const Vector<std::complex<double>> x = sample_vector<std::complex<double>>(100003, 30);
+    Vector<std::complex<double>> y = sample_vector<std::complex<double>>(100003, 31);
+    const Vector<std::complex<double>> original = y;
+    const std::complex<double> alpha(0.25, -1.5);
+    Algebra::Blas::axpy(alpha, x, y);
+    std::complex<double> expected_dot{};
+    double expected_squares = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        EXPECT_NEAR(std::abs(y[i] - (original[i] + alpha * x[i])), 0.0, 1e-15);
+        expected_dot += std::conj(x[i]) * original[i];
+        expected_squares += std::norm(x[i]);
+    }
+    EXPECT_NEAR(std::abs(Algebra::Blas::dot(x, original) - expected_dot), 0.0, 1e-9);
+    EXPECT_NEAR(Algebra::Blas::nrm2(x), std::sqrt(expected_squares), 1e-9);
+    EXPECT_NEAR(Algebra::Blas::dot(x, x).imag(), 0.0, 1e-9);
+
+    // Squares of these would overflow or underflow.
+    EXPECT_DOUBLE_EQ(Algebra::Blas::nrm2(Vector<double>{ 3e200, 4e200 }), 5e200);
+    EXPECT_DOUBLE_EQ(Algebra::Blas::nrm2(Vector<double>{ 3e-200, -4e-200 }), 5e-200);
+    EXPECT_EQ(Algebra::Blas::nrm2(Vector<double>{ 1e-310, 0.0, 0.0 }), 1e-310);
+    EXPECT_EQ(Algebra::Blas::nrm2(Vector<double>(7)), 0.0);
+    EXPECT_EQ(Algebra::Blas::dot(Vector<double>(), Vector<double>()), 0.0);
+    Vector<double> z(4);
+    EXPECT_THROW(Algebra::Blas::axpy(1.0, Vector<double>(3), z), std::invalid_argument);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <stdexcept>
+
+#include "../../include/matrixlib/algebra/blas.h"
+#include "../../include/matrixlib/algebra/matrix_operations.h"
+#include "../../include/matrixlib/core/matrix.h"
+
+using namespace Core;
+using Algebra::Operations::transpose;
+using Algebra::Operations::hermitian_matrix;
+
+namespace {
+
+    Matrix<double> sample(size_t rows, size_t columns, double seed) {
+        Matrix<double> result(rows, columns);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < columns; ++j) {
+                result(i, j) = seed + static_cast<double>(3 * i + 7 * j % 5) - 0.5 * static_cast<double>(j);
+            }
+        }
+        return result;
+    }
+
+    Matrix<std::complex<double>> complex_sample(size_t rows, size_t columns) {
+        Matrix<std::complex<double>> result(rows, columns);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < columns; ++j) {
+                result(i, j) = { static_cast<double>(i) - static_cast<double>(j), 0.5 * static_cast<double>(i + 2 * j) };
+            }
+        }
+        return result;
+    }
+
+    template<typename T>
+    void expect_same(const Matrix<T>& actual, const Matrix<T>& expected) {
+        ASSERT_EQ(actual.get_rows(), expected.get_rows());
+        ASSERT_EQ(actual.get_columns(), expected.get_columns());
+        for (size_t i = 0; i < actual.get_rows(); ++i) {
+            for (size_t j = 0; j < actual.get_columns(); ++j) {
+                EXPECT_NEAR(std::abs(actual(i, j) - expected(i, j)), 0.0, 1e-10);
+            }
+        }
+    }
+
+    TEST(OpFlagsTest, TransposedOperandsMatchMaterializedTranspose) {
+        Matrix<double> a = sample(7, 4, 1.0);
+        Matrix<double> b = sample(7, 5, -2.0);
+        Matrix<double> c = sample(5, 4, 0.5);
+
+        expect_same(transposed(a) * b, transpose(a) * b);
+        expect_same(b * transposed(b), b * transpose(b));
+        expect_same(transposed(c) * transposed(b), transpose(c) * transpose(b));
+        // A temporary operand lives until the product has read it.
+        expect_same(transposed(sample(7, 4, 1.0)) * b, transpose(a) * b);
+    }
+
+    TEST(OpFlagsTest, AdjointAndConjugateOfComplexOperands) {
+        Matrix<std::complex<double>> a = complex_sample(5, 3);
+        Matrix<std::complex<double>> b = complex_sample(5, 2);
+
+        expect_same(adjoint(a) * b, hermitian_matrix(a) * b);
+        expect_same(a * adjoint(a), a * hermitian_matrix(a));
+        expect_same(conjugated(b) * transposed(b), transpose(hermitian_matrix(b)) * transpose(b));
+        expect_same(adjoint(complex_sample(5, 3)) * b, hermitian_matrix(a) * b);
+    }
+
+    TEST(OpFlagsTest, OpsCompose) {
+        Matrix<std::complex<double>> a = complex_sample(3, 4);
+        EXPECT_EQ(transposed(transposed(a)).op(), Op::no_transpose);
+        EXPECT_EQ(conjugated(transposed(a)).op(), Op::conjugate_transpose);
+        EXPECT_EQ(adjoint(conjugated(a)).op(), Op::transpose);
+        EXPECT_EQ(transposed(a).get_rows(), 4u);
+        EXPECT_EQ(transposed(a).get_columns(), 3u);
+    }
+
+    TEST(OpFlagsTest, GemmAcceptsOpOperands) {
+        Matrix<double> a = sample(6, 3, 1.0);
+        Matrix<double> normal(3, 3);
+
+        Algebra::Blas::gemm(1.0, transposed(a), a, 0.0, normal);
+        expect_same(normal, transpose(a) * a);
+        EXPECT_THROW(Algebra::Blas::gemm(1.0, a, a, 0.0, normal), std::invalid_argument);
+    }
+
+    TEST(OpFlagsTest, RejectsIncompatibleShapes) {
+        Matrix<double> a = sample(3, 4, 1.0);
+        Matrix<double> b = sample(4, 4, 0.0);
+        EXPECT_THROW((void)(transposed(a) * transposed(b)), std::invalid_argument);
+    }
+
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <limits>
+#include <stdexcept>
+
+#include "../../include/matrixlib/algebra/blas.h"
+#include "../../include/matrixlib/algebra/matrix_operations.h"
+#include "../../include/matrixlib/core/parallel.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+using Algebra::Blas::GramAccumulator;
+
+namespace {
+
+    // The requested triangle matches the gemm product and the other one is
+    // left as it was.
+    template<typename T>
+    void check_rank_k(size_t n, size_t k, Op op, Triangle triangle, bool hermitian, unsigned seed) {
+        const Matrix<T> a = op == Op::no_transpose ? sample<T>(n, k, seed) : sample<T>(k, n, seed);
+        const Matrix<T> original = sample<T>(n, n, seed + 1);
+        Matrix<T> c = original;
+        const Op adjoint = hermitian ? Op::conjugate_transpose : Op::transpose;
+        const Matrix<T> product = op == Op::no_transpose
+            ? Core::multiply(OpView<T>(a), OpView<T>(Matrix<T>(a), adjoint))
+            : Core::multiply(OpView<T>(a, adjoint), OpView<T>(Matrix<T>(a)));
+        if (hermitian) {
+            Algebra::Blas::herk(0.5, a, op, -1.0, c, triangle);
+        }
+        else {
+            Algebra::Blas::syrk(T(0.5), a, op, T(-1.0), c, triangle);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                const bool inside = triangle == Triangle::upper ? j >= i : j <= i;
+                if (inside) {
+                    T expected = T(0.5) * product(i, j) - original(i, j);
+                    if (hermitian && i == j) {
+                        expected = T(std::real(expected));
+                    }
+                    EXPECT_NEAR(std::abs(c(i, j) - expected), 0.0, 1e-12 * static_cast<double>(k)) << i << ", " << j;
+                }
+                else {
+                    EXPECT_EQ(c(i, j), original(i, j)) << i << ", " << j;
+                }
+            }
+        }
+    }
+
+}
+
+TEST(SyrkTest, SyrkTouchesOnlyOneTriangle) {
+    for (Triangle triangle : { Triangle::upper, Triangle::lower }) {
+        check_rank_k<double>(7, 5, Op::no_transpose, triangle, false, 1);
+        check_rank_k<double>(300, 40, Op::transpose, triangle, false, 2);
+        check_rank_k<std::complex<double>>(150, 33, Op::no_transpose, triangle, false, 3);
+        check_rank_k<std::complex<double>>(130, 9, Op::transpose, triangle, false, 4);
+    }
+}
+
+TEST(SyrkTest, HerkTouchesOnlyOneTriangle) {
+    for (Triangle triangle : { Triangle::upper, Triangle::lower }) {
+        check_rank_k<std::complex<double>>(140, 21, Op::no_transpose, triangle, true, 5);
+        check_rank_k<std::complex<double>>(260, 17, Op::conjugate_transpose, triangle, true, 6);
+        check_rank_k<double>(129, 12, Op::conjugate_transpose, triangle, true, 7);
+    }
+    Matrix<std::complex<double>> c(3, 3);
+    EXPECT_THROW(Algebra::Blas::herk(1.0, Matrix<std::complex<double>>(2, 3), Op::transpose, 0.0, c), std::invalid_argument);
+    Matrix<double> d(3, 3);
+    EXPECT_THROW(Algebra::Blas::syrk(1.0, Matrix<double>(2, 3), Op::no_transpose, 0.0, d), std::invalid_argument);
+}
+
+TEST(SyrkTest, BetaZeroIgnoresOutput) {
+    const Matrix<double> a = sample<double>(50, 20, 10);
+    Matrix<double> c(20, 20, std::numeric_limits<double>::quiet_NaN());
+    Algebra::Blas::syrk(1.0, a, Op::transpose, 0.0, c);
+    Kernels::mirror_triangle(view(c), Triangle::upper, false);
+    expect_near(c, Algebra::Operations::transpose(a) * a, 1e-12);
+}
+
+TEST(SyrkTest, GramIsMirroredAndTagged) {
+    const Matrix<std::complex<double>> x = sample<std::complex<double>>(400, 70, 20);
+    const Matrix<std::complex<double>> g = Algebra::Blas::gram(x);
+    EXPECT_EQ(g.structure().kind(), Structure::hermitian);
+    expect_near(g, Algebra::Operations::hermitian_matrix(x) * x, 1e-11);
+    for (size_t i = 0; i < g.get_rows(); ++i) {
+        EXPECT_EQ(g(i, i).imag(), 0.0);
+        for (size_t j = 0; j < i; ++j) {
+            EXPECT_EQ(g(i, j), std::conj(g(j, i)));
+        }
+    }
+
+    const Matrix<double> r = sample<double>(90, 300, 21);
+    const Matrix<double> g_real = Algebra::Blas::gram(r);
+    EXPECT_EQ(g_real.structure().kind(), Structure::symmetric);
+    expect_near(g_real, Algebra::Operations::transpose(r) * r, 1e-11);
+}
+
+TEST(SyrkTest, OpViewProductsOfOneOperandUseRankK) {
+    const Matrix<std::complex<double>> x = sample<std::complex<double>>(60, 140, 30);
+    const Matrix<std::complex<double>> copy = x;
+    const Matrix<std::complex<double>> gram = adjoint(x) * x;
+    EXPECT_EQ(gram.structure().kind(), Structure::hermitian);
+    expect_near(gram, Core::multiply(adjoint(x), OpView<std::complex<double>>(copy)), 1e-12);
+
+    const Matrix<std::complex<double>> outer = x * transposed(x);
+    EXPECT_EQ(outer.structure().kind(), Structure::symmetric);
+    expect_near(outer, Core::multiply(OpView<std::complex<double>>(x), transposed(copy)), 1e-12);
+
+    // Different operands still go through gemm.
+    EXPECT_EQ((transposed(x) * copy).structure().kind(), Structure::general);
+}
+
+TEST(SyrkTest, StreamingAccumulationMatchesGram) {
+    const Matrix<double> x = sample<double>(1000, 45, 40);
+    GramAccumulator<double> accumulator(45);
+    for (size_t first = 0; first < 1000; first += 137) {
+        const size_t rows = std::min<size_t>(137, 1000 - first);
+        accumulator.add(view(x).block(first, 0, rows, 45));
+    }
+    EXPECT_EQ(accumulator.rows(), 1000u);
+    const Matrix<double> streamed = accumulator.result();
+    EXPECT_EQ(streamed.structure().kind(), Structure::symmetric);
+    expect_near(streamed, Algebra::Blas::gram(x), 1e-11);
+
+    accumulator.reset();
+    accumulator.add(sample<double>(3, 45, 41));
+    EXPECT_EQ(accumulator.rows(), 3u);
+    expect_near(accumulator.result(), Algebra::Blas::gram(sample<double>(3, 45, 41)), 1e-14);
+    EXPECT_THROW(accumulator.add(Matrix<double>(2, 44)), std::invalid_argument);
+}
+
+TEST(SyrkTest, ResultDoesNotDependOnThreadCount) {
+    const Matrix<double> x = sample<double>(300, 400, 50);
+    Parallel::set_max_threads(1);
+    const Matrix<double> serial = Algebra::Blas::gram(x);
+    Parallel::set_max_threads(4);
+    const Matrix<double> threaded = Algebra::Blas::gram(x);
+    Parallel::set_max_threads(0);
+    expect_near(serial, threaded, 0.0);
+}
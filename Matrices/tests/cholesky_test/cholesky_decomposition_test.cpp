@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <vector>
+
+#include "../../include/matrixlib/decompositions/cholesky_decomposition.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+using Decompositions::CHOLESKY_Decomposition::Cholesky_Decomposition;
+
+namespace {
+
+    // B^H B + n I, comfortably positive definite.
+    template<typename T>
+    Matrix<T> positive_definite(size_t n, unsigned seed) {
+        const Matrix<T> b = sample<T>(n, n, seed);
+        Matrix<T> result = adjoint(b) * b;
+        for (size_t i = 0; i < n; ++i) {
+            result(i, i) += T(static_cast<double>(n));
+        }
+        return result;
+    }
+
+    template<typename T>
+    std::vector<T> column(const Matrix<T>& matrix, size_t j) {
+        std::vector<T> result(matrix.get_rows());
+        for (size_t i = 0; i < matrix.get_rows(); ++i) {
+            result[i] = matrix(i, j);
+        }
+        return result;
+    }
+
+    TEST(CholeskyDecompositionTest, FactorsHermitianPositiveDefiniteMatrices) {
+        const Matrix<double> a = positive_definite<double>(20, 1u);
+        Cholesky_Decomposition<double> cholesky(a);
+        const Matrix<double>& r = cholesky.get_R();
+        expect_near(Matrix<double>(transposed(r) * r), a, 1e-10);
+        expect_near(Matrix<double>(cholesky.get_L() * r), a, 1e-10);
+
+        const Matrix<std::complex<double>> c = positive_definite<std::complex<double>>(9, 2u);
+        Cholesky_Decomposition<std::complex<double>> complex_cholesky(c);
+        const Matrix<std::complex<double>>& rc = complex_cholesky.get_R();
+        expect_near(Matrix<std::complex<double>>(adjoint(rc) * rc), c, 1e-10);
+        for (size_t i = 0; i < 9; ++i) {
+            EXPECT_GT(rc(i, i).real(), 0.0);
+            EXPECT_EQ(rc(i, i).imag(), 0.0);
+        }
+    }
+
+    TEST(CholeskyDecompositionTest, BandedMatrixKeepsItsBand) {
+        Matrix<double> a(6, 6);
+        for (size_t i = 0; i < 6; ++i) {
+            a(i, i) = 4.0;
+            if (i + 1 < 6) {
+                a(i, i + 1) = a(i + 1, i) = -1.0;
+            }
+        }
+        a.set_structure(StructureTag::banded(1, 1, 6, 6));
+        Cholesky_Decomposition<double> cholesky(a);
+        const Matrix<double>& r = cholesky.get_R();
+        EXPECT_EQ(r.structure().upper_bandwidth(), 1u);
+        expect_near(Matrix<double>(transposed(r) * r), a, 1e-12);
+    }
+
+    TEST(CholeskyDecompositionTest, RejectsIndefiniteAndNonSquareInput) {
+        Matrix<double> indefinite(2, 2);
+        indefinite(0, 0) = 1.0; indefinite(0, 1) = 2.0;
+        indefinite(1, 0) = 2.0; indefinite(1, 1) = 1.0;
+        EXPECT_THROW(Cholesky_Decomposition<double>{ indefinite }, std::runtime_error);
+        EXPECT_THROW(Cholesky_Decomposition<double>(Matrix<double>(2, 3)), std::invalid_argument);
+    }
+
+    TEST(CholeskyDecompositionTest, RankOneUpdateAndDowndateMatchRefactorization) {
+        const Matrix<std::complex<double>> a = positive_definite<std::complex<double>>(12, 3u);
+        const Matrix<std::complex<double>> x = sample<std::complex<double>>(12, 1, 4u);
+        const Matrix<std::complex<double>> outer = x * adjoint(x);
+
+        Cholesky_Decomposition<std::complex<double>> cholesky(a);
+        cholesky.update(column(x, 0));
+        expect_near(cholesky.get_R(), Cholesky_Decomposition<std::complex<double>>(Matrix<std::complex<double>>(a + outer)).get_R(), 1e-10);
+
+        cholesky.downdate(column(x, 0));
+        expect_near(cholesky.get_R(), Cholesky_Decomposition<std::complex<double>>(a).get_R(), 1e-10);
+    }
+
+    TEST(CholeskyDecompositionTest, RankKUpdateMatchesSequentialUpdates) {
+        const Matrix<double> a = positive_definite<double>(15, 5u);
+        const Matrix<double> x = sample<double>(15, 4, 6u);
+
+        Cholesky_Decomposition<double> blocked(a);
+        blocked.update(x);
+        Cholesky_Decomposition<double> sequential(a);
+        for (size_t p = 0; p < 4; ++p) {
+            sequential.update(column(x, p));
+        }
+        expect_near(blocked.get_R(), sequential.get_R(), 1e-12);
+        expect_near(blocked.get_R(), Cholesky_Decomposition<double>(Matrix<double>(a + x * transposed(x))).get_R(), 1e-10);
+
+        blocked.downdate(x);
+        expect_near(blocked.get_R(), Cholesky_Decomposition<double>(a).get_R(), 1e-10);
+    }
+
+    TEST(CholeskyDecompositionTest, FailedDowndateLeavesFactorUnchanged) {
+        Matrix<double> a(3, 3);
+        a.identity_matrix(1.0);
+        a(2, 2) = 4.0;
+        Cholesky_Decomposition<double> cholesky(a);
+        const Matrix<double> before = cholesky.get_R();
+
+        // A - x x^H has a negative eigenvalue; the failure shows up only at
+        // the last row, after the first two rows have been rotated.
+        Matrix<double> x(3, 2);
+        x(0, 0) = 0.5; x(1, 0) = 0.5; x(2, 0) = 1.0;
+        x(0, 1) = 0.1; x(1, 1) = 0.2; x(2, 1) = 1.9;
+        EXPECT_THROW(cholesky.downdate(x), std::runtime_error);
+        expect_near(cholesky.get_R(), before, 1e-14);
+    }
+
+    TEST(CholeskyDecompositionTest, SlidingWindowCovariance) {
+        const Matrix<double> samples = sample<double>(5, 60, 7u);
+        const size_t window = 20;
+        Matrix<double> covariance(5, 5);
+        covariance.identity_matrix(1.0);
+        for (size_t t = 0; t < window; ++t) {
+            const std::vector<double> x = column(samples, t);
+            for (size_t i = 0; i < 5; ++i) {
+                for (size_t j = 0; j < 5; ++j) {
+                    covariance(i, j) += x[i] * x[j];
+                }
+            }
+        }
+        Cholesky_Decomposition<double> cholesky(covariance);
+        for (size_t t = window; t < samples.get_columns(); ++t) {
+            cholesky.update(column(samples, t));
+            cholesky.downdate(column(samples, t - window));
+        }
+
+        Matrix<double> expected(5, 5);
+        expected.identity_matrix(1.0);
+        for (size_t t = samples.get_columns() - window; t < samples.get_columns(); ++t) {
+            const std::vector<double> x = column(samples, t);
+            for (size_t i = 0; i < 5; ++i) {
+                for (size_t j = 0; j < 5; ++j) {
+                    expected(i, j) += x[i] * x[j];
+                }
+            }
+        }
+        expect_near(cholesky.get_R(), Cholesky_Decomposition<double>(expected).get_R(), 1e-9);
+
+        const Matrix<double> b = sample<double>(5, 2, 8u);
+        expect_near(Matrix<double>(expected * cholesky.solve(b)), b, 1e-9);
+    }
+
+}
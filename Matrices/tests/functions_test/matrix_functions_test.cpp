@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <stdexcept>
+
+#include "../../include/matrixlib/algebra/matrix_functions.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+using namespace Algebra::Functions;
+
+namespace {
+
+    template<typename T>
+    Matrix<T> identity(size_t n) {
+        Matrix<T> result(n, n);
+        result.identity_matrix(T{ 1 });
+        return result;
+    }
+
+    Matrix<double> rotation_generator(double angle) {
+        Matrix<double> result(2, 2);
+        result(0, 1) = -angle;
+        result(1, 0) = angle;
+        return result;
+    }
+
+    Matrix<double> rotation(double angle) {
+        Matrix<double> result(2, 2);
+        result(0, 0) = std::cos(angle);
+        result(0, 1) = -std::sin(angle);
+        result(1, 0) = std::sin(angle);
+        result(1, 1) = std::cos(angle);
+        return result;
+    }
+
+    // Taylor series to convergence, for small norms only.
+    template<typename T>
+    Matrix<T> taylor_reference(const Matrix<T>& a) {
+        Matrix<T> result = identity<T>(a.get_rows());
+        Matrix<T> term = identity<T>(a.get_rows());
+        for (int k = 1; k < 40; ++k) {
+            term = term * a * T(1.0 / k);
+            result = result + term;
+        }
+        return result;
+    }
+
+}
+
+TEST(MatrixFunctionsTest, ExpmOfRotationGeneratorsAtEveryDegree) {
+    for (double angle : { 1e-3, 0.1, 0.5, 1.5, 3.0, 25.0 }) {
+        expect_near(expm(rotation_generator(angle)), rotation(angle), 1e-13 * std::max(1.0, angle));
+    }
+}
+
+TEST(MatrixFunctionsTest, ExpmMatchesTaylorAndGroupProperties) {
+    for (double scale : { 0.002, 0.05, 0.3 }) {
+        const Matrix<double> a = sample<double>(6, 6, 1, scale);
+        expect_near(expm(a), taylor_reference(a), 1e-14);
+    }
+    const Matrix<double> a = sample<double>(12, 12, 2, 3.0);
+    const Matrix<double> e = expm(a);
+    Matrix<double> negated = a * -1.0;
+    expect_near(e * expm(negated), identity<double>(12), 1e-9);
+    expect_near(expm(a * 2.0), e * e, 1e-9 * Algebra::Norms::max_norm(e * e));
+
+    Matrix<double> nilpotent(2, 2);
+    nilpotent(0, 1) = 1.0;
+    Matrix<double> expected = identity<double>(2);
+    expected(0, 1) = 1.0;
+    expect_near(expm(nilpotent), expected, 1e-15);
+}
+
+TEST(MatrixFunctionsTest, ComplexExpm) {
+    using C = std::complex<double>;
+    const Matrix<C> a = sample<C>(8, 8, 3, 2.0);
+    Matrix<C> negated = a * C(-1.0);
+    expect_near(expm(a) * expm(negated), identity<C>(8), 1e-10);
+    Matrix<C> diagonal(2, 2);
+    diagonal(0, 0) = C(0.0, M_PI);
+    diagonal(1, 1) = C(1.0, 0.0);
+    diagonal.set_structure(StructureTag(Structure::diagonal));
+    const Matrix<C> e = expm(diagonal);
+    EXPECT_NEAR(std::abs(e(0, 0) - C(-1.0)), 0.0, 1e-15);
+    EXPECT_NEAR(std::abs(e(1, 1) - C(std::exp(1.0))), 0.0, 1e-15);
+}
+
+TEST(MatrixFunctionsTest, ExpmMultiplyMatchesExpmTimesBlock) {
+    const Matrix<double> a = sample<double>(20, 20, 4, 2.0);
+    const Matrix<double> b = sample<double>(20, 3, 5);
+    for (double t : { 0.0, 0.01, 1.0, 4.0 }) {
+        const Matrix<double> expected = expm(a * t) * b;
+        expect_near(expm_multiply(a, b, t), expected, 1e-10 * std::max(1.0, Algebra::Norms::max_norm(expected)));
+    }
+    using C = std::complex<double>;
+    const Matrix<C> ac = sample<C>(10, 10, 6);
+    const Matrix<C> bc = sample<C>(10, 2, 7);
+    expect_near(expm_multiply(ac, bc, C(0.0, 2.0)), expm(ac * C(0.0, 2.0)) * bc, 1e-11);
+    EXPECT_THROW(expm_multiply(ac, Matrix<C>(3, 1)), std::invalid_argument);
+}
+
+TEST(MatrixFunctionsTest, SqrtmSquaresBack) {
+    const Matrix<double> b = sample<double>(10, 10, 8);
+    Matrix<double> a = transposed(b) * b;
+    for (size_t i = 0; i < 10; ++i) {
+        a(i, i) += 1.0;
+    }
+    const Matrix<double> root = sqrtm(a);
+    expect_near(root * root, a, 1e-11);
+    for (size_t i = 0; i < 10; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            EXPECT_NEAR(root(i, j), root(j, i), 1e-11);
+        }
+    }
+
+    // Complex eigenvalues, real principal root: half the angle.
+    expect_near(sqrtm(rotation(2.0)), rotation(1.0), 1e-14);
+
+    using C = std::complex<double>;
+    const Matrix<C> ac = sample<C>(7, 7, 9);
+    const Matrix<C> rc = sqrtm(ac);
+    expect_near(rc * rc, ac, 1e-11);
+}
+
+TEST(MatrixFunctionsTest, LogmInvertsExpm) {
+    const Matrix<double> a = sample<double>(9, 9, 10, 0.5);
+    expect_near(logm(expm(a)), a, 1e-11);
+    expect_near(logm(rotation(1.0)), rotation_generator(1.0), 1e-14);
+
+    using C = std::complex<double>;
+    const Matrix<C> ac = sample<C>(6, 6, 11, 0.4);
+    expect_near(logm(expm(ac)), ac, 1e-11);
+    expect_near(expm(logm(ac)), ac, 1e-11);
+}
+
+TEST(MatrixFunctionsTest, RealRootsAndLogarithmsMustExist) {
+    Matrix<double> negative(2, 2);
+    negative(0, 0) = -1.0;
+    negative(0, 1) = 1.0;
+    negative(1, 1) = 2.0;
+    EXPECT_THROW(sqrtm(negative), std::runtime_error);
+    EXPECT_THROW(logm(negative), std::runtime_error);
+    EXPECT_THROW(logm(Matrix<double>(2, 2)), std::runtime_error);
+
+    using C = std::complex<double>;
+    Matrix<C> complex_negative(1, 1);
+    complex_negative(0, 0) = C(-4.0);
+    EXPECT_NEAR(std::abs(sqrtm(complex_negative)(0, 0) - C(0.0, 2.0)), 0.0, 1e-15);
+}
+
+TEST(MatrixFunctionsTest, MatrixPowerMatchesRepeatedProducts) {
+    const Matrix<double> a = sample<double>(6, 6, 30, 0.4);
+    Matrix<double> expected = identity<double>(6);
+    for (unsigned long long k = 0; k <= 37; ++k) {
+        expect_near(matrix_power(a, k), expected, 1e-12);
+        expected = expected * a;
+    }
+    expect_near(matrix_power(rotation(0.01), 1000), rotation(10.0), 1e-10);
+
+    const Matrix<std::complex<double>> c = sample<std::complex<double>>(5, 5, 31, 0.3);
+    expect_near(matrix_power(Matrix<std::complex<double>>(c), 13), c * c * c * c * c * c * c * c * c * c * c * c * c, 1e-12);
+    EXPECT_THROW((void)matrix_power(Matrix<double>(2, 3), 2), std::invalid_argument);
+}
+
+TEST(MatrixFunctionsTest, MatrixPowerOfDiagonal) {
+    Matrix<double> d(3, 3);
+    d(0, 0) = 2.0;
+    d(1, 1) = -0.5;
+    d(2, 2) = 1.5;
+    d.set_structure(StructureTag(Structure::diagonal));
+    const Matrix<double> power = matrix_power(d, 7);
+    EXPECT_DOUBLE_EQ(power(0, 0), 128.0);
+    EXPECT_DOUBLE_EQ(power(1, 1), -0.0078125);
+    EXPECT_DOUBLE_EQ(power(2, 2), std::pow(1.5, 7));
+    EXPECT_EQ(power(0, 1), 0.0);
+    EXPECT_EQ(power.structure().kind(), Structure::diagonal);
+}
+
+TEST(MatrixFunctionsTest, PolyvalMatchesHorner) {
+    std::mt19937 engine(32);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    const Matrix<double> a = sample<double>(7, 7, 33, 0.3);
+    for (size_t size : { 1u, 2u, 3u, 5u, 10u, 21u }) {
+        std::vector<double> coefficients(size);
+        for (double& coefficient : coefficients) {
+            coefficient = distribution(engine);
+        }
+        Matrix<double> expected(7, 7);
+        for (size_t k = size; k-- > 0;) {
+            expected = expected * a + coefficients[k] * identity<double>(7);
+        }
+        expect_near(polyval(coefficients, a), expected, 1e-12);
+    }
+
+    // Truncated exponential series.
+    const Matrix<std::complex<double>> c = sample<std::complex<double>>(4, 4, 34, 0.2);
+    std::vector<std::complex<double>> taylor(18);
+    double factorial = 1.0;
+    for (size_t k = 0; k < taylor.size(); ++k) {
+        factorial *= k == 0 ? 1.0 : static_cast<double>(k);
+        taylor[k] = 1.0 / factorial;
+    }
+    expect_near(polyval(taylor, Matrix<std::complex<double>>(c)), expm(c), 1e-13);
+
+    expect_near(polyval(std::vector<double>{ 0.0, 0.0 }, a), Matrix<double>(7, 7), 0.0);
+    expect_near(polyval(std::vector<double>{}, a), Matrix<double>(7, 7), 0.0);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../include/matrixlib/core/instrumentation.h"
+#include "../../include/matrixlib/core/matrix.h"
+#include "../../include/matrixlib/decompositions/lup_decomposition.h"
+
+using namespace Core;
+using namespace Core::Instrumentation;
+
+namespace {
+
+    class InstrumentationTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            reset();
+            set_trace_enabled(false);
+        }
+        void TearDown() override {
+            set_trace_enabled(false);
+        }
+    };
+
+    TEST_F(InstrumentationTest, MultiplicationRecordsCallsAndFlops) {
+        Matrix<double> a(4, 3, 1.0);
+        Matrix<double> b(3, 5, 2.0);
+
+        auto c = a * b;
+        auto d = a * b;
+
+        ZoneSummary zone = zone_summary("Core::Matrix::operator*");
+        EXPECT_EQ(zone.calls, 2u);
+        EXPECT_EQ(zone.flops, 2u * 2 * 4 * 3 * 5);
+        EXPECT_EQ(zone.bytes, 2u * (12 + 15 + 20) * sizeof(double));
+        EXPECT_DOUBLE_EQ(c(0, 0), 6.0);
+        EXPECT_DOUBLE_EQ(d(3, 4), 6.0);
+    }
+
+    TEST_F(InstrumentationTest, DecompositionPhasesAreRecorded) {
+        Matrix<double> m(3, 3);
+        m(0, 0) = 1; m(0, 1) = 2; m(0, 2) = 3;
+        m(1, 0) = 4; m(1, 1) = 5; m(1, 2) = 6;
+        m(2, 0) = 7; m(2, 1) = 8; m(2, 2) = 10;
+
+        Decompositions::LUP_Decomposition::Lup_Decomposition<double> lup(m);
+
+        EXPECT_EQ(zone_summary("Lup_Decomposition::computeDecomposition").calls, 1u);
+        EXPECT_EQ(zone_summary("Lup_Decomposition::elimination").calls, 1u);
+        EXPECT_EQ(zone_summary("Lup_Decomposition::extract_factors").calls, 1u);
+    }
+
+    TEST_F(InstrumentationTest, CountersAccumulateAcrossThreads) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([] {
+                Matrix<float> a(2, 2, 1.0f);
+                for (int i = 0; i < 25; ++i) {
+                    a += a;
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        ZoneSummary zone = zone_summary("Core::Matrix::operator+=");
+        EXPECT_EQ(zone.calls, 100u);
+        EXPECT_EQ(zone.flops, 400u);
+    }
+
+    TEST_F(InstrumentationTest, ResetClearsCounters) {
+        Matrix<double> a(2, 2, 1.0);
+        auto b = a + a;
+        EXPECT_EQ(zone_summary("Core::Matrix::operator+").calls, 1u);
+
+        reset();
+        EXPECT_EQ(zone_summary("Core::Matrix::operator+").calls, 0u);
+    }
+
+    TEST_F(InstrumentationTest, SummaryTableListsZones) {
+        Matrix<double> a(2, 2, 1.0);
+        auto b = a - a;
+
+        std::ostringstream out;
+        write_summary(out);
+        EXPECT_NE(out.str().find("Core::Matrix::operator-"), std::string::npos);
+        EXPECT_NE(out.str().find("GFLOP/s"), std::string::npos);
+    }
+
+    TEST_F(InstrumentationTest, ChromeTraceContainsCompleteEvents) {
+        set_trace_enabled(true);
+        Matrix<double> a(2, 2, 1.0);
+        auto b = a * a;
+        set_trace_enabled(false);
+
+        std::ostringstream out;
+        write_chrome_trace(out);
+        const std::string json = out.str();
+        EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+        EXPECT_NE(json.find("\"name\":\"Core::Matrix::operator*\""), std::string::npos);
+        EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+        EXPECT_NE(json.find("\"flops\":16"), std::string::npos);
+    }
+
+    TEST_F(InstrumentationTest, TraceCanBeWrittenWhileZonesRun) {
+        set_trace_enabled(true);
+        std::atomic<bool> stop{ false };
+        std::thread worker([&stop] {
+            // A fresh thread, so its trace buffer is allocated mid-write.
+            Matrix<float> a(2, 2, 1.0f);
+            for (int i = 0; i < 1000 || !stop.load(); ++i) {
+                a += a;
+                a *= 0.5f;
+            }
+        });
+        for (int i = 0; i < 20; ++i) {
+            std::ostringstream out;
+            write_chrome_trace(out);
+            EXPECT_EQ(out.str().rfind("{\"traceEvents\":[", 0), 0u);
+        }
+        stop.store(true);
+        worker.join();
+        set_trace_enabled(false);
+
+        std::ostringstream out;
+        write_chrome_trace(out);
+        EXPECT_NE(out.str().find("\"name\":\"Core::Matrix::operator+=\""), std::string::npos);
+    }
+
+    TEST_F(InstrumentationTest, TraceIsEmptyWhenDisabled) {
+        Matrix<double> a(2, 2, 1.0);
+        auto b = a * a;
+
+        std::ostringstream out;
+        write_chrome_trace(out);
+        EXPECT_EQ(out.str().find("\"ph\":\"X\""), std::string::npos);
+    }
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "../../include/matrixlib/core/instrumentation.h"
+#include "../../include/matrixlib/core/perf_counters.h"
+#include "../../include/matrixlib/core/matrix.h"
+
+using namespace Core;
+using namespace Core::Instrumentation;
+
+namespace {
+
+    class PerfCountersTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            reset();
+            set_hardware_counters_enabled(true);
+        }
+        void TearDown() override {
+            set_hardware_counters_enabled(false);
+        }
+    };
+
+    TEST_F(PerfCountersTest, GroupReportsStatusWhenUnavailable) {
+        PerfCounterGroup group;
+        if (!group.available()) {
+            EXPECT_FALSE(group.status().empty());
+            CounterSample sample = group.read();
+            EXPECT_FALSE(sample.has(HardwareCounter::cycles));
+        }
+        else {
+            CounterSample begin = group.read();
+            volatile double sink = 0;
+            for (int i = 0; i < 10000; ++i) {
+                sink = sink + i;
+            }
+            CounterSample delta = difference(group.read(), begin);
+            if (delta.has(HardwareCounter::instructions)) {
+                EXPECT_GT(delta[HardwareCounter::instructions], 0u);
+            }
+        }
+    }
+
+    TEST_F(PerfCountersTest, ZonesCollectCountersOrDegradeGracefully) {
+        Matrix<double> a(32, 32, 1.0);
+        auto b = a * a;
+
+        ZoneSummary zone = zone_summary("Core::Matrix::operator*");
+        EXPECT_EQ(zone.calls, 1u);
+        if (hardware_counters_available()) {
+            EXPECT_TRUE(zone.has(HardwareCounter::cycles) || zone.has(HardwareCounter::instructions));
+        }
+        else {
+            EXPECT_FALSE(zone.has(HardwareCounter::cycles));
+            EXPECT_DOUBLE_EQ(zone.instructions_per_cycle(), 0.0);
+        }
+
+        std::ostringstream out;
+        write_summary(out);
+        EXPECT_NE(out.str().find("IPC"), std::string::npos);
+        if (!hardware_counters_available()) {
+            EXPECT_NE(out.str().find("n/a"), std::string::npos);
+            EXPECT_NE(out.str().find("hardware counters unavailable"), std::string::npos);
+        }
+    }
+
+    TEST_F(PerfCountersTest, DerivedMetricsFromCounts) {
+        ZoneSummary zone;
+        zone.calls = 1;
+        zone.nanoseconds = 1000;
+        zone.flops = 4000;
+        zone.bytes = 1000;
+        zone.hardware[static_cast<std::size_t>(HardwareCounter::cycles)] = 2000;
+        zone.hardware[static_cast<std::size_t>(HardwareCounter::instructions)] = 3000;
+        zone.hardware[static_cast<std::size_t>(HardwareCounter::llc_misses)] = 10;
+        zone.hardware_calls.fill(1);
+
+        EXPECT_DOUBLE_EQ(zone.instructions_per_cycle(), 1.5);
+        EXPECT_DOUBLE_EQ(zone.arithmetic_intensity(), 4.0);
+        EXPECT_DOUBLE_EQ(zone.measured_arithmetic_intensity(), 0.0);
+
+        zone.hardware_calls[static_cast<std::size_t>(HardwareCounter::fp_operations)] = 0;
+        EXPECT_DOUBLE_EQ(zone.measured_arithmetic_intensity(), 4000.0 / 640.0);
+    }
+
+    TEST_F(PerfCountersTest, RooflineClassifiesBoundedness) {
+        RooflineModel model{ 100.0, 10.0 };
+        EXPECT_DOUBLE_EQ(model.ridge_point(), 10.0);
+
+        ZoneSummary streaming;
+        streaming.nanoseconds = 1000;
+        streaming.flops = 2000;
+        streaming.bytes = 8000;
+        RooflinePoint low = roofline_position(streaming, model);
+        EXPECT_TRUE(low.memory_bound);
+        EXPECT_DOUBLE_EQ(low.attainable_gflops_per_second, 2.5);
+        EXPECT_DOUBLE_EQ(low.efficiency, 0.8);
+
+        ZoneSummary dense;
+        dense.nanoseconds = 1000;
+        dense.flops = 50000;
+        dense.bytes = 1000;
+        RooflinePoint high = roofline_position(dense, model);
+        EXPECT_FALSE(high.memory_bound);
+        EXPECT_DOUBLE_EQ(high.attainable_gflops_per_second, 100.0);
+        EXPECT_DOUBLE_EQ(high.efficiency, 0.5);
+    }
+}
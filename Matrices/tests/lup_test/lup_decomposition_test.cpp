@@ -99,4 +99,75 @@ TEST(LUPDecompositionTest, PermutationCount) {
     
     Lup_Decomposition<double> lup(m);
     EXPECT_GT(lup.get_permutations(), 0);
-}
\ No newline at end of file
+}
+TEST(LUPDecompositionTest, SolveWithOpFlags) {
+    Matrix<double> m(3, 3);
+    m(0, 0) = 1; m(0, 1) = 2; m(0, 2) = 3;
+    m(1, 0) = 4; m(1, 1) = 5; m(1, 2) = 6;
+    m(2, 0) = 7; m(2, 1) = 8; m(2, 2) = 10;
+    Matrix<double> b(3, 2);
+    b(0, 0) = 1; b(1, 0) = -2; b(2, 0) = 3;
+    b(0, 1) = 0; b(1, 1) = 4; b(2, 1) = 1;
+
+    Lup_Decomposition<double> lup(m);
+
+    Matrix<double> x = lup.solve(b);
+    Matrix<double> residual = m * x - b;
+    Matrix<double> xt = lup.solve(b, Core::Op::transpose);
+    Matrix<double> residual_t = Core::transposed(m) * xt - b;
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            EXPECT_NEAR(residual(i, j), 0.0, 1e-12);
+            EXPECT_NEAR(residual_t(i, j), 0.0, 1e-12);
+        }
+    }
+
+    EXPECT_THROW(lup.solve(Matrix<double>(2, 1)), std::invalid_argument);
+}
+
+TEST(LUPDecompositionTest, ComplexSolveWithAdjointAndConjugate) {
+    using C = std::complex<double>;
+    Matrix<C> m(2, 2);
+    m(0, 0) = C(1, 2); m(0, 1) = C(3, -1);
+    m(1, 0) = C(0, 4); m(1, 1) = C(2, 1);
+    Matrix<C> b(2, 1);
+    b(0, 0) = C(1, 0); b(1, 0) = C(-1, 2);
+
+    Lup_Decomposition<C> lup(m);
+    for (Core::Op op : { Core::Op::no_transpose, Core::Op::transpose, Core::Op::conjugate_transpose, Core::Op::conjugate }) {
+        Matrix<C> x = lup.solve(b, op);
+        Matrix<C> applied = Core::OpView<C>(m, op) * x;
+        for (size_t i = 0; i < 2; ++i) {
+            EXPECT_NEAR(std::abs(applied(i, 0) - b(i, 0)), 0.0, 1e-12);
+        }
+    }
+}
+
+TEST(LUPDecompositionTest, VectorSolveMatchesMatrixSolve) {
+    using C = std::complex<double>;
+    const size_t n = 7;
+    Matrix<C> m(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            m(i, j) = C(static_cast<double>((3 * i + 5 * j) % 7) - 3.0, static_cast<double>((i + 2 * j) % 5) - 2.0);
+        }
+    }
+    Matrix<C> b(n, 1);
+    Core::Vector<C> b_vector(n);
+    for (size_t i = 0; i < n; ++i) {
+        b(i, 0) = b_vector[i] = C(1.0 + static_cast<double>(i), -static_cast<double>(i % 3));
+    }
+
+    Lup_Decomposition<C> lup(m);
+    EXPECT_GT(lup.get_permutations(), 0);
+    Core::Vector<C> x(n);
+    for (Core::Op op : { Core::Op::no_transpose, Core::Op::transpose, Core::Op::conjugate_transpose, Core::Op::conjugate }) {
+        lup.solve(b_vector, x, op);
+        const Matrix<C> expected = lup.solve(b, op);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_NEAR(std::abs(x[i] - expected(i, 0)), 0.0, 1e-12);
+        }
+    }
+    Core::Vector<C> wrong(n - 1);
+    EXPECT_THROW(lup.solve(b_vector, wrong), std::invalid_argument);
+}
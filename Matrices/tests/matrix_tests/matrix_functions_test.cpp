@@ -96,4 +96,43 @@ namespace {
         EXPECT_THROW(m3x3.swap_rows(3, 0), std::out_of_range);
         EXPECT_THROW(m3x3.swap_rows(3, 3), std::out_of_range);
     }
-}
\ No newline at end of file
+
+    TEST_F(MatrixUtilityFunctionsTest, ResizeKeepsLeadingBlockAndZeroFills) {
+        Matrix<double> m(2, 2);
+        m(0, 0) = 1.0; m(0, 1) = 2.0;
+        m(1, 0) = 3.0; m(1, 1) = 4.0;
+        const double* first_row = m(0).data();
+
+        m.resize(3, 2);
+        EXPECT_EQ(m(0).data(), first_row);
+        EXPECT_EQ(m.get_rows(), 3u);
+        EXPECT_NEAR(m(1, 1), 4.0, epsilon);
+        EXPECT_NEAR(m(2, 0), 0.0, epsilon);
+
+        m.resize(1, 1);
+        EXPECT_EQ(m.get_columns(), 1u);
+        EXPECT_NEAR(m(0, 0), 1.0, epsilon);
+    }
+
+    TEST_F(MatrixUtilityFunctionsTest, InsertAndEraseRowsAndColumns) {
+        Matrix<double> m(2, 2);
+        m(0, 0) = 1.0; m(0, 1) = 2.0;
+        m(1, 0) = 3.0; m(1, 1) = 4.0;
+
+        m.insert_row(1);
+        m.insert_column(0);
+        ASSERT_EQ(m.get_rows(), 3u);
+        ASSERT_EQ(m.get_columns(), 3u);
+        EXPECT_NEAR(m(0, 1), 1.0, epsilon);
+        EXPECT_NEAR(m(1, 2), 0.0, epsilon);
+        EXPECT_NEAR(m(2, 2), 4.0, epsilon);
+
+        m.erase_row(1);
+        m.erase_column(0);
+        EXPECT_NEAR(m(0, 1), 2.0, epsilon);
+        EXPECT_NEAR(m(1, 0), 3.0, epsilon);
+
+        EXPECT_THROW(m.insert_row(3), std::out_of_range);
+        EXPECT_THROW(m.erase_column(2), std::out_of_range);
+    }
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <complex>
+#include <stdexcept>
+
+#include "../../include/matrixlib/core/static_matrix.h"
+
+using namespace Core;
+
+namespace {
+
+    constexpr StaticMatrix<double, 2, 3> a(1.0, 2.0, 3.0,
+                                           4.0, 5.0, 6.0);
+    constexpr StaticMatrix<double, 3, 2> b(7.0, 8.0,
+                                           9.0, 10.0,
+                                           11.0, 12.0);
+
+    // Evaluated by the compiler; a wrong answer fails the build.
+    constexpr StaticMatrix2<double> product = a * b;
+    static_assert(product(0, 0) == 58.0 && product(0, 1) == 64.0);
+    static_assert(product(1, 0) == 139.0 && product(1, 1) == 154.0);
+    static_assert(transpose(a)(2, 1) == 6.0);
+    static_assert(trace(product) == 212.0);
+    static_assert(trace(StaticMatrix3<double>::identity()) == 3.0);
+    static_assert(max_norm(a - a * 2.0) == 6.0);
+    static_assert(inductive_l_one_norm_columns(a) == 9.0);
+    static_assert(inductive_l_one_norm_rows(a) == 15.0);
+    static_assert(squared_frobenius_norm(a) == 91.0);
+    static_assert(StaticMatrix2<double>::identity() * product == product);
+    static_assert(sizeof(StaticMatrix4<float>) == 16 * sizeof(float));
+
+}
+
+TEST(StaticMatrixTest, ProductMatchesDynamicMatrix) {
+    const Matrix<double> expected = a.to_matrix() * b.to_matrix();
+    const Matrix<double> actual(product);
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(StaticMatrixTest, ConvertsFromMatrixAndChecksShape) {
+    Matrix<double> dynamic(2, 3);
+    dynamic(1, 2) = 5.0;
+    const StaticMatrix<double, 2, 3> converted(dynamic);
+    EXPECT_EQ(converted(1, 2), 5.0);
+    EXPECT_THROW((StaticMatrix<double, 3, 2>(dynamic)), std::invalid_argument);
+}
+
+TEST(StaticMatrixTest, ViewFeedsSharedKernels) {
+    StaticMatrix2<double> result;
+    Kernels::gemm(1.0, view(a), Op::no_transpose, view(b), Op::no_transpose, 0.0, view(result));
+    EXPECT_EQ(result, product);
+
+    StaticMatrix<double, 3, 3> target;
+    const Matrix<double> block = b.to_matrix();
+    MatrixView<double> window = view(target).block(0, 1, 3, 2);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            window(i, j) = block(i, j);
+        }
+    }
+    EXPECT_EQ(target(2, 2), 12.0);
+    EXPECT_EQ(target(2, 0), 0.0);
+}
+
+TEST(StaticMatrixTest, ComplexAdjointAndNorms) {
+    using C = std::complex<double>;
+    const StaticMatrix2<C> m(C(3.0, 4.0), C(0.0, 1.0),
+                             C(1.0, 0.0), C(0.0, 0.0));
+    const StaticMatrix2<C> h = adjoint(m);
+    EXPECT_EQ(h(0, 1), C(1.0, 0.0));
+    EXPECT_EQ(h(1, 0), C(0.0, -1.0));
+    EXPECT_EQ(max_norm(m), 5.0);
+    EXPECT_DOUBLE_EQ(frobenius_norm(m), std::sqrt(27.0));
+    const std::array<C, 2> x{ C(1.0, 0.0), C(0.0, 1.0) };
+    const std::array<C, 2> y = m * x;
+    EXPECT_EQ(y[0], C(2.0, 4.0));
+    EXPECT_EQ(y[1], C(1.0, 0.0));
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <sstream>
+#include <type_traits>
+
+#include "../../include/matrixlib/core/allocation_tracker.h"
+#include "../../include/matrixlib/core/matrix.h"
+#include "../../include/matrixlib/algebra/blas.h"
+#include "../../include/matrixlib/core/vector.h"
+#include "../../include/matrixlib/decompositions/lup_decomposition.h"
+
+// Counts every heap allocation in test_runner, so the other suites can check
+// heap_allocations() as well.
+MATRIXLIB_DEFINE_HEAP_ALLOCATION_HOOKS()
+
+using namespace Core;
+using namespace Core::Memory;
+
+namespace {
+
+    class AllocationTrackerTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            set_allocation_tracking_enabled(true);
+            reset_allocation_stats();
+        }
+        void TearDown() override {
+            set_allocation_tracking_enabled(false);
+        }
+    };
+
+    TEST_F(AllocationTrackerTest, CountsMatrixStoragePerType) {
+        {
+            Matrix<double> a(4, 3);
+            Matrix<std::complex<float>> b(2, 2);
+
+            AllocationStats doubles = matrix_allocation_stats<double>();
+            EXPECT_EQ(doubles.allocations, 5u);
+            EXPECT_EQ(doubles.live_bytes, 4 * sizeof(std::vector<double>) + 12 * sizeof(double));
+
+            AllocationStats complexes = matrix_allocation_stats<std::complex<float>>();
+            EXPECT_EQ(complexes.allocations, 3u);
+        }
+        AllocationStats doubles = matrix_allocation_stats<double>();
+        EXPECT_EQ(doubles.deallocations, 5u);
+        EXPECT_EQ(doubles.live_bytes, 0u);
+        EXPECT_EQ(doubles.peak_live_bytes, 4 * sizeof(std::vector<double>) + 12 * sizeof(double));
+    }
+
+    TEST_F(AllocationTrackerTest, CopiesAllocateAndMovesDoNot) {
+        Matrix<double> a(3, 3, 1.0);
+        AllocationScope scope("copies");
+
+        Matrix<double> copy = a;
+        EXPECT_EQ(scope.allocations(), 4u);
+
+        Matrix<double> moved = std::move(copy);
+        EXPECT_EQ(scope.allocations(), 4u);
+        EXPECT_EQ(scope.live_bytes(), static_cast<std::int64_t>(MatrixFootprint<double>::bytes(3, 3)));
+    }
+
+    TEST_F(AllocationTrackerTest, InPlaceOperationsAreAllocationFree) {
+        Matrix<double> a(8, 8, 1.0);
+        Matrix<double> b(8, 8, 2.0);
+
+        AllocationScope scope("hot loop");
+        for (int i = 0; i < 100; ++i) {
+            a += b;
+            a -= b;
+            a *= 1.0;
+        }
+        EXPECT_EQ(scope.allocations(), 0u);
+
+        auto c = a + b;
+        EXPECT_EQ(scope.allocations(), 9u);
+    }
+
+    TEST_F(AllocationTrackerTest, HeapCountsIncludeKernelTemporaries) {
+        // Tall and narrow, so the transposed gemv sums per-block partial rows
+        // in a std::vector that no footprint covers.
+        Matrix<double> a(4096, 16, 1.0);
+        Vector<double> x(4096, 1.0);
+        Vector<double> y(16, 0.0);
+
+        AllocationScope scope("gemv");
+        Algebra::Blas::gemv(1.0, a, Op::transpose, x, 0.0, y);
+        ASSERT_TRUE(heap_allocations_counted());
+        EXPECT_EQ(scope.allocations(), 0u);
+        EXPECT_GE(scope.heap_allocations(), 1u);
+        EXPECT_GE(scope.heap_bytes(), 16 * sizeof(double));
+        EXPECT_DOUBLE_EQ(y[0], 4096.0);
+    }
+
+    TEST_F(AllocationTrackerTest, InPlaceOperationsDoNotTouchTheHeap) {
+        Matrix<double> a(8, 8, 1.0);
+        Matrix<double> b(8, 8, 2.0);
+
+        AllocationScope scope("hot loop");
+        for (int i = 0; i < 100; ++i) {
+            // Opening a scope allocates its path; that is not charged.
+            AllocationScope nested("a nested scope with a path too long for the small string buffer");
+            a += b;
+            a -= b;
+            a *= 1.0;
+        }
+        EXPECT_EQ(scope.heap_allocations(), 0u);
+
+        // The footprint misses the prototype row the constructor copies from.
+        auto c = a + b;
+        EXPECT_EQ(scope.allocations(), 9u);
+        EXPECT_GT(scope.heap_allocations(), scope.allocations());
+        EXPECT_GT(scope.heap_bytes(), scope.bytes());
+    }
+
+    TEST_F(AllocationTrackerTest, ReportsTopSitesPerPhase) {
+        Matrix<double> m(3, 3);
+        m(0, 0) = 1; m(0, 1) = 2; m(0, 2) = 3;
+        m(1, 0) = 4; m(1, 1) = 5; m(1, 2) = 6;
+        m(2, 0) = 7; m(2, 1) = 8; m(2, 2) = 10;
+
+        {
+            AllocationScope outer("solver");
+            Decompositions::LUP_Decomposition::Lup_Decomposition<double> lup(m);
+            EXPECT_GE(outer.peak_bytes(), 4 * MatrixFootprint<double>::bytes(3, 3));
+        }
+
+        auto sites = top_allocation_sites(10, "solver/Lup_Decomposition::computeDecomposition");
+        ASSERT_FALSE(sites.empty());
+        EXPECT_EQ(sites.front().path, "solver/Lup_Decomposition::computeDecomposition");
+        EXPECT_EQ(sites.front().bytes, 4 * MatrixFootprint<double>::bytes(3, 3));
+        EXPECT_GE(sites.front().peak_live_bytes, 4 * MatrixFootprint<double>::bytes(3, 3));
+
+        std::ostringstream out;
+        write_allocation_report(out);
+        EXPECT_NE(out.str().find("solver/Lup_Decomposition::computeDecomposition"), std::string::npos);
+        EXPECT_NE(out.str().find("double"), std::string::npos);
+    }
+
+    TEST_F(AllocationTrackerTest, RecordingNeverThrows) {
+        // The noexcept Matrix constructors build footprints.
+        static_assert(noexcept(record_allocation(0, 1, 8)));
+        static_assert(std::is_nothrow_constructible_v<MatrixFootprint<double>, std::size_t, std::size_t>);
+        static_assert(std::is_nothrow_copy_constructible_v<MatrixFootprint<double>>);
+        static_assert(std::is_nothrow_constructible_v<VectorFootprint<double>, std::size_t>);
+        SUCCEED();
+    }
+
+    TEST_F(AllocationTrackerTest, DisabledTrackingRecordsNothing) {
+        set_allocation_tracking_enabled(false);
+        Matrix<float> a(5, 5);
+        AllocationScope scope("ignored");
+        Matrix<float> b = a;
+        set_allocation_tracking_enabled(true);
+
+        EXPECT_EQ(matrix_allocation_stats<float>().allocations, 0u);
+        EXPECT_EQ(scope.allocations(), 0u);
+    }
+}
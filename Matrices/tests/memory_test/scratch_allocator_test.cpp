@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <vector>
+
+#include "../../include/matrixlib/algebra/matrix_operations.h"
+#include "../../include/matrixlib/core/matrix.h"
+#include "../../include/matrixlib/core/scratch_allocator.h"
+
+using namespace Core;
+using namespace Core::Memory;
+
+namespace {
+
+    TEST(ScratchAllocatorTest, ArenaScopeReleasesEverythingAtOnce) {
+        ScratchArena& arena = ScratchArena::local();
+        const std::size_t before = arena.bytes_in_use();
+        {
+            ArenaScope scope;
+            ScratchMatrix<double> a(16, 16, 1.0);
+            ScratchMatrix<double> b = a + a;
+            EXPECT_GT(arena.bytes_in_use(), before);
+            EXPECT_DOUBLE_EQ(b(15, 15), 2.0);
+        }
+        EXPECT_EQ(arena.bytes_in_use(), before);
+    }
+
+    TEST(ScratchAllocatorTest, NestedScopesRewindToTheirOwnMark) {
+        ScratchArena& arena = ScratchArena::local();
+        ArenaScope outer;
+        std::vector<double, ScratchAllocator<double>> kept(100, 1.0);
+        const std::size_t after_outer = arena.bytes_in_use();
+        {
+            ArenaScope inner;
+            std::vector<double, ScratchAllocator<double>> temporary(1000, 2.0);
+            EXPECT_GT(arena.bytes_in_use(), after_outer);
+        }
+        EXPECT_EQ(arena.bytes_in_use(), after_outer);
+        EXPECT_DOUBLE_EQ(kept[99], 1.0);
+    }
+
+    TEST(ScratchAllocatorTest, ResizingInsideAScopeKeepsOuterStorage) {
+        ScratchArena& arena = ScratchArena::local();
+        ScratchMatrix<double> outside(2, 2);
+        {
+            ArenaScope scope;
+            const std::size_t before = arena.bytes_in_use();
+            outside.assign(Matrix<double>(40, 40, 3.0));
+            EXPECT_EQ(arena.bytes_in_use(), before);
+            ScratchMatrix<double> local(40, 40, 1.0);
+            EXPECT_GT(arena.bytes_in_use(), before);
+        }
+        {
+            // Reuses the rewound arena; outside must not see these writes.
+            ArenaScope scope;
+            std::vector<double, ScratchAllocator<double>> overwrite(8192, 7.0);
+        }
+        EXPECT_DOUBLE_EQ(outside(39, 39), 3.0);
+        EXPECT_DOUBLE_EQ(outside(0, 0), 3.0);
+
+        ArenaScope outer;
+        ScratchMatrix<double> kept(1, 1);
+        const std::size_t after_outer = arena.bytes_in_use();
+        {
+            ArenaScope inner;
+            const std::size_t before = arena.bytes_in_use();
+            kept.assign(Matrix<double>(30, 30, 5.0));
+            EXPECT_EQ(arena.bytes_in_use(), before);
+        }
+        EXPECT_EQ(arena.bytes_in_use(), after_outer);
+        {
+            ArenaScope inner;
+            std::vector<double, ScratchAllocator<double>> overwrite(8192, 7.0);
+        }
+        EXPECT_DOUBLE_EQ(kept(29, 29), 5.0);
+    }
+
+    TEST(ScratchAllocatorTest, PoolReusesFreedBlocksOutsideScopes) {
+        ASSERT_FALSE(ArenaScope::active());
+        SizeClassPool& pool = SizeClassPool::local();
+        {
+            std::vector<float, ScratchAllocator<float>> warm(200);
+        }
+        const std::size_t reused = pool.reused_blocks();
+        for (int i = 0; i < 10; ++i) {
+            std::vector<float, ScratchAllocator<float>> block(200);
+        }
+        EXPECT_EQ(pool.reused_blocks(), reused + 10);
+    }
+
+    TEST(ScratchAllocatorTest, SizeClassesArePowersOfTwo) {
+        EXPECT_EQ(SizeClassPool::size_class(1), 0u);
+        EXPECT_EQ(SizeClassPool::size_class(64), 0u);
+        EXPECT_EQ(SizeClassPool::size_class(65), 1u);
+        EXPECT_EQ(SizeClassPool::class_size(SizeClassPool::size_class(5000)), 8192u);
+        EXPECT_EQ(SizeClassPool::size_class(std::size_t{ 1 } << 21), SizeClassPool::class_count);
+    }
+
+    TEST(ScratchAllocatorTest, ScratchMatrixSupportsOperations) {
+        ArenaScope scope;
+        ScratchMatrix<std::complex<double>> a(2, 3);
+        a(0, 0) = { 1, 1 }; a(0, 2) = { 0, 2 };
+        a(1, 1) = { 3, 0 };
+
+        auto h = Algebra::Operations::hermitian_matrix(a);
+        auto product = a * h;
+        EXPECT_EQ(h.get_rows(), 3u);
+        EXPECT_DOUBLE_EQ(product(0, 0).real(), 6.0);
+        EXPECT_DOUBLE_EQ(product(1, 1).real(), 9.0);
+    }
+
+    TEST(ScratchAllocatorTest, ResultsCopyOutOfTheArena) {
+        Matrix<double> kept;
+        {
+            ArenaScope scope;
+            ScratchMatrix<double> a(3, 3, 2.0);
+            ScratchMatrix<double> b = a * a;
+            kept = Matrix<double>(b);
+        }
+        EXPECT_DOUBLE_EQ(kept(2, 2), 12.0);
+
+        Matrix<double> target(3, 3);
+        {
+            ArenaScope scope;
+            ScratchMatrix<double> a(3, 3, 1.0);
+            target.assign(a + a);
+        }
+        EXPECT_DOUBLE_EQ(target(1, 2), 2.0);
+    }
+}
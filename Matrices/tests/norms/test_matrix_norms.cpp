@@ -58,3 +58,100 @@ TEST(NormsTest, L1NormReal) {
     });
     EXPECT_DOUBLE_EQ(l1_norm(mat), 10.0);
 }
+
+TEST(NormsTest, FusedNormsMatchIndividualNorms) {
+    auto mat = make_matrix<std::complex<double>>({
+        {{1.0, 2.0}, {-3.0, 0.5}, {0.0, -4.0}},
+        {{2.5, 0.0}, {1.0, 1.0}, {-0.5, 2.0}}
+    });
+    NormSet<std::complex<double>> all = norms(mat);
+    EXPECT_DOUBLE_EQ(all.frobenius, frobenius_norm(mat));
+    EXPECT_DOUBLE_EQ(all.l_one_columns, inductive_l_one_norm_columns(mat));
+    EXPECT_DOUBLE_EQ(all.l_one_rows, inductive_l_one_norm_rows(mat));
+    EXPECT_DOUBLE_EQ(all.max, max_norm(mat));
+    EXPECT_DOUBLE_EQ(all.l1, l1_norm(mat));
+    EXPECT_NEAR(all.frobenius, std::sqrt(1 + 4 + 9 + 0.25 + 16 + 6.25 + 2 + 0.25 + 4), 1e-12);
+    EXPECT_NEAR(all.l_one_columns, std::abs(std::complex<double>(0, -4)) + std::abs(std::complex<double>(-0.5, 2)), 1e-12);
+}
+
+TEST(NormsTest, MaskSelectsNorms) {
+    auto mat = make_matrix<double>({
+        {1.0, -2.0},
+        {3.0, 4.0}
+    });
+    NormSet<double> some = norms(mat, row_sum | max_entry);
+    EXPECT_EQ(some.mask, static_cast<unsigned>(row_sum | max_entry));
+    EXPECT_DOUBLE_EQ(some.l_one_rows, 7.0);
+    EXPECT_DOUBLE_EQ(some.max, 4.0);
+    EXPECT_DOUBLE_EQ(some.l_one_columns, 0.0);
+}
+
+TEST(NormsTest, FrobeniusNormDoesNotOverflowOrUnderflow) {
+    auto huge = make_matrix<double>({
+        {3e200, 4e200},
+        {0.0, 0.0}
+    });
+    EXPECT_DOUBLE_EQ(frobenius_norm(huge), 5e200);
+
+    auto tiny = make_matrix<std::complex<double>>({
+        {{3e-200, 0.0}},
+        {{0.0, 4e-200}}
+    });
+    EXPECT_DOUBLE_EQ(frobenius_norm(tiny), 5e-200);
+    EXPECT_DOUBLE_EQ(max_norm(make_matrix<std::complex<double>>({ {{1e300, 1e300}} })), std::sqrt(2.0) * 1e300);
+}
+
+TEST(NormsTest, ComplexModulusDoesNotUnderflow) {
+    auto tiny = make_matrix<std::complex<double>>({
+        {{3e-170, 4e-170}, {1e-170, 0.0}},
+        {{0.0, 0.0}, {0.0, 0.0}}
+    });
+    EXPECT_DOUBLE_EQ(max_norm(tiny), 5e-170);
+    EXPECT_DOUBLE_EQ(l1_norm(tiny), 6e-170);
+    EXPECT_DOUBLE_EQ(inductive_l_one_norm_columns(tiny), 5e-170);
+    EXPECT_DOUBLE_EQ(inductive_l_one_norm_rows(tiny), 6e-170);
+    EXPECT_DOUBLE_EQ(frobenius_norm(tiny), std::sqrt(26.0) * 1e-170);
+}
+
+TEST(NormsTest, FrobeniusNormOfSubnormalEntries) {
+    auto single = make_matrix<double>({
+        {1e-310, 0.0},
+        {0.0, 0.0}
+    });
+    EXPECT_EQ(frobenius_norm(single), 1e-310);
+
+    auto pair = make_matrix<std::complex<double>>({
+        {{3e-310, 4e-310}}
+    });
+    EXPECT_NEAR(frobenius_norm(pair), 5e-310, 1e-320);
+}
+
+TEST(NormsTest, FusedNormsAreIndependentOfThreadCount) {
+    Matrix<double> mat(700, 300);
+    for (size_t i = 0; i < mat.get_rows(); ++i) {
+        for (size_t j = 0; j < mat.get_columns(); ++j) {
+            mat(i, j) = std::sin(static_cast<double>(i * 31 + j)) * static_cast<double>(1 + (i % 7));
+        }
+    }
+    Core::Parallel::set_max_threads(1);
+    NormSet<double> serial = norms(mat);
+    Core::Parallel::set_max_threads(5);
+    NormSet<double> parallel = norms(mat);
+    Core::Parallel::set_max_threads(0);
+
+    EXPECT_EQ(serial.frobenius, parallel.frobenius);
+    EXPECT_EQ(serial.l_one_columns, parallel.l_one_columns);
+    EXPECT_EQ(serial.l_one_rows, parallel.l_one_rows);
+    EXPECT_EQ(serial.max, parallel.max);
+    EXPECT_EQ(serial.l1, parallel.l1);
+
+    double column_max = 0.0;
+    for (size_t j = 0; j < mat.get_columns(); ++j) {
+        double sum = 0.0;
+        for (size_t i = 0; i < mat.get_rows(); ++i) {
+            sum += std::abs(mat(i, j));
+        }
+        column_max = std::max(column_max, sum);
+    }
+    EXPECT_NEAR(serial.l_one_columns, column_max, 1e-9 * column_max);
+}
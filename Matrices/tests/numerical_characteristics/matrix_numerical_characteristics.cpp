@@ -1,11 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <complex>
+#include <limits>
 #include <vector>
 
 #include "../../include/matrixlib/algebra/numerical_characteristics.h"
+#include "../test_helpers.h"
 
 using namespace Core;
+using namespace TestHelpers;
 using namespace Decompositions;
 using namespace Algebra::Characteristics;
 using std::complex;
@@ -81,4 +85,255 @@ TEST(LinearAlgebraTest, EigenValuesFunction) {
     std::sort(imag_parts.begin(), imag_parts.end());
     EXPECT_NEAR(imag_parts[0], -1.0, 1e-6);
     EXPECT_NEAR(imag_parts[1], 1.0, 1e-6);
-}
\ No newline at end of file
+}
+TEST(LinearAlgebraTest, SpectralNormEstimate) {
+    Matrix<double> diagonal(3, 3);
+    diagonal(0, 0) = 1.0; diagonal(1, 1) = -3.0; diagonal(2, 2) = 2.0;
+    auto estimate = Algebra::Norms::spectral_norm_estimate(diagonal, 1e-10);
+    EXPECT_TRUE(estimate.converged);
+    EXPECT_NEAR(estimate.value, 3.0, 1e-6);
+
+    // Rank one: u v^T has ||.||_2 = ||u|| ||v||.
+    Matrix<complex<double>> rank_one(3, 2);
+    const complex<double> u[3] = { {1, 1}, {0, 2}, {-1, 0} };
+    const complex<double> v[2] = { {2, 0}, {1, -1} };
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            rank_one(i, j) = u[i] * std::conj(v[j]);
+        }
+    }
+    EXPECT_NEAR(Algebra::Norms::spectral_norm_estimate(rank_one).value, std::sqrt(7.0) * std::sqrt(6.0), 1e-6);
+
+    Matrix<double> general(2, 2);
+    general(0, 0) = 1.0; general(0, 1) = 2.0;
+    general(1, 0) = 3.0; general(1, 1) = 4.0;
+    // sigma_max^2 is the larger eigenvalue of A^T A = [[10, 14], [14, 20]].
+    EXPECT_NEAR(Algebra::Norms::spectral_norm_estimate(general, 1e-12).value, std::sqrt(15.0 + std::sqrt(221.0)), 1e-6);
+    EXPECT_EQ(Algebra::Norms::spectral_norm_estimate(Matrix<double>(2, 2)).value, 0.0);
+}
+
+TEST(LinearAlgebraTest, ConditionNumberEstimate) {
+    const size_t n = 6;
+    Matrix<double> hilbert(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            hilbert(i, j) = 1.0 / static_cast<double>(i + j + 1);
+        }
+    }
+    LUP_Decomposition::Lup_Decomposition<double> lup(hilbert);
+
+    Matrix<double> identity(n, n);
+    identity.identity_matrix(1.0);
+    const double exact_inverse_norm = Algebra::Norms::inductive_l_one_norm_columns(lup.solve(identity));
+    const double estimate = inverse_one_norm_estimate(lup);
+    EXPECT_LE(estimate, exact_inverse_norm * (1.0 + 1e-8));
+    EXPECT_GE(estimate, exact_inverse_norm / 3.0);
+
+    const double kappa = condition_number_estimate(hilbert, lup);
+    EXPECT_NEAR(kappa, Algebra::Norms::inductive_l_one_norm_columns(hilbert) * estimate, 1e-6 * kappa);
+    EXPECT_GT(kappa, 1e6);
+
+    Matrix<complex<double>> diagonal(3, 3);
+    diagonal(0, 0) = { 0, 4 }; diagonal(1, 1) = { 0.5, 0 }; diagonal(2, 2) = { 1, 1 };
+    LUP_Decomposition::Lup_Decomposition<complex<double>> complex_lup(diagonal);
+    EXPECT_NEAR(inverse_one_norm_estimate(complex_lup), 2.0, 1e-12);
+    EXPECT_NEAR(condition_number_estimate(diagonal, complex_lup), 8.0, 1e-12);
+}
+
+namespace {
+
+    // sum log|u_ii| and the sign from an explicit LUP, for reference.
+    template<typename T>
+    LogDeterminant<T> reference_slogdet(const Matrix<T>& matrix) {
+        LUP_Decomposition::Lup_Decomposition<T> lup(matrix);
+        LogDeterminant<T> result;
+        result.sign = lup.get_permutations() % 2 == 0 ? T{ 1 } : T{ -1 };
+        for (size_t i = 0; i < matrix.get_rows(); ++i) {
+            const T pivot = lup.get_U()(i, i);
+            result.log_magnitude += std::log(std::abs(pivot));
+            result.sign *= pivot / std::abs(pivot);
+        }
+        return result;
+    }
+
+    template<typename T>
+    Matrix<T> diagonally_weighted_sample(size_t n, double diagonal, unsigned seed) {
+        Matrix<T> result = sample<T>(n, n, seed);
+        for (size_t i = 0; i < n; ++i) {
+            result(i, i) += T(diagonal);
+        }
+        return result;
+    }
+
+}
+
+TEST(LinearAlgebraTest, SlogdetMatchesPivotProductAcrossBlocks) {
+    const Matrix<double> a = diagonally_weighted_sample<double>(150, 0.0, 7);
+    const LogDeterminant<double> expected = reference_slogdet(a);
+    const LogDeterminant<double> actual = slogdet(a);
+    EXPECT_EQ(actual.sign, expected.sign);
+    EXPECT_NEAR(actual.log_magnitude, expected.log_magnitude, 1e-9 * std::abs(expected.log_magnitude));
+
+    const Matrix<complex<double>> c = diagonally_weighted_sample<complex<double>>(70, 0.0, 8);
+    const LogDeterminant<complex<double>> expected_complex = reference_slogdet(c);
+    const LogDeterminant<complex<double>> actual_complex = slogdet(c);
+    EXPECT_NEAR(std::abs(actual_complex.sign - expected_complex.sign), 0.0, 1e-10);
+    EXPECT_NEAR(std::abs(actual_complex.sign), 1.0, 1e-14);
+    EXPECT_NEAR(actual_complex.log_magnitude, expected_complex.log_magnitude, 1e-9 * std::abs(expected_complex.log_magnitude));
+}
+
+TEST(LinearAlgebraTest, SlogdetStaysFiniteWhereDeterminantOverflows) {
+    const size_t n = 300;
+    const Matrix<double> a = diagonally_weighted_sample<double>(n, 1e3, 9);
+    const LogDeterminant<double> result = slogdet(a);
+    EXPECT_EQ(result.sign, 1.0);
+    EXPECT_NEAR(result.log_magnitude, static_cast<double>(n) * std::log(1e3), 1.0);
+    EXPECT_NEAR(result.log_magnitude, reference_slogdet(a).log_magnitude, 1e-9 * result.log_magnitude);
+}
+
+TEST(LinearAlgebraTest, SlogdetPositiveDefinitePath) {
+    const size_t n = 130;
+    const Matrix<complex<double>> b = diagonally_weighted_sample<complex<double>>(n, 0.0, 10);
+    Matrix<complex<double>> a = adjoint(b) * b;
+    for (size_t i = 0; i < n; ++i) {
+        a(i, i) += complex<double>(1.0);
+    }
+    const LogDeterminant<complex<double>> general = slogdet(a);
+    const LogDeterminant<complex<double>> cholesky = slogdet(a, Assume::positive_definite);
+    EXPECT_EQ(cholesky.sign, complex<double>(1.0));
+    EXPECT_NEAR(std::abs(general.sign - cholesky.sign), 0.0, 1e-10);
+    EXPECT_NEAR(cholesky.log_magnitude, general.log_magnitude, 1e-9 * std::abs(general.log_magnitude));
+
+    const Matrix<double> c = diagonally_weighted_sample<double>(n + 20, 0.0, 11);
+    Matrix<double> spd = transposed(c) * c;
+    for (size_t i = 0; i < spd.get_rows(); ++i) {
+        spd(i, i) += 1.0;
+    }
+    const LogDeterminant<double> real_general = slogdet(spd);
+    const LogDeterminant<double> real_cholesky = slogdet(spd, Assume::positive_definite);
+    EXPECT_EQ(real_cholesky.sign, 1.0);
+    EXPECT_NEAR(real_cholesky.log_magnitude, real_general.log_magnitude, 1e-9 * std::abs(real_general.log_magnitude));
+
+    // A wrong declaration falls back to the LU path.
+    Matrix<double> indefinite(2, 2);
+    indefinite(0, 0) = 2.0;
+    indefinite(1, 1) = -3.0;
+    const LogDeterminant<double> fallback = slogdet(indefinite, Assume::positive_definite);
+    EXPECT_EQ(fallback.sign, -1.0);
+    EXPECT_NEAR(fallback.log_magnitude, std::log(6.0), 1e-15);
+}
+
+TEST(LinearAlgebraTest, SlogdetOfSingularAndPermutedMatrices) {
+    Matrix<double> singular(3, 3);
+    singular(0, 0) = 1.0; singular(0, 1) = 2.0;
+    singular(1, 0) = 2.0; singular(1, 1) = 4.0;
+    singular(2, 2) = 5.0;
+    const LogDeterminant<double> zero = slogdet(singular);
+    EXPECT_EQ(zero.sign, 0.0);
+    EXPECT_TRUE(std::isinf(zero.log_magnitude) && zero.log_magnitude < 0);
+
+    Matrix<double> swap(2, 2);
+    swap(0, 1) = 1.0;
+    swap(1, 0) = 1.0;
+    EXPECT_EQ(slogdet(swap).sign, -1.0);
+    EXPECT_EQ(slogdet(swap).log_magnitude, 0.0);
+    EXPECT_THROW((void)slogdet(Matrix<double>(2, 3)), std::invalid_argument);
+}
+
+namespace {
+
+    template<typename T>
+    vector<T> column_entries(const Matrix<T>& matrix) {
+        vector<T> result(matrix.get_rows());
+        for (size_t i = 0; i < matrix.get_rows(); ++i) {
+            result[i] = matrix(i, 0);
+        }
+        return result;
+    }
+
+    template<typename T>
+    void check_fused_reductions(size_t m, size_t n, unsigned seed) {
+        const Matrix<T> a = sample<T>(m, n, seed);
+        const Matrix<T> b = sample<T>(n, m, seed + 1);
+        const Matrix<T> product = a * b;
+        const double tolerance = 10.0 * std::numeric_limits<Core::Traits::NormType<T>>::epsilon() * static_cast<double>(n);
+
+        const vector<T> diagonal = diag_of_product(a, b);
+        ASSERT_EQ(diagonal.size(), m);
+        for (size_t i = 0; i < m; ++i) {
+            EXPECT_NEAR(std::abs(diagonal[i] - product(i, i)), 0.0, tolerance) << i;
+        }
+        EXPECT_NEAR(std::abs(trace_of_product(a, b) - trace(product)), 0.0, tolerance * static_cast<double>(m));
+
+        const Matrix<T> x = sample<T>(m, 1, seed + 2);
+        const Matrix<T> y = sample<T>(n, 1, seed + 3);
+        const Matrix<T> ay = a * y;
+        T expected{};
+        for (size_t i = 0; i < m; ++i) {
+            expected += Core::Traits::conjugate(x(i, 0)) * ay(i, 0);
+        }
+        EXPECT_NEAR(std::abs(bilinear_form(column_entries(x), a, column_entries(y)) - expected), 0.0, tolerance * static_cast<double>(m));
+
+        const Matrix<T> c = sample<T>(m, n, seed + 4);
+        const vector<T> dots = rowwise_dot(a, c);
+        for (size_t i = 0; i < m; ++i) {
+            T reference{};
+            for (size_t j = 0; j < n; ++j) {
+                reference += Core::Traits::conjugate(a(i, j)) * c(i, j);
+            }
+            EXPECT_NEAR(std::abs(dots[i] - reference), 0.0, tolerance) << i;
+        }
+    }
+
+}
+
+TEST(LinearAlgebraTest, FusedReductionsMatchFormedProducts) {
+    check_fused_reductions<double>(7, 5, 60);
+    check_fused_reductions<double>(700, 130, 61);
+    check_fused_reductions<complex<double>>(130, 300, 62);
+    check_fused_reductions<float>(33, 71, 63);
+}
+
+TEST(LinearAlgebraTest, FusedReductionsUseSymmetricRows) {
+    Matrix<double> s = sample<double>(90, 90, 64);
+    for (size_t i = 0; i < 90; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            s(i, j) = s(j, i);
+        }
+    }
+    s.set_structure(StructureTag(Structure::symmetric));
+    const Matrix<double> a = sample<double>(90, 90, 65);
+    EXPECT_NEAR(trace_of_product(a, s), trace(a * s), 1e-10);
+
+    Matrix<complex<double>> h = sample<complex<double>>(40, 40, 66);
+    for (size_t i = 0; i < 40; ++i) {
+        h(i, i) = h(i, i).real();
+        for (size_t j = 0; j < i; ++j) {
+            h(i, j) = std::conj(h(j, i));
+        }
+    }
+    h.set_structure(StructureTag(Structure::hermitian));
+    const Matrix<complex<double>> c = sample<complex<double>>(40, 40, 67);
+    const Matrix<complex<double>> product = c * h;
+    const vector<complex<double>> diagonal = diag_of_product(c, h);
+    for (size_t i = 0; i < 40; ++i) {
+        EXPECT_NEAR(std::abs(diagonal[i] - product(i, i)), 0.0, 1e-12) << i;
+    }
+
+    const vector<double> x = column_entries(sample<double>(90, 1, 68));
+    double expected = 0.0;
+    for (size_t i = 0; i < 90; ++i) {
+        for (size_t j = 0; j < 90; ++j) {
+            expected += x[i] * s(i, j) * x[j];
+        }
+    }
+    EXPECT_NEAR(quadratic_form(x, s), expected, 1e-10);
+}
+
+TEST(LinearAlgebraTest, FusedReductionsCheckShapes) {
+    EXPECT_THROW((void)trace_of_product(Matrix<double>(2, 3), Matrix<double>(2, 3)), std::invalid_argument);
+    EXPECT_THROW((void)quadratic_form(vector<double>(3), Matrix<double>(3, 2)), std::invalid_argument);
+    EXPECT_THROW((void)bilinear_form(vector<double>(3), Matrix<double>(3, 2), vector<double>(3)), std::invalid_argument);
+    EXPECT_THROW((void)rowwise_dot(Matrix<double>(2, 3), Matrix<double>(3, 2)), std::invalid_argument);
+    EXPECT_EQ(trace_of_product(Matrix<double>(0, 4), Matrix<double>(4, 0)), 0.0);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <stdexcept>
+
+#include "../../include/matrixlib/algebra/matrix_chain.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+using namespace Algebra::Operations;
+
+namespace {
+
+    ChainOperand general(size_t rows, size_t columns) {
+        return { rows, columns, StructureTag() };
+    }
+
+}
+
+TEST(MatrixChainTest, TextbookOrder) {
+    // CLRS 15.2: 30x35, 35x15, 15x5, 5x10, 10x20, 20x25.
+    const ChainPlan plan({ general(30, 35), general(35, 15), general(15, 5),
+                           general(5, 10), general(10, 20), general(20, 25) });
+    EXPECT_DOUBLE_EQ(plan.cost(), 15125.0);
+    EXPECT_EQ(plan.to_string(), "((A0 (A1 A2)) ((A3 A4) A5))");
+}
+
+TEST(MatrixChainTest, VectorAtTheEndIsFoldedFirst) {
+    const ChainPlan plan({ general(400, 400), general(400, 400), general(400, 400), general(400, 1) });
+    EXPECT_EQ(plan.to_string(), "(A0 (A1 (A2 A3)))");
+    EXPECT_DOUBLE_EQ(plan.cost(), 3.0 * 400 * 400);
+}
+
+TEST(MatrixChainTest, DiagonalOperandsAreCheap) {
+    // D A D: each product visits only the diagonal band, n^2 multiply-adds.
+    const ChainOperand diagonal{ 50, 50, StructureTag(Structure::diagonal) };
+    const ChainPlan plan({ diagonal, general(50, 50), diagonal });
+    EXPECT_DOUBLE_EQ(plan.cost(), 2.0 * 50 * 50);
+    EXPECT_DOUBLE_EQ(ChainPlan::product_cost(10, 10, 10, StructureTag(Structure::identity), StructureTag()), 100.0);
+}
+
+TEST(MatrixChainTest, MultiplyChainMatchesLeftToRight) {
+    const Matrix<double> a = sample<double>(20, 30, 1);
+    const Matrix<double> b = sample<double>(30, 5, 2);
+    const Matrix<double> c = sample<double>(5, 40, 3);
+    const Matrix<double> d = sample<double>(40, 40, 4);
+    const Matrix<double> v = sample<double>(40, 1, 5);
+    expect_near(multiply_chain(a, b, c, d, v), a * b * c * d * v, 1e-12);
+    expect_near(multiply_chain({ a, b, c }), a * b * c, 1e-12);
+    expect_near(multiply_chain(d, d, d, d, d), d * d * d * d * d, 1e-9);
+
+    Matrix<double> scaling(40, 40);
+    for (size_t i = 0; i < 40; ++i) {
+        scaling(i, i) = 1.0 + static_cast<double>(i);
+    }
+    scaling.set_structure(StructureTag(Structure::diagonal));
+    Matrix<double> identity(40, 40);
+    identity.identity_matrix(1.0);
+    expect_near(multiply_chain(a, b, c, scaling, identity, d, scaling), a * b * c * scaling * d * scaling, 1e-10);
+
+    const Matrix<std::complex<double>> x = sample<std::complex<double>>(6, 9, 6);
+    const Matrix<std::complex<double>> y = sample<std::complex<double>>(9, 2, 7);
+    const Matrix<std::complex<double>> z = sample<std::complex<double>>(2, 6, 8);
+    expect_near(multiply_chain(x, y, z, x), x * y * z * x, 1e-12);
+    expect_near(multiply_chain({ x, y, z }), x * y * z, 1e-12);
+}
+
+TEST(MatrixChainTest, ShapesMustChain) {
+    EXPECT_THROW((void)multiply_chain(Matrix<double>(2, 3), Matrix<double>(2, 3)), std::invalid_argument);
+    EXPECT_THROW((void)ChainPlan({}), std::invalid_argument);
+    const Matrix<double> single = sample<double>(2, 3, 9);
+    expect_near(multiply_chain({ single }), single, 0.0);
+}
@@ -1,8 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <complex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "../../include/matrixlib/algebra/matrix_operations.h"
+#include "../../include/matrixlib/core/parallel.h"
 
 using namespace Core;
 using namespace Algebra::Operations;
@@ -95,4 +102,103 @@ TEST(MatrixOperationsTest, EmptyMatrix) {
     auto hermitian = hermitian_matrix(cmat);
     EXPECT_EQ(hermitian.get_rows(), 0);
     EXPECT_EQ(hermitian.get_columns(), 0);
-}
\ No newline at end of file
+}
+
+namespace {
+    Matrix<std::complex<double>> numbered(size_t rows, size_t columns) {
+        Matrix<std::complex<double>> result(rows, columns);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < columns; ++j) {
+                result(i, j) = { static_cast<double>(i), static_cast<double>(j) };
+            }
+        }
+        return result;
+    }
+
+    void expect_hermitian_of(const Matrix<std::complex<double>>& result, size_t rows, size_t columns, bool conjugate) {
+        ASSERT_EQ(result.get_rows(), columns);
+        ASSERT_EQ(result.get_columns(), rows);
+        for (size_t i = 0; i < columns; ++i) {
+            for (size_t j = 0; j < rows; ++j) {
+                EXPECT_EQ(result(i, j), std::complex<double>(static_cast<double>(j), conjugate ? -static_cast<double>(i) : static_cast<double>(i)));
+            }
+        }
+    }
+}
+
+TEST(MatrixOperationsTest, TiledTransposeOfOddShapes) {
+    for (auto shape : { std::pair<size_t, size_t>{ 1, 1 }, { 7, 9 }, { 65, 130 }, { 201, 67 } }) {
+        Matrix<std::complex<double>> matrix = numbered(shape.first, shape.second);
+        expect_hermitian_of(transpose(matrix), shape.first, shape.second, false);
+        expect_hermitian_of(hermitian_matrix(matrix), shape.first, shape.second, true);
+        expect_hermitian_of(transpose(Matrix<std::complex<double>>(matrix)), shape.first, shape.second, false);
+        expect_hermitian_of(hermitian_matrix(Matrix<std::complex<double>>(matrix)), shape.first, shape.second, true);
+    }
+}
+
+TEST(MatrixOperationsTest, SquareRvalueTransposeReusesStorage) {
+    for (size_t n : { 5u, 8u, 33u }) {
+        Matrix<std::complex<double>> matrix = numbered(n, n);
+        const std::complex<double>* first_row = matrix(0).data();
+        Matrix<std::complex<double>> result = hermitian_matrix(std::move(matrix));
+        EXPECT_EQ(result(0).data(), first_row);
+        expect_hermitian_of(result, n, n, true);
+    }
+}
+
+TEST(MatrixOperationsTest, ParallelTransposeMatchesSerial) {
+    Matrix<std::complex<double>> matrix = numbered(300, 520);
+    Matrix<std::complex<double>> square = numbered(400, 400);
+    Parallel::set_max_threads(4);
+    Matrix<std::complex<double>> result = hermitian_matrix(matrix);
+    Matrix<std::complex<double>> in_place = hermitian_matrix(std::move(square));
+    Parallel::set_max_threads(0);
+    expect_hermitian_of(result, 300, 520, true);
+    expect_hermitian_of(in_place, 400, 400, true);
+}
+
+TEST(MatrixOperationsTest, ParallelForCoversRangeAndRethrows) {
+    Parallel::set_max_threads(3);
+    std::vector<int> hits(100, 0);
+    Parallel::parallel_for(0, hits.size(), 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            ++hits[i];
+        }
+    });
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 100);
+    EXPECT_THROW(Parallel::parallel_for(0, 10, 1, [](size_t first, size_t) {
+        if (first == 0) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+    try {
+        Parallel::parallel_for(0, 9, 1, [](size_t first, size_t) {
+            throw std::runtime_error(std::to_string(first));
+        });
+        FAIL();
+    }
+    catch (const std::runtime_error& error) {
+        EXPECT_STREQ(error.what(), "0");
+    }
+    Parallel::set_max_threads(0);
+}
+
+TEST(MatrixOperationsTest, NestedParallelForRunsSerially) {
+    Parallel::set_max_threads(4);
+    std::vector<int> hits(64, 0);
+    std::atomic<int> moved{ 0 };
+    Parallel::parallel_for(0, hits.size(), 1, [&](size_t first, size_t last) {
+        const std::thread::id outer = std::this_thread::get_id();
+        Parallel::parallel_for(first, last, 1, [&](size_t inner_first, size_t inner_last) {
+            if (std::this_thread::get_id() != outer) {
+                ++moved;
+            }
+            for (size_t i = inner_first; i < inner_last; ++i) {
+                ++hits[i];
+            }
+        });
+    });
+    Parallel::set_max_threads(0);
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 64);
+    EXPECT_EQ(moved.load(), 0);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <stdexcept>
+
+#include "../../include/matrixlib/algebra/matrix_operations.h"
+#include "../../include/matrixlib/algebra/numerical_characteristics.h"
+#include "../../include/matrixlib/algebra/small_kernels.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+
+namespace {
+
+    // Determinant through the pivoted elimination, for reference.
+    template<typename T>
+    T reference_determinant(const Matrix<T>& matrix) {
+        const Decompositions::LUP_Decomposition::Lup_Decomposition<T> lup(matrix);
+        T result = lup.get_permutations() % 2 == 0 ? T{ 1 } : T{ -1 };
+        for (size_t i = 0; i < matrix.get_rows(); ++i) {
+            result *= lup.get_U()(i, i);
+        }
+        return result;
+    }
+
+    template<typename T>
+    void check_size(size_t n, unsigned seed) {
+        const Matrix<T> a = sample<T>(n, n, seed);
+        const Matrix<T> b = sample<T>(n, 3, seed + 100);
+        Matrix<T> identity(n, n);
+        identity.identity_matrix(T{ 1 });
+
+        const T expected = reference_determinant(a);
+        EXPECT_NEAR(std::abs(Algebra::Small::determinant(a) - expected), 0.0, 1e-12) << n;
+        expect_near(a * Algebra::Small::inverse(a), identity, 1e-10);
+        expect_near(a * Algebra::Small::solve(a, b), b, 1e-10);
+    }
+
+}
+
+TEST(SmallKernelsTest, ClosedFormsMatchElimination) {
+    for (size_t n = 1; n <= 4; ++n) {
+        check_size<double>(n, static_cast<unsigned>(n));
+        check_size<std::complex<double>>(n, static_cast<unsigned>(10 + n));
+    }
+}
+
+TEST(SmallKernelsTest, StaticOverloads) {
+    const StaticMatrix3<double> a(2.0, 1.0, 0.0,
+                                  1.0, 3.0, 1.0,
+                                  0.0, 1.0, 4.0);
+    EXPECT_DOUBLE_EQ(Algebra::Small::determinant(a), 18.0);
+    const StaticMatrix3<double> product = a * Algebra::Small::inverse(a);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_NEAR(product(i, j), i == j ? 1.0 : 0.0, 1e-15);
+        }
+    }
+    const StaticMatrix<double, 3, 1> b(3.0, 5.0, 5.0);
+    const StaticMatrix<double, 3, 1> x = Algebra::Small::solve(a, b);
+    EXPECT_NEAR(x(0, 0), 1.0, 1e-15);
+    EXPECT_NEAR(x(1, 0), 1.0, 1e-15);
+    EXPECT_NEAR(x(2, 0), 1.0, 1e-15);
+}
+
+TEST(SmallKernelsTest, NearlySingularFallsBackToPivoting) {
+    // |det| / prod of row sums is about 1e-12, below the closed-form threshold.
+    const double delta = 1e-12;
+    const StaticMatrix3<double> a(1.0, 1.0, 1.0,
+                                  1.0, 1.0 + delta, 1.0,
+                                  1.0, 1.0, 1.0 + delta);
+    const StaticMatrix3<double> inverse = Algebra::Small::inverse(a);
+    const StaticMatrix3<double> product = a * inverse;
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_NEAR(product(i, j), i == j ? 1.0 : 0.0, 1e-3);
+        }
+    }
+}
+
+TEST(SmallKernelsTest, SingularMatrices) {
+    const StaticMatrix2<double> singular(1.0, 2.0,
+                                         2.0, 4.0);
+    EXPECT_EQ(Algebra::Small::determinant(singular), 0.0);
+    EXPECT_THROW((void)Algebra::Small::inverse(singular), std::runtime_error);
+    EXPECT_THROW((void)Algebra::Small::determinant(Matrix<double>(5, 5)), std::invalid_argument);
+}
+
+TEST(SmallKernelsTest, GenericEntryPointsDispatchBySize) {
+    const Matrix<double> small = sample<double>(3, 3, 40);
+    EXPECT_NEAR(Algebra::Characteristics::determinant(small), reference_determinant(small), 1e-14);
+    const Matrix<double> large = sample<double>(7, 7, 41);
+    const Matrix<double> b = sample<double>(7, 2, 42);
+    Matrix<double> identity(7, 7);
+    identity.identity_matrix(1.0);
+    expect_near(large * Algebra::Operations::inverse(large), identity, 1e-10);
+    expect_near(large * Algebra::Operations::solve(large, b), b, 1e-10);
+    expect_near(small * Algebra::Operations::solve(small, sample<double>(3, 4, 43)), sample<double>(3, 4, 43), 1e-10);
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <utility>
+#include <vector>
+
+#include "../../include/matrixlib/decompositions/qr_decomposition.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+using Decompositions::QR_Decomposition::Qr_Decomposition;
+using Decompositions::QR_Decomposition::lstsq;
+
+namespace {
+
+    template<typename T>
+    void expect_valid_factorization(const Matrix<T>& a) {
+        Qr_Decomposition<T> qr(a);
+        const size_t k = std::min(a.get_rows(), a.get_columns());
+        const Matrix<T> q = qr.get_Q();
+        const Matrix<T> r = qr.get_R();
+        ASSERT_EQ(q.get_rows(), a.get_rows());
+        ASSERT_EQ(q.get_columns(), k);
+        ASSERT_EQ(r.get_rows(), k);
+        ASSERT_EQ(r.get_columns(), a.get_columns());
+
+        expect_near(Matrix<T>(q * r), a, 1e-10);
+        Matrix<T> identity(k, k);
+        identity.identity_matrix(T{ 1 });
+        expect_near(Matrix<T>(adjoint(q) * q), identity, 1e-12);
+        for (size_t i = 0; i < k; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                EXPECT_EQ(r(i, j), T{ 0 });
+            }
+        }
+    }
+
+    TEST(QrDecompositionTest, FactorsSquareTallAndWideMatrices) {
+        expect_valid_factorization(sample<double>(4, 4, 1u));
+        expect_valid_factorization(sample<double>(150, 70, 2u));
+        expect_valid_factorization(sample<double>(33, 90, 3u));
+        expect_valid_factorization(sample<std::complex<double>>(80, 40, 4u));
+        expect_valid_factorization(sample<std::complex<double>>(5, 8, 5u));
+    }
+
+    TEST(QrDecompositionTest, AppliesQWithoutFormingIt) {
+        const Matrix<double> a = sample<double>(100, 45, 6u);
+        Qr_Decomposition<double> qr(a);
+        const Matrix<double> q = qr.get_Q();
+        const Matrix<double> b = sample<double>(100, 3, 7u);
+        const Matrix<double> c = sample<double>(45, 2, 8u);
+
+        expect_near(qr.apply_Q_adjoint(b), Matrix<double>(transposed(q) * b), 1e-12);
+        expect_near(qr.apply_Q(c), Matrix<double>(q * c), 1e-12);
+        EXPECT_THROW((void)qr.apply_Q(Matrix<double>(44, 1)), std::invalid_argument);
+        EXPECT_THROW((void)qr.apply_Q_adjoint(Matrix<double>(99, 1)), std::invalid_argument);
+    }
+
+    TEST(QrDecompositionTest, LeastSquaresSatisfiesNormalEquations) {
+        const Matrix<double> a = sample<double>(300, 40, 8u);
+        const Matrix<double> b = sample<double>(300, 2, 9u);
+        const Matrix<double> x = lstsq(a, b);
+        ASSERT_EQ(x.get_rows(), 40u);
+        ASSERT_EQ(x.get_columns(), 2u);
+
+        const Matrix<double> residual = a * x - b;
+        const Matrix<double> gradient = transposed(a) * residual;
+        for (size_t i = 0; i < gradient.get_rows(); ++i) {
+            for (size_t j = 0; j < gradient.get_columns(); ++j) {
+                EXPECT_NEAR(gradient(i, j), 0.0, 1e-10);
+            }
+        }
+    }
+
+    TEST(QrDecompositionTest, LeastSquaresRecoversConsistentComplexSystem) {
+        const Matrix<std::complex<double>> a = sample<std::complex<double>>(60, 35, 10u);
+        const Matrix<std::complex<double>> expected = sample<std::complex<double>>(35, 2, 11u);
+        const Matrix<std::complex<double>> b = a * expected;
+        expect_near(Qr_Decomposition<std::complex<double>>(a).solve(b), expected, 1e-10);
+    }
+
+    TEST(QrDecompositionTest, LeastSquaresRejectsUnsupportedShapes) {
+        Matrix<double> deficient(4, 2);
+        for (size_t i = 0; i < 4; ++i) {
+            deficient(i, 0) = 1.0;
+        }
+        EXPECT_THROW((void)lstsq(deficient, Matrix<double>(4, 1)), std::runtime_error);
+        EXPECT_THROW((void)lstsq(sample<double>(2, 3, 12u), Matrix<double>(2, 1)), std::invalid_argument);
+        EXPECT_THROW((void)lstsq(sample<double>(4, 3, 13u), Matrix<double>(3, 1)), std::invalid_argument);
+        EXPECT_THROW(Qr_Decomposition<double>(Matrix<double>(0, 0)), std::invalid_argument);
+    }
+
+    // Checks Q R == expected with orthonormal thin Q and triangular R.
+    template<typename T>
+    void expect_factors_of(const Qr_Decomposition<T>& qr, const Matrix<T>& expected) {
+        const size_t k = std::min(expected.get_rows(), expected.get_columns());
+        ASSERT_EQ(qr.get_rows(), expected.get_rows());
+        ASSERT_EQ(qr.get_columns(), expected.get_columns());
+        const Matrix<T> q = qr.get_Q();
+        const Matrix<T> r = qr.get_R();
+        ASSERT_EQ(q.get_columns(), k);
+        ASSERT_EQ(r.get_rows(), k);
+        expect_near(Matrix<T>(q * r), expected, 1e-10);
+        Matrix<T> identity(k, k);
+        identity.identity_matrix(T{ 1 });
+        expect_near(Matrix<T>(adjoint(q) * q), identity, 1e-12);
+        for (size_t i = 0; i < k; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                EXPECT_EQ(r(i, j), T{ 0 });
+            }
+        }
+    }
+
+    template<typename T>
+    Matrix<T> with_row(const Matrix<T>& a, const std::vector<T>& row, size_t position) {
+        Matrix<T> result(a.get_rows() + 1, a.get_columns());
+        for (size_t i = 0; i < result.get_rows(); ++i) {
+            for (size_t j = 0; j < a.get_columns(); ++j) {
+                result(i, j) = i == position ? row[j] : a(i < position ? i : i - 1, j);
+            }
+        }
+        return result;
+    }
+
+    template<typename T>
+    Matrix<T> without_column(const Matrix<T>& a, size_t position) {
+        Matrix<T> result(a.get_rows(), a.get_columns() - 1);
+        for (size_t i = 0; i < a.get_rows(); ++i) {
+            for (size_t j = 0; j < result.get_columns(); ++j) {
+                result(i, j) = a(i, j < position ? j : j + 1);
+            }
+        }
+        return result;
+    }
+
+    TEST(QrDecompositionTest, AddsAndRemovesRows) {
+        Matrix<double> a = sample<double>(12, 5, 20u);
+        Qr_Decomposition<double> qr(a);
+        const std::vector<double> row{ 0.5, -1.0, 2.0, 0.25, -0.75 };
+
+        qr.add_row(row, 4);
+        a = with_row(a, row, 4);
+        expect_factors_of(qr, a);
+
+        qr.add_row(row);
+        a = with_row(a, row, a.get_rows());
+        expect_factors_of(qr, a);
+
+        qr.remove_row(0);
+        Matrix<double> removed(a.get_rows() - 1, a.get_columns());
+        for (size_t i = 1; i < a.get_rows(); ++i) {
+            for (size_t j = 0; j < a.get_columns(); ++j) {
+                removed(i - 1, j) = a(i, j);
+            }
+        }
+        expect_factors_of(qr, removed);
+
+        EXPECT_THROW(qr.add_row(std::vector<double>(4)), std::invalid_argument);
+        EXPECT_THROW(qr.remove_row(100), std::out_of_range);
+    }
+
+    TEST(QrDecompositionTest, RemovesRowWhoseUnitVectorIsInTheRangeOfQ) {
+        Matrix<double> a(4, 2);
+        a(0, 0) = 3.0;
+        a(1, 1) = 2.0;
+        a(2, 1) = 1.0;
+        Qr_Decomposition<double> qr(a);
+        qr.remove_row(0);
+        Matrix<double> expected(3, 2);
+        expected(0, 1) = 2.0;
+        expected(1, 1) = 1.0;
+        expect_factors_of(qr, expected);
+    }
+
+    TEST(QrDecompositionTest, AddsAndRemovesColumnsOfTallAndWideMatrices) {
+        for (const auto& shape : { std::pair<size_t, size_t>{ 10, 4 }, std::pair<size_t, size_t>{ 4, 7 }, std::pair<size_t, size_t>{ 6, 6 } }) {
+            Matrix<std::complex<double>> a = sample<std::complex<double>>(shape.first, shape.second, 21u);
+            Qr_Decomposition<std::complex<double>> qr(a);
+
+            const Matrix<std::complex<double>> extra = sample<std::complex<double>>(shape.first, 1, 22u);
+            std::vector<std::complex<double>> column(shape.first);
+            for (size_t i = 0; i < shape.first; ++i) {
+                column[i] = extra(i, 0);
+            }
+            qr.add_column(column, 1);
+            Matrix<std::complex<double>> widened(shape.first, shape.second + 1);
+            for (size_t i = 0; i < shape.first; ++i) {
+                for (size_t j = 0; j <= shape.second; ++j) {
+                    widened(i, j) = j == 1 ? column[i] : a(i, j < 1 ? j : j - 1);
+                }
+            }
+            expect_factors_of(qr, widened);
+
+            qr.remove_column(0);
+            a = without_column(widened, 0);
+            expect_factors_of(qr, a);
+        }
+    }
+
+    TEST(QrDecompositionTest, RankOneUpdate) {
+        for (const auto& shape : { std::pair<size_t, size_t>{ 9, 4 }, std::pair<size_t, size_t>{ 3, 5 } }) {
+            Matrix<std::complex<double>> a = sample<std::complex<double>>(shape.first, shape.second, 23u);
+            Qr_Decomposition<std::complex<double>> qr(a);
+            const Matrix<std::complex<double>> u = sample<std::complex<double>>(shape.first, 1, 24u);
+            const Matrix<std::complex<double>> v = sample<std::complex<double>>(shape.second, 1, 25u);
+            std::vector<std::complex<double>> u_vector(shape.first), v_vector(shape.second);
+            for (size_t i = 0; i < shape.first; ++i) {
+                u_vector[i] = u(i, 0);
+            }
+            for (size_t j = 0; j < shape.second; ++j) {
+                v_vector[j] = v(j, 0);
+            }
+            qr.update(u_vector, v_vector);
+            expect_factors_of(qr, Matrix<std::complex<double>>(a + u * adjoint(v)));
+        }
+    }
+
+    TEST(QrDecompositionTest, AddRowReusesTheRowsOfQ) {
+        const Matrix<double> data = sample<double>(30, 4, 28u);
+        Qr_Decomposition<double> qr(sample<double>(10, 4, 29u));
+        qr.add_row(std::vector<double>(data(0).begin(), data(0).end()));
+
+        Memory::set_allocation_tracking_enabled(true);
+        {
+            Memory::AllocationScope scope("streaming");
+            for (size_t i = 1; i < data.get_rows(); ++i) {
+                qr.add_row(std::vector<double>(data(i).begin(), data(i).end()));
+            }
+            // One new row of Q and one of R per update, not a copy of Q.
+            EXPECT_LE(scope.allocations(), 2 * (data.get_rows() - 1));
+        }
+        Memory::set_allocation_tracking_enabled(false);
+        EXPECT_EQ(qr.get_rows(), 40u);
+    }
+
+    TEST(QrDecompositionTest, StreamingRowsWithPeriodicRefactorization) {
+        const Matrix<double> data = sample<double>(240, 6, 26u);
+        Matrix<double> initial(40, 6);
+        for (size_t i = 0; i < 40; ++i) {
+            std::copy(data(i).begin(), data(i).end(), initial(i).begin());
+        }
+        Qr_Decomposition<double> qr(initial);
+        qr.set_refactor_interval(64);
+        for (size_t i = 40; i < data.get_rows(); ++i) {
+            qr.add_row(std::vector<double>(data(i).begin(), data(i).end()));
+        }
+        expect_factors_of(qr, data);
+
+        const Matrix<double> b = sample<double>(240, 1, 27u);
+        expect_near(qr.solve(b), lstsq(data, b), 1e-10);
+    }
+
+}
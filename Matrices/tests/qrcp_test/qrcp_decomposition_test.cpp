@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "../../include/matrixlib/algebra/numerical_characteristics.h"
+#include "../../include/matrixlib/decompositions/qrcp_decomposition.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+using Decompositions::QRCP_Decomposition::Qrcp_Decomposition;
+
+namespace {
+
+    template<typename T>
+    void expect_valid_factorization(const Matrix<T>& a) {
+        Qrcp_Decomposition<T> qrcp(a);
+        const Matrix<T> q = qrcp.get_Q();
+        const Matrix<T> r = qrcp.get_R();
+        const std::vector<size_t>& permutation = qrcp.get_permutation();
+        const Matrix<T> qr = q * r;
+        const size_t k = std::min(a.get_rows(), a.get_columns());
+
+        for (size_t i = 0; i < a.get_rows(); ++i) {
+            for (size_t j = 0; j < a.get_columns(); ++j) {
+                EXPECT_NEAR(std::abs(qr(i, j) - a(i, permutation[j])), 0.0, 1e-10) << i << ", " << j;
+            }
+        }
+        const Matrix<T> gram = adjoint(q) * q;
+        for (size_t i = 0; i < k; ++i) {
+            for (size_t j = 0; j < k; ++j) {
+                EXPECT_NEAR(std::abs(gram(i, j) - (i == j ? T{ 1 } : T{ 0 })), 0.0, 1e-12);
+            }
+        }
+        const auto diagonal = qrcp.diagonal_magnitudes();
+        for (size_t i = 1; i < diagonal.size(); ++i) {
+            EXPECT_LE(diagonal[i], diagonal[i - 1] * (1.0 + 1e-12));
+        }
+    }
+
+    TEST(QrcpDecompositionTest, FactorsSquareTallAndWideMatrices) {
+        expect_valid_factorization(sample<double>(5, 5, 4u));
+        expect_valid_factorization(sample<double>(90, 45, 12u));
+        expect_valid_factorization(sample<double>(40, 75, 21u));
+        expect_valid_factorization(sample<std::complex<double>>(50, 37, 10u));
+        expect_valid_factorization(sample<std::complex<double>>(6, 9, 5u));
+    }
+
+    TEST(QrcpDecompositionTest, RevealsRankOfLowRankProduct) {
+        const Matrix<double> a = sample<double>(70, 6, 3u) * sample<double>(6, 50, 18u);
+        Qrcp_Decomposition<double> qrcp(a);
+        EXPECT_EQ(qrcp.rank(), 6u);
+        EXPECT_EQ(Algebra::Characteristics::rank(a), 6);
+
+        const Matrix<std::complex<double>> c = sample<std::complex<double>>(9, 3, 6u) * sample<std::complex<double>>(3, 12, 2u);
+        EXPECT_EQ(Algebra::Characteristics::rank(c), 3);
+    }
+
+    TEST(QrcpDecompositionTest, RankToleranceIsRelative) {
+        Matrix<double> tiny = sample<double>(4, 6, 7u);
+        tiny *= 1e-14;
+        EXPECT_EQ(Algebra::Characteristics::relative_rank(tiny, 1e-10), 4);
+        // The two-argument rank keeps its absolute threshold.
+        EXPECT_EQ(Algebra::Characteristics::rank(tiny, 1e-10), 0);
+
+        Matrix<double> graded(3, 3);
+        graded(0, 0) = 1.0; graded(1, 1) = 1e-6; graded(2, 2) = 1e-13;
+        EXPECT_EQ(Algebra::Characteristics::relative_rank(graded, 1e-10), 2);
+        EXPECT_EQ(Algebra::Characteristics::rank(graded, 1e-10), 2);
+        EXPECT_EQ(Algebra::Characteristics::rank(graded, 1e-14), 3);
+        EXPECT_EQ(Algebra::Characteristics::rank(graded), 3);
+    }
+
+    TEST(QrcpDecompositionTest, PivotsSelectIndependentColumns) {
+        Matrix<double> a(4, 4);
+        // Columns 0 and 2 repeat column 1 scaled; column 3 is independent.
+        for (size_t i = 0; i < 4; ++i) {
+            a(i, 1) = static_cast<double>(i + 1);
+            a(i, 0) = 2.0 * a(i, 1);
+            a(i, 2) = -a(i, 1);
+            a(i, 3) = i % 2 == 0 ? 1.0 : -1.0;
+        }
+        Qrcp_Decomposition<double> qrcp(a);
+        ASSERT_EQ(qrcp.rank(), 2u);
+        EXPECT_EQ(qrcp.get_permutation()[0], 0u);
+        EXPECT_EQ(qrcp.get_permutation()[1], 3u);
+    }
+
+    TEST(QrcpDecompositionTest, RejectsEmptyMatrix) {
+        EXPECT_THROW(Qrcp_Decomposition<double>(Matrix<double>(0, 3)), std::invalid_argument);
+    }
+
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <complex>
+#include <stdexcept>
+
+#include "../../include/matrixlib/decompositions/schur_decomposition.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+using Decompositions::SCHUR_Decomposition::Schur_Decomposition;
+
+namespace {
+
+    template<typename T>
+    void check_factorization(const Matrix<T>& a) {
+        using C = std::complex<double>;
+        const size_t n = a.get_rows();
+        const Schur_Decomposition<T> schur(a);
+        const Matrix<C>& q = schur.get_Q();
+        const Matrix<C>& t = schur.get_T();
+        const Matrix<C> product = (q * t) * adjoint(q);
+        const Matrix<C> gram = adjoint(q) * q;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                EXPECT_NEAR(std::abs(product(i, j) - C(a(i, j))), 0.0, 1e-12) << i << ", " << j;
+                EXPECT_NEAR(std::abs(gram(i, j) - (i == j ? C(1.0) : C(0.0))), 0.0, 1e-12) << i << ", " << j;
+                if (i > j) {
+                    EXPECT_EQ(t(i, j), C(0.0));
+                }
+            }
+        }
+    }
+
+}
+
+TEST(SchurDecompositionTest, FactorsRealAndComplexMatrices) {
+    check_factorization(sample<double>(1, 1, 1));
+    check_factorization(sample<double>(2, 2, 2));
+    check_factorization(sample<double>(9, 9, 3));
+    check_factorization(sample<double>(40, 40, 4));
+    check_factorization(sample<std::complex<double>>(17, 17, 5));
+}
+
+TEST(SchurDecompositionTest, RotationHasConjugateEigenvalues) {
+    Matrix<double> rotation(2, 2);
+    rotation(0, 1) = -2.0;
+    rotation(1, 0) = 2.0;
+    std::vector<std::complex<double>> values = Schur_Decomposition<double>(rotation).eigenvalues();
+    std::sort(values.begin(), values.end(), [](const auto& x, const auto& y) { return x.imag() < y.imag(); });
+    EXPECT_NEAR(std::abs(values[0] - std::complex<double>(0.0, -2.0)), 0.0, 1e-14);
+    EXPECT_NEAR(std::abs(values[1] - std::complex<double>(0.0, 2.0)), 0.0, 1e-14);
+    EXPECT_THROW(Schur_Decomposition<double>(Matrix<double>(2, 3)), std::invalid_argument);
+}
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <vector>
+
+#include "../../include/matrixlib/algebra/matrix_properties.h"
+#include "../../include/matrixlib/algebra/numerical_characteristics.h"
+#include "../../include/matrixlib/core/matrix.h"
+#include "../../include/matrixlib/decompositions/lup_decomposition.h"
+
+using namespace Core;
+using Algebra::Properties::detect_structure;
+using Algebra::Properties::tag_structure;
+
+namespace {
+
+    Matrix<double> banded_sample(size_t n, size_t lower, size_t upper) {
+        Matrix<double> result(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                if (j + lower >= i && i + upper >= j) {
+                    result(i, j) = 1.0 + static_cast<double>((3 * i + 5 * j) % 7) + (i == j ? 10.0 : 0.0);
+                }
+            }
+        }
+        return result;
+    }
+
+    Matrix<double> dense_sample(size_t rows, size_t columns) {
+        Matrix<double> result(rows, columns);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < columns; ++j) {
+                result(i, j) = static_cast<double>((i * 7 + j * 3) % 11) - 5.0;
+            }
+        }
+        return result;
+    }
+
+    void expect_near(const Matrix<double>& actual, const Matrix<double>& expected) {
+        ASSERT_EQ(actual.get_rows(), expected.get_rows());
+        ASSERT_EQ(actual.get_columns(), expected.get_columns());
+        for (size_t i = 0; i < actual.get_rows(); ++i) {
+            for (size_t j = 0; j < actual.get_columns(); ++j) {
+                EXPECT_NEAR(actual(i, j), expected(i, j), 1e-9);
+            }
+        }
+    }
+
+    TEST(StructureTest, DetectsNarrowestStructure) {
+        EXPECT_EQ(detect_structure(banded_sample(6, 0, 5)).kind(), Structure::upper_triangular);
+        EXPECT_EQ(detect_structure(banded_sample(6, 5, 0)).kind(), Structure::lower_triangular);
+        EXPECT_EQ(detect_structure(banded_sample(6, 0, 0)).kind(), Structure::diagonal);
+
+        StructureTag tridiagonal = detect_structure(banded_sample(6, 1, 1));
+        EXPECT_EQ(tridiagonal.kind(), Structure::banded);
+        EXPECT_EQ(tridiagonal.lower_bandwidth(), 1u);
+        EXPECT_EQ(tridiagonal.upper_bandwidth(), 1u);
+
+        Matrix<double> identity(4, 4);
+        identity.identity_matrix(1.0);
+        EXPECT_EQ(detect_structure(identity).kind(), Structure::identity);
+
+        Matrix<double> symmetric = dense_sample(4, 4) + Algebra::Operations::transpose(dense_sample(4, 4));
+        EXPECT_EQ(detect_structure(symmetric).kind(), Structure::symmetric);
+        EXPECT_TRUE(detect_structure(dense_sample(4, 5)).is_general());
+
+        Matrix<std::complex<double>> hermitian(2, 2);
+        hermitian(0, 0) = 2.0; hermitian(1, 1) = 3.0;
+        hermitian(0, 1) = { 1, 1 }; hermitian(1, 0) = { 1, -1 };
+        EXPECT_EQ(detect_structure(hermitian).kind(), Structure::hermitian);
+    }
+
+    TEST(StructureTest, MutationDropsTheTag) {
+        Matrix<double> matrix = banded_sample(4, 0, 3);
+        tag_structure(matrix);
+        ASSERT_EQ(matrix.structure().kind(), Structure::upper_triangular);
+
+        const Matrix<double>& read_only = matrix;
+        EXPECT_GT(read_only(0, 0), 0.0);
+        EXPECT_EQ(matrix.structure().kind(), Structure::upper_triangular);
+        EXPECT_GT(matrix.get(0, 0), 0.0);
+        EXPECT_GT(matrix.get(0)[1], 0.0);
+        EXPECT_EQ(matrix.structure().kind(), Structure::upper_triangular);
+
+        Matrix<double> copy = matrix;
+        EXPECT_EQ(copy.structure().kind(), Structure::upper_triangular);
+
+        matrix(3, 0) = 1.0;
+        EXPECT_TRUE(matrix.structure().is_general());
+
+        copy *= 2.0;
+        EXPECT_EQ(copy.structure().kind(), Structure::upper_triangular);
+        copy += copy;
+        EXPECT_TRUE(copy.structure().is_general());
+
+        Matrix<double> marked = banded_sample(4, 0, 3);
+        tag_structure(marked);
+        marked.mark_modified();
+        EXPECT_TRUE(marked.structure().is_general());
+        marked.mark_modified();
+        EXPECT_TRUE(marked.structure().is_general());
+
+        EXPECT_THROW(dense_sample(2, 3).set_structure(StructureTag(Structure::identity)), std::invalid_argument);
+    }
+
+    TEST(StructureTest, StructuredProductsMatchDense) {
+        const size_t n = 9;
+        Matrix<double> dense = dense_sample(n, 5);
+        for (auto band : { std::pair<size_t, size_t>{ 0, 8 }, { 8, 0 }, { 0, 0 }, { 1, 2 } }) {
+            Matrix<double> structured = banded_sample(n, band.first, band.second);
+            Matrix<double> expected = structured * dense;
+            Matrix<double> expected_square = structured * structured;
+
+            tag_structure(structured);
+            expect_near(structured * dense, expected);
+            expect_near(Algebra::Operations::transpose(dense) * structured,
+                Algebra::Operations::transpose(Algebra::Operations::transpose(structured) * dense));
+
+            Matrix<double> square = structured * structured;
+            expect_near(square, expected_square);
+            EXPECT_EQ(square.structure().lower_bandwidth(n), std::min(n - 1, 2 * band.first));
+            EXPECT_EQ(square.structure().upper_bandwidth(n), std::min(n - 1, 2 * band.second));
+        }
+    }
+
+    TEST(StructureTest, IdentityProductPassesOperandThrough) {
+        Matrix<double> identity(3, 3);
+        identity.identity_matrix(1.0);
+        tag_structure(identity);
+        Matrix<double> dense = dense_sample(3, 4);
+        expect_near(identity * dense, dense);
+    }
+
+    TEST(StructureTest, SmallEntriesAreNotDroppedByTheTag) {
+        Matrix<double> a = dense_sample(3, 3);
+        Matrix<double> b = dense_sample(3, 3);
+        a *= 1e-11;
+        b *= 1e-11;
+        Matrix<double> expected = a * b;
+
+        tag_structure(a);
+        EXPECT_TRUE(a.structure().is_general() || a.structure().kind() == Structure::symmetric);
+        Matrix<double> product = a * b;
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                EXPECT_DOUBLE_EQ(product(i, j), expected(i, j));
+            }
+        }
+
+        Matrix<double> near_identity(3, 3);
+        near_identity.identity_matrix(1.0);
+        near_identity(1, 1) = 1.0 + 1e-12;
+        EXPECT_EQ(detect_structure(near_identity).kind(), Structure::diagonal);
+
+        Matrix<double> left(std::vector<std::vector<double>>{ { 1.0, 2.0 }, { 3.0, 4.0 } });
+        Matrix<double> nearly_symmetric(std::vector<std::vector<double>>{ { 1e-11, 5e-11 }, { 1e-11, 2e-11 } });
+        const double trace = Algebra::Characteristics::trace_of_product(left, nearly_symmetric);
+        tag_structure(nearly_symmetric);
+        EXPECT_TRUE(nearly_symmetric.structure().is_general());
+        EXPECT_DOUBLE_EQ(Algebra::Characteristics::trace_of_product(left, nearly_symmetric), trace);
+    }
+
+    TEST(StructureTest, BandedLupMatchesDense) {
+        for (auto band : { std::pair<size_t, size_t>{ 1, 1 }, { 2, 0 }, { 0, 3 }, { 7, 0 } }) {
+            Matrix<double> matrix = banded_sample(8, band.first, band.second);
+            Matrix<double> rhs = dense_sample(8, 2);
+            Decompositions::LUP_Decomposition::Lup_Decomposition<double> dense(matrix);
+            tag_structure(matrix);
+            Decompositions::LUP_Decomposition::Lup_Decomposition<double> banded(matrix);
+
+            expect_near(banded.solve(rhs), dense.solve(rhs));
+            expect_near(banded.get_P() * matrix, banded.get_L() * banded.get_U());
+            EXPECT_NEAR(Algebra::Characteristics::determinant(banded), Algebra::Characteristics::determinant(dense), 1e-6);
+        }
+    }
+
+    TEST(StructureTest, BandedSolveWithPivotingMatchesResidual) {
+        // A weak diagonal forces row swaps, which spread the multipliers of L.
+        const size_t n = 40;
+        Matrix<double> matrix = banded_sample(n, 2, 1);
+        for (size_t i = 0; i < n; ++i) {
+            matrix(i, i) = 0.01 * static_cast<double>(i % 3);
+        }
+        tag_structure(matrix);
+        const Matrix<double> rhs = dense_sample(n, 3);
+        Decompositions::LUP_Decomposition::Lup_Decomposition<double> lup(matrix);
+        EXPECT_GT(lup.get_permutations(), 0u);
+
+        expect_near(matrix * lup.solve(rhs), rhs);
+        expect_near(transposed(matrix) * lup.solve(rhs, Op::transpose), rhs);
+    }
+
+    TEST(StructureTest, TriangularDeterminantAndEigenvalues) {
+        Matrix<double> upper = banded_sample(5, 0, 4);
+        const double dense_determinant = Algebra::Characteristics::determinant(upper);
+
+        double diagonal_product = 1.0;
+        for (size_t i = 0; i < 5; ++i) {
+            diagonal_product *= upper(i, i);
+        }
+        tag_structure(upper);
+        EXPECT_NEAR(Algebra::Characteristics::determinant(upper), dense_determinant, 1e-6 * std::abs(dense_determinant));
+        EXPECT_DOUBLE_EQ(Algebra::Characteristics::determinant(upper), diagonal_product);
+
+        std::vector<double> eigenvalues = Algebra::Characteristics::eigen_values(upper, 10);
+        ASSERT_EQ(eigenvalues.size(), 5u);
+        for (size_t i = 0; i < 5; ++i) {
+            EXPECT_DOUBLE_EQ(eigenvalues[i], static_cast<const Matrix<double>&>(upper)(i, i));
+        }
+    }
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "../include/matrixlib/core/matrix.h"
+#include "../include/matrixlib/core/type_traits.h"
+#include "../include/matrixlib/core/vector.h"
+
+// Random samples and comparisons shared by the decomposition, kernel and
+// matrix function tests. Entries are uniform in [-scale, scale], real and
+// imaginary parts drawn in turn, so a seed gives the same matrix everywhere.
+
+namespace TestHelpers {
+
+    template<typename T>
+    T random_value(std::mt19937& engine, double scale = 1.0) {
+        std::uniform_real_distribution<double> distribution(-scale, scale);
+        if constexpr (Core::Traits::is_complex<T>::value) {
+            const double real = distribution(engine);
+            return T(real, distribution(engine));
+        }
+        else {
+            return static_cast<T>(distribution(engine));
+        }
+    }
+
+    template<typename T>
+    Core::Matrix<T> sample(size_t rows, size_t columns, std::mt19937& engine, double scale = 1.0) {
+        Core::Matrix<T> result(rows, columns);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < columns; ++j) {
+                result(i, j) = random_value<T>(engine, scale);
+            }
+        }
+        return result;
+    }
+
+    template<typename T>
+    Core::Matrix<T> sample(size_t rows, size_t columns, unsigned seed, double scale = 1.0) {
+        std::mt19937 engine(seed);
+        return sample<T>(rows, columns, engine, scale);
+    }
+
+    template<typename T>
+    Core::Vector<T> sample_vector(size_t size, unsigned seed) {
+        std::mt19937 engine(seed);
+        Core::Vector<T> result(size);
+        for (T& value : result) {
+            value = random_value<T>(engine);
+        }
+        return result;
+    }
+
+    template<typename T>
+    void expect_near(const Core::Matrix<T>& actual, const Core::Matrix<T>& expected, double tolerance) {
+        ASSERT_EQ(actual.get_rows(), expected.get_rows());
+        ASSERT_EQ(actual.get_columns(), expected.get_columns());
+        for (size_t i = 0; i < actual.get_rows(); ++i) {
+            for (size_t j = 0; j < actual.get_columns(); ++j) {
+                EXPECT_NEAR(std::abs(actual(i, j) - expected(i, j)), 0.0, tolerance) << i << ", " << j;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+
+#include "../../include/matrixlib/core/parallel.h"
+#include "../../include/matrixlib/decompositions/tsqr_decomposition.h"
+#include "../test_helpers.h"
+
+using namespace Core;
+using namespace TestHelpers;
+using Decompositions::QR_Decomposition::Qr_Decomposition;
+using Decompositions::TSQR_Decomposition::Tsqr_Decomposition;
+
+namespace {
+
+    template<typename T>
+    void expect_valid_factorization(const Matrix<T>& a, size_t leaves) {
+        Tsqr_Decomposition<T> tsqr(a);
+        EXPECT_EQ(tsqr.leaf_count(), leaves);
+        const Matrix<T> q = tsqr.get_Q();
+        const Matrix<T>& r = tsqr.get_R();
+        ASSERT_EQ(q.get_rows(), a.get_rows());
+        ASSERT_EQ(q.get_columns(), a.get_columns());
+        ASSERT_EQ(r.get_rows(), a.get_columns());
+
+        expect_near(Matrix<T>(q * r), a, 1e-10);
+        Matrix<T> identity(a.get_columns(), a.get_columns());
+        identity.identity_matrix(T{ 1 });
+        expect_near(Matrix<T>(adjoint(q) * q), identity, 1e-12);
+
+        // R is unique up to a unimodular scaling of its rows.
+        const Matrix<T> reference = Qr_Decomposition<T>(a).get_R();
+        for (size_t i = 0; i < r.get_rows(); ++i) {
+            for (size_t j = 0; j < r.get_columns(); ++j) {
+                EXPECT_NEAR(std::abs(r(i, j)), std::abs(reference(i, j)), 1e-10);
+            }
+        }
+    }
+
+    TEST(TsqrDecompositionTest, FactorsOverATreeOfLeaves) {
+        // Five leaves: the odd one is carried up a level unchanged.
+        expect_valid_factorization(sample<double>(5 * 4096 + 7, 12, 1u), 5);
+        expect_valid_factorization(sample<std::complex<double>>(2 * 4096, 5, 2u), 2);
+        expect_valid_factorization(sample<double>(50, 20, 3u), 1);
+    }
+
+    TEST(TsqrDecompositionTest, SolvesLeastSquaresLikeHouseholderQr) {
+        const Matrix<double> a = sample<double>(3 * 4096 + 100, 9, 4u);
+        const Matrix<double> b = sample<double>(a.get_rows(), 2, 5u);
+        const Matrix<double> x = Tsqr_Decomposition<double>(a).solve(b);
+        expect_near(x, Qr_Decomposition<double>(a).solve(b), 1e-10);
+    }
+
+    TEST(TsqrDecompositionTest, ResultDoesNotDependOnThreadCount) {
+        const Matrix<double> a = sample<double>(4 * 4096, 6, 6u);
+        Parallel::set_max_threads(1);
+        const Matrix<double> serial = Tsqr_Decomposition<double>(a).get_R();
+        Parallel::set_max_threads(4);
+        const Matrix<double> threaded = Tsqr_Decomposition<double>(a).get_R();
+        Parallel::set_max_threads(0);
+        for (size_t i = 0; i < serial.get_rows(); ++i) {
+            for (size_t j = 0; j < serial.get_columns(); ++j) {
+                EXPECT_EQ(serial(i, j), threaded(i, j));
+            }
+        }
+    }
+
+    TEST(TsqrDecompositionTest, RejectsWideAndMismatchedInput) {
+        EXPECT_THROW(Tsqr_Decomposition<double>(Matrix<double>(3, 4)), std::invalid_argument);
+        Tsqr_Decomposition<double> tsqr(sample<double>(10, 3, 7u));
+        EXPECT_THROW((void)tsqr.apply_Q_adjoint(Matrix<double>(9, 1)), std::invalid_argument);
+        EXPECT_THROW((void)tsqr.apply_Q(Matrix<double>(2, 1)), std::invalid_argument);
+    }
+
+}